@@ -917,6 +917,7 @@ rm -rf $RPM_BUILD_ROOT
 %{_libdir}/slurm/proctrack_cgroup.so
 %{_libdir}/slurm/proctrack_linuxproc.so
 %{_libdir}/slurm/proctrack_pgid.so
+%{_libdir}/slurm/route_adaptive.so
 %{_libdir}/slurm/route_default.so
 %{_libdir}/slurm/route_topology.so
 %{_libdir}/slurm/sched_backfill.so
@@ -86,6 +86,50 @@ slurm_kill_job (uint32_t job_id, uint16_t signal, uint16_t flags)
 	return SLURM_SUCCESS;
 }
 
+/*
+ * slurm_kill_jobs - issue one RPC to send the specified signal to a list of
+ *	jobs, or to every active job matching the filters in the request
+ * NOTE: free the response using slurm_free_kill_jobs_resp_msg
+ * IN req - description of jobs to signal
+ * OUT resp - count of jobs signaled plus the jobs which could not be signaled
+ *	and why
+ * RET 0 if the request was processed, in which case individual jobs may still
+ *	have failed, otherwise return -1 and set errno to indicate the error
+ */
+extern int
+slurm_kill_jobs (kill_jobs_msg_t *req, kill_jobs_resp_msg_t **resp)
+{
+	int rc;
+	slurm_msg_t req_msg;
+	slurm_msg_t resp_msg;
+
+	slurm_msg_t_init(&req_msg);
+	slurm_msg_t_init(&resp_msg);
+	req_msg.msg_type = REQUEST_KILL_JOBS;
+	req_msg.data     = req;
+
+	if (slurm_send_recv_controller_msg(&req_msg, &resp_msg) < 0)
+		return SLURM_ERROR;
+
+	switch (resp_msg.msg_type) {
+	case RESPONSE_SLURM_RC:
+		rc = ((return_code_msg_t *) resp_msg.data)->return_code;
+		slurm_free_return_code_msg(resp_msg.data);
+		*resp = NULL;
+		if (rc)
+			slurm_seterrno_ret(rc);
+		break;
+	case RESPONSE_KILL_JOBS:
+		*resp = (kill_jobs_resp_msg_t *) resp_msg.data;
+		break;
+	default:
+		*resp = NULL;
+		slurm_seterrno_ret(SLURM_UNEXPECTED_MSG_ERROR);
+	}
+
+	return SLURM_SUCCESS;
+}
+
 /*
  * Kill a job step with job id "job_id" and step id "step_id", optionally
  *	sending the processes in the job step a signal "signal"
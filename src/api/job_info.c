@@ -1206,6 +1206,126 @@ slurm_load_jobs (time_t update_time, job_info_msg_t **job_info_msg_pptr,
 	return SLURM_PROTOCOL_SUCCESS;
 }
 
+static int _cmp_job_id(const void *x, const void *y)
+{
+	uint32_t a = *(uint32_t *) x, b = *(uint32_t *) y;
+
+	if (a < b)
+		return -1;
+	if (a > b)
+		return 1;
+	return 0;
+}
+
+/* Merge the records of a job information delta response with unchanged
+ * records from old_job_info, which are moved into the returned message */
+static job_info_msg_t *_merge_job_delta(job_info_msg_t *old_job_info,
+					job_info_delta_msg_t *delta_ptr)
+{
+	job_info_msg_t *new_job_info = delta_ptr->job_info;
+	slurm_job_info_t *job_array;
+	uint32_t *skip_id, skip_cnt, i, record_count;
+
+	/* Old records replaced or removed by the delta are skipped */
+	skip_cnt = new_job_info->record_count + delta_ptr->removed_cnt;
+	skip_id = xmalloc(sizeof(uint32_t) * (skip_cnt + 1));
+	for (i = 0; i < new_job_info->record_count; i++)
+		skip_id[i] = new_job_info->job_array[i].job_id;
+	if (delta_ptr->removed_cnt) {
+		memcpy(skip_id + new_job_info->record_count,
+		       delta_ptr->removed_id,
+		       sizeof(uint32_t) * delta_ptr->removed_cnt);
+	}
+	qsort(skip_id, skip_cnt, sizeof(uint32_t), _cmp_job_id);
+
+	job_array = xmalloc(sizeof(slurm_job_info_t) *
+			    (old_job_info->record_count +
+			     new_job_info->record_count + 1));
+	record_count = 0;
+	for (i = 0; i < old_job_info->record_count; i++) {
+		slurm_job_info_t *job_ptr = &old_job_info->job_array[i];
+		if (bsearch(&job_ptr->job_id, skip_id, skip_cnt,
+			    sizeof(uint32_t), _cmp_job_id)) {
+			slurm_free_job_info_members(job_ptr);
+			continue;
+		}
+		memcpy(&job_array[record_count++], job_ptr,
+		       sizeof(slurm_job_info_t));
+	}
+	if (new_job_info->record_count) {
+		memcpy(&job_array[record_count], new_job_info->job_array,
+		       sizeof(slurm_job_info_t) * new_job_info->record_count);
+		record_count += new_job_info->record_count;
+	}
+	xfree(skip_id);
+
+	xfree(old_job_info->job_array);
+	old_job_info->record_count = 0;
+	xfree(new_job_info->job_array);
+	new_job_info->job_array = job_array;
+	new_job_info->record_count = record_count;
+
+	return new_job_info;
+}
+
+/*
+ * slurm_load_jobs_delta - issue RPC to get slurm job information, only
+ *	transferring the records changed since old_job_info was loaded
+ * IN old_job_info - job information previously loaded by this function
+ *	with the same show_flags, or NULL to load all jobs
+ * OUT job_info_msg_pptr - place to store a job configuration pointer,
+ *	unchanged records of old_job_info are moved into it
+ * IN show_flags - job filtering options
+ * RET 0 or -1 on error (SLURM_NO_CHANGE_IN_DATA if nothing changed)
+ * NOTE: free the response and old_job_info using slurm_free_job_info_msg
+ */
+extern int slurm_load_jobs_delta(job_info_msg_t *old_job_info,
+				 job_info_msg_t **job_info_msg_pptr,
+				 uint16_t show_flags)
+{
+	int rc;
+	slurm_msg_t resp_msg;
+	slurm_msg_t req_msg;
+	delta_info_request_msg_t req;
+	job_info_delta_msg_t *delta_ptr;
+
+	slurm_msg_t_init(&req_msg);
+	slurm_msg_t_init(&resp_msg);
+
+	req.generation   = old_job_info ? old_job_info->generation : 0;
+	req.show_flags   = show_flags;
+	req_msg.msg_type = REQUEST_JOB_INFO_DELTA;
+	req_msg.data     = &req;
+
+	if (slurm_send_recv_controller_msg(&req_msg, &resp_msg) < 0)
+		return SLURM_ERROR;
+
+	switch (resp_msg.msg_type) {
+	case RESPONSE_JOB_INFO_DELTA:
+		delta_ptr = (job_info_delta_msg_t *) resp_msg.data;
+		if (delta_ptr->full || !old_job_info) {
+			*job_info_msg_pptr = delta_ptr->job_info;
+		} else {
+			*job_info_msg_pptr = _merge_job_delta(old_job_info,
+							      delta_ptr);
+		}
+		delta_ptr->job_info = NULL;
+		slurm_free_job_info_delta_msg(delta_ptr);
+		break;
+	case RESPONSE_SLURM_RC:
+		rc = ((return_code_msg_t *) resp_msg.data)->return_code;
+		slurm_free_return_code_msg(resp_msg.data);
+		if (rc)
+			slurm_seterrno_ret(rc);
+		break;
+	default:
+		slurm_seterrno_ret(SLURM_UNEXPECTED_MSG_ERROR);
+		break;
+	}
+
+	return SLURM_PROTOCOL_SUCCESS;
+}
+
 /*
  * slurm_load_job_user - issue RPC to get slurm information about all jobs
  *	to be run as the specified user
@@ -536,6 +536,108 @@ extern int slurm_load_node (time_t update_time,
 	return SLURM_PROTOCOL_SUCCESS;
 }
 
+/* Merge the records of a node information delta response into the unchanged
+ * records from old_node_info, which are moved into the returned message */
+static node_info_msg_t *_merge_node_delta(node_info_msg_t *old_node_info,
+					  node_info_delta_msg_t *delta_ptr)
+{
+	node_info_msg_t *new_node_info = delta_ptr->node_info;
+	node_info_t *node_array;
+	uint32_t i, inx;
+
+	node_array = old_node_info->node_array;
+	for (i = 0; i < new_node_info->record_count; i++) {
+		inx = delta_ptr->node_inx[i];
+		slurm_free_node_info_members(&node_array[inx]);
+		memcpy(&node_array[inx], &new_node_info->node_array[i],
+		       sizeof(node_info_t));
+	}
+
+	old_node_info->node_array = NULL;
+	old_node_info->record_count = 0;
+	xfree(new_node_info->node_array);
+	new_node_info->node_array = node_array;
+	new_node_info->record_count = delta_ptr->node_cnt;
+
+	return new_node_info;
+}
+
+/*
+ * slurm_load_node_delta - issue RPC to get slurm node information, only
+ *	transferring the records changed since old_node_info was loaded
+ * IN old_node_info - node information previously loaded by this function
+ *	with the same show_flags, or NULL to load all nodes
+ * OUT resp - place to store a node configuration pointer, unchanged
+ *	records of old_node_info are moved into it
+ * IN show_flags - node filtering options
+ * RET 0 or a slurm error code (SLURM_NO_CHANGE_IN_DATA if nothing changed)
+ * NOTE: free the response and old_node_info using slurm_free_node_info_msg
+ */
+extern int slurm_load_node_delta(node_info_msg_t *old_node_info,
+				 node_info_msg_t **resp, uint16_t show_flags)
+{
+	int rc;
+	uint32_t i;
+	slurm_msg_t req_msg;
+	slurm_msg_t resp_msg;
+	delta_info_request_msg_t req;
+	node_info_delta_msg_t *delta_ptr;
+
+	slurm_msg_t_init(&req_msg);
+	slurm_msg_t_init(&resp_msg);
+	req.generation   = old_node_info ? old_node_info->generation : 0;
+	req.show_flags   = show_flags;
+	req_msg.msg_type = REQUEST_NODE_INFO_DELTA;
+	req_msg.data     = &req;
+
+	if (slurm_send_recv_controller_msg(&req_msg, &resp_msg) < 0)
+		return SLURM_ERROR;
+
+	switch (resp_msg.msg_type) {
+	case RESPONSE_NODE_INFO_DELTA:
+		delta_ptr = (node_info_delta_msg_t *) resp_msg.data;
+		if (show_flags & SHOW_MIXED)
+			_set_node_mixed(delta_ptr->node_info);
+		if (delta_ptr->full) {
+			*resp = delta_ptr->node_info;
+			delta_ptr->node_info = NULL;
+			slurm_free_node_info_delta_msg(delta_ptr);
+			break;
+		}
+		/* Load all nodes if the delta does not match old_node_info */
+		if (old_node_info &&
+		    (old_node_info->record_count == delta_ptr->node_cnt)) {
+			for (i = 0; i < delta_ptr->node_info->record_count;
+			     i++) {
+				if (delta_ptr->node_inx[i] >=
+				    delta_ptr->node_cnt)
+					break;
+			}
+			if (i >= delta_ptr->node_info->record_count) {
+				*resp = _merge_node_delta(old_node_info,
+							  delta_ptr);
+				delta_ptr->node_info = NULL;
+				slurm_free_node_info_delta_msg(delta_ptr);
+				break;
+			}
+		}
+		slurm_free_node_info_delta_msg(delta_ptr);
+		return slurm_load_node_delta(NULL, resp, show_flags);
+	case RESPONSE_SLURM_RC:
+		rc = ((return_code_msg_t *) resp_msg.data)->return_code;
+		slurm_free_return_code_msg(resp_msg.data);
+		if (rc)
+			slurm_seterrno_ret(rc);
+		*resp = NULL;
+		break;
+	default:
+		slurm_seterrno_ret(SLURM_UNEXPECTED_MSG_ERROR);
+		break;
+	}
+
+	return SLURM_PROTOCOL_SUCCESS;
+}
+
 /*
  * slurm_load_node_single - issue RPC to get slurm configuration information
  *	for a specific node
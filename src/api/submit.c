@@ -54,6 +54,7 @@ extern pid_t getsid(pid_t pid);		/* missing from <unistd.h> */
 
 #include "src/common/read_config.h"
 #include "src/common/slurm_protocol_api.h"
+#include "src/common/xmalloc.h"
 
 /*
  * slurm_submit_batch_job - issue RPC to submit a job for later execution
@@ -119,3 +120,83 @@ slurm_submit_batch_job (job_desc_msg_t *req,
 
 	return SLURM_PROTOCOL_SUCCESS;
 }
+
+/*
+ * slurm_submit_batch_job_multi - issue one RPC to submit several jobs for
+ *	later execution
+ * NOTE: free the response using slurm_free_submit_response_multi_msg
+ * IN job_desc_msg - array of job_cnt batch job descriptions
+ * IN job_cnt - count of jobs to submit
+ * OUT resp - job ID and error code of each job, in the order of job_desc_msg
+ * RET 0 if the request was processed, in which case individual jobs may still
+ *	have been rejected, otherwise return -1 and set errno to indicate the
+ *	error
+ */
+int
+slurm_submit_batch_job_multi (job_desc_msg_t **req, uint32_t job_cnt,
+			      submit_response_multi_msg_t **resp)
+{
+	int i, rc;
+	slurm_msg_t req_msg;
+	slurm_msg_t resp_msg;
+	job_desc_multi_msg_t multi_msg;
+	bool *host_set;
+	char host[64];
+	pid_t sid = getsid(0);
+
+	if (gethostname_short(host, sizeof(host)) != 0)
+		host[0] = '\0';
+
+	slurm_msg_t_init(&req_msg);
+	slurm_msg_t_init(&resp_msg);
+
+	/*
+	 * set Node and session id for each job
+	 */
+	host_set = xmalloc(sizeof(bool) * job_cnt);
+	for (i = 0; i < job_cnt; i++) {
+		if (req[i]->alloc_sid == NO_VAL)
+			req[i]->alloc_sid = sid;
+		if ((req[i]->alloc_node == NULL) && host[0]) {
+			req[i]->alloc_node = host;
+			host_set[i] = true;
+		}
+	}
+
+	multi_msg.job_cnt  = job_cnt;
+	multi_msg.job_desc = req;
+	req_msg.msg_type = REQUEST_SUBMIT_BATCH_JOB_MULTI;
+	req_msg.data     = &multi_msg;
+
+	rc = slurm_send_recv_controller_msg(&req_msg, &resp_msg);
+
+	/*
+	 *  Clear hostnames set internally to this function
+	 *    (memory is on the stack)
+	 */
+	for (i = 0; i < job_cnt; i++) {
+		if (host_set[i])
+			req[i]->alloc_node = NULL;
+	}
+	xfree(host_set);
+
+	if (rc == SLURM_SOCKET_ERROR)
+		return SLURM_ERROR;
+
+	switch (resp_msg.msg_type) {
+	case RESPONSE_SLURM_RC:
+		rc = ((return_code_msg_t *) resp_msg.data)->return_code;
+		slurm_free_return_code_msg(resp_msg.data);
+		if (rc)
+			slurm_seterrno_ret(rc);
+		*resp = NULL;
+		break;
+	case RESPONSE_SUBMIT_BATCH_JOB_MULTI:
+		*resp = (submit_response_multi_msg_t *) resp_msg.data;
+		break;
+	default:
+		slurm_seterrno_ret(SLURM_UNEXPECTED_MSG_ERROR);
+	}
+
+	return SLURM_PROTOCOL_SUCCESS;
+}
@@ -79,7 +79,8 @@
 #define _assert_bitstr_valid(name) do { \
 	assert((name) != NULL); \
 	assert(_bitstr_magic(name) == BITSTR_MAGIC \
-			    || _bitstr_magic(name) == BITSTR_MAGIC_STACK); \
+			    || _bitstr_magic(name) == BITSTR_MAGIC_STACK \
+			    || _bitstr_magic(name) == BITSTR_MAGIC_SPARSE); \
 } while (0)
 
 /* check bit position */
@@ -95,6 +96,724 @@
 	assert((bit) <= 0x40000000); 	\
 } while (0)
 
+/* bitstr_t is signed, whole word operations are done unsigned */
+#ifdef USE_64BIT_BITSTR
+typedef uint64_t bitstr_word_t;
+#else
+typedef uint32_t bitstr_word_t;
+#endif
+
+#define BITSTR_WORD_BITS	((bitoff_t) (sizeof(bitstr_t) * 8))
+
+/* data words of the bitstring */
+#define _bit_data(name)		((bitstr_word_t *) ((name) + BITSTR_OVERHEAD))
+
+/* whole words in a bitstring of nbits bits, and bits in its last word */
+#define _bit_full_words(nbits)	((nbits) >> BITSTR_SHIFT)
+#define _bit_tail_bits(nbits)	((nbits) & BITSTR_MAXPOS)
+
+/* mask for bits lo through hi within a word, 0 <= lo <= hi <= BITSTR_MAXPOS */
+#ifdef SLURM_BIGENDIAN
+#define _word_mask(lo, hi) \
+	((~(bitstr_word_t) 0 << (BITSTR_MAXPOS - (hi))) & \
+	 (~(bitstr_word_t) 0 >> (lo)))
+#else
+#define _word_mask(lo, hi) \
+	((~(bitstr_word_t) 0 >> (BITSTR_MAXPOS - (hi))) & \
+	 (~(bitstr_word_t) 0 << (lo)))
+#endif
+
+#if !defined(USE_64BIT_BITSTR)
+/*
+ * Returns the hamming weight (i.e. the number of bits set) in a word.
+ * NOTE: This routine borrowed from Linux 2.4.9 <linux/bitops.h>.
+ */
+static uint32_t
+hweight(uint32_t w)
+{
+	uint32_t res;
+
+	res = (w   & 0x55555555) + ((w >> 1)    & 0x55555555);
+	res = (res & 0x33333333) + ((res >> 2)  & 0x33333333);
+	res = (res & 0x0F0F0F0F) + ((res >> 4)  & 0x0F0F0F0F);
+	res = (res & 0x00FF00FF) + ((res >> 8)  & 0x00FF00FF);
+	res = (res & 0x0000FFFF) + ((res >> 16) & 0x0000FFFF);
+
+	return res;
+}
+#else
+/*
+ * A 64 bit version crafted from 32-bit one borrowed above.
+ */
+static uint64_t
+hweight(uint64_t w)
+{
+	uint64_t res;
+
+	res = (w   & 0x5555555555555555) + ((w >> 1)    & 0x5555555555555555);
+	res = (res & 0x3333333333333333) + ((res >> 2)  & 0x3333333333333333);
+	res = (res & 0x0F0F0F0F0F0F0F0F) + ((res >> 4)  & 0x0F0F0F0F0F0F0F0F);
+	res = (res & 0x00FF00FF00FF00FF) + ((res >> 8)  & 0x00FF00FF00FF00FF);
+	res = (res & 0x0000FFFF0000FFFF) + ((res >> 16) & 0x0000FFFF0000FFFF);
+	res = (res & 0x00000000FFFFFFFF) + ((res >> 32) & 0x00000000FFFFFFFF);
+
+	return res;
+}
+#endif /* !USE_64BIT_BITSTR */
+
+/* Position within a word of its first and last bits set, w must be non-zero */
+#if defined(__GNUC__) && defined(USE_64BIT_BITSTR)
+#  define _word_ctz(w)	__builtin_ctzll(w)
+#  define _word_clz(w)	__builtin_clzll(w)
+#elif defined(__GNUC__)
+#  define _word_ctz(w)	__builtin_ctz(w)
+#  define _word_clz(w)	__builtin_clz(w)
+#else
+static int _word_ctz(bitstr_word_t w)
+{
+	int n = 0;
+
+	while (!(w & 1)) {
+		w >>= 1;
+		n++;
+	}
+	return n;
+}
+
+static int _word_clz(bitstr_word_t w)
+{
+	int n = 0;
+
+	while (!(w & ((bitstr_word_t) 1 << BITSTR_MAXPOS))) {
+		w <<= 1;
+		n++;
+	}
+	return n;
+}
+#endif
+#ifdef SLURM_BIGENDIAN
+#  define _word_ffs(w)	_word_clz(w)
+#  define _word_fls(w)	(BITSTR_MAXPOS - _word_ctz(w))
+#else
+#  define _word_ffs(w)	_word_ctz(w)
+#  define _word_fls(w)	(BITSTR_MAXPOS - _word_clz(w))
+#endif
+
+/*
+ * Count the bits set in nwords words of w1, or in w1 & w2 if w2 is not NULL.
+ * Where the compiler can build it, a version using the processor's popcnt
+ * instruction is selected at run time if the processor supports it.
+ */
+static int32_t
+_count_words_sw(const bitstr_word_t *w1, const bitstr_word_t *w2,
+		int32_t nwords)
+{
+	int32_t i, count = 0;
+
+	if (w2) {
+		for (i = 0; i < nwords; i++)
+			count += hweight(w1[i] & w2[i]);
+	} else {
+		for (i = 0; i < nwords; i++)
+			count += hweight(w1[i]);
+	}
+	return count;
+}
+
+#if defined(__GNUC__) && \
+    ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 8))) && \
+    (defined(__x86_64__) || defined(__i386__))
+#ifdef USE_64BIT_BITSTR
+#  define _popcount(w)	__builtin_popcountll(w)
+#else
+#  define _popcount(w)	__builtin_popcount(w)
+#endif
+static int32_t __attribute__((target("popcnt")))
+_count_words_hw(const bitstr_word_t *w1, const bitstr_word_t *w2,
+		int32_t nwords)
+{
+	int32_t i, count = 0;
+
+	if (w2) {
+		for (i = 0; i < nwords; i++)
+			count += _popcount(w1[i] & w2[i]);
+	} else {
+		for (i = 0; i < nwords; i++)
+			count += _popcount(w1[i]);
+	}
+	return count;
+}
+
+static int32_t _count_words_init(const bitstr_word_t *w1,
+				 const bitstr_word_t *w2, int32_t nwords);
+static int32_t (*_count_words)(const bitstr_word_t *w1,
+			       const bitstr_word_t *w2, int32_t nwords) =
+	_count_words_init;
+
+/* Select the kernel on first use, racing threads select the same one */
+static int32_t
+_count_words_init(const bitstr_word_t *w1, const bitstr_word_t *w2,
+		  int32_t nwords)
+{
+	if (__builtin_cpu_supports("popcnt"))
+		_count_words = _count_words_hw;
+	else
+		_count_words = _count_words_sw;
+	return _count_words(w1, w2, nwords);
+}
+#else
+#  define _count_words	_count_words_sw
+#endif
+
+/* mask for bit off within its word */
+#define _word_bit(off)	_word_mask((off) & BITSTR_MAXPOS, (off) & BITSTR_MAXPOS)
+
+/* Set bits start through stop of the words at w */
+static void
+_words_nset(bitstr_word_t *w, bitoff_t start, bitoff_t stop)
+{
+	bitoff_t first, last, i;
+
+	first = start >> BITSTR_SHIFT;
+	last  = stop  >> BITSTR_SHIFT;
+	if (first == last) {
+		w[first] |= _word_mask(start & BITSTR_MAXPOS,
+				       stop & BITSTR_MAXPOS);
+		return;
+	}
+	w[first] |= _word_mask(start & BITSTR_MAXPOS, BITSTR_MAXPOS);
+	for (i = first + 1; i < last; i++)
+		w[i] = ~(bitstr_word_t) 0;
+	w[last] |= _word_mask(0, stop & BITSTR_MAXPOS);
+}
+
+/* Clear bits start through stop of the words at w */
+static void
+_words_nclear(bitstr_word_t *w, bitoff_t start, bitoff_t stop)
+{
+	bitoff_t first, last, i;
+
+	first = start >> BITSTR_SHIFT;
+	last  = stop  >> BITSTR_SHIFT;
+	if (first == last) {
+		w[first] &= ~_word_mask(start & BITSTR_MAXPOS,
+					stop & BITSTR_MAXPOS);
+		return;
+	}
+	w[first] &= ~_word_mask(start & BITSTR_MAXPOS, BITSTR_MAXPOS);
+	for (i = first + 1; i < last; i++)
+		w[i] = 0;
+	w[last] &= ~_word_mask(0, stop & BITSTR_MAXPOS);
+}
+
+/* First bit clear in the first nbits bits of the words at w, -1 if none */
+static bitoff_t
+_words_ffc(bitstr_word_t *w, bitoff_t nbits)
+{
+	bitstr_word_t word;
+	bitoff_t i, full = _bit_full_words(nbits);
+
+	for (i = 0; i < full; i++) {
+		if ((word = ~w[i]))
+			return (i * BITSTR_WORD_BITS) + _word_ffs(word);
+	}
+	if (_bit_tail_bits(nbits)) {
+		word = ~w[full] & _word_mask(0, _bit_tail_bits(nbits) - 1);
+		if (word)
+			return (full * BITSTR_WORD_BITS) + _word_ffs(word);
+	}
+	return -1;
+}
+
+/* First bit set in the first nbits bits of the words at w, -1 if none */
+static bitoff_t
+_words_ffs(bitstr_word_t *w, bitoff_t nbits)
+{
+	bitstr_word_t word;
+	bitoff_t i, full = _bit_full_words(nbits);
+
+	for (i = 0; i < full; i++) {
+		if ((word = w[i]))
+			return (i * BITSTR_WORD_BITS) + _word_ffs(word);
+	}
+	if (_bit_tail_bits(nbits)) {
+		word = w[full] & _word_mask(0, _bit_tail_bits(nbits) - 1);
+		if (word)
+			return (full * BITSTR_WORD_BITS) + _word_ffs(word);
+	}
+	return -1;
+}
+
+/* Last bit set in the first nbits bits of the words at w, -1 if none */
+static bitoff_t
+_words_fls(bitstr_word_t *w, bitoff_t nbits)
+{
+	bitstr_word_t word;
+	bitoff_t i, full = _bit_full_words(nbits);
+
+	if (_bit_tail_bits(nbits)) {
+		word = w[full] & _word_mask(0, _bit_tail_bits(nbits) - 1);
+		if (word)
+			return (full * BITSTR_WORD_BITS) + _word_fls(word);
+	}
+	for (i = full - 1; i >= 0; i--) {
+		if ((word = w[i]))
+			return (i * BITSTR_WORD_BITS) + _word_fls(word);
+	}
+	return -1;
+}
+
+/* Count the bits set in bits start through end - 1 of the words at w */
+static int32_t
+_words_count_range(bitstr_word_t *w, bitoff_t start, bitoff_t end)
+{
+	bitoff_t first, last;
+	int32_t count;
+
+	first = start >> BITSTR_SHIFT;
+	last  = (end - 1) >> BITSTR_SHIFT;
+	if (first == last) {
+		return hweight(w[first] & _word_mask(start & BITSTR_MAXPOS,
+						     (end - 1) & BITSTR_MAXPOS));
+	}
+	count  = hweight(w[first] & _word_mask(start & BITSTR_MAXPOS,
+					       BITSTR_MAXPOS));
+	count += _count_words(w + first + 1, NULL, last - first - 1);
+	count += hweight(w[last] & _word_mask(0, (end - 1) & BITSTR_MAXPOS));
+
+	return count;
+}
+
+/*
+ * Sparse bitstrings, see bit_alloc_sparse().  The bits are split into chunks
+ * of SPARSE_CHUNK_BITS.  A chunk with no bits or every bit set has no storage,
+ * one with few bits set holds the sorted offsets of those bits, and any other
+ * holds words laid out as in a flat bitstring.  The magic cookie and size
+ * words are shared with flat bitstrings.
+ */
+#define SPARSE_CHUNK_SHIFT	16
+#define SPARSE_CHUNK_BITS	((bitoff_t) 1 << SPARSE_CHUNK_SHIFT)
+#define SPARSE_CHUNK_WORDS	(SPARSE_CHUNK_BITS / BITSTR_WORD_BITS)
+#define SPARSE_ARRAY_MAX	4096	/* offsets take less space than words */
+
+typedef struct {
+	int32_t count;		/* bits set in the chunk */
+	int32_t size;		/* entries allocated in array */
+	uint16_t *array;	/* offsets of set bits, if count is small */
+	bitstr_word_t *words;	/* the bits, if neither array nor empty/full */
+} sparse_chunk_t;
+
+typedef struct {
+	bitstr_t magic;
+	bitstr_t nbits;
+	sparse_chunk_t *chunks;
+} sparse_bitstr_t;
+
+enum {
+	SPARSE_AND,
+	SPARSE_AND_NOT,
+	SPARSE_OR,
+	SPARSE_COPY
+};
+
+enum {
+	SPARSE_OVERLAP,
+	SPARSE_OVERLAP_ANY,
+	SPARSE_SUPER_SET,
+	SPARSE_EQUAL
+};
+
+#define _bit_is_sparse(name)	(_bitstr_magic(name) == BITSTR_MAGIC_SPARSE)
+#define _sparse_chunks(name)	(((sparse_bitstr_t *) (name))->chunks)
+
+/* chunks in a sparse bitstring of nbits bits */
+#define _sparse_chunk_cnt(nbits) \
+	(((nbits) + SPARSE_CHUNK_BITS - 1) >> SPARSE_CHUNK_SHIFT)
+
+/* bits in chunk c of b, only the last chunk can be short */
+#define _sparse_len(name, c) \
+	MIN(SPARSE_CHUNK_BITS, _bitstr_bits(name) - \
+			       ((bitoff_t) (c) << SPARSE_CHUNK_SHIFT))
+
+/* data words for nbits bits */
+#define _data_words(nbits)	(_bitstr_words(nbits) - BITSTR_OVERHEAD)
+
+static void _sparse_chunk_free(sparse_chunk_t *chunk)
+{
+	xfree(chunk->array);
+	xfree(chunk->words);
+	chunk->size = 0;
+}
+
+/* Index of the first entry of a chunk's array not below off */
+static int32_t _sparse_search(sparse_chunk_t *chunk, bitoff_t off)
+{
+	int32_t lo = 0, hi = chunk->count, mid;
+
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (chunk->array[mid] < off)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/*
+ * Expand a chunk of len bits into the words at w.  Bits of the last word
+ * beyond len may be left set.
+ */
+static void _sparse_words(sparse_chunk_t *chunk, bitoff_t len,
+			  bitstr_word_t *w)
+{
+	size_t size = _data_words(len) * sizeof(bitstr_word_t);
+	int32_t i;
+
+	if (chunk->words) {
+		memcpy(w, chunk->words, size);
+	} else if (chunk->count == len) {
+		memset(w, 0xff, size);
+	} else {
+		memset(w, 0, size);
+		for (i = 0; i < chunk->count; i++) {
+			w[chunk->array[i] >> BITSTR_SHIFT] |=
+				_word_bit(chunk->array[i]);
+		}
+	}
+}
+
+/*
+ * Store len bits from the words at w in a chunk, using the smallest
+ * representation.  w may be the chunk's own words.
+ */
+static void _sparse_put(sparse_chunk_t *chunk, bitoff_t len, bitstr_word_t *w)
+{
+	bitoff_t nwords = _data_words(len), i;
+	bitstr_word_t word;
+	int32_t count, bit, n = 0;
+
+	if (_bit_tail_bits(len))
+		w[nwords - 1] &= _word_mask(0, _bit_tail_bits(len) - 1);
+	count = _count_words(w, NULL, nwords);
+
+	if ((count > SPARSE_ARRAY_MAX) && (count < len)) {
+		xfree(chunk->array);
+		chunk->size = 0;
+		if (!chunk->words) {
+			chunk->words = xmalloc_nz(nwords *
+						  sizeof(bitstr_word_t));
+		}
+		if (chunk->words != w)
+			memcpy(chunk->words, w, nwords * sizeof(bitstr_word_t));
+		chunk->count = count;
+		return;
+	}
+
+	if ((count == 0) || (count == len)) {
+		xfree(chunk->array);
+		chunk->size = 0;
+	} else {
+		if (chunk->size < count) {
+			chunk->size = count;
+			xrealloc_nz(chunk->array, count * sizeof(uint16_t));
+		}
+		for (i = 0; i < nwords; i++) {
+			for (word = w[i]; word; word &= ~_word_bit(bit)) {
+				bit = _word_ffs(word);
+				chunk->array[n++] = (i * BITSTR_WORD_BITS) + bit;
+			}
+		}
+	}
+	xfree(chunk->words);
+	chunk->count = count;
+}
+
+/*
+ * Return the words holding chunk c of b, which has len bits, expanding a
+ * sparse chunk into buf if it has no words of its own.  b may be flat.
+ */
+static bitstr_word_t *_chunk_view(bitstr_t *b, bitoff_t c, bitoff_t len,
+				  bitstr_word_t *buf)
+{
+	sparse_chunk_t *chunk;
+
+	if (!_bit_is_sparse(b))
+		return _bit_data(b) + (c * SPARSE_CHUNK_WORDS);
+	chunk = &_sparse_chunks(b)[c];
+	if (chunk->words)
+		return chunk->words;
+	_sparse_words(chunk, len, buf);
+	return buf;
+}
+
+/* Set or clear one bit of a sparse bitstring */
+static void _sparse_set(bitstr_t *b, bitoff_t bit, bool value)
+{
+	bitstr_word_t buf[SPARSE_CHUNK_WORDS], *w, mask;
+	sparse_chunk_t *chunk;
+	bitoff_t c, off, len;
+	int32_t pos;
+
+	c = bit >> SPARSE_CHUNK_SHIFT;
+	off = bit & (SPARSE_CHUNK_BITS - 1);
+	len = _sparse_len(b, c);
+	chunk = &_sparse_chunks(b)[c];
+
+	if (chunk->words) {
+		w = &chunk->words[off >> BITSTR_SHIFT];
+		mask = _word_bit(off);
+		if (((*w & mask) != 0) == value)
+			return;
+		*w ^= mask;
+		chunk->count += value ? 1 : -1;
+		if ((chunk->count == 0) || (chunk->count == len))
+			xfree(chunk->words);
+		return;
+	}
+
+	if (chunk->count == (value ? len : 0))
+		return;
+	if (chunk->array || (chunk->count == 0)) {
+		pos = _sparse_search(chunk, off);
+		if (!value) {
+			if ((pos == chunk->count) || (chunk->array[pos] != off))
+				return;
+			chunk->count--;
+			memmove(&chunk->array[pos], &chunk->array[pos + 1],
+				(chunk->count - pos) * sizeof(uint16_t));
+			if (chunk->count == 0)
+				_sparse_chunk_free(chunk);
+			return;
+		}
+		if ((pos < chunk->count) && (chunk->array[pos] == off))
+			return;
+		if ((chunk->count < SPARSE_ARRAY_MAX) &&
+		    (chunk->count + 1 < len)) {
+			if (chunk->size == chunk->count) {
+				chunk->size = MAX(8, chunk->size * 2);
+				xrealloc_nz(chunk->array,
+					    chunk->size * sizeof(uint16_t));
+			}
+			memmove(&chunk->array[pos + 1], &chunk->array[pos],
+				(chunk->count - pos) * sizeof(uint16_t));
+			chunk->array[pos] = off;
+			chunk->count++;
+			return;
+		}
+	}
+
+	/* Changes representation */
+	_sparse_words(chunk, len, buf);
+	if (value)
+		buf[off >> BITSTR_SHIFT] |= _word_bit(off);
+	else
+		buf[off >> BITSTR_SHIFT] &= ~_word_bit(off);
+	_sparse_put(chunk, len, buf);
+}
+
+/* Set or clear bits start through stop of a sparse bitstring */
+static void _sparse_nset(bitstr_t *b, bitoff_t start, bitoff_t stop,
+			 bool value)
+{
+	bitstr_word_t buf[SPARSE_CHUNK_WORDS], *w;
+	sparse_chunk_t *chunk;
+	bitoff_t c, base, len, lo, hi;
+
+	for (c = start >> SPARSE_CHUNK_SHIFT;
+	     c <= (stop >> SPARSE_CHUNK_SHIFT); c++) {
+		chunk = &_sparse_chunks(b)[c];
+		base = c << SPARSE_CHUNK_SHIFT;
+		len = _sparse_len(b, c);
+		lo = MAX(start, base) - base;
+		hi = MIN(stop, base + len - 1) - base;
+		if (chunk->count == (value ? len : 0))
+			continue;
+		if ((lo == 0) && (hi == len - 1)) {
+			_sparse_chunk_free(chunk);
+			chunk->count = value ? len : 0;
+			continue;
+		}
+		if (chunk->words) {
+			w = chunk->words;
+		} else {
+			_sparse_words(chunk, len, buf);
+			w = buf;
+		}
+		if (value)
+			_words_nset(w, lo, hi);
+		else
+			_words_nclear(w, lo, hi);
+		_sparse_put(chunk, len, w);
+	}
+}
+
+/*
+ * b1 = b1 op b2 where either may be sparse, for the SPARSE_AND etc. ops.
+ */
+static void _sparse_op(bitstr_t *b1, bitstr_t *b2, int op)
+{
+	bitstr_word_t buf1[SPARSE_CHUNK_WORDS], buf2[SPARSE_CHUNK_WORDS];
+	bitstr_word_t *w1, *w2;
+	sparse_chunk_t *chunk1 = NULL, *chunk2;
+	bitoff_t c, len, i, nwords;
+	int fill;
+
+	for (c = 0; c < _sparse_chunk_cnt(_bitstr_bits(b1)); c++) {
+		len = _sparse_len(b1, c);
+		nwords = _data_words(len);
+
+		/* Chunks of b1 left unchanged or set to all clear/set */
+		fill = -1;
+		if (_bit_is_sparse(b2)) {
+			chunk2 = &_sparse_chunks(b2)[c];
+			if (chunk2->count == 0) {
+				if ((op == SPARSE_AND_NOT) ||
+				    (op == SPARSE_OR))
+					continue;
+				fill = 0;
+			} else if (chunk2->count == len) {
+				if (op == SPARSE_AND)
+					continue;
+				fill = (op == SPARSE_AND_NOT) ? 0 : 1;
+			}
+		}
+		if (_bit_is_sparse(b1)) {
+			chunk1 = &_sparse_chunks(b1)[c];
+			if ((chunk1->count == 0) &&
+			    ((op == SPARSE_AND) || (op == SPARSE_AND_NOT)))
+				continue;
+			if ((chunk1->count == len) && (op == SPARSE_OR))
+				continue;
+			if (fill != -1) {
+				_sparse_chunk_free(chunk1);
+				chunk1->count = fill ? len : 0;
+				continue;
+			}
+			if (chunk1->words) {
+				w1 = chunk1->words;
+			} else {
+				if (op != SPARSE_COPY)
+					_sparse_words(chunk1, len, buf1);
+				w1 = buf1;
+			}
+		} else {
+			w1 = _bit_data(b1) + (c * SPARSE_CHUNK_WORDS);
+			if (fill != -1) {
+				if (fill)
+					_words_nset(w1, 0, len - 1);
+				else
+					_words_nclear(w1, 0, len - 1);
+				continue;
+			}
+		}
+
+		w2 = _chunk_view(b2, c, len, buf2);
+		switch (op) {
+		case SPARSE_AND:
+			for (i = 0; i < nwords; i++)
+				w1[i] &= w2[i];
+			break;
+		case SPARSE_AND_NOT:
+			for (i = 0; i < nwords; i++)
+				w1[i] &= ~w2[i];
+			break;
+		case SPARSE_OR:
+			for (i = 0; i < nwords; i++)
+				w1[i] |= w2[i];
+			break;
+		default:
+			if (w1 != w2)
+				memcpy(w1, w2, nwords * sizeof(bitstr_word_t));
+			break;
+		}
+		if (_bit_is_sparse(b1))
+			_sparse_put(chunk1, len, w1);
+	}
+}
+
+/*
+ * Compare b1 and b2 where either may be sparse, for the SPARSE_OVERLAP etc.
+ * ops.  Returns the overlap count, or 1 if the test holds and 0 otherwise.
+ */
+static int32_t _sparse_cmp(bitstr_t *b1, bitstr_t *b2, int op)
+{
+	bitstr_word_t buf1[SPARSE_CHUNK_WORDS], buf2[SPARSE_CHUNK_WORDS];
+	bitstr_word_t *w1, *w2, tail = 0;
+	bitoff_t c, len, i, full;
+	int32_t count = 0, cnt1, cnt2;
+
+	for (c = 0; c < _sparse_chunk_cnt(_bitstr_bits(b1)); c++) {
+		len = _sparse_len(b1, c);
+		cnt1 = _bit_is_sparse(b1) ? _sparse_chunks(b1)[c].count : -1;
+		cnt2 = _bit_is_sparse(b2) ? _sparse_chunks(b2)[c].count : -1;
+		if (((op == SPARSE_OVERLAP) || (op == SPARSE_OVERLAP_ANY)) &&
+		    ((cnt1 == 0) || (cnt2 == 0)))
+			continue;
+		if ((op == SPARSE_SUPER_SET) && ((cnt1 == 0) || (cnt2 == len)))
+			continue;
+		if (op == SPARSE_EQUAL) {
+			if ((cnt1 != -1) && (cnt2 != -1)) {
+				if (cnt1 != cnt2)
+					return 0;
+				if ((cnt1 == 0) || (cnt1 == len))
+					continue;
+			}
+		}
+
+		w1 = _chunk_view(b1, c, len, buf1);
+		w2 = _chunk_view(b2, c, len, buf2);
+		full = _bit_full_words(len);
+		if (_bit_tail_bits(len))
+			tail = _word_mask(0, _bit_tail_bits(len) - 1);
+		switch (op) {
+		case SPARSE_OVERLAP:
+			count += _count_words(w1, w2, full);
+			if (_bit_tail_bits(len))
+				count += hweight(w1[full] & w2[full] & tail);
+			break;
+		case SPARSE_OVERLAP_ANY:
+			for (i = 0; i < full; i++) {
+				if (w1[i] & w2[i])
+					return 1;
+			}
+			if (_bit_tail_bits(len) && (w1[full] & w2[full] & tail))
+				return 1;
+			break;
+		case SPARSE_SUPER_SET:
+			for (i = 0; i < full; i++) {
+				if (w1[i] & ~w2[i])
+					return 0;
+			}
+			if (_bit_tail_bits(len) && (w1[full] & ~w2[full] & tail))
+				return 0;
+			break;
+		default:
+			for (i = 0; i < full; i++) {
+				if (w1[i] != w2[i])
+					return 0;
+			}
+			if (_bit_tail_bits(len) &&
+			    ((w1[full] ^ w2[full]) & tail))
+				return 0;
+			break;
+		}
+	}
+
+	if (op == SPARSE_OVERLAP)
+		return count;
+	return (op == SPARSE_OVERLAP_ANY) ? 0 : 1;
+}
+
+/* Flat copy of a sparse bitstring, for the less common operations */
+static bitstr_t *_sparse_flat(bitstr_t *b)
+{
+	bitstr_t *new = bit_alloc(_bitstr_bits(b));
+
+	_sparse_op(new, b, SPARSE_COPY);
+	return new;
+}
+
 /*
  * external macros
  */
@@ -109,6 +828,7 @@
  * for details.
  */
 strong_alias(bit_alloc,		slurm_bit_alloc);
+strong_alias(bit_alloc_sparse,	slurm_bit_alloc_sparse);
 strong_alias(bit_test,		slurm_bit_test);
 strong_alias(bit_set,		slurm_bit_set);
 strong_alias(bit_clear,		slurm_bit_clear);
@@ -122,6 +842,7 @@ strong_alias(bit_free,		slurm_bit_free);
 strong_alias(bit_realloc,	slurm_bit_realloc);
 strong_alias(bit_size,		slurm_bit_size);
 strong_alias(bit_and,		slurm_bit_and);
+strong_alias(bit_and_not,	slurm_bit_and_not);
 strong_alias(bit_not,		slurm_bit_not);
 strong_alias(bit_or,		slurm_bit_or);
 strong_alias(bit_set_count,	slurm_bit_set_count);
@@ -142,6 +863,7 @@ strong_alias(bit_fls,		slurm_bit_fls);
 strong_alias(bit_fill_gaps,	slurm_bit_fill_gaps);
 strong_alias(bit_super_set,	slurm_bit_super_set);
 strong_alias(bit_overlap,	slurm_bit_overlap);
+strong_alias(bit_overlap_any,	slurm_bit_overlap_any);
 strong_alias(bit_equal,		slurm_bit_equal);
 strong_alias(bit_copy,		slurm_bit_copy);
 strong_alias(bit_pick_cnt,	slurm_bit_pick_cnt);
@@ -174,6 +896,70 @@ bit_alloc(bitoff_t nbits)
 	return new;
 }
 
+/*
+ * Allocate a sparse bitstring, which may be used wherever a bitstring
+ * allocated by bit_alloc() can.  It takes little memory when long runs of
+ * its bits are all clear or all set, and is faster to search and combine.
+ *   nbits (IN)		valid bits in new bitstring, initialized to all clear
+ *   RETURN		new bitstring
+ */
+bitstr_t *
+bit_alloc_sparse(bitoff_t nbits)
+{
+	bitstr_t *new;
+
+	_assert_valid_size(nbits);
+	new = (bitstr_t *)xmalloc(sizeof(sparse_bitstr_t));
+	_bitstr_magic(new) = BITSTR_MAGIC_SPARSE;
+	_bitstr_bits(new) = nbits;
+	if (nbits) {
+		_sparse_chunks(new) = xmalloc(_sparse_chunk_cnt(nbits) *
+					      sizeof(sparse_chunk_t));
+	}
+	return new;
+}
+
+/* Resize a sparse bitstring, see bit_realloc() */
+static bitstr_t *
+_sparse_realloc(bitstr_t *b, bitoff_t nbits)
+{
+	bitstr_word_t buf[SPARSE_CHUNK_WORDS];
+	sparse_chunk_t *chunks = _sparse_chunks(b);
+	bitoff_t old_cnt, new_cnt, c, old_len, new_len;
+
+	old_cnt = _sparse_chunk_cnt(_bitstr_bits(b));
+	new_cnt = _sparse_chunk_cnt(nbits);
+	for (c = new_cnt; c < old_cnt; c++)
+		_sparse_chunk_free(&chunks[c]);
+
+	/* The last chunk kept may change length, rebuild it */
+	if (old_cnt && new_cnt) {
+		c = MIN(old_cnt, new_cnt) - 1;
+		old_len = _sparse_len(b, c);
+		new_len = MIN(SPARSE_CHUNK_BITS,
+			      nbits - (c << SPARSE_CHUNK_SHIFT));
+		if (old_len != new_len) {
+			memset(buf, 0, sizeof(buf));
+			_sparse_words(&chunks[c], old_len, buf);
+			if (_bit_tail_bits(old_len)) {
+				buf[_bit_full_words(old_len)] &=
+					_word_mask(0,
+						   _bit_tail_bits(old_len) - 1);
+			}
+			_sparse_chunk_free(&chunks[c]);
+			_sparse_put(&chunks[c], new_len, buf);
+		}
+	}
+
+	if (new_cnt)
+		xrealloc(chunks, new_cnt * sizeof(sparse_chunk_t));
+	else
+		xfree(chunks);
+	_sparse_chunks(b) = chunks;
+	_bitstr_bits(b) = nbits;
+	return b;
+}
+
 /*
  * Reallocate a bitstring (expand or contract size).
  *   b (IN)		pointer to old bitstring
@@ -187,6 +973,8 @@ bit_realloc(bitstr_t *b, bitoff_t nbits)
 
 	_assert_bitstr_valid(b);
 	_assert_valid_size(nbits);
+	if (_bit_is_sparse(b))
+		return _sparse_realloc(b, nbits);
 	new = xrealloc(b, _bitstr_words(nbits) * sizeof(bitstr_t));
 	if (!new) {
 		log_oom(__FILE__, __LINE__, __CURRENT_FUNC__);
@@ -206,8 +994,15 @@ bit_realloc(bitstr_t *b, bitoff_t nbits)
 void
 bit_free(bitstr_t *b)
 {
+	bitoff_t c;
+
 	assert(b);
-	assert(_bitstr_magic(b) == BITSTR_MAGIC);
+	assert(_bitstr_magic(b) == BITSTR_MAGIC || _bit_is_sparse(b));
+	if (_bit_is_sparse(b)) {
+		for (c = 0; c < _sparse_chunk_cnt(_bitstr_bits(b)); c++)
+			_sparse_chunk_free(&_sparse_chunks(b)[c]);
+		xfree(_sparse_chunks(b));
+	}
 	_bitstr_magic(b) = 0;
 	xfree(b);
 }
@@ -235,6 +1030,22 @@ bit_test(bitstr_t *b, bitoff_t bit)
 {
 	_assert_bitstr_valid(b);
 	_assert_bit_valid(b, bit);
+	if (_bit_is_sparse(b)) {
+		sparse_chunk_t *chunk;
+		bitoff_t off = bit & (SPARSE_CHUNK_BITS - 1);
+		int32_t pos;
+
+		chunk = &_sparse_chunks(b)[bit >> SPARSE_CHUNK_SHIFT];
+		if (chunk->words) {
+			return ((chunk->words[off >> BITSTR_SHIFT] &
+				 _word_bit(off)) ? 1 : 0);
+		}
+		if (!chunk->array)
+			return (chunk->count ? 1 : 0);
+		pos = _sparse_search(chunk, off);
+		return (((pos < chunk->count) && (chunk->array[pos] == off)) ?
+			1 : 0);
+	}
 	return ((b[_bit_word(bit)] & _bit_mask(bit)) ? 1 : 0);
 }
 
@@ -248,7 +1059,10 @@ bit_set(bitstr_t *b, bitoff_t bit)
 {
 	_assert_bitstr_valid(b);
 	_assert_bit_valid(b, bit);
-	b[_bit_word(bit)] |= _bit_mask(bit);
+	if (_bit_is_sparse(b))
+		_sparse_set(b, bit, true);
+	else
+		b[_bit_word(bit)] |= _bit_mask(bit);
 }
 
 /*
@@ -261,7 +1075,10 @@ bit_clear(bitstr_t *b, bitoff_t bit)
 {
 	_assert_bitstr_valid(b);
 	_assert_bit_valid(b, bit);
-	b[_bit_word(bit)] &= ~_bit_mask(bit);
+	if (_bit_is_sparse(b))
+		_sparse_set(b, bit, false);
+	else
+		b[_bit_word(bit)] &= ~_bit_mask(bit);
 }
 
 /*
@@ -277,14 +1094,12 @@ bit_nset(bitstr_t *b, bitoff_t start, bitoff_t stop)
 	_assert_bit_valid(b, start);
 	_assert_bit_valid(b, stop);
 
-	while (start <= stop && start % 8 > 0) 	     /* partial first byte? */
-		bit_set(b, start++);
-	while (stop >= start && (stop+1) % 8 > 0)    /* partial last byte? */
-		bit_set(b, stop--);
-	if (stop > start) {                          /* now do whole bytes */
-		assert((stop-start+1) % 8 == 0);
-		memset(_bit_byteaddr(b, start), 0xff, (stop-start+1) / 8);
-	}
+	if (start > stop)
+		return;
+	if (_bit_is_sparse(b))
+		_sparse_nset(b, start, stop, true);
+	else
+		_words_nset(_bit_data(b), start, stop);
 }
 
 /*
@@ -300,14 +1115,12 @@ bit_nclear(bitstr_t *b, bitoff_t start, bitoff_t stop)
 	_assert_bit_valid(b, start);
 	_assert_bit_valid(b, stop);
 
-	while (start <= stop && start % 8 > 0) 	/* partial first byte? */
-		bit_clear(b, start++);
-	while (stop >= start && (stop+1) % 8 > 0)/* partial last byte? */
-		bit_clear(b, stop--);
-	if (stop > start) {			/* now do whole bytes */
-		assert((stop-start+1) % 8 == 0);
-		memset(_bit_byteaddr(b, start), 0, (stop-start+1) / 8);
-	}
+	if (start > stop)
+		return;
+	if (_bit_is_sparse(b))
+		_sparse_nset(b, start, stop, false);
+	else
+		_words_nclear(_bit_data(b), start, stop);
 }
 
 /*
@@ -339,26 +1152,23 @@ bit_clear_all(bitstr_t *b)
 bitoff_t
 bit_ffc(bitstr_t *b)
 {
-	bitoff_t bit = 0, value = -1;
+	bitstr_word_t buf[SPARSE_CHUNK_WORDS];
+	sparse_chunk_t *chunk;
+	bitoff_t c, len;
 
 	_assert_bitstr_valid(b);
 
-	while (bit < _bitstr_bits(b) && value == -1) {
-		int32_t word = _bit_word(bit);
-
-		if (b[word] == BITSTR_MAXPOS) {
-			bit += sizeof(bitstr_t)*8;
+	if (!_bit_is_sparse(b))
+		return _words_ffc(_bit_data(b), _bitstr_bits(b));
+	for (c = 0; c < _sparse_chunk_cnt(_bitstr_bits(b)); c++) {
+		chunk = &_sparse_chunks(b)[c];
+		len = _sparse_len(b, c);
+		if (chunk->count == len)
 			continue;
-		}
-		while (bit < _bitstr_bits(b) && _bit_word(bit) == word) {
-			if (!bit_test(b, bit)) {
-				value = bit;
-				break;
-			}
-			bit++;
-		}
+		return (c << SPARSE_CHUNK_SHIFT) +
+		       _words_ffc(_chunk_view(b, c, len, buf), len);
 	}
-	return value;
+	return -1;
 }
 
 /* Find the first n contiguous bits clear in b.
@@ -478,26 +1288,26 @@ bit_nffs(bitstr_t *b, int32_t n)
 bitoff_t
 bit_ffs(bitstr_t *b)
 {
-	bitoff_t bit = 0, value = -1;
+	sparse_chunk_t *chunk;
+	bitoff_t c, bit;
 
 	_assert_bitstr_valid(b);
 
-	while (bit < _bitstr_bits(b) && value == -1) {
-		int32_t word = _bit_word(bit);
-
-		if (b[word] == 0) {
-			bit += sizeof(bitstr_t)*8;
+	if (!_bit_is_sparse(b))
+		return _words_ffs(_bit_data(b), _bitstr_bits(b));
+	for (c = 0; c < _sparse_chunk_cnt(_bitstr_bits(b)); c++) {
+		chunk = &_sparse_chunks(b)[c];
+		if (chunk->count == 0)
 			continue;
-		}
-		while (bit < _bitstr_bits(b) && _bit_word(bit) == word) {
-			if (bit_test(b, bit)) {
-				value = bit;
-				break;
-			}
-			bit++;
-		}
+		if (chunk->words)
+			bit = _words_ffs(chunk->words, _sparse_len(b, c));
+		else if (chunk->array)
+			bit = chunk->array[0];
+		else
+			bit = 0;
+		return (c << SPARSE_CHUNK_SHIFT) + bit;
 	}
-	return value;
+	return -1;
 }
 
 /*
@@ -508,39 +1318,26 @@ bit_ffs(bitstr_t *b)
 bitoff_t
 bit_fls(bitstr_t *b)
 {
-	bitoff_t bit, value = -1;
-	int32_t word;
+	sparse_chunk_t *chunk;
+	bitoff_t c, bit;
 
 	_assert_bitstr_valid(b);
 
-	if (_bitstr_bits(b) == 0)	/* empty bitstring */
-		return -1;
-
-	bit = _bitstr_bits(b) - 1;	/* zero origin */
-
-	while (bit >= 0 && 		/* test partitial words */
-		(_bit_word(bit) == _bit_word(bit + 1))) {
-		if (bit_test(b, bit)) {
-			value = bit;
-			break;
-		}
-		bit--;
-	}
-	while (bit >= 0 && value == -1) {	/* test whole words */
-		word = _bit_word(bit);
-		if (b[word] == 0) {
-			bit -= sizeof(bitstr_t) * 8;
+	if (!_bit_is_sparse(b))
+		return _words_fls(_bit_data(b), _bitstr_bits(b));
+	for (c = _sparse_chunk_cnt(_bitstr_bits(b)) - 1; c >= 0; c--) {
+		chunk = &_sparse_chunks(b)[c];
+		if (chunk->count == 0)
 			continue;
-		}
-		while (bit >= 0) {
-			if (bit_test(b, bit)) {
-				value = bit;
-				break;
-			}
-			bit--;
-		}
+		if (chunk->words)
+			bit = _words_fls(chunk->words, _sparse_len(b, c));
+		else if (chunk->array)
+			bit = chunk->array[chunk->count - 1];
+		else
+			bit = _sparse_len(b, c) - 1;
+		return (c << SPARSE_CHUNK_SHIFT) + bit;
 	}
-	return value;
+	return -1;
 }
 
 /*
@@ -570,17 +1367,27 @@ bit_fill_gaps(bitstr_t *b)
 int
 bit_super_set(bitstr_t *b1, bitstr_t *b2)
 {
-	bitoff_t bit;
+	bitstr_word_t *w1, *w2;
+	bitoff_t nbits, i, full;
 
 	_assert_bitstr_valid(b1);
 	_assert_bitstr_valid(b2);
 	assert(_bitstr_bits(b1) == _bitstr_bits(b2));
 
-	for (bit = 0; bit < _bitstr_bits(b1); bit += sizeof(bitstr_t)*8) {
-		if (b1[_bit_word(bit)] != (b1[_bit_word(bit)] &
-		                           b2[_bit_word(bit)]))
+	if (_bit_is_sparse(b1) || _bit_is_sparse(b2))
+		return _sparse_cmp(b1, b2, SPARSE_SUPER_SET);
+	w1 = _bit_data(b1);
+	w2 = _bit_data(b2);
+	nbits = _bitstr_bits(b1);
+	full = _bit_full_words(nbits);
+	for (i = 0; i < full; i++) {
+		if (w1[i] & ~w2[i])
 			return 0;
 	}
+	if (_bit_tail_bits(nbits) &&
+	    (w1[full] & ~w2[full] &
+	     _word_mask(0, _bit_tail_bits(nbits) - 1)))
+		return 0;
 
 	return 1;
 }
@@ -598,6 +1405,8 @@ bit_equal(bitstr_t *b1, bitstr_t *b2)
 
 	if (_bitstr_bits(b1) != _bitstr_bits(b2))
 		return 0;
+	if (_bit_is_sparse(b1) || _bit_is_sparse(b2))
+		return _sparse_cmp(b1, b2, SPARSE_EQUAL);
 
 	for (bit = 0; bit < _bitstr_bits(b1); bit += sizeof(bitstr_t)*8) {
 		if (b1[_bit_word(bit)] != b2[_bit_word(bit)])
@@ -617,14 +1426,48 @@ bit_equal(bitstr_t *b1, bitstr_t *b2)
 void
 bit_and(bitstr_t *b1, bitstr_t *b2)
 {
-	bitoff_t bit;
+	bitstr_word_t *w1, *w2;
+	bitoff_t i, nwords;
+
+	_assert_bitstr_valid(b1);
+	_assert_bitstr_valid(b2);
+	assert(_bitstr_bits(b1) == _bitstr_bits(b2));
+
+	if (_bit_is_sparse(b1) || _bit_is_sparse(b2)) {
+		_sparse_op(b1, b2, SPARSE_AND);
+		return;
+	}
+	w1 = _bit_data(b1);
+	w2 = _bit_data(b2);
+	nwords = _bitstr_words(_bitstr_bits(b1)) - BITSTR_OVERHEAD;
+	for (i = 0; i < nwords; i++)
+		w1[i] &= w2[i];
+}
+
+/*
+ * b1 &= ~b2, without changing b2
+ *   b1 (IN/OUT)	first string
+ *   b2 (IN)		second bitstring
+ */
+void
+bit_and_not(bitstr_t *b1, bitstr_t *b2)
+{
+	bitstr_word_t *w1, *w2;
+	bitoff_t i, nwords;
 
 	_assert_bitstr_valid(b1);
 	_assert_bitstr_valid(b2);
 	assert(_bitstr_bits(b1) == _bitstr_bits(b2));
 
-	for (bit = 0; bit < _bitstr_bits(b1); bit += sizeof(bitstr_t)*8)
-		b1[_bit_word(bit)] &= b2[_bit_word(bit)];
+	if (_bit_is_sparse(b1) || _bit_is_sparse(b2)) {
+		_sparse_op(b1, b2, SPARSE_AND_NOT);
+		return;
+	}
+	w1 = _bit_data(b1);
+	w2 = _bit_data(b2);
+	nwords = _bitstr_words(_bitstr_bits(b1)) - BITSTR_OVERHEAD;
+	for (i = 0; i < nwords; i++)
+		w1[i] &= ~w2[i];
 }
 
 /*
@@ -634,12 +1477,35 @@ bit_and(bitstr_t *b1, bitstr_t *b2)
 void
 bit_not(bitstr_t *b)
 {
-	bitoff_t bit;
+	bitstr_word_t *w;
+	bitoff_t i, nwords;
 
 	_assert_bitstr_valid(b);
 
-	for (bit = 0; bit < _bitstr_bits(b); bit += sizeof(bitstr_t)*8)
-		b[_bit_word(bit)] = ~b[_bit_word(bit)];
+	if (_bit_is_sparse(b)) {
+		bitstr_word_t buf[SPARSE_CHUNK_WORDS];
+		sparse_chunk_t *chunk;
+		bitoff_t c, len;
+
+		for (c = 0; c < _sparse_chunk_cnt(_bitstr_bits(b)); c++) {
+			chunk = &_sparse_chunks(b)[c];
+			len = _sparse_len(b, c);
+			if (!chunk->array && !chunk->words) {
+				chunk->count = len - chunk->count;
+				continue;
+			}
+			w = _chunk_view(b, c, len, buf);
+			nwords = _data_words(len);
+			for (i = 0; i < nwords; i++)
+				w[i] = ~w[i];
+			_sparse_put(chunk, len, w);
+		}
+		return;
+	}
+	w = _bit_data(b);
+	nwords = _bitstr_words(_bitstr_bits(b)) - BITSTR_OVERHEAD;
+	for (i = 0; i < nwords; i++)
+		w[i] = ~w[i];
 }
 
 /*
@@ -650,14 +1516,22 @@ bit_not(bitstr_t *b)
 void
 bit_or(bitstr_t *b1, bitstr_t *b2)
 {
-	bitoff_t bit;
+	bitstr_word_t *w1, *w2;
+	bitoff_t i, nwords;
 
 	_assert_bitstr_valid(b1);
 	_assert_bitstr_valid(b2);
 	assert(_bitstr_bits(b1) == _bitstr_bits(b2));
 
-	for (bit = 0; bit < _bitstr_bits(b1); bit += sizeof(bitstr_t)*8)
-		b1[_bit_word(bit)] |= b2[_bit_word(bit)];
+	if (_bit_is_sparse(b1) || _bit_is_sparse(b2)) {
+		_sparse_op(b1, b2, SPARSE_OR);
+		return;
+	}
+	w1 = _bit_data(b1);
+	w2 = _bit_data(b2);
+	nwords = _bitstr_words(_bitstr_bits(b1)) - BITSTR_OVERHEAD;
+	for (i = 0; i < nwords; i++)
+		w1[i] |= w2[i];
 }
 
 
@@ -674,6 +1548,29 @@ bit_copy(bitstr_t *b)
 
 	_assert_bitstr_valid(b);
 
+	if (_bit_is_sparse(b)) {
+		sparse_chunk_t *from, *to;
+		bitoff_t c;
+
+		new = bit_alloc_sparse(_bitstr_bits(b));
+		for (c = 0; c < _sparse_chunk_cnt(_bitstr_bits(b)); c++) {
+			from = &_sparse_chunks(b)[c];
+			to = &_sparse_chunks(new)[c];
+			to->count = from->count;
+			if (from->array) {
+				to->size = from->count;
+				len = from->count * sizeof(uint16_t);
+				to->array = xmalloc_nz(len);
+				memcpy(to->array, from->array, len);
+			} else if (from->words) {
+				len = _data_words(_sparse_len(b, c)) *
+				      sizeof(bitstr_word_t);
+				to->words = xmalloc_nz(len);
+				memcpy(to->words, from->words, len);
+			}
+		}
+		return new;
+	}
 	newsize_bits  = bit_size(b);
 	len = (_bitstr_words(newsize_bits) - BITSTR_OVERHEAD)*sizeof(bitstr_t);
 	new = bit_alloc(newsize_bits);
@@ -692,48 +1589,14 @@ bit_copybits(bitstr_t *dest, bitstr_t *src)
 	_assert_bitstr_valid(src);
 	assert(bit_size(src) == bit_size(dest));
 
+	if (_bit_is_sparse(dest) || _bit_is_sparse(src)) {
+		_sparse_op(dest, src, SPARSE_COPY);
+		return;
+	}
 	len = (_bitstr_words(bit_size(src)) - BITSTR_OVERHEAD)*sizeof(bitstr_t);
 	memcpy(&dest[BITSTR_OVERHEAD], &src[BITSTR_OVERHEAD], len);
 }
 
-#if !defined(USE_64BIT_BITSTR)
-/*
- * Returns the hamming weight (i.e. the number of bits set) in a word.
- * NOTE: This routine borrowed from Linux 2.4.9 <linux/bitops.h>.
- */
-static uint32_t
-hweight(uint32_t w)
-{
-	uint32_t res;
-
-	res = (w   & 0x55555555) + ((w >> 1)    & 0x55555555);
-	res = (res & 0x33333333) + ((res >> 2)  & 0x33333333);
-	res = (res & 0x0F0F0F0F) + ((res >> 4)  & 0x0F0F0F0F);
-	res = (res & 0x00FF00FF) + ((res >> 8)  & 0x00FF00FF);
-	res = (res & 0x0000FFFF) + ((res >> 16) & 0x0000FFFF);
-
-	return res;
-}
-#else
-/*
- * A 64 bit version crafted from 32-bit one borrowed above.
- */
-static uint64_t
-hweight(uint64_t w)
-{
-	uint64_t res;
-
-	res = (w   & 0x5555555555555555) + ((w >> 1)    & 0x5555555555555555);
-	res = (res & 0x3333333333333333) + ((res >> 2)  & 0x3333333333333333);
-	res = (res & 0x0F0F0F0F0F0F0F0F) + ((res >> 4)  & 0x0F0F0F0F0F0F0F0F);
-	res = (res & 0x00FF00FF00FF00FF) + ((res >> 8)  & 0x00FF00FF00FF00FF);
-	res = (res & 0x0000FFFF0000FFFF) + ((res >> 16) & 0x0000FFFF0000FFFF);
-	res = (res & 0x00000000FFFFFFFF) + ((res >> 32) & 0x00000000FFFFFFFF);
-
-	return res;
-}
-#endif /* !USE_64BIT_BITSTR */
-
 /*
  * Count the number of bits set in bitstring.
  *   b (IN)		bitstring to check
@@ -742,19 +1605,25 @@ hweight(uint64_t w)
 int32_t
 bit_set_count(bitstr_t *b)
 {
-	int32_t count = 0;
-	bitoff_t bit, bit_cnt;
-	int32_t word_size = sizeof(bitstr_t) * 8;
+	bitstr_word_t *w;
+	bitoff_t nbits, full, i;
+	int32_t count;
 
 	_assert_bitstr_valid(b);
 
-	bit_cnt = _bitstr_bits(b);
-	for (bit = 0; (bit + word_size) <= bit_cnt; bit += word_size) {
-		count += hweight(b[_bit_word(bit)]);
+	if (_bit_is_sparse(b)) {
+		for (count = 0, i = 0; i < _sparse_chunk_cnt(_bitstr_bits(b));
+		     i++)
+			count += _sparse_chunks(b)[i].count;
+		return count;
 	}
-	for ( ; bit < bit_cnt; bit++) {
-		if (bit_test(b, bit))
-			count++;
+	w = _bit_data(b);
+	nbits = _bitstr_bits(b);
+	full = _bit_full_words(nbits);
+	count = _count_words(w, NULL, full);
+	if (_bit_tail_bits(nbits)) {
+		count += hweight(w[full] &
+				 _word_mask(0, _bit_tail_bits(nbits) - 1));
 	}
 	return count;
 }
@@ -769,27 +1638,36 @@ bit_set_count(bitstr_t *b)
 int32_t
 bit_set_count_range(bitstr_t *b, int32_t start, int32_t end)
 {
-	int32_t count = 0, eow;
-	bitoff_t bit;
-	const int32_t word_size = sizeof(bitstr_t) * 8;
+	bitstr_word_t buf[SPARSE_CHUNK_WORDS];
+	sparse_chunk_t *chunk;
+	bitoff_t c, base, len, lo, hi;
+	int32_t count = 0;
 
 	_assert_bitstr_valid(b);
 	_assert_bit_valid(b,start);
 
 	end = MIN(end, _bitstr_bits(b));
-	eow = ((start+word_size-1)/word_size) * word_size;  /* end of word */
-	for ( bit = start; bit < end && bit < eow; bit++) {
-		if (bit_test(b, bit))
-			count++;
-	}
-	for (; (bit + word_size) <= end ; bit += word_size) {
-		count += hweight(b[_bit_word(bit)]);
-	}
-	for ( ; bit < end; bit++) {
-		if (bit_test(b, bit))
-			count++;
+	if (start >= end)
+		return 0;
+	if (!_bit_is_sparse(b))
+		return _words_count_range(_bit_data(b), start, end);
+
+	for (c = start >> SPARSE_CHUNK_SHIFT;
+	     c <= ((end - 1) >> SPARSE_CHUNK_SHIFT); c++) {
+		chunk = &_sparse_chunks(b)[c];
+		base = c << SPARSE_CHUNK_SHIFT;
+		len = _sparse_len(b, c);
+		lo = MAX(start, base) - base;
+		hi = MIN(end, base + len) - base;
+		if ((chunk->count == 0) || (chunk->count == len) ||
+		    ((lo == 0) && (hi == len))) {
+			count += (chunk->count == len) ? hi - lo :
+				 chunk->count;
+			continue;
+		}
+		count += _words_count_range(_chunk_view(b, c, len, buf),
+					    lo, hi);
 	}
-
 	return count;
 }
 
@@ -799,28 +1677,59 @@ bit_set_count_range(bitstr_t *b, int32_t start, int32_t end)
 extern int32_t
 bit_overlap(bitstr_t *b1, bitstr_t *b2)
 {
-	int32_t count = 0;
-	bitoff_t bit, bit_cnt;
-	int32_t word_size = sizeof(bitstr_t) * 8;
+	bitstr_word_t *w1, *w2;
+	bitoff_t nbits, full;
+	int32_t count;
 
 	_assert_bitstr_valid(b1);
 	_assert_bitstr_valid(b2);
 	assert(_bitstr_bits(b1) == _bitstr_bits(b2));
 
-	bit_cnt = _bitstr_bits(b1);
-	for (bit = 0; bit < bit_cnt; bit += word_size) {
-		if ((bit + word_size - 1) >= bit_cnt)
-			break;
-		count += hweight(b1[_bit_word(bit)] & b2[_bit_word(bit)]);
-	}
-	for ( ; bit < bit_cnt; bit++) {
-		if (bit_test(b1, bit) && bit_test(b2, bit))
-			count++;
+	if (_bit_is_sparse(b1) || _bit_is_sparse(b2))
+		return _sparse_cmp(b1, b2, SPARSE_OVERLAP);
+	w1 = _bit_data(b1);
+	w2 = _bit_data(b2);
+	nbits = _bitstr_bits(b1);
+	full = _bit_full_words(nbits);
+	count = _count_words(w1, w2, full);
+	if (_bit_tail_bits(nbits)) {
+		count += hweight(w1[full] & w2[full] &
+				 _word_mask(0, _bit_tail_bits(nbits) - 1));
 	}
 
 	return count;
 }
 
+/*
+ * return 1 if any bit set in b1 is also set in b2, 0 otherwise
+ */
+extern int
+bit_overlap_any(bitstr_t *b1, bitstr_t *b2)
+{
+	bitstr_word_t *w1, *w2;
+	bitoff_t nbits, i, full;
+
+	_assert_bitstr_valid(b1);
+	_assert_bitstr_valid(b2);
+	assert(_bitstr_bits(b1) == _bitstr_bits(b2));
+
+	if (_bit_is_sparse(b1) || _bit_is_sparse(b2))
+		return _sparse_cmp(b1, b2, SPARSE_OVERLAP_ANY);
+	w1 = _bit_data(b1);
+	w2 = _bit_data(b2);
+	nbits = _bitstr_bits(b1);
+	full = _bit_full_words(nbits);
+	for (i = 0; i < full; i++) {
+		if (w1[i] & w2[i])
+			return 1;
+	}
+	if (_bit_tail_bits(nbits) &&
+	    (w1[full] & w2[full] & _word_mask(0, _bit_tail_bits(nbits) - 1)))
+		return 1;
+
+	return 0;
+}
+
 /*
  * Count the number of bits clear in bitstring.
  *   b (IN)		bitstring to check
@@ -968,6 +1877,13 @@ bit_pick_cnt(bitstr_t *b, bitoff_t nbits)
 
 	if (_bitstr_bits(b) < nbits)
 		return NULL;
+	if (_bit_is_sparse(b)) {
+		bitstr_t *flat = _sparse_flat(b);
+
+		new = bit_pick_cnt(flat, nbits);
+		bit_free(flat);
+		return new;
+	}
 
 	new = bit_alloc(bit_size(b));
 	if (new == NULL)
@@ -1028,6 +1944,13 @@ bit_fmt(char *str, int32_t len, bitstr_t *b)
 
 	_assert_bitstr_valid(b);
 	assert(len > 0);
+	if (_bit_is_sparse(b)) {
+		bitstr_t *flat = _sparse_flat(b);
+
+		bit_fmt(str, len, flat);
+		bit_free(flat);
+		return str;
+	}
 	*str = '\0';
 	for (bit = 0; bit < _bitstr_bits(b); ) {
 		word = _bit_word(bit);
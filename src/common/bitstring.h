@@ -52,6 +52,11 @@
  * bitstrings are always stored in a little-endian fashion.  In other words,
  * bit "1" is always in the byte of a word at the lowest memory address,
  * regardless of the native architecture endianness.
+ *
+ * bit_alloc_sparse() allocates a bitstr_t with the same interface whose bits
+ * are held in chunks which take no space when all clear or all set, and
+ * little when only a few bits are set.  Only words 0 and 1 of it may be
+ * used directly.
  */
 
 #ifndef _BITSTRING_H_
@@ -99,6 +104,7 @@ typedef bitstr_t bitoff_t;
 /* bitstr_t signature in first word */
 #define BITSTR_MAGIC 		0x42434445
 #define BITSTR_MAGIC_STACK	0x42434446 /* signature if on stack */
+#define BITSTR_MAGIC_SPARSE	0x42434447 /* signature if sparse */
 
 /* max bit position in word */
 #define BITSTR_MAXPOS		(sizeof(bitstr_t)*8 - 1)
@@ -118,6 +124,7 @@ bitoff_t bit_ffc(bitstr_t *b);
 bitoff_t bit_ffs(bitstr_t *b);
 
 /* new */
+bitstr_t *bit_alloc_sparse(bitoff_t nbits);
 bitoff_t bit_nffs(bitstr_t *b, int32_t n);
 bitoff_t bit_nffc(bitstr_t *b, int32_t n);
 bitoff_t bit_noc(bitstr_t *b, int32_t n, int32_t seed);
@@ -125,6 +132,7 @@ void	bit_free(bitstr_t *b);
 bitstr_t *bit_realloc(bitstr_t *b, bitoff_t nbits);
 bitoff_t bit_size(bitstr_t *b);
 void	bit_and(bitstr_t *b1, bitstr_t *b2);
+void	bit_and_not(bitstr_t *b1, bitstr_t *b2);
 void	bit_not(bitstr_t *b);
 void	bit_or(bitstr_t *b1, bitstr_t *b2);
 int32_t	bit_set_count(bitstr_t *b);
@@ -147,6 +155,7 @@ bitoff_t bit_fls(bitstr_t *b);
 void	bit_fill_gaps(bitstr_t *b);
 int	bit_super_set(bitstr_t *b1, bitstr_t *b2);
 int     bit_overlap(bitstr_t *b1, bitstr_t *b2);
+int     bit_overlap_any(bitstr_t *b1, bitstr_t *b2);
 int     bit_equal(bitstr_t *b1, bitstr_t *b2);
 void    bit_copybits(bitstr_t *dest, bitstr_t *src);
 bitstr_t *bit_copy(bitstr_t *b);
@@ -50,6 +50,8 @@
 #include "slurm/slurm.h"
 
 #include "src/common/forward.h"
+#include "src/common/timers.h"
+#include "src/common/xhash.h"
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 #include "src/common/slurm_auth.h"
@@ -63,6 +65,25 @@
 
 #define MAX_RETRIES 3
 
+/* Seconds for which a node that could not be reached is not used to forward
+ * messages */
+#ifndef FORWARD_FAIL_TIME
+#define FORWARD_FAIL_TIME 300
+#endif
+
+/* Forwarding history of one node, see forward_history_init() */
+typedef struct {
+	char *node_name;
+	uint32_t srtt;		/* smoothed round trip time, usec */
+	time_t fail_time;	/* last failure, 0 if reached since */
+} fwd_hist_t;
+
+static pthread_mutex_t hist_mutex = PTHREAD_MUTEX_INITIALIZER;
+static xhash_t *hist_table = NULL;
+static bool hist_enabled = false;
+static uint64_t hist_srtt_sum = 0;	/* sum and count of srtt over all */
+static uint32_t hist_srtt_cnt = 0;	/* nodes, for their mean */
+
 typedef struct {
 	pthread_cond_t *notify;
 	int            *p_thr_count;
@@ -80,6 +101,137 @@ static void _forward_msg_internal(hostlist_t hl, hostlist_t* sp_hl,
 				  forward_struct_t *fwd_struct,
 				  header_t *header, int timeout,
 				  int hl_count);
+static void _forward_abandon(hostlist_t hl, forward_struct_t *fwd_struct,
+			     header_t *header);
+
+static const char *_hist_identify(void *item)
+{
+	return ((fwd_hist_t *) item)->node_name;
+}
+
+static void _hist_free(void *item)
+{
+	fwd_hist_t *hist = (fwd_hist_t *) item;
+
+	xfree(hist->node_name);
+	xfree(hist);
+}
+
+/* Record the outcome of sending a message to a node,
+ * hist_mutex must be locked by the caller */
+static void _hist_update(char *node_name, int usec, bool failed, time_t now)
+{
+	fwd_hist_t *hist;
+
+	if (!(hist = xhash_get(hist_table, node_name))) {
+		hist = xmalloc(sizeof(fwd_hist_t));
+		hist->node_name = xstrdup(node_name);
+		xhash_add(hist_table, hist);
+	}
+	if (failed) {
+		hist->fail_time = now;
+		return;
+	}
+	hist->fail_time = 0;
+	if (usec <= 0)
+		return;
+	if (hist->srtt) {
+		hist_srtt_sum -= hist->srtt;
+		hist->srtt = ((hist->srtt * 7) + usec) / 8;
+	} else {
+		hist->srtt = usec;
+		hist_srtt_cnt++;
+	}
+	hist_srtt_sum += hist->srtt;
+}
+
+/* Record the replies of a subtree. The round trip time of the node sent to
+ * is only recorded when it did not forward the message (usec is 0 if so),
+ * otherwise it includes the time taken by the rest of the subtree */
+static void _hist_update_list(List ret_list, char *node_name, int usec)
+{
+	ListIterator itr;
+	ret_data_info_t *ret_data_info;
+	time_t now = time(NULL);
+
+	if (!hist_enabled || !ret_list)
+		return;
+
+	slurm_mutex_lock(&hist_mutex);
+	itr = list_iterator_create(ret_list);
+	while ((ret_data_info = list_next(itr))) {
+		char *name = ret_data_info->node_name;
+		if (!name)
+			name = node_name;
+		_hist_update(name, xstrcmp(name, node_name) ? 0 : usec,
+			     (ret_data_info->type == RESPONSE_FORWARD_FAILED),
+			     now);
+	}
+	list_iterator_destroy(itr);
+	slurm_mutex_unlock(&hist_mutex);
+}
+
+/* Rank a node for use as a forwarder, lower is better.
+ * hist_mutex must be locked by the caller */
+static uint64_t _hist_score(char *node_name, time_t now)
+{
+	fwd_hist_t *hist = xhash_get(hist_table, node_name);
+	uint64_t mean = 0;
+
+	if (hist_srtt_cnt)
+		mean = hist_srtt_sum / hist_srtt_cnt;
+	if (!hist)
+		return mean;
+	if (hist->fail_time &&
+	    (difftime(now, hist->fail_time) < FORWARD_FAIL_TIME)) {
+		/* Prefer the node which failed longest ago */
+		return ((uint64_t) 1 << 32) +
+		       (FORWARD_FAIL_TIME - difftime(now, hist->fail_time));
+	}
+	if (hist->srtt)
+		return hist->srtt;
+	return mean;
+}
+
+/* Count of nodes reached by a tree of the given width and depth */
+static uint64_t _tree_reach(int width, int levels)
+{
+	uint64_t reach = 0, level_cnt = 1;
+	int i;
+
+	for (i = 0; i < levels; i++) {
+		level_cnt *= width;
+		reach += level_cnt;
+		if (reach > INFINITE)
+			break;
+	}
+	return reach;
+}
+
+/* Fan-out for a hostlist of host_cnt nodes: the smallest width which needs
+ * no more levels than max_width */
+static int _level_width(int host_cnt, int max_width)
+{
+	int levels = 1, lo, hi, mid;
+
+	if (max_width < 2)
+		return 1;
+	if (host_cnt <= max_width)
+		return host_cnt;
+
+	while (_tree_reach(max_width, levels) < host_cnt)
+		levels++;
+	lo = 2;
+	hi = max_width;
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (_tree_reach(mid, levels) >= host_cnt)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+	return lo;
+}
 
 void _destroy_tree_fwd(fwd_tree_t *fwd_tree)
 {
@@ -104,7 +256,7 @@ void *_forward_thread(void *arg)
 {
 	forward_msg_t *fwd_msg = (forward_msg_t *)arg;
 	forward_struct_t *fwd_struct = fwd_msg->fwd_struct;
-	Buf buffer = init_buf(BUF_SIZE);	/* probably enough for header */
+	Buf buffer = init_buf_refs(BUF_SIZE);	/* probably enough for header */
 	List ret_list = NULL;
 	slurm_fd_t fd = -1;
 	ret_data_info_t *ret_data_info = NULL;
@@ -114,6 +266,9 @@ void *_forward_thread(void *arg)
 	char *buf = NULL;
 	int steps = 0;
 	int start_timeout = fwd_msg->timeout;
+	int rc, iov_cnt;
+	struct iovec *iov;
+	DEF_TIMERS;
 
 	/* repeat until we are sure the message was sent */
 	while ((name = hostlist_shift(hl))) {
@@ -145,9 +300,8 @@ void *_forward_thread(void *arg)
 				 * don't have to time out for each
 				 * node serially.
 				 */
-				_forward_msg_internal(hl, NULL, fwd_struct,
-						      &fwd_msg->header, 0,
-						      hostlist_count(hl));
+				_forward_abandon(hl, fwd_struct,
+						 &fwd_msg->header);
 				continue;
 			}
 			goto cleanup;
@@ -170,26 +324,20 @@ void *_forward_thread(void *arg)
 
 		pack_header(&fwd_msg->header, buffer);
 
-		/* add forward data to buffer */
-		if (remaining_buf(buffer) < fwd_struct->buf_len) {
-			int new_size = buffer->processed + fwd_struct->buf_len;
-			new_size += 1024; /* padded for paranoia */
-			xrealloc_nz(buffer->head, new_size);
-			buffer->size = new_size;
-		}
-		if (fwd_struct->buf_len) {
-			memcpy(&buffer->head[buffer->processed],
-			       fwd_struct->buf, fwd_struct->buf_len);
-			buffer->processed += fwd_struct->buf_len;
-		}
+		/* add forward data to buffer, shared by all forward threads
+		 * rather than copied into each thread's buffer */
+		packmem_array_ref(fwd_struct->buf, fwd_struct->buf_len,
+				  buffer);
 
 		/*
 		 * forward message
 		 */
-		if (slurm_msg_sendto(fd,
-				     get_buf_data(buffer),
-				     get_buf_offset(buffer),
-				     SLURM_PROTOCOL_NO_SEND_RECV_FLAGS ) < 0) {
+		START_TIMER;
+		iov = get_buf_iovec(buffer, &iov_cnt);
+		rc = slurm_msg_sendto_iov(fd, iov, iov_cnt,
+					  SLURM_PROTOCOL_NO_SEND_RECV_FLAGS);
+		xfree(iov);
+		if (rc < 0) {
 			error("forward_thread: slurm_msg_sendto: %m");
 
 			slurm_mutex_lock(&fwd_struct->forward_mutex);
@@ -198,7 +346,7 @@ void *_forward_thread(void *arg)
 			free(name);
 			if (hostlist_count(hl) > 0) {
 				free_buf(buffer);
-				buffer = init_buf(fwd_struct->buf_len);
+				buffer = init_buf_refs(BUF_SIZE);
 				slurm_mutex_unlock(&fwd_struct->forward_mutex);
 				slurm_close(fd);
 				fd = -1;
@@ -207,9 +355,8 @@ void *_forward_thread(void *arg)
 				 * don't have to time out for each
 				 * node serially.
 				 */
-				_forward_msg_internal(hl, NULL, fwd_struct,
-						      &fwd_msg->header, 0,
-						      hostlist_count(hl));
+				_forward_abandon(hl, fwd_struct,
+						 &fwd_msg->header);
 				continue;
 			}
 			goto cleanup;
@@ -250,6 +397,9 @@ void *_forward_thread(void *arg)
 		}
 
 		ret_list = slurm_receive_msgs(fd, steps, fwd_msg->timeout);
+		END_TIMER;
+		_hist_update_list(ret_list, name,
+				  fwd_msg->header.forward.cnt ? 0 : DELTA_TIMER);
 		/* info("sent %d forwards got %d back", */
 		/*      fwd_msg->header.forward.cnt, list_count(ret_list)); */
 
@@ -263,7 +413,7 @@ void *_forward_thread(void *arg)
 				list_destroy(ret_list);
 			if (hostlist_count(hl) > 0) {
 				free_buf(buffer);
-				buffer = init_buf(fwd_struct->buf_len);
+				buffer = init_buf_refs(BUF_SIZE);
 				slurm_mutex_unlock(&fwd_struct->forward_mutex);
 				slurm_close(fd);
 				fd = -1;
@@ -353,11 +503,15 @@ void *_fwd_tree_thread(void *arg)
 	char *name = NULL;
 	char *buf = NULL;
 	slurm_msg_t send_msg;
+	hostlist_t *sp_hl;
+	int hl_count;
+	DEF_TIMERS;
 
 	slurm_msg_t_init(&send_msg);
 	send_msg.msg_type = fwd_tree->orig_msg->msg_type;
 	send_msg.data = fwd_tree->orig_msg->data;
 	send_msg.protocol_version = fwd_tree->orig_msg->protocol_version;
+	send_msg.flags = fwd_tree->orig_msg->flags;
 
 	/* repeat until we are sure the message was sent */
 	while ((name = hostlist_shift(fwd_tree->tree_hl))) {
@@ -389,8 +543,12 @@ void *_fwd_tree_thread(void *arg)
 		} else
 			debug3("Tree sending to %s", name);
 
+		START_TIMER;
 		ret_list = slurm_send_addr_recv_msgs(&send_msg, name,
 						     fwd_tree->timeout);
+		END_TIMER;
+		_hist_update_list(ret_list, name,
+				  send_msg.forward.cnt ? 0 : DELTA_TIMER);
 
 		xfree(send_msg.forward.nodelist);
 
@@ -437,6 +595,18 @@ void *_fwd_tree_thread(void *arg)
 				 * don't have to time out for each
 				 * node serially.
 				 */
+				if (hist_enabled &&
+				    (route_g_split_hostlist(fwd_tree->tree_hl,
+							    &sp_hl, &hl_count)
+				     == SLURM_SUCCESS)) {
+					/* Re-route the subtree through
+					 * other forwarders */
+					_start_msg_tree_internal(
+						NULL, sp_hl, fwd_tree,
+						hl_count);
+					xfree(sp_hl);
+					continue;
+				}
 				_start_msg_tree_internal(
 					fwd_tree->tree_hl, NULL,
 					fwd_tree,
@@ -604,6 +774,27 @@ static void _forward_msg_internal(hostlist_t hl, hostlist_t* sp_hl,
 	}
 }
 
+/* The forwarder of a subtree could not be reached, send the message to the
+ * rest of the subtree. With history enabled (route/adaptive) the subtree is
+ * split again and re-routed through other forwarders, otherwise the message
+ * is sent to each node directly. */
+static void _forward_abandon(hostlist_t hl, forward_struct_t *fwd_struct,
+			     header_t *header)
+{
+	hostlist_t *sp_hl;
+	int hl_count;
+
+	if (hist_enabled &&
+	    (route_g_split_hostlist(hl, &sp_hl, &hl_count) == SLURM_SUCCESS)) {
+		_forward_msg_internal(NULL, sp_hl, fwd_struct, header, 0,
+				      hl_count);
+		xfree(sp_hl);
+		return;
+	}
+	_forward_msg_internal(hl, NULL, fwd_struct, header, 0,
+			      hostlist_count(hl));
+}
+
 /*
  * forward_init    - initilize forward structure
  * IN: forward     - forward_t *   - struct to store forward info
@@ -757,9 +948,118 @@ extern void mark_as_failed_forward(List *ret_list, char *node_name, int err)
 	ret_data_info->err = err;
 	list_push(*ret_list, ret_data_info);
 
+	if (hist_enabled)
+		forward_history_update(node_name, 0, true);
+
 	return;
 }
 
+/*
+ * forward_history_init - start recording the round trip time and failures
+ *	of the nodes messages are sent to, for use by forward_split_hostlist()
+ */
+extern void forward_history_init(void)
+{
+	slurm_mutex_lock(&hist_mutex);
+	if (!hist_table)
+		hist_table = xhash_init(_hist_identify, _hist_free, NULL, 0);
+	hist_enabled = true;
+	slurm_mutex_unlock(&hist_mutex);
+}
+
+/*
+ * forward_history_update - record the outcome of sending a message to a node
+ * IN: node_name      - char *   - node the message was sent to
+ * IN: usec           - int      - round trip time, 0 if not measured
+ * IN: failed         - bool     - true if the node could not be reached
+ */
+extern void forward_history_update(char *node_name, int usec, bool failed)
+{
+	if (!hist_enabled || !node_name)
+		return;
+
+	slurm_mutex_lock(&hist_mutex);
+	_hist_update(node_name, usec, failed, time(NULL));
+	slurm_mutex_unlock(&hist_mutex);
+}
+
+/*
+ * forward_history_failed - test if a node recently could not be reached
+ * IN: node_name      - char *   - node name to test
+ * RET: true if the node failed within the last FORWARD_FAIL_TIME seconds
+ */
+extern bool forward_history_failed(char *node_name)
+{
+	fwd_hist_t *hist;
+	bool failed = false;
+
+	if (!hist_enabled || !node_name)
+		return false;
+
+	slurm_mutex_lock(&hist_mutex);
+	hist = xhash_get(hist_table, node_name);
+	if (hist && hist->fail_time &&
+	    (difftime(time(NULL), hist->fail_time) < FORWARD_FAIL_TIME))
+		failed = true;
+	slurm_mutex_unlock(&hist_mutex);
+
+	return failed;
+}
+
+/*
+ * forward_split_hostlist - split a hostlist for adaptive forwarding.
+ *	See forward.h for details.
+ */
+extern int forward_split_hostlist(hostlist_t hl, int max_width,
+				  hostlist_t **sp_hl, int *count)
+{
+	int host_cnt, width, i, j, first, size, best;
+	char **names;
+	uint64_t *score;
+	time_t now = time(NULL);
+
+	host_cnt = hostlist_count(hl);
+	width = _level_width(host_cnt, max_width);
+	*sp_hl = xmalloc(MAX(width, 1) * sizeof(hostlist_t));
+	*count = 0;
+	if (host_cnt == 0)
+		return SLURM_SUCCESS;
+
+	names = xmalloc(host_cnt * sizeof(char *));
+	score = xmalloc(host_cnt * sizeof(uint64_t));
+	for (i = 0; i < host_cnt; i++)
+		names[i] = hostlist_shift(hl);
+	if (hist_enabled) {
+		slurm_mutex_lock(&hist_mutex);
+		for (i = 0; i < host_cnt; i++)
+			score[i] = _hist_score(names[i], now);
+		slurm_mutex_unlock(&hist_mutex);
+	}
+
+	/* Contiguous sublists keep the nodelists in the headers short */
+	for (i = 0, first = 0; i < width; i++, first += size) {
+		size = host_cnt / width;
+		if (i < (host_cnt % width))
+			size++;
+		best = first;
+		for (j = first + 1; j < first + size; j++) {
+			if (score[j] < score[best])
+				best = j;
+		}
+		(*sp_hl)[i] = hostlist_create(names[best]);
+		for (j = first; j < first + size; j++) {
+			if (j != best)
+				hostlist_push_host((*sp_hl)[i], names[j]);
+			free(names[j]);
+		}
+	}
+	*count = width;
+
+	xfree(names);
+	xfree(score);
+	return SLURM_SUCCESS;
+}
+
 extern void forward_wait(slurm_msg_t * msg)
 {
 	int count = 0;
@@ -115,6 +115,49 @@ extern void mark_as_failed_forward(List *ret_list, char *node_name, int err);
 
 extern void forward_wait(slurm_msg_t *msg);
 
+/*
+ * forward_history_init - start recording the round trip time and failures
+ *	of the nodes messages are sent to, for use by forward_split_hostlist()
+ */
+extern void forward_history_init(void);
+
+/*
+ * forward_history_update - record the outcome of sending a message to a node
+ * IN: node_name      - char *   - node the message was sent to
+ * IN: usec           - int      - round trip time, 0 if not measured
+ * IN: failed         - bool     - true if the node could not be reached
+ */
+extern void forward_history_update(char *node_name, int usec, bool failed);
+
+/*
+ * forward_history_failed - test if a node recently could not be reached
+ * IN: node_name      - char *   - node name to test
+ * RET: true if the node failed within the last FORWARD_FAIL_TIME seconds
+ */
+extern bool forward_history_failed(char *node_name);
+
+/*
+ * forward_split_hostlist - split a hostlist for adaptive forwarding.
+ *	The fan-out is the smallest width which reaches every node in as few
+ *	levels as max_width would, so the width shrinks at each lower level.
+ *	The node with the best history in each sublist is placed first, so it
+ *	forwards the message to the rest of the sublist, nodes that recently
+ *	failed or are slow to respond are only used as leaves.
+ *
+ * IN: hl        - hostlist_t   - list of every node to send message to
+ *                                will be empty on return
+ * IN: max_width - int          - maximum fan-out, TreeWidth
+ * OUT: sp_hl    - hostlist_t** - the array of hostlists that will be malloced
+ * OUT: count    - int*         - the count of created hostlists
+ * RET: SLURM_SUCCESS - int
+ *
+ * Note: created hostlist will have to be freed independently using
+ *       hostlist_destroy by the caller.
+ * Note: the hostlist_t array will have to be xfree.
+ */
+extern int forward_split_hostlist(hostlist_t hl, int max_width,
+				  hostlist_t **sp_hl, int *count);
+
 /*
  * no_resp_forward - Used to respond for nodes not able to respond since
  *                   the parent had failed in some way
@@ -3817,8 +3817,8 @@ static int _job_alloc(void *job_gres_data, void *node_gres_data,
 			if (core_bitmap && node_gres_ptr->topo_cpus_bitmap[i] &&
 			    (bit_size(core_bitmap) ==
 			     bit_size(node_gres_ptr->topo_cpus_bitmap[i])) &&
-			    !bit_overlap(core_bitmap,
-					 node_gres_ptr->topo_cpus_bitmap[i]))
+			    !bit_overlap_any(core_bitmap,
+					     node_gres_ptr->topo_cpus_bitmap[i]))
 				continue;
 			sz1 = bit_size(job_gres_ptr->gres_bit_alloc[node_offset]);
 			sz2 = bit_size(node_gres_ptr->topo_gres_bitmap[i]);
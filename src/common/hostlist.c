@@ -112,6 +112,8 @@ strong_alias(hostlist_pop_range,	slurm_hostlist_pop_range);
 strong_alias(hostlist_push,		slurm_hostlist_push);
 strong_alias(hostlist_push_host_dims,	slurm_hostlist_push_host_dims);
 strong_alias(hostlist_push_host,	slurm_hostlist_push_host);
+strong_alias(hostlist_push_host_range,	slurm_hostlist_push_host_range);
+strong_alias(hostlist_for_each_range,	slurm_hostlist_for_each_range);
 strong_alias(hostlist_push_list,	slurm_hostlist_push_list);
 strong_alias(hostlist_ranged_string_dims,
 	                                slurm_hostlist_ranged_string_dims);
@@ -899,7 +901,11 @@ static int hostrange_prefix_cmp(hostrange_t h1, hostrange_t h2)
 	if (h2 == NULL)
 		return -1;
 
-	retval = strnatcmp(h1->prefix, h2->prefix);
+	/* Identical prefixes are the common case, skip the natural compare */
+	if ((h1->prefix == h2->prefix) || !strcmp(h1->prefix, h2->prefix))
+		retval = 0;
+	else
+		retval = strnatcmp(h1->prefix, h2->prefix);
 	return retval == 0 ? h2->singlehost - h1->singlehost : retval;
 }
 
@@ -1438,10 +1444,17 @@ static int
 hostlist_push_hr(hostlist_t hl, char *prefix, unsigned long lo,
 		 unsigned long hi, int width)
 {
-	hostrange_t hr = hostrange_create(prefix, lo, hi, width);
-	int retval = hostlist_push_range(hl, hr);
-	hostrange_destroy(hr);
-	return retval;
+	struct hostrange_components hr;
+
+	/* hostlist_push_range() copies hr only if it can not extend the
+	 * tail range, so build it on the stack */
+	hr.prefix = prefix;
+	hr.lo = lo;
+	hr.hi = hi;
+	hr.width = width;
+	hr.singlehost = 0;
+
+	return hostlist_push_range(hl, &hr);
 }
 
 /* Insert a range object hr into position n of the hostlist hl
@@ -2076,27 +2089,50 @@ int hostlist_push(hostlist_t hl, const char *hosts)
 
 int hostlist_push_host_dims(hostlist_t hl, const char *str, int dims)
 {
-	hostrange_t hr;
-	hostname_t hn;
+	struct hostrange_components hr;
+	char buf[MAXHOSTNAMELEN + 1], *prefix = buf, *suffix, *p;
+	int idx, len, hostlist_base;
 
 	if (!str || !hl)
 		return 0;
 
 	if (!dims)
 		dims = slurmdb_setup_cluster_name_dims();
+	hostlist_base = hostlist_get_base(dims);
 
-	hn = hostname_create_dims(str, dims);
+	/* Split str as hostname_create_dims() does, but without allocating
+	 * anything unless the host starts a new range */
+	idx = host_prefix_end(str, dims);
+	len = strlen(str);
+	suffix = (char *) str + idx + 1;
+	hr.singlehost = 1;
+	hr.lo = hr.hi = 0L;
+	hr.width = 0;
+	if (idx < len - 1) {
+		if ((dims > 1) && ((len - idx - 1) != dims))
+			hostlist_base = 10;
+		hr.lo = hr.hi = strtoul(suffix, &p, hostlist_base);
+		if (*p == '\0') {
+			hr.singlehost = 0;
+			hr.width = len - idx - 1;
+		}
+	}
 
-	if (hostname_suffix_is_valid(hn))
-		hr = hostrange_create(hn->prefix, hn->num, hn->num,
-				      hostname_suffix_width(hn));
-	else
-		hr = hostrange_create_single(str);
+	if (hr.singlehost) {
+		hr.lo = hr.hi = 0L;
+		hr.prefix = (char *) str;
+	} else {
+		if ((idx + 1 >= sizeof(buf)) && !(prefix = malloc(idx + 2)))
+			seterrno_ret(ENOMEM, 0);
+		memcpy(prefix, str, idx + 1);
+		prefix[idx + 1] = '\0';
+		hr.prefix = prefix;
+	}
 
-	hostlist_push_range(hl, hr);
+	hostlist_push_range(hl, &hr);
 
-	hostrange_destroy(hr);
-	hostname_destroy(hn);
+	if (prefix != buf)
+		free(prefix);
 
 	return 1;
 }
@@ -2107,6 +2143,62 @@ int hostlist_push_host(hostlist_t hl, const char *str)
 	return hostlist_push_host_dims(hl, str, dims);
 }
 
+int hostlist_push_host_range(hostlist_t hl, const char *prefix,
+			     unsigned long lo, unsigned long hi, int width)
+{
+	struct hostrange_components hr;
+
+	if (!prefix || !hl || (lo > hi))
+		return 0;
+
+	hr.prefix = (char *) prefix;
+	if (width < 0) {
+		hr.singlehost = 1;
+		hr.lo = hr.hi = 0L;
+		hr.width = 0;
+	} else {
+		hr.singlehost = 0;
+		hr.lo = lo;
+		hr.hi = hi;
+		hr.width = width;
+	}
+
+	hostlist_push_range(hl, &hr);
+
+	return hostrange_count(&hr);
+}
+
+int hostlist_for_each_range(hostlist_t hl,
+			    int (*f)(const char *prefix, unsigned long lo,
+				     unsigned long hi, int width, void *arg),
+			    void *arg)
+{
+	hostrange_t hr;
+	int i, n = 0;
+
+	if (!hl || !f)
+		return 0;
+
+	LOCK_HOSTLIST(hl);
+	for (i = 0; i < hl->nranges; i++) {
+		hr = hl->hr[i];
+		n++;
+		if (hr->singlehost) {
+			if ((*f)(hr->prefix, 0L, 0L, -1, arg) < 0) {
+				n = -n;
+				break;
+			}
+		} else if ((*f)(hr->prefix, hr->lo, hr->hi, hr->width,
+				arg) < 0) {
+			n = -n;
+			break;
+		}
+	}
+	UNLOCK_HOSTLIST(hl);
+
+	return n;
+}
+
 int hostlist_push_list(hostlist_t h1, hostlist_t h2)
 {
 	int i, n = 0;
@@ -3145,9 +3237,22 @@ _test_box(int *start, int *end, int dims)
 	return _test_box_in_grid(0, 0, start, end, dims);
 }
 
+/* Initial buffer size for the ranged string of hl, large enough for most
+ * lists so that the string need not be rebuilt in a larger buffer */
+static int _ranged_string_size(hostlist_t hl)
+{
+	int buf_size;
+
+	LOCK_HOSTLIST(hl);
+	buf_size = 8192 + (hl->nranges * 16);
+	UNLOCK_HOSTLIST(hl);
+
+	return buf_size;
+}
+
 char *hostlist_ranged_string_malloc(hostlist_t hl)
 {
-	int buf_size = 8192;
+	int buf_size = _ranged_string_size(hl);
 	char *buf = malloc(buf_size);
 	while (buf && (hostlist_ranged_string(hl, buf_size, buf) < 0)) {
 		buf_size *= 2;
@@ -3160,7 +3265,7 @@ char *hostlist_ranged_string_malloc(hostlist_t hl)
 
 char *hostlist_ranged_string_xmalloc_dims(hostlist_t hl, int dims, int brackets)
 {
-	int buf_size = 8192;
+	int buf_size = _ranged_string_size(hl);
 	char *buf = xmalloc_nz(buf_size);
 	while (hostlist_ranged_string_dims(
 		       hl, buf_size, buf, dims, brackets) < 0) {
@@ -215,6 +215,33 @@ int hostlist_push_host(hostlist_t hl, const char *host);
  */
 int hostlist_push_list(hostlist_t hl1, hostlist_t hl2);
 
+/* hostlist_push_host_range():
+ *
+ * push the hosts prefix[lo-hi] onto the hostlist hl, with the numeric
+ * suffix zero padded to width digits. If width is negative, prefix alone
+ * is pushed as a single host with no numeric suffix.
+ *
+ * Returns the number of hosts pushed onto hl, 0 on invalid arguments.
+ */
+int hostlist_push_host_range(hostlist_t hl, const char *prefix,
+			     unsigned long lo, unsigned long hi, int width);
+
+/* hostlist_for_each_range():
+ *
+ * Invoke the function f with arg for each range of the hostlist hl, in
+ * order, without expanding the range into hostnames. Arguments to f are
+ * the same as to hostlist_push_host_range(), so width is -1 for a host
+ * with no numeric suffix. f must not modify hl.
+ *
+ * Returns the number of ranges on which f was invoked. If f returns <0
+ * the walk is aborted and the negative of that range's position is
+ * returned.
+ */
+int hostlist_for_each_range(hostlist_t hl,
+			    int (*f)(const char *prefix, unsigned long lo,
+				     unsigned long hi, int width, void *arg),
+			    void *arg);
+
 
 /* hostlist_pop():
  *
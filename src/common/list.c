@@ -150,6 +150,16 @@ static void * lsd_nomem_error(char *file, int line, char *mesg)
 #endif
 #define LIST_MAGIC 0xDEADBEEF
 
+/*  Each thread keeps up to LIST_CACHE_MAX free nodes of its own, so that
+ *  adding and removing list entries rarely takes list_free_lock. Nodes move
+ *  between a thread's cache and the global freelist LIST_CACHE_BATCH at a
+ *  time, and go back to the global freelist when the thread exits.
+ */
+#if defined(WITH_PTHREADS) && !defined(MEMORY_LEAK_DEBUG)
+#  define LIST_CACHE_MAX 256
+#  define LIST_CACHE_BATCH 64
+#endif
+
 
 /****************
  *  Data Types  *
@@ -186,6 +196,13 @@ struct list {
 
 typedef struct listNode * ListNode;
 
+#ifdef LIST_CACHE_MAX
+struct listCache {
+	void                 *nodes;        /* thread's freelist of nodes        */
+	int                   count;        /* number of nodes in freelist       */
+};
+#endif /* LIST_CACHE_MAX */
+
 
 /****************
  *  Prototypes  *
@@ -201,6 +218,12 @@ static ListIterator list_iterator_alloc (void);
 static void list_iterator_free (ListIterator i);
 static void * list_alloc_aux (int size, void *pfreelist);
 static void list_free_aux (void *x, void *pfreelist);
+static void list_grow_aux (int size, void **pfree);
+#ifdef LIST_CACHE_MAX
+static struct listCache * list_cache_get (void);
+static void list_cache_fill (struct listCache *c);
+static void list_cache_flush (struct listCache *c, int keep);
+#endif /* LIST_CACHE_MAX */
 static void *_list_pop_locked(List l);
 static void *_list_append_locked(List l, void *x);
 
@@ -216,6 +239,12 @@ static ListIterator list_free_iterators = NULL;
 static pthread_mutex_t list_free_lock = PTHREAD_MUTEX_INITIALIZER;
 #endif /* WITH_PTHREADS */
 
+#ifdef LIST_CACHE_MAX
+static pthread_key_t list_cache_key;
+static pthread_once_t list_cache_once = PTHREAD_ONCE_INIT;
+static int list_cache_enabled = 0;
+#endif /* LIST_CACHE_MAX */
+
 
 /************
  *  Macros  *
@@ -972,6 +1001,20 @@ list_free (List l)
 static ListNode
 list_node_alloc (void)
 {
+#ifdef LIST_CACHE_MAX
+	struct listCache *c;
+	void **px;
+
+	if ((c = list_cache_get())) {
+		if (!c->nodes)
+			list_cache_fill(c);
+		if ((px = c->nodes)) {
+			c->nodes = *px;
+			c->count--;
+			return((ListNode) px);
+		}
+	}
+#endif /* LIST_CACHE_MAX */
 	return(list_alloc_aux(sizeof(struct listNode), &list_free_nodes));
 }
 
@@ -980,6 +1023,18 @@ list_node_alloc (void)
 static void
 list_node_free (ListNode p)
 {
+#ifdef LIST_CACHE_MAX
+	struct listCache *c;
+	void **px = (void **) p;
+
+	if ((c = list_cache_get())) {
+		*px = c->nodes;
+		c->nodes = px;
+		if (++c->count > LIST_CACHE_MAX)
+			list_cache_flush(c, LIST_CACHE_MAX / 2);
+		return;
+	}
+#endif /* LIST_CACHE_MAX */
 	list_free_aux(p, &list_free_nodes);
 }
 
@@ -1010,7 +1065,6 @@ list_alloc_aux (int size, void *pfreelist)
  */
 	void **px;
 	void **pfree = pfreelist;
-	void **plast;
 
 	assert(sizeof(char) == 1);
 	assert(size >= sizeof(void *));
@@ -1018,15 +1072,8 @@ list_alloc_aux (int size, void *pfreelist)
 	assert(LIST_ALLOC > 0);
 	list_mutex_lock(&list_free_lock);
 
-	if (!*pfree) {
-		if ((*pfree = xmalloc(LIST_ALLOC * size))) {
-			px = *pfree;
-			plast = (void **) ((char *) *pfree + ((LIST_ALLOC - 1) * size));
-			while (px < plast)
-				*px = (char *) px + size, px = *px;
-			*plast = NULL;
-		}
-	}
+	if (!*pfree)
+		list_grow_aux(size, pfree);
 	if ((px = *pfree))
 		*pfree = *px;
 	else
@@ -1060,6 +1107,127 @@ list_free_aux (void *x, void *pfreelist)
 #endif
 }
 
+/* list_grow_aux()
+ */
+static void
+list_grow_aux (int size, void **pfree)
+{
+/*  Adds a chunk of LIST_ALLOC objects of [size] bytes to the empty
+ *  freelist [*pfree]. The caller must hold list_free_lock.
+ */
+	void **px;
+	void **plast;
+
+	if ((*pfree = xmalloc(LIST_ALLOC * size))) {
+		px = *pfree;
+		plast = (void **) ((char *) *pfree + ((LIST_ALLOC - 1) * size));
+		while (px < plast)
+			*px = (char *) px + size, px = *px;
+		*plast = NULL;
+	}
+}
+
+#ifdef LIST_CACHE_MAX
+/* list_cache_destroy()
+ */
+static void
+list_cache_destroy (void *arg)
+{
+/*  Returns the nodes cached by an exiting thread to the global freelist.
+ */
+	struct listCache *c = arg;
+
+	list_cache_flush(c, 0);
+	xfree(c);
+}
+
+/* list_cache_init()
+ */
+static void
+list_cache_init (void)
+{
+	if (pthread_key_create(&list_cache_key, list_cache_destroy) == 0)
+		list_cache_enabled = 1;
+}
+
+/* list_cache_get()
+ */
+static struct listCache *
+list_cache_get (void)
+{
+/*  Returns the calling thread's node cache, creating it on first use,
+ *  or NULL if thread caches are not available.
+ */
+	struct listCache *c;
+
+	pthread_once(&list_cache_once, list_cache_init);
+	if (!list_cache_enabled)
+		return(NULL);
+	if (!(c = pthread_getspecific(list_cache_key))) {
+		c = xmalloc(sizeof(struct listCache));
+		if (pthread_setspecific(list_cache_key, c)) {
+			xfree(c);
+			return(NULL);
+		}
+	}
+	return(c);
+}
+
+/* list_cache_fill()
+ */
+static void
+list_cache_fill (struct listCache *c)
+{
+/*  Moves up to LIST_CACHE_BATCH nodes from the global freelist to the
+ *  thread's cache [c].
+ */
+	void **px;
+	void **pfree = (void **) &list_free_nodes;
+
+	list_mutex_lock(&list_free_lock);
+	while (c->count < LIST_CACHE_BATCH) {
+		if (!*pfree)
+			list_grow_aux(sizeof(struct listNode), pfree);
+		if (!(px = *pfree))
+			break;
+		*pfree = *px;
+		*px = c->nodes;
+		c->nodes = px;
+		c->count++;
+	}
+	list_mutex_unlock(&list_free_lock);
+}
+
+/* list_cache_flush()
+ */
+static void
+list_cache_flush (struct listCache *c, int keep)
+{
+/*  Returns all but [keep] nodes of the thread's cache [c] to the global
+ *  freelist. The nodes are unlinked before taking list_free_lock so that
+ *  only the splice happens under the lock.
+ */
+	void **pkeep = (void **) &c->nodes;
+	void **pfirst;
+	void **plast;
+	int i;
+
+	for (i = 0; (i < keep) && *pkeep; i++)
+		pkeep = *pkeep;
+	if (!(pfirst = *pkeep))
+		return;
+	*pkeep = NULL;
+	c->count = i;
+	for (plast = pfirst; *plast; plast = *plast)
+		;
+
+	list_mutex_lock(&list_free_lock);
+	*plast = list_free_nodes;
+	list_free_nodes = (ListNode) pfirst;
+	list_mutex_unlock(&list_free_lock);
+}
+#endif /* LIST_CACHE_MAX */
+
 #ifdef WITH_PTHREADS
 static void
 list_reinit_mutexes (void)
@@ -84,6 +84,8 @@ List config_list  = NULL;	/* list of config_record entries */
 List feature_list = NULL;	/* list of features_record entries */
 List front_end_list = NULL;	/* list of slurm_conf_frontend_t entries */
 time_t last_node_update = (time_t) 0;	/* time of last update */
+uint32_t node_delta_next_gen = 1;	/* generation of unseen changes */
+bool node_delta_changed = false;	/* node_delta_next_gen in use */
 struct node_record *node_record_table_ptr = NULL;	/* node records */
 xhash_t* node_hash_table = NULL;
 int node_record_count = 0;		/* count in node_record_table_ptr */
@@ -91,6 +93,39 @@ int node_record_count = 0;		/* count in node_record_table_ptr */
 uint16_t *cr_node_num_cores = NULL;
 uint32_t *cr_node_cores_offset = NULL;
 
+/* Node names grouped into runs sharing a prefix and suffix format, with
+ * consecutive numeric suffixes at consecutive node indexes. This lets node
+ * name ranges be converted to and from node bitmaps without expanding each
+ * name. Built by rehash_node() and only used with the table and hash it was
+ * built for. */
+typedef struct node_name_run {
+	uint32_t prefix;	/* offset of prefix in name_run_prefix */
+	int      width;		/* zero padded suffix width, 0 if unpadded */
+	uint32_t lo, hi;	/* numeric suffix range */
+	int      inx;		/* node_record_table_ptr index of lo */
+} node_name_run_t;
+
+/* Argument of _range2bitmap() */
+typedef struct name2bitmap_args {
+	bitstr_t *bitmap;
+	bool      best_effort;
+	char     *caller;
+	int       rc;
+} name2bitmap_args_t;
+
+#define NAME_RUN_MAX_DIGITS 9
+
+static const uint32_t pow10_tbl[NAME_RUN_MAX_DIGITS] = {
+	1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000 };
+
+static node_name_run_t *name_runs = NULL;	/* in node index order */
+static node_name_run_t *name_runs_sorted = NULL; /* by prefix, width, lo */
+static int   name_run_cnt = 0;
+static char *name_run_prefix = NULL;		/* '\0' separated prefixes */
+static xhash_t *name_run_hash = NULL;
+static struct node_record *name_run_table = NULL;
+static int   name_run_node_cnt = 0;
+
 static void	_add_config_feature(char *feature, bitstr_t *node_bitmap);
 static int	_build_single_nodeline_info(slurm_conf_node_t *node_ptr,
 					    struct config_record *config_ptr);
@@ -106,6 +141,12 @@ static void	_list_delete_config (void *config_entry);
 static void	_list_delete_feature (void *feature_entry);
 static int	_list_find_config (void *config_entry, void *key);
 static int	_list_find_feature (void *feature_entry, void *key);
+static void	_build_name_runs (void);
+static void	_free_name_runs (void);
+static int	_suffix_digits (uint32_t num);
+static bool	_name_runs_valid (void);
+static int	_range2bitmap (const char *prefix, unsigned long lo,
+			       unsigned long hi, int width, void *arg);
 
 
 static void _add_config_feature(char *feature, bitstr_t *node_bitmap)
@@ -462,7 +503,9 @@ static int _list_find_config (void *config_entry, void *key)
  */
 hostlist_t bitmap2hostlist (bitstr_t *bitmap)
 {
-	int i, first, last;
+	int i, j, end, first, last;
+	node_name_run_t *run, *run_end;
+	uint32_t lo;
 	hostlist_t hl;
 
 	if (bitmap == NULL)
@@ -474,13 +517,42 @@ hostlist_t bitmap2hostlist (bitstr_t *bitmap)
 
 	last  = bit_fls(bitmap);
 	hl = hostlist_create(NULL);
-	for (i = first; i <= last; i++) {
-		if (bit_test(bitmap, i) == 0)
+	if (!_name_runs_valid()) {
+		for (i = first; i <= last; i++) {
+			if (bit_test(bitmap, i) == 0)
+				continue;
+			hostlist_push_host(hl, node_record_table_ptr[i].name);
+		}
+		return hl;
+	}
+
+	/* Push each stretch of set bits within a name run as one range */
+	run = name_runs;
+	run_end = name_runs + name_run_cnt;
+	for (i = first; i <= last; ) {
+		if (bit_test(bitmap, i) == 0) {
+			i++;
+			continue;
+		}
+		while ((run < run_end) &&
+		       ((run->inx + (int) (run->hi - run->lo)) < i))
+			run++;
+		if ((run == run_end) || (run->inx > i)) {
+			hostlist_push_host(hl, node_record_table_ptr[i].name);
+			i++;
 			continue;
-		hostlist_push_host(hl, node_record_table_ptr[i].name);
+		}
+		end = MIN(last, run->inx + (int) (run->hi - run->lo));
+		for (j = i + 1; (j <= end) && bit_test(bitmap, j); j++)
+			;
+		lo = run->lo + (i - run->inx);
+		hostlist_push_host_range(hl, name_run_prefix + run->prefix,
+					 lo, lo + (j - 1 - i),
+					 run->width ? run->width :
+					 _suffix_digits(lo));
+		i = j;
 	}
 	return hl;
-
 }
 
 /*
@@ -807,6 +879,7 @@ extern struct node_record *create_node_record (
 	node_ptr->energy = acct_gather_energy_alloc();
 	node_ptr->ext_sensors = ext_sensors_alloc();
 	node_ptr->owner = NO_VAL;
+	NODE_DELTA_TOUCH(node_ptr);
 	xassert (node_ptr->magic = NODE_MAGIC)  /* set value */;
 	return node_ptr;
 }
@@ -952,6 +1025,7 @@ extern void node_fini2 (void)
 	}
 
 	xhash_free(node_hash_table);
+	_free_name_runs();
 	node_ptr = node_record_table_ptr;
 	for (i = 0; i < node_record_count; i++, node_ptr++)
 		purge_node_rec(node_ptr);
@@ -994,6 +1068,18 @@ extern int node_name2bitmap (char *node_names, bool best_effort,
 		return rc;
 	}
 
+	if (_name_runs_valid()) {
+		name2bitmap_args_t args;
+
+		args.bitmap = my_bitmap;
+		args.best_effort = best_effort;
+		args.caller = "node_name2bitmap";
+		args.rc = rc;
+		hostlist_for_each_range(host_list, _range2bitmap, &args);
+		hostlist_destroy(host_list);
+		return args.rc;
+	}
+
 	while ( (this_node_name = hostlist_shift (host_list)) ) {
 		struct node_record *node_ptr;
 		node_ptr = _find_node_record(this_node_name, best_effort, true);
@@ -1031,6 +1117,17 @@ extern int hostlist2bitmap (hostlist_t hl, bool best_effort, bitstr_t **bitmap)
 	my_bitmap = (bitstr_t *) bit_alloc (node_record_count);
 	*bitmap = my_bitmap;
 
+	if (_name_runs_valid()) {
+		name2bitmap_args_t args;
+
+		args.bitmap = my_bitmap;
+		args.best_effort = best_effort;
+		args.caller = "hostlist2bitmap";
+		args.rc = rc;
+		hostlist_for_each_range(hl, _range2bitmap, &args);
+		return args.rc;
+	}
+
 	hi = hostlist_iterator_create(hl);
 	while ((name = hostlist_next(hi)) != NULL) {
 		struct node_record *node_ptr;
@@ -1093,6 +1190,7 @@ extern void rehash_node (void)
 			continue;	/* vestigial record */
 		xhash_add(node_hash_table, node_ptr);
 	}
+	_build_name_runs();
 
 #if _DEBUG
 	_dump_hash();
@@ -1220,3 +1318,260 @@ extern int adjust_cpus_nppcu(uint16_t ntasks_per_core, uint16_t threads,
 
 	return cpus;
 }
+
+/* Split a node name into a prefix and a numeric suffix of up to
+ * NAME_RUN_MAX_DIGITS digits.
+ * OUT prefix_len - length of prefix
+ * OUT width - suffix width if zero padded, otherwise 0
+ * OUT num - numeric suffix
+ * RET false if the name has no usable numeric suffix */
+static bool _split_node_name(char *name, int *prefix_len, int *width,
+			     uint32_t *num)
+{
+	int i, len = strlen(name);
+	uint32_t n = 0;
+
+	for (i = len; (i > 0) && isdigit((int) name[i - 1]); i--)
+		;
+	if ((i == len) || ((len - i) > NAME_RUN_MAX_DIGITS))
+		return false;
+	*prefix_len = i;
+	*width = ((name[i] == '0') && ((len - i) > 1)) ? (len - i) : 0;
+	for ( ; i < len; i++)
+		n = (n * 10) + (name[i] - '0');
+	*num = n;
+	return true;
+}
+
+/* Order name runs by prefix, width and numeric suffix */
+static int _name_run_cmp(const void *a, const void *b)
+{
+	const node_name_run_t *run1 = a, *run2 = b;
+	int rc;
+
+	rc = strcmp(name_run_prefix + run1->prefix,
+		    name_run_prefix + run2->prefix);
+	if (rc)
+		return rc;
+	if (run1->width != run2->width)
+		return (run1->width < run2->width) ? -1 : 1;
+	if (run1->lo != run2->lo)
+		return (run1->lo < run2->lo) ? -1 : 1;
+	return 0;
+}
+
+static void _free_name_runs(void)
+{
+	xfree(name_runs);
+	xfree(name_runs_sorted);
+	xfree(name_run_prefix);
+	name_run_cnt = 0;
+	name_run_hash = NULL;
+	name_run_table = NULL;
+	name_run_node_cnt = 0;
+}
+
+/* Build name_runs and name_runs_sorted from node_record_table_ptr */
+static void _build_name_runs(void)
+{
+	node_name_run_t *run = NULL;
+	int i, prefix_len, width, prefix_size = 0, prefix_used = 0;
+	uint32_t num;
+	char *name;
+
+	_free_name_runs();
+	if ((node_record_count == 0) ||
+	    (slurmdb_setup_cluster_name_dims() > 1))
+		return;
+
+	name_runs = xmalloc(sizeof(node_name_run_t) * node_record_count);
+	for (i = 0; i < node_record_count; i++) {
+		name = node_record_table_ptr[i].name;
+		if (!name || !_split_node_name(name, &prefix_len, &width,
+					       &num)) {
+			run = NULL;
+			continue;
+		}
+		if (run && (run->width == width) && (run->hi + 1 == num) &&
+		    !strncmp(name_run_prefix + run->prefix, name,
+			     prefix_len) &&
+		    (name_run_prefix[run->prefix + prefix_len] == '\0')) {
+			run->hi++;
+			continue;
+		}
+
+		if (!name_run_cnt ||
+		    strncmp(name_run_prefix + name_runs[name_run_cnt-1].prefix,
+			    name, prefix_len) ||
+		    name_run_prefix[name_runs[name_run_cnt-1].prefix +
+				    prefix_len]) {
+			if (prefix_used + prefix_len + 1 > prefix_size) {
+				prefix_size = MAX(prefix_size * 2,
+						  prefix_used + prefix_len +
+						  1024);
+				xrealloc(name_run_prefix, prefix_size);
+			}
+			memcpy(name_run_prefix + prefix_used, name,
+			       prefix_len);
+			name_run_prefix[prefix_used + prefix_len] = '\0';
+			run = &name_runs[name_run_cnt];
+			run->prefix = prefix_used;
+			prefix_used += prefix_len + 1;
+		} else {
+			run = &name_runs[name_run_cnt];
+			run->prefix = name_runs[name_run_cnt - 1].prefix;
+		}
+		run->width = width;
+		run->lo = run->hi = num;
+		run->inx = i;
+		name_run_cnt++;
+	}
+	if (name_run_cnt == 0) {
+		_free_name_runs();
+		return;
+	}
+
+	name_runs_sorted = xmalloc(sizeof(node_name_run_t) * name_run_cnt);
+	memcpy(name_runs_sorted, name_runs,
+	       sizeof(node_name_run_t) * name_run_cnt);
+	qsort(name_runs_sorted, name_run_cnt, sizeof(node_name_run_t),
+	      _name_run_cmp);
+	for (i = 1; i < name_run_cnt; i++) {
+		if ((name_runs_sorted[i].lo <= name_runs_sorted[i-1].hi) &&
+		    (name_runs_sorted[i].width ==
+		     name_runs_sorted[i-1].width) &&
+		    !strcmp(name_run_prefix + name_runs_sorted[i].prefix,
+			    name_run_prefix + name_runs_sorted[i-1].prefix)) {
+			/* Duplicate node name, leave it to the hash table */
+			_free_name_runs();
+			return;
+		}
+	}
+
+	name_run_hash = node_hash_table;
+	name_run_table = node_record_table_ptr;
+	name_run_node_cnt = node_record_count;
+}
+
+static bool _name_runs_valid(void)
+{
+	return (name_run_cnt && node_hash_table &&
+		(name_run_hash == node_hash_table) &&
+		(name_run_table == node_record_table_ptr) &&
+		(name_run_node_cnt == node_record_count));
+}
+
+/* Set the bit of the node with the given name, logging invalid names */
+static void _name2bitmap(name2bitmap_args_t *args, char *name)
+{
+	struct node_record *node_ptr;
+
+	node_ptr = _find_node_record(name, args->best_effort, true);
+	if (node_ptr) {
+		bit_set(args->bitmap, (bitoff_t) (node_ptr -
+						  node_record_table_ptr));
+	} else {
+		error("%s: invalid node specified %s", args->caller, name);
+		if (!args->best_effort)
+			args->rc = EINVAL;
+	}
+}
+
+/* Set the bits of nodes prefix[lo-hi] one name at a time */
+static void _range2bitmap_by_name(name2bitmap_args_t *args,
+				  const char *prefix, unsigned long lo,
+				  unsigned long hi, int width)
+{
+	unsigned long n;
+	char *name;
+
+	for (n = lo; n <= hi; n++) {
+		name = xstrdup_printf("%s%0*lu", prefix, width, n);
+		_name2bitmap(args, name);
+		xfree(name);
+	}
+}
+
+/* Set the bits of nodes prefix[lo-hi], all having the same zero padded
+ * suffix width key (0 if unpadded) in the name run index. Numbers not
+ * found in any run are looked up by name. */
+static void _range2bitmap_by_run(name2bitmap_args_t *args,
+				 const char *prefix, int key,
+				 uint32_t lo, uint32_t hi, int width)
+{
+	node_name_run_t *run;
+	int low = 0, high = name_run_cnt, mid, rc;
+	uint32_t next = lo, first, last;
+
+	/* Find the first run of this prefix and width ending at or after lo */
+	while (low < high) {
+		mid = (low + high) / 2;
+		run = &name_runs_sorted[mid];
+		rc = strcmp(name_run_prefix + run->prefix, prefix);
+		if (rc == 0)
+			rc = run->width - key;
+		if ((rc < 0) || ((rc == 0) && (run->hi < lo)))
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	for (run = name_runs_sorted + low;
+	     (run < name_runs_sorted + name_run_cnt) && (next <= hi); run++) {
+		if ((run->lo > hi) || (run->width != key) ||
+		    strcmp(name_run_prefix + run->prefix, prefix))
+			break;
+		if (run->lo > next)
+			_range2bitmap_by_name(args, prefix, next, run->lo - 1,
+					      width);
+		first = MAX(next, run->lo);
+		last = MIN(hi, run->hi);
+		bit_nset(args->bitmap, run->inx + (first - run->lo),
+			 run->inx + (last - run->lo));
+		next = last + 1;
+	}
+	if (next <= hi)
+		_range2bitmap_by_name(args, prefix, next, hi, width);
+}
+
+/* hostlist_for_each_range() function to set the bits of a node range */
+static int _range2bitmap(const char *prefix, unsigned long lo,
+			 unsigned long hi, int width, void *arg)
+{
+	name2bitmap_args_t *args = (name2bitmap_args_t *) arg;
+	int len = strlen(prefix);
+	uint32_t split;
+
+	if (width < 0) {
+		_name2bitmap(args, (char *) prefix);
+		return 0;
+	}
+	if ((width > NAME_RUN_MAX_DIGITS) ||
+	    (hi >= (pow10_tbl[NAME_RUN_MAX_DIGITS - 1] * 10UL)) ||
+	    (len && isdigit((int) prefix[len - 1]))) {
+		/* Not a form that node names are split into */
+		_range2bitmap_by_name(args, prefix, lo, hi, width);
+		return 0;
+	}
+
+	/* Suffixes below split print with leading zeros */
+	split = (width > 1) ? pow10_tbl[width - 1] : 0;
+	if (lo < split)
+		_range2bitmap_by_run(args, prefix, width, lo,
+				     MIN(hi, split - 1), width);
+	if (hi >= split)
+		_range2bitmap_by_run(args, prefix, 0, MAX(lo, split), hi,
+				     width);
+	return 0;
+}
+
+/* Number of decimal digits in num */
+static int _suffix_digits(uint32_t num)
+{
+	int digits = 1;
+
+	while (digits < NAME_RUN_MAX_DIGITS && (num >= pow10_tbl[digits]))
+		digits++;
+	return (num >= pow10_tbl[NAME_RUN_MAX_DIGITS - 1] * 10) ?
+	       (NAME_RUN_MAX_DIGITS + 1) : digits;
+}
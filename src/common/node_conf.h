@@ -173,11 +173,23 @@ struct node_record {
 	bitstr_t *node_spec_bitmap;	/* node cpu specialization bitmap */
 	uint32_t owner;			/* User allowed to use node or NO_VAL */
 	uint16_t owner_job_cnt;		/* Count of exclusive jobs by "owner" */
+	uint32_t delta_gen;		/* generation of last change to packed
+					 * record, see pack_all_node_delta() */
 };
 extern struct node_record *node_record_table_ptr;  /* ptr to node records */
 extern int node_record_count;		/* count in node_record_table_ptr */
 extern xhash_t* node_hash_table;	/* hash table for node records */
 extern time_t last_node_update;		/* time of last node record update */
+extern uint32_t node_delta_next_gen;	/* generation of node record changes
+					 * not yet seen by any client */
+extern bool node_delta_changed;	/* set if any record has node_delta_next_gen */
+
+/* Record a change to a node record for pack_all_node_delta(). Use along with
+ * setting last_node_update, the node write lock must be set. */
+#define NODE_DELTA_TOUCH(_node_ptr) do {			\
+		(_node_ptr)->delta_gen = node_delta_next_gen;	\
+		node_delta_changed = true;			\
+	} while (0)
 
 extern uint16_t *cr_node_num_cores;
 extern uint32_t *cr_node_cores_offset;
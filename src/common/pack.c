@@ -65,6 +65,8 @@ strong_alias(create_buf,	slurm_create_buf);
 strong_alias(free_buf,		slurm_free_buf);
 strong_alias(grow_buf,		slurm_grow_buf);
 strong_alias(init_buf,		slurm_init_buf);
+strong_alias(init_buf_refs,	slurm_init_buf_refs);
+strong_alias(get_buf_iovec,	slurm_get_buf_iovec);
 strong_alias(xfer_buf_data,	slurm_xfer_buf_data);
 strong_alias(pack_time,		slurm_pack_time);
 strong_alias(unpack_time,	slurm_unpack_time);
@@ -90,6 +92,7 @@ strong_alias(unpackmem_malloc,	slurm_unpackmem_malloc);
 strong_alias(packstr_array,	slurm_packstr_array);
 strong_alias(unpackstr_array,	slurm_unpackstr_array);
 strong_alias(packmem_array,	slurm_packmem_array);
+strong_alias(packmem_array_ref,	slurm_packmem_array_ref);
 strong_alias(unpackmem_array,	slurm_unpackmem_array);
 
 /* Basic buffer management routines */
@@ -110,6 +113,10 @@ Buf create_buf(char *data, int size)
 	my_buf->size = size;
 	my_buf->processed = 0;
 	my_buf->head = data;
+	my_buf->use_refs = 0;
+	my_buf->refs = NULL;
+	my_buf->ref_cnt = 0;
+	my_buf->ref_size = 0;
 
 	return my_buf;
 }
@@ -119,6 +126,7 @@ void free_buf(Buf my_buf)
 {
 	assert(my_buf->magic == BUF_MAGIC);
 	xfree(my_buf->head);
+	xfree(my_buf->refs);
 	xfree(my_buf);
 }
 
@@ -135,6 +143,27 @@ void grow_buf (Buf buffer, int size)
 	xrealloc_nz(buffer->head, buffer->size);
 }
 
+/* Make room for at least size more bytes in a buffer being packed. The
+ * buffer grows by at least a quarter of its size, so packing a large
+ * response does not copy it again every BUF_SIZE bytes.
+ * RET SLURM_SUCCESS or SLURM_ERROR if the buffer size limit is exceeded */
+static int _grow_buf(Buf buffer, uint32_t size, const char *caller)
+{
+	uint64_t new_size = (uint64_t) buffer->size + size + BUF_SIZE;
+
+	if (new_size > MAX_BUF_SIZE) {
+		error("%s: Buffer size limit exceeded (%"PRIu64" > %u)",
+		      caller, new_size, MAX_BUF_SIZE);
+		return SLURM_ERROR;
+	}
+	new_size = MAX(new_size, (uint64_t) buffer->size + (buffer->size / 4));
+	new_size = MIN(new_size, MAX_BUF_SIZE);
+
+	buffer->size = new_size;
+	xrealloc_nz(buffer->head, buffer->size);
+	return SLURM_SUCCESS;
+}
+
 /* init_buf - create an empty buffer of the given size */
 Buf init_buf(int size)
 {
@@ -152,9 +181,55 @@ Buf init_buf(int size)
 	my_buf->size = size;
 	my_buf->processed = 0;
 	my_buf->head = xmalloc_nz(sizeof(char)*size);
+	my_buf->use_refs = 0;
+	my_buf->refs = NULL;
+	my_buf->ref_cnt = 0;
+	my_buf->ref_size = 0;
 	return my_buf;
 }
 
+/* init_buf_refs - create an empty buffer of the given size, into which
+ * packmem_array_ref() packs large data by reference rather than copying
+ * it. Such a buffer must be sent using the iovec from get_buf_iovec(),
+ * get_buf_data() returns only the data packed by copy. */
+Buf init_buf_refs(int size)
+{
+	Buf my_buf = init_buf(size);
+
+	if (my_buf)
+		my_buf->use_refs = 1;
+	return my_buf;
+}
+
+/* get_buf_iovec - describe the packed contents of a buffer, including any
+ * data packed by reference, as an array of iovec
+ * OUT iov_cnt - number of entries in the returned array
+ * RET array of iovec, the caller must xfree it */
+struct iovec *get_buf_iovec(Buf my_buf, int *iov_cnt)
+{
+	struct iovec *iov;
+	uint32_t offset = 0;
+	int i, cnt = 0;
+
+	assert(my_buf->magic == BUF_MAGIC);
+	iov = xmalloc(sizeof(struct iovec) * (my_buf->ref_cnt * 2 + 1));
+	for (i = 0; i < my_buf->ref_cnt; i++) {
+		if (my_buf->refs[i].offset > offset) {
+			iov[cnt].iov_base = my_buf->head + offset;
+			iov[cnt++].iov_len = my_buf->refs[i].offset - offset;
+			offset = my_buf->refs[i].offset;
+		}
+		iov[cnt].iov_base = my_buf->refs[i].data;
+		iov[cnt++].iov_len = my_buf->refs[i].size;
+	}
+	if (my_buf->processed > offset) {
+		iov[cnt].iov_base = my_buf->head + offset;
+		iov[cnt++].iov_len = my_buf->processed - offset;
+	}
+	*iov_cnt = cnt;
+	return iov;
+}
+
 /* xfer_buf_data - return a pointer to the buffer's data and release the
  * buffer's structure */
 void *xfer_buf_data(Buf my_buf)
@@ -162,7 +237,9 @@ void *xfer_buf_data(Buf my_buf)
 	void *data_ptr;
 
 	assert(my_buf->magic == BUF_MAGIC);
+	assert(my_buf->ref_cnt == 0);
 	data_ptr = (void *) my_buf->head;
+	xfree(my_buf->refs);
 	xfree(my_buf);
 	return data_ptr;
 }
@@ -175,16 +252,9 @@ void pack_time(time_t val, Buf buffer)
 {
 	int64_t n64 = HTON_int64((int64_t) val);
 
-	if (remaining_buf(buffer) < sizeof(n64)) {
-		if ((buffer->size + BUF_SIZE) > MAX_BUF_SIZE) {
-			error("%s: Buffer size limit exceeded (%d > %d)",
-			      __func__, (buffer->size + BUF_SIZE),
-			      MAX_BUF_SIZE);
-			return;
-		}
-		buffer->size += BUF_SIZE;
-		xrealloc_nz(buffer->head, buffer->size);
-	}
+	if ((remaining_buf(buffer) < sizeof(n64)) &&
+	    _grow_buf(buffer, sizeof(n64), __func__))
+		return;
 
 	memcpy(&buffer->head[buffer->processed], &n64, sizeof(n64));
 	buffer->processed += sizeof(n64);
@@ -221,16 +291,9 @@ void 	packdouble(double val, Buf buffer)
 	  * more than 15 decimals will mess things up, but this corrects it. */
 	uval.d =  (val * FLOAT_MULT);
 	nl =  HTON_uint64(uval.u);
-	if (remaining_buf(buffer) < sizeof(nl)) {
-		if ((buffer->size + BUF_SIZE) > MAX_BUF_SIZE) {
-			error("%s: Buffer size limit exceeded (%d > %d)",
-			      __func__, (buffer->size + BUF_SIZE),
-			      MAX_BUF_SIZE);
-			return;
-		}
-		buffer->size += BUF_SIZE;
-		xrealloc_nz(buffer->head, buffer->size);
-	}
+	if ((remaining_buf(buffer) < sizeof(nl)) &&
+	    _grow_buf(buffer, sizeof(nl), __func__))
+		return;
 
 	memcpy(&buffer->head[buffer->processed], &nl, sizeof(nl));
 	buffer->processed += sizeof(nl);
@@ -269,16 +332,9 @@ void pack64(uint64_t val, Buf buffer)
 {
 	uint64_t nl =  HTON_uint64(val);
 
-	if (remaining_buf(buffer) < sizeof(nl)) {
-		if ((buffer->size + BUF_SIZE) > MAX_BUF_SIZE) {
-			error("%s: Buffer size limit exceeded (%d > %d)",
-			      __func__, (buffer->size + BUF_SIZE),
-			      MAX_BUF_SIZE);
-			return;
-		}
-		buffer->size += BUF_SIZE;
-		xrealloc_nz(buffer->head, buffer->size);
-	}
+	if ((remaining_buf(buffer) < sizeof(nl)) &&
+	    _grow_buf(buffer, sizeof(nl), __func__))
+		return;
 
 	memcpy(&buffer->head[buffer->processed], &nl, sizeof(nl));
 	buffer->processed += sizeof(nl);
@@ -308,16 +364,9 @@ void pack32(uint32_t val, Buf buffer)
 {
 	uint32_t nl = htonl(val);
 
-	if (remaining_buf(buffer) < sizeof(nl)) {
-		if ((buffer->size + BUF_SIZE) > MAX_BUF_SIZE) {
-			error("%s: Buffer size limit exceeded (%d > %d)",
-			      __func__, (buffer->size + BUF_SIZE),
-			      MAX_BUF_SIZE);
-			return;
-		}
-		buffer->size += BUF_SIZE;
-		xrealloc_nz(buffer->head, buffer->size);
-	}
+	if ((remaining_buf(buffer) < sizeof(nl)) &&
+	    _grow_buf(buffer, sizeof(nl), __func__))
+		return;
 
 	memcpy(&buffer->head[buffer->processed], &nl, sizeof(nl));
 	buffer->processed += sizeof(nl);
@@ -434,16 +483,9 @@ void pack16(uint16_t val, Buf buffer)
 {
 	uint16_t ns = htons(val);
 
-	if (remaining_buf(buffer) < sizeof(ns)) {
-		if ((buffer->size + BUF_SIZE) > MAX_BUF_SIZE) {
-			error("%s: Buffer size limit exceeded (%d > %d)",
-			      __func__, (buffer->size + BUF_SIZE),
-			      MAX_BUF_SIZE);
-			return;
-		}
-		buffer->size += BUF_SIZE;
-		xrealloc_nz(buffer->head, buffer->size);
-	}
+	if ((remaining_buf(buffer) < sizeof(ns)) &&
+	    _grow_buf(buffer, sizeof(ns), __func__))
+		return;
 
 	memcpy(&buffer->head[buffer->processed], &ns, sizeof(ns));
 	buffer->processed += sizeof(ns);
@@ -472,16 +514,9 @@ int unpack16(uint16_t * valp, Buf buffer)
  */
 void pack8(uint8_t val, Buf buffer)
 {
-	if (remaining_buf(buffer) < sizeof(uint8_t)) {
-		if ((buffer->size + BUF_SIZE) > MAX_BUF_SIZE) {
-			error("%s: Buffer size limit exceeded (%d > %d)",
-			      __func__, (buffer->size + BUF_SIZE),
-			      MAX_BUF_SIZE);
-			return;
-		}
-		buffer->size += BUF_SIZE;
-		xrealloc_nz(buffer->head, buffer->size);
-	}
+	if ((remaining_buf(buffer) < sizeof(uint8_t)) &&
+	    _grow_buf(buffer, sizeof(uint8_t), __func__))
+		return;
 
 	memcpy(&buffer->head[buffer->processed], &val, sizeof(uint8_t));
 	buffer->processed += sizeof(uint8_t);
@@ -515,16 +550,9 @@ void packmem(char *valp, uint32_t size_val, Buf buffer)
 		      __func__, size_val, MAX_PACK_MEM_LEN);
 		return;
 	}
-	if (remaining_buf(buffer) < (sizeof(ns) + size_val)) {
-		if ((buffer->size + size_val + BUF_SIZE) > MAX_BUF_SIZE) {
-			error("%s: Buffer size limit exceeded (%d > %d)",
-			      __func__, (buffer->size + size_val + BUF_SIZE),
-			      MAX_BUF_SIZE);
-			return;
-		}
-		buffer->size += (size_val + BUF_SIZE);
-		xrealloc_nz(buffer->head, buffer->size);
-	}
+	if ((remaining_buf(buffer) < (sizeof(ns) + size_val)) &&
+	    _grow_buf(buffer, sizeof(ns) + size_val, __func__))
+		return;
 
 	memcpy(&buffer->head[buffer->processed], &ns, sizeof(ns));
 	buffer->processed += sizeof(ns);
@@ -692,16 +720,9 @@ void packstr_array(char **valp, uint32_t size_val, Buf buffer)
 	int i;
 	uint32_t ns = htonl(size_val);
 
-	if (remaining_buf(buffer) < sizeof(ns)) {
-		if ((buffer->size + BUF_SIZE) > MAX_BUF_SIZE) {
-			error("%s: Buffer size limit exceeded (%d > %d)",
-			      __func__, (buffer->size + BUF_SIZE),
-			      MAX_BUF_SIZE);
-			return;
-		}
-		buffer->size += BUF_SIZE;
-		xrealloc_nz(buffer->head, buffer->size);
-	}
+	if ((remaining_buf(buffer) < sizeof(ns)) &&
+	    _grow_buf(buffer, sizeof(ns), __func__))
+		return;
 
 	memcpy(&buffer->head[buffer->processed], &ns, sizeof(ns));
 	buffer->processed += sizeof(ns);
@@ -757,21 +778,43 @@ int unpackstr_array(char ***valp, uint32_t * size_valp, Buf buffer)
  */
 void packmem_array(char *valp, uint32_t size_val, Buf buffer)
 {
-	if (remaining_buf(buffer) < size_val) {
-		if ((buffer->size + size_val + BUF_SIZE) > MAX_BUF_SIZE) {
-			error("%s: Buffer size limit exceeded (%d > %d)",
-			      __func__, (buffer->size + size_val + BUF_SIZE),
-			      MAX_BUF_SIZE);
-			return;
-		}
-		buffer->size += (size_val + BUF_SIZE);
-		xrealloc_nz(buffer->head, buffer->size);
-	}
+	if ((remaining_buf(buffer) < size_val) &&
+	    _grow_buf(buffer, size_val, __func__))
+		return;
 
 	memcpy(&buffer->head[buffer->processed], valp, size_val);
 	buffer->processed += size_val;
 }
 
+/*
+ * Same as packmem_array(), but if the buffer was created by init_buf_refs()
+ * and size_val is at least MIN_BUF_REF_SIZE, reference the memory rather
+ * than copying it into the buffer. The memory must then remain unchanged
+ * until the buffer is sent or freed.
+ */
+void packmem_array_ref(char *valp, uint32_t size_val, Buf buffer)
+{
+	buf_ref_t *ref;
+
+	if (!buffer->use_refs || (size_val < MIN_BUF_REF_SIZE)) {
+		packmem_array(valp, size_val, buffer);
+		return;
+	}
+	if (((uint64_t) get_buf_length(buffer) + size_val) > MAX_BUF_SIZE) {
+		error("%s: Buffer size limit exceeded (%"PRIu64" > %u)",
+		      __func__, (uint64_t) get_buf_length(buffer) + size_val,
+		      MAX_BUF_SIZE);
+		return;
+	}
+
+	xrealloc(buffer->refs, sizeof(buf_ref_t) * (buffer->ref_cnt + 1));
+	ref = &buffer->refs[buffer->ref_cnt++];
+	ref->offset = buffer->processed;
+	ref->data = valp;
+	ref->size = size_val;
+	buffer->ref_size += size_val;
+}
+
 /*
  * Given a pointer to memory (valp), size (size_val), and buffer,
  * store the buffer contents into memory
@@ -57,6 +57,7 @@
 #include <assert.h>
 #include <time.h>
 #include <string.h>
+#include <sys/uio.h>
 #include "src/common/bitstring.h"
 
 #define BUF_MAGIC 0x42554545
@@ -69,11 +70,25 @@
 #define MAX_PACK_ARRAY_LEN	(128 * 1024)
 #define MAX_PACK_MEM_LEN	(128 * 1024 * 1024)
 
+/* Smallest data that packmem_array_ref() references rather than copies */
+#define MIN_BUF_REF_SIZE	(4 * 1024)
+
+/* Data packed by reference into a buffer created by init_buf_refs() */
+typedef struct buf_ref {
+	uint32_t offset;	/* offset in head the data follows */
+	char *data;
+	uint32_t size;
+} buf_ref_t;
+
 struct slurm_buf {
 	uint32_t magic;
 	char *head;
 	uint32_t size;
 	uint32_t processed;
+	uint16_t use_refs;	/* set by init_buf_refs() */
+	buf_ref_t *refs;	/* data packed by reference, not in head */
+	uint32_t ref_cnt;
+	uint32_t ref_size;	/* total size of data in refs */
 };
 
 typedef struct slurm_buf * Buf;
@@ -83,10 +98,14 @@ typedef struct slurm_buf * Buf;
 #define set_buf_offset(__buf,__val)	(__buf->processed = __val)
 #define remaining_buf(__buf)		(__buf->size - __buf->processed)
 #define size_buf(__buf)			(__buf->size)
+/* packed size including data packed by reference */
+#define get_buf_length(__buf)		(__buf->processed + __buf->ref_size)
 
 Buf	create_buf (char *data, int size);
 void	free_buf(Buf my_buf);
 Buf	init_buf(int size);
+Buf	init_buf_refs(int size);
+struct iovec *get_buf_iovec(Buf my_buf, int *iov_cnt);
 void    grow_buf (Buf my_buf, int size);
 void	*xfer_buf_data(Buf my_buf);
 
@@ -127,6 +146,7 @@ void	packstr_array(char **valp, uint32_t size_val, Buf buffer);
 int	unpackstr_array(char ***valp, uint32_t* size_val, Buf buffer);
 
 void	packmem_array(char *valp, uint32_t size_val, Buf buffer);
+void	packmem_array_ref(char *valp, uint32_t size_val, Buf buffer);
 int	unpackmem_array(char *valp, uint32_t size_valp, Buf buffer);
 
 #define safe_pack_time(val,buf) do {			\
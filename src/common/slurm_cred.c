@@ -194,6 +194,7 @@ struct slurm_job_credential {
 
 	char     *signature; 	/* credential signature			*/
 	unsigned int siglen;	/* signature length in bytes		*/
+	uint16_t  protocol_version; /* version used to pack for signing	*/
 };
 
 /*
@@ -216,6 +217,16 @@ typedef struct slurm_crypto_ops {
 	const char *(*crypto_str_error)		(int);
 } slurm_crypto_ops_t;
 
+/*
+ * Optional crypto plugin function signing several buffers in one call.
+ * Plugins without it have each buffer signed with crypto_sign().
+ * Returns zero or the error code of a failed signature, for which the
+ * corresponding sig_pp entry is left NULL.
+ */
+typedef int (*crypto_sign_batch_t)(void *key, int cnt, char **buffers,
+				   int *buf_sizes, char **sig_pp,
+				   unsigned int *sig_size_p);
+
 /*
  * These strings must be in the same order as the fields declared
  * for slurm_crypto_ops_t.
@@ -235,6 +246,7 @@ struct sbcast_cache {
 };
 
 static slurm_crypto_ops_t ops;
+static crypto_sign_batch_t crypto_sign_batch = NULL;
 static plugin_context_t *g_context = NULL;
 static pthread_mutex_t g_context_lock = PTHREAD_MUTEX_INITIALIZER;
 static bool init_run = false;
@@ -270,8 +282,9 @@ static void _verifier_ctx_init(slurm_cred_ctx_t ctx);
 static bool _credential_replayed(slurm_cred_ctx_t ctx, slurm_cred_t *cred);
 static bool _credential_revoked(slurm_cred_ctx_t ctx, slurm_cred_t *cred);
 
-static int _slurm_cred_sign(slurm_cred_ctx_t ctx, slurm_cred_t *cred,
-			    uint16_t protocol_version);
+static slurm_cred_t *_slurm_cred_create(slurm_cred_ctx_t ctx,
+					slurm_cred_arg_t *arg,
+					uint16_t protocol_version);
 static int _slurm_cred_verify_signature(slurm_cred_ctx_t ctx, slurm_cred_t *c,
 					uint16_t protocol_version);
 
@@ -334,6 +347,8 @@ static int _slurm_crypto_init(void)
 		retval = SLURM_ERROR;
 		goto done;
 	}
+	crypto_sign_batch = (crypto_sign_batch_t)
+		plugin_get_sym(g_context->cur_plugin, "crypto_sign_batch");
 	sbcast_cache_list = list_create(_sbcast_cache_del);
 	init_run = true;
 
@@ -354,6 +369,7 @@ static int _slurm_crypto_fini(void)
 	init_run = false;
 	list_destroy(sbcast_cache_list);
 	sbcast_cache_list = NULL;
+	crypto_sign_batch = NULL;
 	rc = plugin_context_destroy(g_context);
 	g_context = NULL;
 	return rc;
@@ -535,13 +551,129 @@ slurm_cred_t *
 slurm_cred_create(slurm_cred_ctx_t ctx, slurm_cred_arg_t *arg,
 		  uint16_t protocol_version)
 {
-	slurm_cred_t *cred = NULL;
+	slurm_cred_t *cred;
 
+	cred = slurm_cred_create_unsigned(ctx, arg, protocol_version);
+	if (cred && (slurm_cred_sign_batch(ctx, &cred, 1) != SLURM_SUCCESS)) {
+		slurm_cred_destroy(cred);
+		cred = NULL;
+	}
+	return cred;
+}
+
+slurm_cred_t *
+slurm_cred_create_unsigned(slurm_cred_ctx_t ctx, slurm_cred_arg_t *arg,
+			   uint16_t protocol_version)
+{
 	xassert(ctx != NULL);
 	xassert(arg != NULL);
 	if (_slurm_crypto_init() < 0)
 		return NULL;
 
+	return _slurm_cred_create(ctx, arg, protocol_version);
+}
+
+int
+slurm_cred_sign_batch(slurm_cred_ctx_t ctx, slurm_cred_t **creds,
+		      int cred_cnt)
+{
+	slurm_cred_t **sign_creds;
+	Buf *buffers;
+	char **data, **sigs;
+	int *sizes;
+	unsigned int *siglens;
+	int i, sign_cnt = 0, rc = 0;
+
+	xassert(ctx != NULL);
+	if (cred_cnt <= 0)
+		return SLURM_SUCCESS;
+	if (_slurm_crypto_init() < 0)
+		return SLURM_ERROR;
+
+	sign_creds = xmalloc(sizeof(slurm_cred_t *) * cred_cnt);
+	buffers = xmalloc(sizeof(Buf) * cred_cnt);
+	data    = xmalloc(sizeof(char *) * cred_cnt);
+	sizes   = xmalloc(sizeof(int) * cred_cnt);
+	sigs    = xmalloc(sizeof(char *) * cred_cnt);
+	siglens = xmalloc(sizeof(unsigned int) * cred_cnt);
+	for (i = 0; i < cred_cnt; i++) {
+		slurm_cred_t *cred = creds[i];
+		if (!cred)
+			continue;
+		slurm_mutex_lock(&cred->mutex);
+		xassert(cred->magic == CRED_MAGIC);
+		if (!cred->signature) {
+			buffers[sign_cnt] = init_buf(4096);
+			_pack_cred(cred, buffers[sign_cnt],
+				   cred->protocol_version);
+			data[sign_cnt]  = get_buf_data(buffers[sign_cnt]);
+			sizes[sign_cnt] = get_buf_offset(buffers[sign_cnt]);
+			sign_creds[sign_cnt++] = cred;
+		}
+		slurm_mutex_unlock(&cred->mutex);
+	}
+
+	if (sign_cnt) {
+		slurm_mutex_lock(&ctx->mutex);
+		xassert(ctx->magic == CRED_CTX_MAGIC);
+		xassert(ctx->type == SLURM_CRED_CREATOR);
+		if (crypto_sign_batch) {
+			rc = (*crypto_sign_batch)(ctx->key, sign_cnt, data,
+						  sizes, sigs, siglens);
+		} else {
+			for (i = 0; i < sign_cnt; i++) {
+				int sign_rc = (*(ops.crypto_sign))(
+					ctx->key, data[i], sizes[i],
+					&sigs[i], &siglens[i]);
+				if (sign_rc) {
+					rc = sign_rc;
+					xfree(sigs[i]);
+				}
+			}
+		}
+		slurm_mutex_unlock(&ctx->mutex);
+	}
+
+	for (i = 0; i < sign_cnt; i++) {
+		free_buf(buffers[i]);
+		slurm_mutex_lock(&sign_creds[i]->mutex);
+		sign_creds[i]->signature = sigs[i];
+		sign_creds[i]->siglen = sigs[i] ? siglens[i] : 0;
+		slurm_mutex_unlock(&sign_creds[i]->mutex);
+	}
+	xfree(sign_creds);
+	xfree(buffers);
+	xfree(data);
+	xfree(sizes);
+	xfree(sigs);
+	xfree(siglens);
+
+	if (rc) {
+		error("Credential sign: %s", (*(ops.crypto_str_error))(rc));
+		return SLURM_ERROR;
+	}
+	return SLURM_SUCCESS;
+}
+
+bool
+slurm_cred_signed(slurm_cred_t *cred)
+{
+	bool rc;
+
+	xassert(cred != NULL);
+	slurm_mutex_lock(&cred->mutex);
+	rc = (cred->signature != NULL);
+	slurm_mutex_unlock(&cred->mutex);
+
+	return rc;
+}
+
+static slurm_cred_t *
+_slurm_cred_create(slurm_cred_ctx_t ctx, slurm_cred_arg_t *arg,
+		   uint16_t protocol_version)
+{
+	slurm_cred_t *cred = NULL;
+
 	cred = _slurm_cred_alloc();
 	slurm_mutex_lock(&cred->mutex);
 	xassert(cred->magic == CRED_MAGIC);
@@ -593,23 +725,10 @@ slurm_cred_create(slurm_cred_ctx_t ctx, slurm_cred_arg_t *arg,
 	}
 #endif
 	cred->ctime  = time(NULL);
-
-	slurm_mutex_lock(&ctx->mutex);
-	xassert(ctx->magic == CRED_CTX_MAGIC);
-	xassert(ctx->type == SLURM_CRED_CREATOR);
-	if (_slurm_cred_sign(ctx, cred, protocol_version) < 0)
-		goto fail;
-
-	slurm_mutex_unlock(&ctx->mutex);
+	cred->protocol_version = protocol_version;
 	slurm_mutex_unlock(&cred->mutex);
 
 	return cred;
-
-fail:
-	slurm_mutex_unlock(&ctx->mutex);
-	slurm_mutex_unlock(&cred->mutex);
-	slurm_cred_destroy(cred);
-	return NULL;
 }
 
 slurm_cred_t *
@@ -655,6 +774,7 @@ slurm_cred_copy(slurm_cred_t *cred)
 	rcred->job_hostlist    = xstrdup(cred->job_hostlist);
 #endif
 	rcred->ctime  = cred->ctime;
+	rcred->protocol_version = cred->protocol_version;
 	rcred->siglen = cred->siglen;
 	/* Assumes signature is a string,
 	 * otherwise use xmalloc and strcpy here */
@@ -1661,30 +1781,6 @@ _print_data(char *data, int datalen)
 }
 #endif
 
-static int
-_slurm_cred_sign(slurm_cred_ctx_t ctx, slurm_cred_t *cred,
-		 uint16_t protocol_version)
-{
-	Buf           buffer;
-	int           rc;
-
-	buffer = init_buf(4096);
-	_pack_cred(cred, buffer, protocol_version);
-	rc = (*(ops.crypto_sign))(ctx->key,
-				  get_buf_data(buffer),
-				  get_buf_offset(buffer),
-				  &cred->signature,
-				  &cred->siglen);
-	free_buf(buffer);
-
-	if (rc) {
-		error("Credential sign: %s",
-		      (*(ops.crypto_str_error))(rc));
-		return SLURM_ERROR;
-	}
-	return SLURM_SUCCESS;
-}
-
 static int
 _slurm_cred_verify_signature(slurm_cred_ctx_t ctx, slurm_cred_t *cred,
 			     uint16_t protocol_version)
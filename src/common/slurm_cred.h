@@ -190,6 +190,34 @@ int slurm_crypto_fini(void);
 slurm_cred_t *slurm_cred_create(slurm_cred_ctx_t ctx, slurm_cred_arg_t *arg,
 				uint16_t protocol_version);
 
+/*
+ * Create a slurm credential as slurm_cred_create() does, but without signing
+ * it. This permits the caller to release its locks before the credential is
+ * signed with slurm_cred_sign_batch(), which must be done before the
+ * credential is packed.
+ *
+ * Returns NULL on failure.
+ */
+slurm_cred_t *slurm_cred_create_unsigned(slurm_cred_ctx_t ctx,
+					 slurm_cred_arg_t *arg,
+					 uint16_t protocol_version);
+
+/*
+ * Sign every unsigned credential in the array `creds' of `cred_cnt'
+ * entries (NULL entries are skipped) using one call to the crypto plugin
+ * when the plugin supports it.
+ *
+ * Returns SLURM_SUCCESS or SLURM_ERROR if any credential could not be
+ * signed, use slurm_cred_signed() to identify which.
+ */
+int slurm_cred_sign_batch(slurm_cred_ctx_t ctx, slurm_cred_t **creds,
+			  int cred_cnt);
+
+/*
+ * Return true if the credential has been signed.
+ */
+bool slurm_cred_signed(slurm_cred_t *cred);
+
 /*
  * Copy a slurm credential.
  * Returns NULL on failure.
@@ -3306,9 +3306,9 @@ _pack_msg(slurm_msg_t *msg, header_t *hdr, Buf buffer)
 {
 	unsigned int tmplen, msglen;
 
-	tmplen = get_buf_offset(buffer);
+	tmplen = get_buf_length(buffer);
 	pack_msg(msg, buffer);
-	msglen = get_buf_offset(buffer) - tmplen;
+	msglen = get_buf_length(buffer) - tmplen;
 
 	/* update header with correct cred and msg lengths */
 	update_header(hdr, msglen);
@@ -3328,7 +3328,8 @@ int slurm_send_node_msg(slurm_fd_t fd, slurm_msg_t * msg)
 {
 	header_t header;
 	Buf      buffer;
-	int      rc;
+	int      rc, iov_cnt;
+	struct iovec *iov;
 	void *   auth_cred;
 	time_t   start_time = time(NULL);
 
@@ -3373,9 +3374,11 @@ int slurm_send_node_msg(slurm_fd_t fd, slurm_msg_t * msg)
 	init_header(&header, msg, msg->flags);
 
 	/*
-	 * Pack header into buffer for transmission
+	 * Pack header into buffer for transmission. Large pre-packed
+	 * message data (e.g. cached job information) is referenced by the
+	 * buffer rather than copied into it.
 	 */
-	buffer = init_buf(BUF_SIZE);
+	buffer = init_buf_refs(BUF_SIZE);
 	pack_header(&header, buffer);
 
 	/*
@@ -3401,9 +3404,10 @@ int slurm_send_node_msg(slurm_fd_t fd, slurm_msg_t * msg)
 	/*
 	 * Send message
 	 */
-	rc = slurm_msg_sendto( fd, get_buf_data(buffer),
-			       get_buf_offset(buffer),
-			       SLURM_PROTOCOL_NO_SEND_RECV_FLAGS );
+	iov = get_buf_iovec(buffer, &iov_cnt);
+	rc = slurm_msg_sendto_iov(fd, iov, iov_cnt,
+				  SLURM_PROTOCOL_NO_SEND_RECV_FLAGS);
+	xfree(iov);
 
 	if ((rc < 0) && (errno == ENOTCONN)) {
 		debug3("slurm_msg_sendto: peer has disappeared for msg_type=%u",
@@ -4005,6 +4009,10 @@ List slurm_send_addr_recv_msgs(slurm_msg_t *msg, char *name, int timeout)
 		fd = slurm_open_msg_conn(&msg->address);
 		if ((fd >= 0) || (errno != ECONNREFUSED))
 			break;
+		/* Do not wait for a node which recently failed, its subtree
+		 * is re-routed instead (route/adaptive) */
+		if (forward_history_failed(name))
+			break;
 		if (i == 0)
 			debug3("connect refused, retrying");
 	}
@@ -96,6 +96,8 @@
 /* used to set flags to empty */
 #define SLURM_PROTOCOL_NO_FLAGS 0
 #define SLURM_GLOBAL_AUTH_KEY   0x0001
+/* REQUEST_NODE_REGISTRATION_STATUS sender accepts the registration as reply */
+#define SLURM_NODE_REG_REPLY    0x0002
 
 #include "src/common/slurm_protocol_socket_common.h"
 
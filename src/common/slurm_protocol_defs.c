@@ -520,6 +520,62 @@ extern void slurm_free_job_step_kill_msg(job_step_kill_msg_t * msg)
 	xfree(msg);
 }
 
+extern void slurm_free_kill_jobs_msg(kill_jobs_msg_t * msg)
+{
+	if (msg) {
+		xfree(msg->account);
+		xfree(msg->job_id);
+		xfree(msg->job_name);
+		xfree(msg->partition);
+		xfree(msg->qos);
+		xfree(msg->reservation);
+		xfree(msg);
+	}
+}
+
+/*
+ * slurm_free_kill_jobs_resp_msg - free the response of slurm_kill_jobs
+ * IN msg - pointer to kill jobs response message
+ */
+extern void slurm_free_kill_jobs_resp_msg(kill_jobs_resp_msg_t * msg)
+{
+	if (msg) {
+		xfree(msg->job_id);
+		xfree(msg->error_code);
+		xfree(msg);
+	}
+}
+
+extern void slurm_free_node_multi_msg(node_multi_msg_t * msg)
+{
+	int i;
+
+	if (msg) {
+		for (i = 0; i < msg->msg_cnt; i++) {
+			if (msg->msg_data[i])
+				slurm_free_msg_data(msg->msg_type[i],
+						    msg->msg_data[i]);
+		}
+		xfree(msg->msg_type);
+		xfree(msg->msg_data);
+		xfree(msg);
+	}
+}
+
+extern bool node_multi_msg_type(uint16_t msg_type)
+{
+	switch (msg_type) {
+	case REQUEST_ABORT_JOB:
+	case REQUEST_KILL_PREEMPTED:
+	case REQUEST_KILL_TIMELIMIT:
+	case REQUEST_LAUNCH_PROLOG:
+	case REQUEST_TERMINATE_JOB:
+		return true;
+	default:
+		return false;
+	}
+}
+
 extern void slurm_free_job_info_request_msg(job_info_request_msg_t *msg)
 {
 	xfree(msg);
@@ -541,6 +597,11 @@ extern void slurm_free_node_info_request_msg(node_info_request_msg_t *msg)
 	xfree(msg);
 }
 
+extern void slurm_free_delta_info_request_msg(delta_info_request_msg_t *msg)
+{
+	xfree(msg);
+}
+
 extern void slurm_free_node_info_single_msg(node_info_single_msg_t *msg)
 {
 	if (msg) {
@@ -612,6 +673,18 @@ extern void slurm_free_job_desc_msg(job_desc_msg_t * msg)
 	}
 }
 
+extern void slurm_free_job_desc_multi_msg(job_desc_multi_msg_t * msg)
+{
+	int i;
+
+	if (msg) {
+		for (i = 0; i < msg->job_cnt; i++)
+			slurm_free_job_desc_msg(msg->job_desc[i]);
+		xfree(msg->job_desc);
+		xfree(msg);
+	}
+}
+
 extern void slurm_free_prolog_launch_msg(prolog_launch_msg_t * msg)
 {
 	int i;
@@ -1145,6 +1218,10 @@ extern void slurm_free_suspend_int_msg(suspend_int_msg_t *msg)
 extern void slurm_free_stats_response_msg(stats_info_response_msg_t *msg)
 {
 	if (msg) {
+		xfree(msg->lock_cnt);
+		xfree(msg->lock_wait_time);
+		xfree(msg->lock_wait_max);
+		xfree(msg->lock_wait_hist);
 		xfree(msg->rpc_type_id);
 		xfree(msg->rpc_type_cnt);
 		xfree(msg->rpc_type_time);
@@ -2577,6 +2654,29 @@ extern void slurm_free_submit_response_response_msg(submit_response_msg_t * msg)
 	xfree(msg);
 }
 
+/*
+ * slurm_free_submit_response_multi_msg - free slurm
+ *	multiple job submit response message
+ * IN msg - pointer to job submit response message
+ * NOTE: buffer is loaded by slurm_submit_batch_job_multi
+ */
+extern void slurm_free_submit_response_multi_msg(
+	submit_response_multi_msg_t * msg)
+{
+	int i;
+
+	if (msg) {
+		if (msg->err_msg) {
+			for (i = 0; i < msg->job_cnt; i++)
+				xfree(msg->err_msg[i]);
+			xfree(msg->err_msg);
+		}
+		xfree(msg->job_id);
+		xfree(msg->error_code);
+		xfree(msg);
+	}
+}
+
 
 /*
  * slurm_free_ctl_conf - free slurm control information response message
@@ -2736,6 +2836,34 @@ extern void slurm_free_node_info_msg(node_info_msg_t * msg)
 	}
 }
 
+/*
+ * slurm_free_job_info_delta_msg - free the job information delta response
+ *	message
+ * IN msg - pointer to job information delta response message
+ */
+extern void slurm_free_job_info_delta_msg(job_info_delta_msg_t *msg)
+{
+	if (msg) {
+		slurm_free_job_info_msg(msg->job_info);
+		xfree(msg->removed_id);
+		xfree(msg);
+	}
+}
+
+/*
+ * slurm_free_node_info_delta_msg - free the node information delta response
+ *	message
+ * IN msg - pointer to node information delta response message
+ */
+extern void slurm_free_node_info_delta_msg(node_info_delta_msg_t *msg)
+{
+	if (msg) {
+		slurm_free_node_info_msg(msg->node_info);
+		xfree(msg->node_inx);
+		xfree(msg);
+	}
+}
+
 static void _free_all_node_info(node_info_msg_t *msg)
 {
 	int i;
@@ -3137,6 +3265,16 @@ extern int slurm_free_msg_data(slurm_msg_type_t type, void *data)
 	case REQUEST_NODE_INFO_SINGLE:
 		slurm_free_node_info_single_msg(data);
 		break;
+	case REQUEST_JOB_INFO_DELTA:
+	case REQUEST_NODE_INFO_DELTA:
+		slurm_free_delta_info_request_msg(data);
+		break;
+	case RESPONSE_JOB_INFO_DELTA:
+		slurm_free_job_info_delta_msg(data);
+		break;
+	case RESPONSE_NODE_INFO_DELTA:
+		slurm_free_node_info_delta_msg(data);
+		break;
 	case REQUEST_PARTITION_INFO:
 		slurm_free_part_info_request_msg(data);
 		break;
@@ -3146,6 +3284,12 @@ extern int slurm_free_msg_data(slurm_msg_type_t type, void *data)
 	case REQUEST_CANCEL_JOB_STEP:
 		slurm_free_job_step_kill_msg(data);
 		break;
+	case REQUEST_KILL_JOBS:
+		slurm_free_kill_jobs_msg(data);
+		break;
+	case RESPONSE_KILL_JOBS:
+		slurm_free_kill_jobs_resp_msg(data);
+		break;
 	case REQUEST_COMPLETE_JOB_ALLOCATION:
 		slurm_free_complete_job_allocation_msg(data);
 		break;
@@ -3168,12 +3312,21 @@ extern int slurm_free_msg_data(slurm_msg_type_t type, void *data)
 	case REQUEST_LAUNCH_PROLOG:
 		slurm_free_prolog_launch_msg(data);
 		break;
+	case REQUEST_NODE_MULTI_MSG:
+		slurm_free_node_multi_msg(data);
+		break;
 	case REQUEST_RESOURCE_ALLOCATION:
 	case REQUEST_JOB_WILL_RUN:
 	case REQUEST_SUBMIT_BATCH_JOB:
 	case REQUEST_UPDATE_JOB:
 		slurm_free_job_desc_msg(data);
 		break;
+	case REQUEST_SUBMIT_BATCH_JOB_MULTI:
+		slurm_free_job_desc_multi_msg(data);
+		break;
+	case RESPONSE_SUBMIT_BATCH_JOB_MULTI:
+		slurm_free_submit_response_multi_msg(data);
+		break;
 	case RESPONSE_ACCT_GATHER_UPDATE:
 		slurm_free_acct_gather_node_resp_msg(data);
 		break;
@@ -3394,6 +3547,12 @@ extern uint32_t slurm_get_return_code(slurm_msg_type_t type, void *data)
 	case RESPONSE_ACCT_GATHER_UPDATE:
 		rc = SLURM_SUCCESS;
 		break;
+	case MESSAGE_NODE_REGISTRATION_STATUS:
+		/* Registration returned in reply to
+		 * REQUEST_NODE_REGISTRATION_STATUS, its status is
+		 * processed by validate_node_specs() */
+		rc = SLURM_SUCCESS;
+		break;
 	case RESPONSE_FORWARD_FAILED:
 		/* There may be other reasons for the failure, but
 		 * this may be a slurm_msg_t data type lacking the
@@ -3548,6 +3707,10 @@ rpc_num2string(uint16_t opcode)
 		return "REQUEST_JOB_INFO";
 	case RESPONSE_JOB_INFO:
 		return "RESPONSE_JOB_INFO";
+	case REQUEST_JOB_INFO_DELTA:
+		return "REQUEST_JOB_INFO_DELTA";
+	case RESPONSE_JOB_INFO_DELTA:
+		return "RESPONSE_JOB_INFO_DELTA";
 	case REQUEST_JOB_STEP_INFO:
 		return "REQUEST_JOB_STEP_INFO";
 	case RESPONSE_JOB_STEP_INFO:
@@ -3556,6 +3719,10 @@ rpc_num2string(uint16_t opcode)
 		return "REQUEST_NODE_INFO";
 	case RESPONSE_NODE_INFO:
 		return "RESPONSE_NODE_INFO";
+	case REQUEST_NODE_INFO_DELTA:
+		return "REQUEST_NODE_INFO_DELTA";
+	case RESPONSE_NODE_INFO_DELTA:
+		return "RESPONSE_NODE_INFO_DELTA";
 	case REQUEST_PARTITION_INFO:
 		return "REQUEST_PARTITION_INFO";
 	case RESPONSE_PARTITION_INFO:
@@ -3686,6 +3853,10 @@ rpc_num2string(uint16_t opcode)
 		return "REQUEST_JOB_SBCAST_CRED";
 	case RESPONSE_JOB_SBCAST_CRED:
 		return "RESPONSE_JOB_SBCAST_CRED";
+	case REQUEST_SUBMIT_BATCH_JOB_MULTI:
+		return "REQUEST_SUBMIT_BATCH_JOB_MULTI";
+	case RESPONSE_SUBMIT_BATCH_JOB_MULTI:
+		return "RESPONSE_SUBMIT_BATCH_JOB_MULTI";
 	case REQUEST_JOB_STEP_CREATE:
 		return "REQUEST_JOB_STEP_CREATE";
 	case RESPONSE_JOB_STEP_CREATE:
@@ -3750,6 +3921,10 @@ rpc_num2string(uint16_t opcode)
 		return "REQUEST_SUSPEND_INT";
 	case REQUEST_KILL_JOB:
 		return "REQUEST_KILL_JOB";
+	case REQUEST_KILL_JOBS:
+		return "REQUEST_KILL_JOBS";
+	case RESPONSE_KILL_JOBS:
+		return "RESPONSE_KILL_JOBS";
 	case REQUEST_LAUNCH_TASKS:
 		return "REQUEST_LAUNCH_TASKS";
 	case RESPONSE_LAUNCH_TASKS:
@@ -3788,6 +3963,8 @@ rpc_num2string(uint16_t opcode)
 		return "REQUEST_COMPLETE_PROLOG";
 	case RESPONSE_PROLOG_EXECUTING:
 		return "RESPONSE_PROLOG_EXECUTING";
+	case REQUEST_NODE_MULTI_MSG:
+		return "REQUEST_NODE_MULTI_MSG";
 	case SRUN_PING:
 		return "SRUN_PING";
 	case SRUN_TIMEOUT:
@@ -246,6 +246,10 @@ typedef enum {
 	RESPONSE_CACHE_INFO,
 	REQUEST_SICP_INFO,
 	RESPONSE_SICP_INFO,
+	REQUEST_JOB_INFO_DELTA,
+	RESPONSE_JOB_INFO_DELTA,
+	REQUEST_NODE_INFO_DELTA,
+	RESPONSE_NODE_INFO_DELTA,
 
 	REQUEST_UPDATE_JOB = 3001,
 	REQUEST_UPDATE_NODE,
@@ -283,6 +287,8 @@ typedef enum {
 	REQUEST_JOB_NOTIFY,
 	REQUEST_JOB_SBCAST_CRED,
 	RESPONSE_JOB_SBCAST_CRED,
+	REQUEST_SUBMIT_BATCH_JOB_MULTI,
+	RESPONSE_SUBMIT_BATCH_JOB_MULTI,
 
 	REQUEST_JOB_STEP_CREATE = 5001,
 	RESPONSE_JOB_STEP_CREATE,
@@ -318,6 +324,8 @@ typedef enum {
 	REQUEST_KILL_JOB,       /* 5032 */
 	REQUEST_KILL_JOBSTEP,
 	RESPONSE_JOB_ARRAY_ERRORS,
+	REQUEST_KILL_JOBS,
+	RESPONSE_KILL_JOBS,
 
 	REQUEST_LAUNCH_TASKS = 6001,
 	RESPONSE_LAUNCH_TASKS,
@@ -340,6 +348,7 @@ typedef enum {
 	REQUEST_LAUNCH_PROLOG,
 	REQUEST_COMPLETE_PROLOG,
 	RESPONSE_PROLOG_EXECUTING,
+	REQUEST_NODE_MULTI_MSG,	/* several slurmctld requests for one node */
 
 	SRUN_PING = 7001,
 	SRUN_TIMEOUT,
@@ -552,6 +561,31 @@ typedef struct node_info_request_msg {
 	uint16_t show_flags;
 } node_info_request_msg_t;
 
+typedef struct delta_info_request_msg {
+	uint64_t generation;	/* generation of client's data, 0 if none */
+	uint16_t show_flags;
+} delta_info_request_msg_t;
+
+typedef struct job_info_delta_msg {
+	uint16_t full;		/* set if job_info includes all jobs */
+	job_info_msg_t *job_info; /* jobs changed since requested generation */
+	uint32_t removed_cnt;	/* count of removed_id records */
+	uint32_t *removed_id;	/* jobs purged or no longer visible */
+} job_info_delta_msg_t;
+
+typedef struct node_info_delta_msg {
+	uint16_t full;		/* set if node_info includes all nodes */
+	node_info_msg_t *node_info; /* nodes changed since requested
+				     * generation */
+	uint32_t node_cnt;	/* count of node records */
+	uint32_t *node_inx;	/* node_info record indexes, NULL if full */
+} node_info_delta_msg_t;
+
+typedef struct job_desc_multi_msg {
+	uint32_t job_cnt;	/* count of job_desc records */
+	job_desc_msg_t **job_desc;
+} job_desc_multi_msg_t;
+
 typedef struct node_info_single_msg {
 	char *node_name;
 	uint16_t show_flags;
@@ -815,6 +849,14 @@ typedef struct signal_job_msg {
 	uint32_t signal;
 } signal_job_msg_t;
 
+/* Several slurmctld requests for the same node sent as one RPC. Only
+ * message types accepted by node_multi_msg_type() may be included. */
+typedef struct node_multi_msg {
+	uint32_t msg_cnt;
+	uint16_t *msg_type;	/* slurm_msg_type_t of each message */
+	void **msg_data;	/* body of each message */
+} node_multi_msg_t;
+
 typedef struct job_time_msg {
 	uint32_t job_id;
 	time_t expiration_time;
@@ -1131,6 +1173,9 @@ extern void slurm_free_job_step_info_request_msg(
 extern void slurm_free_front_end_info_request_msg(
 		front_end_info_request_msg_t *msg);
 extern void slurm_free_node_info_request_msg(node_info_request_msg_t *msg);
+extern void slurm_free_delta_info_request_msg(delta_info_request_msg_t *msg);
+extern void slurm_free_job_info_delta_msg(job_info_delta_msg_t *msg);
+extern void slurm_free_node_info_delta_msg(node_info_delta_msg_t *msg);
 extern void slurm_free_node_info_single_msg(node_info_single_msg_t *msg);
 extern void slurm_free_part_info_request_msg(part_info_request_msg_t *msg);
 extern void slurm_free_stats_info_request_msg(stats_info_request_msg_t *msg);
@@ -1158,6 +1203,7 @@ extern void slurm_free_reboot_msg(reboot_msg_t * msg);
 extern void slurm_free_shutdown_msg(shutdown_msg_t * msg);
 
 extern void slurm_free_job_desc_msg(job_desc_msg_t * msg);
+extern void slurm_free_job_desc_multi_msg(job_desc_multi_msg_t * msg);
 
 extern void
 slurm_free_node_registration_status_msg(slurm_node_registration_status_msg_t *
@@ -1206,9 +1252,11 @@ extern void slurm_free_reattach_tasks_request_msg(
 extern void slurm_free_reattach_tasks_response_msg(
 		reattach_tasks_response_msg_t * msg);
 extern void slurm_free_kill_job_msg(kill_job_msg_t * msg);
+extern void slurm_free_node_multi_msg(node_multi_msg_t * msg);
 extern void slurm_free_signal_job_msg(signal_job_msg_t * msg);
 extern void slurm_free_update_job_time_msg(job_time_msg_t * msg);
 extern void slurm_free_job_step_kill_msg(job_step_kill_msg_t * msg);
+extern void slurm_free_kill_jobs_msg(kill_jobs_msg_t * msg);
 extern void slurm_free_epilog_complete_msg(epilog_complete_msg_t * msg);
 extern void slurm_free_srun_job_complete_msg(srun_job_complete_msg_t * msg);
 extern void slurm_free_srun_exec_msg(srun_exec_msg_t *msg);
@@ -1232,6 +1280,8 @@ extern void slurm_free_job_step_create_response_msg(
 		job_step_create_response_msg_t * msg);
 extern void slurm_free_submit_response_response_msg(
 		submit_response_msg_t * msg);
+extern void slurm_free_submit_response_multi_msg(
+		submit_response_multi_msg_t * msg);
 extern void slurm_free_ctl_conf(slurm_ctl_conf_info_msg_t * config_ptr);
 extern void slurm_free_job_info_msg(job_info_msg_t * job_buffer_ptr);
 extern void slurm_free_job_step_info_response_msg(
@@ -1345,6 +1395,10 @@ extern char *slurm_ctime_r(const time_t *timep, char *time_str);
  */
 extern char *rpc_num2string(uint16_t opcode);
 
+/* Return true if a message of the given type may be sent to a slurmd as part
+ * of a REQUEST_NODE_MULTI_MSG */
+extern bool node_multi_msg_type(uint16_t msg_type);
+
 #define safe_read(fd, buf, size) do {					\
 		int remaining = size;					\
 		char *ptr = (char *) buf;				\
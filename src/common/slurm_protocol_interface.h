@@ -68,6 +68,7 @@
 
 
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <sys/ioctl.h>
 #include <unistd.h>
 #include <fcntl.h>
@@ -124,6 +125,11 @@ extern ssize_t slurm_msg_sendto ( slurm_fd_t open_fd, char *buffer ,
  * IN timeout - maximum time to wait for a message in milliseconds */
 extern ssize_t slurm_msg_sendto_timeout ( slurm_fd_t open_fd, char *buffer,
 				   size_t size, uint32_t flags, int timeout );
+/* slurm_msg_sendto_iov is identical to slurm_msg_sendto except that the
+ * message is gathered from the iov_cnt buffers described by iov
+ * RET number of bytes written */
+extern ssize_t slurm_msg_sendto_iov ( slurm_fd_t open_fd, struct iovec *iov,
+				      int iov_cnt, uint32_t flags );
 
 /********************/
 /* stream functions */
@@ -165,6 +171,12 @@ extern int slurm_get_stream_addr ( slurm_fd_t open_fd ,
 
 extern int slurm_send_timeout ( slurm_fd_t open_fd, char *buffer ,
 				size_t size , uint32_t flags, int timeout ) ;
+/* slurm_send_iov_timeout is identical to slurm_send_timeout except that
+ * the data is gathered from the iov_cnt buffers described by iov, which
+ * are modified as data is sent */
+extern int slurm_send_iov_timeout ( slurm_fd_t open_fd, struct iovec *iov,
+				    int iov_cnt, uint32_t flags,
+				    int timeout ) ;
 extern int slurm_recv_timeout ( slurm_fd_t open_fd, char *buffer ,
 				size_t size , uint32_t flags, int timeout ) ;
 
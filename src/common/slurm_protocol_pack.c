@@ -73,11 +73,13 @@
 
 
 #define _pack_job_info_msg(msg,buf)		_pack_buffer_msg(msg,buf)
+#define _pack_job_info_delta_msg(msg,buf)	_pack_buffer_msg(msg,buf)
 #define _pack_job_step_info_msg(msg,buf)	_pack_buffer_msg(msg,buf)
 #define _pack_block_info_resp_msg(msg,buf)	_pack_buffer_msg(msg,buf)
 #define _pack_burst_buffer_info_resp_msg(msg,buf) _pack_buffer_msg(msg,buf)
 #define _pack_front_end_info_msg(msg,buf)	_pack_buffer_msg(msg,buf)
 #define _pack_node_info_msg(msg,buf)		_pack_buffer_msg(msg,buf)
+#define _pack_node_info_delta_msg(msg,buf)	_pack_buffer_msg(msg,buf)
 #define _pack_partition_info_msg(msg,buf)	_pack_buffer_msg(msg,buf)
 #define _pack_stats_response_msg(msg,buf)	_pack_buffer_msg(msg,buf)
 #define _pack_reserve_info_msg(msg,buf)		_pack_buffer_msg(msg,buf)
@@ -178,6 +180,8 @@ static int _unpack_node_info_single_msg(node_info_single_msg_t ** msg,
 
 static int _unpack_node_info_msg(node_info_msg_t ** msg, Buf buffer,
 				 uint16_t protocol_version);
+static int _unpack_node_info_delta_msg(node_info_delta_msg_t ** msg,
+				       Buf buffer, uint16_t protocol_version);
 static int _unpack_node_info_members(node_info_t * node, Buf buffer,
 				     uint16_t protocol_version);
 
@@ -438,11 +442,42 @@ static void _pack_prolog_launch_msg(prolog_launch_msg_t * msg,
 static int _unpack_prolog_launch_msg(prolog_launch_msg_t ** msg,
 				Buf buffer, uint16_t protocol_version);
 
+static void _pack_node_multi_msg(node_multi_msg_t * msg, Buf buffer,
+				 uint16_t protocol_version);
+static int _unpack_node_multi_msg(node_multi_msg_t ** msg, Buf buffer,
+				  uint16_t protocol_version);
+
 static void _pack_job_desc_msg(job_desc_msg_t * job_desc_ptr, Buf buffer,
 			       uint16_t protocol_version);
 static int _unpack_job_desc_msg(job_desc_msg_t ** job_desc_buffer_ptr,
 				Buf buffer,
 				uint16_t protocol_version);
+static void _pack_kill_jobs_msg(kill_jobs_msg_t * msg, Buf buffer,
+				uint16_t protocol_version);
+static int _unpack_kill_jobs_msg(kill_jobs_msg_t ** msg, Buf buffer,
+				 uint16_t protocol_version);
+static void _pack_kill_jobs_resp_msg(kill_jobs_resp_msg_t * msg, Buf buffer,
+				     uint16_t protocol_version);
+static int _unpack_kill_jobs_resp_msg(kill_jobs_resp_msg_t ** msg,
+				      Buf buffer, uint16_t protocol_version);
+static void _pack_job_desc_multi_msg(job_desc_multi_msg_t * msg, Buf buffer,
+				     uint16_t protocol_version);
+static int _unpack_job_desc_multi_msg(job_desc_multi_msg_t ** msg,
+				      Buf buffer, uint16_t protocol_version);
+static void _pack_submit_response_multi_msg(submit_response_multi_msg_t * msg,
+					    Buf buffer,
+					    uint16_t protocol_version);
+static int _unpack_submit_response_multi_msg(
+	submit_response_multi_msg_t ** msg, Buf buffer,
+	uint16_t protocol_version);
+static void _pack_delta_info_request_msg(delta_info_request_msg_t * msg,
+					 Buf buffer,
+					 uint16_t protocol_version);
+static int _unpack_delta_info_request_msg(delta_info_request_msg_t ** msg,
+					  Buf buffer,
+					  uint16_t protocol_version);
+static int _unpack_job_info_delta_msg(job_info_delta_msg_t ** msg, Buf buffer,
+				      uint16_t protocol_version);
 static int _unpack_job_info_msg(job_info_msg_t ** msg, Buf buffer,
 				uint16_t protocol_version);
 
@@ -806,6 +841,12 @@ pack_msg(slurm_msg_t const *msg, Buf buffer)
 					   msg->data, buffer,
 					   msg->protocol_version);
 		break;
+	case REQUEST_JOB_INFO_DELTA:
+	case REQUEST_NODE_INFO_DELTA:
+		_pack_delta_info_request_msg((delta_info_request_msg_t *)
+					     msg->data, buffer,
+					     msg->protocol_version);
+		break;
 	case REQUEST_PARTITION_INFO:
 		_pack_part_info_request_msg((part_info_request_msg_t *)
 					    msg->data, buffer,
@@ -830,12 +871,18 @@ pack_msg(slurm_msg_t const *msg, Buf buffer)
 	case RESPONSE_JOB_INFO:
 		_pack_job_info_msg((slurm_msg_t *) msg, buffer);
 		break;
+	case RESPONSE_JOB_INFO_DELTA:
+		_pack_job_info_delta_msg((slurm_msg_t *) msg, buffer);
+		break;
 	case RESPONSE_PARTITION_INFO:
 		_pack_partition_info_msg((slurm_msg_t *) msg, buffer);
 		break;
 	case RESPONSE_NODE_INFO:
 		_pack_node_info_msg((slurm_msg_t *) msg, buffer);
 		break;
+	case RESPONSE_NODE_INFO_DELTA:
+		_pack_node_info_delta_msg((slurm_msg_t *) msg, buffer);
+		break;
 	case MESSAGE_NODE_REGISTRATION_STATUS:
 		_pack_node_registration_status_msg(
 			(slurm_node_registration_status_msg_t *) msg->data,
@@ -856,6 +903,11 @@ pack_msg(slurm_msg_t const *msg, Buf buffer)
 				   msg->data, buffer,
 				   msg->protocol_version);
 		break;
+	case REQUEST_SUBMIT_BATCH_JOB_MULTI:
+		_pack_job_desc_multi_msg((job_desc_multi_msg_t *)
+					 msg->data, buffer,
+					 msg->protocol_version);
+		break;
 	case REQUEST_UPDATE_JOB_STEP:
 		_pack_update_job_step_msg((step_update_request_msg_t *)
 					  msg->data, buffer,
@@ -906,6 +958,11 @@ pack_msg(slurm_msg_t const *msg, Buf buffer)
 					  msg->data, buffer,
 					  msg->protocol_version);
 		break;
+	case RESPONSE_SUBMIT_BATCH_JOB_MULTI:
+		_pack_submit_response_multi_msg((submit_response_multi_msg_t *)
+						msg->data, buffer,
+						msg->protocol_version);
+		break;
 	case RESPONSE_JOB_ALLOCATION_INFO_LITE:
 	case RESPONSE_RESOURCE_ALLOCATION:
 		_pack_resource_allocation_response_msg
@@ -1017,6 +1074,14 @@ pack_msg(slurm_msg_t const *msg, Buf buffer)
 					msg->data, buffer,
 					msg->protocol_version);
 		break;
+	case REQUEST_KILL_JOBS:
+		_pack_kill_jobs_msg((kill_jobs_msg_t *) msg->data, buffer,
+				    msg->protocol_version);
+		break;
+	case RESPONSE_KILL_JOBS:
+		_pack_kill_jobs_resp_msg((kill_jobs_resp_msg_t *) msg->data,
+					 buffer, msg->protocol_version);
+		break;
 	case REQUEST_COMPLETE_JOB_ALLOCATION:
 		_pack_complete_job_allocation_msg(
 			(complete_job_allocation_msg_t *)msg->data, buffer,
@@ -1112,6 +1177,10 @@ pack_msg(slurm_msg_t const *msg, Buf buffer)
 		_pack_prolog_launch_msg((prolog_launch_msg_t *)
 					   msg->data, buffer, msg->protocol_version);
 		break;
+	case REQUEST_NODE_MULTI_MSG:
+		_pack_node_multi_msg((node_multi_msg_t *) msg->data, buffer,
+				     msg->protocol_version);
+		break;
 	case RESPONSE_PROLOG_EXECUTING:
 	case RESPONSE_JOB_READY:
 	case RESPONSE_SLURM_RC:
@@ -1411,6 +1480,12 @@ unpack_msg(slurm_msg_t * msg, Buf buffer)
 						  & (msg->data), buffer,
 						  msg->protocol_version);
 		break;
+	case REQUEST_JOB_INFO_DELTA:
+	case REQUEST_NODE_INFO_DELTA:
+		rc = _unpack_delta_info_request_msg((delta_info_request_msg_t **)
+						    & (msg->data), buffer,
+						    msg->protocol_version);
+		break;
 	case REQUEST_PARTITION_INFO:
 		rc = _unpack_part_info_request_msg((part_info_request_msg_t **)
 						   & (msg->data), buffer,
@@ -1438,6 +1513,11 @@ unpack_msg(slurm_msg_t * msg, Buf buffer)
 					  buffer,
 					  msg->protocol_version);
 		break;
+	case RESPONSE_JOB_INFO_DELTA:
+		rc = _unpack_job_info_delta_msg((job_info_delta_msg_t **)
+						& (msg->data), buffer,
+						msg->protocol_version);
+		break;
 	case RESPONSE_PARTITION_INFO:
 		rc = _unpack_partition_info_msg((partition_info_msg_t **) &
 						(msg->data), buffer,
@@ -1448,6 +1528,11 @@ unpack_msg(slurm_msg_t * msg, Buf buffer)
 					   (msg->data), buffer,
 					   msg->protocol_version);
 		break;
+	case RESPONSE_NODE_INFO_DELTA:
+		rc = _unpack_node_info_delta_msg((node_info_delta_msg_t **) &
+						 (msg->data), buffer,
+						 msg->protocol_version);
+		break;
 	case MESSAGE_NODE_REGISTRATION_STATUS:
 		rc = _unpack_node_registration_status_msg(
 			(slurm_node_registration_status_msg_t **)
@@ -1468,6 +1553,11 @@ unpack_msg(slurm_msg_t * msg, Buf buffer)
 					  buffer,
 					  msg->protocol_version);
 		break;
+	case REQUEST_SUBMIT_BATCH_JOB_MULTI:
+		rc = _unpack_job_desc_multi_msg((job_desc_multi_msg_t **)
+						& (msg->data), buffer,
+						msg->protocol_version);
+		break;
 	case REQUEST_UPDATE_JOB_STEP:
 		rc = _unpack_update_job_step_msg(
 			(step_update_request_msg_t **) & (msg->data),
@@ -1520,6 +1610,11 @@ unpack_msg(slurm_msg_t * msg, Buf buffer)
 						 & (msg->data), buffer,
 						 msg->protocol_version);
 		break;
+	case RESPONSE_SUBMIT_BATCH_JOB_MULTI:
+		rc = _unpack_submit_response_multi_msg(
+			(submit_response_multi_msg_t **) & (msg->data),
+			buffer, msg->protocol_version);
+		break;
 	case RESPONSE_JOB_ALLOCATION_INFO_LITE:
 	case RESPONSE_RESOURCE_ALLOCATION:
 		rc = _unpack_resource_allocation_response_msg(
@@ -1640,6 +1735,15 @@ unpack_msg(slurm_msg_t * msg, Buf buffer)
 					       & (msg->data), buffer,
 					       msg->protocol_version);
 		break;
+	case REQUEST_KILL_JOBS:
+		rc = _unpack_kill_jobs_msg((kill_jobs_msg_t **) & (msg->data),
+					   buffer, msg->protocol_version);
+		break;
+	case RESPONSE_KILL_JOBS:
+		rc = _unpack_kill_jobs_resp_msg((kill_jobs_resp_msg_t **)
+						& (msg->data), buffer,
+						msg->protocol_version);
+		break;
 	case REQUEST_COMPLETE_JOB_ALLOCATION:
 		rc = _unpack_complete_job_allocation_msg(
 			(complete_job_allocation_msg_t **)&msg->data, buffer,
@@ -1745,6 +1849,11 @@ unpack_msg(slurm_msg_t * msg, Buf buffer)
 					       & (msg->data),
 					       buffer, msg->protocol_version);
 		break;
+	case REQUEST_NODE_MULTI_MSG:
+		rc = _unpack_node_multi_msg((node_multi_msg_t **)
+					    & (msg->data), buffer,
+					    msg->protocol_version);
+		break;
 	case RESPONSE_PROLOG_EXECUTING:
 	case RESPONSE_JOB_READY:
 	case RESPONSE_SLURM_RC:
@@ -2796,8 +2905,13 @@ _pack_node_registration_status_msg(slurm_node_registration_status_msg_t *
 		if (msg->startup)
 			switch_g_pack_node_info(msg->switch_nodeinfo, buffer,
 						protocol_version);
-		if (msg->gres_info)
+		if (msg->gres_info) {
 			gres_info_size = get_buf_offset(msg->gres_info);
+			/* Unpacked, but not yet read, by a slurmd relaying
+			 * the message through the forward tree */
+			if (gres_info_size == 0)
+				gres_info_size = size_buf(msg->gres_info);
+		}
 		pack32(gres_info_size, buffer);
 		if (gres_info_size) {
 			packmem(get_buf_data(msg->gres_info), gres_info_size,
@@ -3327,6 +3441,49 @@ unpack_error:
 	return SLURM_ERROR;
 }
 
+static void
+_pack_submit_response_multi_msg(submit_response_multi_msg_t * msg,
+				Buf buffer, uint16_t protocol_version)
+{
+	xassert(msg != NULL);
+
+	pack32_array(msg->job_id, msg->job_cnt, buffer);
+	pack32_array(msg->error_code, msg->job_cnt, buffer);
+	packstr_array(msg->err_msg, msg->job_cnt, buffer);
+}
+
+static int
+_unpack_submit_response_multi_msg(submit_response_multi_msg_t ** msg,
+				  Buf buffer, uint16_t protocol_version)
+{
+	submit_response_multi_msg_t *tmp_ptr;
+	uint32_t i, uint32_tmp;
+	char **err_msg = NULL;
+
+	xassert(msg != NULL);
+	tmp_ptr = xmalloc(sizeof(submit_response_multi_msg_t));
+	*msg = tmp_ptr;
+
+	safe_unpack32_array(&tmp_ptr->job_id, &tmp_ptr->job_cnt, buffer);
+	safe_unpack32_array(&tmp_ptr->error_code, &uint32_tmp, buffer);
+	if (uint32_tmp != tmp_ptr->job_cnt)
+		goto unpack_error;
+	safe_unpackstr_array(&err_msg, &uint32_tmp, buffer);
+	if (uint32_tmp != tmp_ptr->job_cnt) {
+		for (i = 0; i < uint32_tmp; i++)
+			xfree(err_msg[i]);
+		xfree(err_msg);
+		goto unpack_error;
+	}
+	tmp_ptr->err_msg = err_msg;
+	return SLURM_SUCCESS;
+
+unpack_error:
+	slurm_free_submit_response_multi_msg(tmp_ptr);
+	*msg = NULL;
+	return SLURM_ERROR;
+}
+
 static int
 _unpack_node_info_msg(node_info_msg_t ** msg, Buf buffer,
 		      uint16_t protocol_version)
@@ -3372,6 +3529,38 @@ unpack_error:
 	return SLURM_ERROR;
 }
 
+/* The node information delta response is a node information response holding
+ * the changed node records followed by the generation of the data, the full
+ * flag, the total node count and the index of each changed node record */
+static int
+_unpack_node_info_delta_msg(node_info_delta_msg_t ** msg, Buf buffer,
+			    uint16_t protocol_version)
+{
+	node_info_delta_msg_t *delta_ptr;
+	uint32_t uint32_tmp;
+
+	xassert(msg != NULL);
+	delta_ptr = xmalloc(sizeof(node_info_delta_msg_t));
+	*msg = delta_ptr;
+
+	if (_unpack_node_info_msg(&delta_ptr->node_info, buffer,
+				  protocol_version))
+		goto unpack_error;
+	safe_unpack64(&delta_ptr->node_info->generation, buffer);
+	safe_unpack16(&delta_ptr->full, buffer);
+	safe_unpack32(&delta_ptr->node_cnt, buffer);
+	safe_unpack32_array(&delta_ptr->node_inx, &uint32_tmp, buffer);
+	if (uint32_tmp != (delta_ptr->full ? 0 :
+			   delta_ptr->node_info->record_count))
+		goto unpack_error;
+	return SLURM_SUCCESS;
+
+unpack_error:
+	slurm_free_node_info_delta_msg(delta_ptr);
+	*msg = NULL;
+	return SLURM_ERROR;
+}
+
 static int
 _unpack_node_info_members(node_info_t * node, Buf buffer,
 			  uint16_t protocol_version)
@@ -4798,7 +4987,7 @@ static void
 _pack_buffer_msg(slurm_msg_t * msg, Buf buffer)
 {
 	xassert(msg != NULL);
-	packmem_array(msg->data, msg->data_size, buffer);
+	packmem_array_ref(msg->data, msg->data_size, buffer);
 }
 
 static int
@@ -4844,6 +5033,34 @@ unpack_error:
 	return SLURM_ERROR;
 }
 
+/* The job information delta response is a job information response holding
+ * the changed job records followed by the generation of the data, the full
+ * flag and the IDs of jobs removed since the requested generation */
+static int
+_unpack_job_info_delta_msg(job_info_delta_msg_t ** msg, Buf buffer,
+			   uint16_t protocol_version)
+{
+	job_info_delta_msg_t *delta_ptr;
+
+	xassert(msg != NULL);
+	delta_ptr = xmalloc(sizeof(job_info_delta_msg_t));
+	*msg = delta_ptr;
+
+	if (_unpack_job_info_msg(&delta_ptr->job_info, buffer,
+				 protocol_version))
+		goto unpack_error;
+	safe_unpack64(&delta_ptr->job_info->generation, buffer);
+	safe_unpack16(&delta_ptr->full, buffer);
+	safe_unpack32_array(&delta_ptr->removed_id, &delta_ptr->removed_cnt,
+			    buffer);
+	return SLURM_SUCCESS;
+
+unpack_error:
+	slurm_free_job_info_delta_msg(delta_ptr);
+	*msg = NULL;
+	return SLURM_ERROR;
+}
+
 static int
 _unpack_sicp_info_msg(sicp_info_msg_t ** msg, Buf buffer,
 		      uint16_t protocol_version)
@@ -8275,6 +8492,50 @@ unpack_error:
 	return SLURM_ERROR;
 }
 
+static void
+_pack_job_desc_multi_msg(job_desc_multi_msg_t * msg, Buf buffer,
+			 uint16_t protocol_version)
+{
+	int i;
+
+	xassert(msg != NULL);
+
+	pack32(msg->job_cnt, buffer);
+	for (i = 0; i < msg->job_cnt; i++)
+		_pack_job_desc_msg(msg->job_desc[i], buffer, protocol_version);
+}
+
+static int
+_unpack_job_desc_multi_msg(job_desc_multi_msg_t ** msg, Buf buffer,
+			   uint16_t protocol_version)
+{
+	job_desc_multi_msg_t *tmp_ptr;
+	uint32_t job_cnt;
+	int i;
+
+	xassert(msg != NULL);
+	tmp_ptr = xmalloc(sizeof(job_desc_multi_msg_t));
+	*msg = tmp_ptr;
+
+	safe_unpack32(&job_cnt, buffer);
+	/* Each job description takes far more than one byte */
+	if (job_cnt > remaining_buf(buffer))
+		goto unpack_error;
+	tmp_ptr->job_desc = xmalloc(sizeof(job_desc_msg_t *) * job_cnt);
+	for (i = 0; i < job_cnt; i++) {
+		if (_unpack_job_desc_msg(&tmp_ptr->job_desc[i], buffer,
+					 protocol_version))
+			goto unpack_error;
+		tmp_ptr->job_cnt++;
+	}
+	return SLURM_SUCCESS;
+
+unpack_error:
+	slurm_free_job_desc_multi_msg(tmp_ptr);
+	*msg = NULL;
+	return SLURM_ERROR;
+}
+
 static void
 _pack_job_alloc_info_msg(job_alloc_info_msg_t * job_desc_ptr, Buf buffer,
 			 uint16_t protocol_version)
@@ -9260,6 +9521,146 @@ unpack_error:
 	return SLURM_ERROR;
 }
 
+static void
+_pack_kill_jobs_msg(kill_jobs_msg_t * msg, Buf buffer,
+		    uint16_t protocol_version)
+{
+	xassert(msg != NULL);
+
+	packstr(msg->account, buffer);
+	pack16(msg->flags, buffer);
+	pack32_array(msg->job_id, msg->job_cnt, buffer);
+	packstr(msg->job_name, buffer);
+	packstr(msg->partition, buffer);
+	packstr(msg->qos, buffer);
+	packstr(msg->reservation, buffer);
+	pack16(msg->signal, buffer);
+	pack16(msg->state, buffer);
+	pack32(msg->user_id, buffer);
+}
+
+static int
+_unpack_kill_jobs_msg(kill_jobs_msg_t ** msg_ptr, Buf buffer,
+		      uint16_t protocol_version)
+{
+	kill_jobs_msg_t *msg;
+	uint32_t uint32_tmp;
+
+	xassert(msg_ptr != NULL);
+	msg = xmalloc(sizeof(kill_jobs_msg_t));
+	*msg_ptr = msg;
+
+	safe_unpackstr_xmalloc(&msg->account, &uint32_tmp, buffer);
+	safe_unpack16(&msg->flags, buffer);
+	safe_unpack32_array(&msg->job_id, &msg->job_cnt, buffer);
+	if (msg->job_cnt == 0)
+		xfree(msg->job_id);	/* No job list, use the filters */
+	safe_unpackstr_xmalloc(&msg->job_name, &uint32_tmp, buffer);
+	safe_unpackstr_xmalloc(&msg->partition, &uint32_tmp, buffer);
+	safe_unpackstr_xmalloc(&msg->qos, &uint32_tmp, buffer);
+	safe_unpackstr_xmalloc(&msg->reservation, &uint32_tmp, buffer);
+	safe_unpack16(&msg->signal, buffer);
+	safe_unpack16(&msg->state, buffer);
+	safe_unpack32(&msg->user_id, buffer);
+	return SLURM_SUCCESS;
+
+unpack_error:
+	slurm_free_kill_jobs_msg(msg);
+	*msg_ptr = NULL;
+	return SLURM_ERROR;
+}
+
+static void
+_pack_kill_jobs_resp_msg(kill_jobs_resp_msg_t * msg, Buf buffer,
+			 uint16_t protocol_version)
+{
+	xassert(msg != NULL);
+
+	pack32(msg->job_cnt, buffer);
+	pack32_array(msg->job_id, msg->err_cnt, buffer);
+	pack32_array(msg->error_code, msg->err_cnt, buffer);
+}
+
+static int
+_unpack_kill_jobs_resp_msg(kill_jobs_resp_msg_t ** msg_ptr, Buf buffer,
+			   uint16_t protocol_version)
+{
+	kill_jobs_resp_msg_t *msg;
+	uint32_t uint32_tmp;
+
+	xassert(msg_ptr != NULL);
+	msg = xmalloc(sizeof(kill_jobs_resp_msg_t));
+	*msg_ptr = msg;
+
+	safe_unpack32(&msg->job_cnt, buffer);
+	safe_unpack32_array(&msg->job_id, &msg->err_cnt, buffer);
+	safe_unpack32_array(&msg->error_code, &uint32_tmp, buffer);
+	if (uint32_tmp != msg->err_cnt)
+		goto unpack_error;
+	return SLURM_SUCCESS;
+
+unpack_error:
+	slurm_free_kill_jobs_resp_msg(msg);
+	*msg_ptr = NULL;
+	return SLURM_ERROR;
+}
+
+static void
+_pack_node_multi_msg(node_multi_msg_t * msg, Buf buffer,
+		     uint16_t protocol_version)
+{
+	slurm_msg_t sub_msg;
+	int i;
+
+	xassert(msg != NULL);
+
+	pack32(msg->msg_cnt, buffer);
+	for (i = 0; i < msg->msg_cnt; i++) {
+		pack16(msg->msg_type[i], buffer);
+		slurm_msg_t_init(&sub_msg);
+		sub_msg.msg_type = msg->msg_type[i];
+		sub_msg.protocol_version = protocol_version;
+		sub_msg.data = msg->msg_data[i];
+		pack_msg(&sub_msg, buffer);
+	}
+}
+
+static int
+_unpack_node_multi_msg(node_multi_msg_t ** msg_ptr, Buf buffer,
+		       uint16_t protocol_version)
+{
+	node_multi_msg_t *msg;
+	slurm_msg_t sub_msg;
+	int i;
+
+	xassert(msg_ptr != NULL);
+	msg = xmalloc(sizeof(node_multi_msg_t));
+	*msg_ptr = msg;
+
+	safe_unpack32(&msg->msg_cnt, buffer);
+	if (msg->msg_cnt > remaining_buf(buffer))
+		goto unpack_error;
+	msg->msg_type = xmalloc(sizeof(uint16_t) * msg->msg_cnt);
+	msg->msg_data = xmalloc(sizeof(void *) * msg->msg_cnt);
+	for (i = 0; i < msg->msg_cnt; i++) {
+		safe_unpack16(&msg->msg_type[i], buffer);
+		if (!node_multi_msg_type(msg->msg_type[i]))
+			goto unpack_error;
+		slurm_msg_t_init(&sub_msg);
+		sub_msg.msg_type = msg->msg_type[i];
+		sub_msg.protocol_version = protocol_version;
+		if (unpack_msg(&sub_msg, buffer) != SLURM_SUCCESS)
+			goto unpack_error;
+		msg->msg_data[i] = sub_msg.data;
+	}
+	return SLURM_SUCCESS;
+
+unpack_error:
+	slurm_free_node_multi_msg(msg);
+	*msg_ptr = NULL;
+	return SLURM_ERROR;
+}
+
 static void
 _pack_update_job_step_msg(step_update_request_msg_t * msg, Buf buffer,
 			  uint16_t protocol_version)
@@ -10177,6 +10578,33 @@ unpack_error:
 	return SLURM_ERROR;
 }
 
+static void
+_pack_delta_info_request_msg(delta_info_request_msg_t * msg, Buf buffer,
+			     uint16_t protocol_version)
+{
+	pack64(msg->generation, buffer);
+	pack16(msg->show_flags, buffer);
+}
+
+static int
+_unpack_delta_info_request_msg(delta_info_request_msg_t ** msg, Buf buffer,
+			       uint16_t protocol_version)
+{
+	delta_info_request_msg_t *delta_info;
+
+	delta_info = xmalloc(sizeof(delta_info_request_msg_t));
+	*msg = delta_info;
+
+	safe_unpack64(&delta_info->generation, buffer);
+	safe_unpack16(&delta_info->show_flags, buffer);
+	return SLURM_SUCCESS;
+
+unpack_error:
+	slurm_free_delta_info_request_msg(delta_info);
+	*msg = NULL;
+	return SLURM_ERROR;
+}
+
 static void
 _pack_node_info_single_msg(node_info_single_msg_t * msg, Buf buffer,
 			   uint16_t protocol_version)
@@ -12333,7 +12761,88 @@ static int  _unpack_stats_response_msg(stats_info_response_msg_t **msg_ptr,
 	msg = xmalloc ( sizeof (stats_info_response_msg_t) );
 	*msg_ptr = msg ;
 
-	if (protocol_version >= SLURM_14_11_PROTOCOL_VERSION) {
+	if (protocol_version >= SLURM_15_08_PROTOCOL_VERSION) {
+		safe_unpack32(&msg->parts_packed,	buffer);
+		if (msg->parts_packed) {
+			safe_unpack_time(&msg->req_time,	buffer);
+			safe_unpack_time(&msg->req_time_start,	buffer);
+			safe_unpack32(&msg->server_thread_count,buffer);
+			safe_unpack32(&msg->agent_queue_size,	buffer);
+			safe_unpack32(&msg->jobs_submitted,	buffer);
+			safe_unpack32(&msg->jobs_started,	buffer);
+			safe_unpack32(&msg->jobs_completed,	buffer);
+			safe_unpack32(&msg->jobs_canceled,	buffer);
+			safe_unpack32(&msg->jobs_failed,	buffer);
+
+			safe_unpack32(&msg->schedule_cycle_max,	buffer);
+			safe_unpack32(&msg->schedule_cycle_last,buffer);
+			safe_unpack32(&msg->schedule_cycle_sum,	buffer);
+			safe_unpack32(&msg->schedule_cycle_counter, buffer);
+			safe_unpack32(&msg->schedule_cycle_depth, buffer);
+			safe_unpack32(&msg->schedule_queue_len,	buffer);
+
+			safe_unpack32(&msg->bf_backfilled_jobs,	buffer);
+			safe_unpack32(&msg->bf_last_backfilled_jobs, buffer);
+			safe_unpack32(&msg->bf_cycle_counter,	buffer);
+			safe_unpack32(&msg->bf_cycle_sum,	buffer);
+			safe_unpack32(&msg->bf_cycle_last,	buffer);
+			safe_unpack32(&msg->bf_last_depth,	buffer);
+			safe_unpack32(&msg->bf_last_depth_try,	buffer);
+
+			safe_unpack32(&msg->bf_queue_len,	buffer);
+			safe_unpack32(&msg->bf_cycle_max,	buffer);
+			safe_unpack_time(&msg->bf_when_last_cycle, buffer);
+			safe_unpack32(&msg->bf_depth_sum,	buffer);
+			safe_unpack32(&msg->bf_depth_try_sum,	buffer);
+			safe_unpack32(&msg->bf_queue_len_sum,	buffer);
+			safe_unpack32(&msg->bf_active,		buffer);
+
+			safe_unpack32(&msg->lock_stat_size,	buffer);
+			safe_unpack32_array(&msg->lock_cnt, &uint32_tmp,
+					    buffer);
+			if (uint32_tmp != msg->lock_stat_size)
+				goto unpack_error;
+			safe_unpack64_array(&msg->lock_wait_time, &uint32_tmp,
+					    buffer);
+			if (uint32_tmp != msg->lock_stat_size)
+				goto unpack_error;
+			safe_unpack32_array(&msg->lock_wait_max, &uint32_tmp,
+					    buffer);
+			if (uint32_tmp != msg->lock_stat_size)
+				goto unpack_error;
+			safe_unpack32(&msg->lock_hist_size,	buffer);
+			safe_unpack32_array(&msg->lock_wait_hist, &uint32_tmp,
+					    buffer);
+			if (uint32_tmp != (msg->lock_stat_size *
+					   msg->lock_hist_size))
+				goto unpack_error;
+
+			safe_unpack32(&msg->job_hash_size,	buffer);
+			safe_unpack32(&msg->job_hash_cnt,	buffer);
+			safe_unpack64(&msg->job_hash_lookups,	buffer);
+			safe_unpack64(&msg->job_hash_probes,	buffer);
+			safe_unpack32(&msg->job_hash_probe_max,	buffer);
+
+			safe_unpack32(&msg->agent_count,	buffer);
+			safe_unpack32(&msg->agent_thread_count,	buffer);
+			safe_unpack64(&msg->agent_msg_count,	buffer);
+			safe_unpack32(&msg->agent_queue_max,	buffer);
+
+			safe_unpack32(&msg->bf_threads,		buffer);
+			safe_unpack64(&msg->bf_spec_tests,	buffer);
+			safe_unpack64(&msg->bf_spec_used,	buffer);
+		}
+
+		safe_unpack32(&msg->rpc_type_size,		buffer);
+		safe_unpack16_array(&msg->rpc_type_id,   &uint32_tmp, buffer);
+		safe_unpack32_array(&msg->rpc_type_cnt,  &uint32_tmp, buffer);
+		safe_unpack64_array(&msg->rpc_type_time, &uint32_tmp, buffer);
+
+		safe_unpack32(&msg->rpc_user_size,		buffer);
+		safe_unpack32_array(&msg->rpc_user_id,   &uint32_tmp, buffer);
+		safe_unpack32_array(&msg->rpc_user_cnt,  &uint32_tmp, buffer);
+		safe_unpack64_array(&msg->rpc_user_time, &uint32_tmp, buffer);
+	} else if (protocol_version >= SLURM_14_11_PROTOCOL_VERSION) {
 		safe_unpack32(&msg->parts_packed,	buffer);
 		if (msg->parts_packed) {
 			safe_unpack_time(&msg->req_time,	buffer);
@@ -48,10 +48,12 @@
 #include <string.h>
 #include <netdb.h>
 #include <errno.h>
+#include <limits.h>
 #include <netinet/in.h>
 #include <sys/poll.h>
 #include <sys/time.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <signal.h>
 #include <stdio.h>
 #include <stdarg.h>
@@ -81,6 +83,10 @@
 #define PORT_RETRIES    3
 #define MIN_USER_PORT   (IPPORT_RESERVED + 1)
 #define MAX_USER_PORT   0xffff
+
+#ifndef IOV_MAX
+#  define IOV_MAX	16	/* minimum permitted by POSIX */
+#endif
 #define RANDOM_USER_PORT ((uint16_t) ((lrand48() % \
 		(MAX_USER_PORT - MIN_USER_PORT + 1)) + MIN_USER_PORT))
 
@@ -98,8 +104,10 @@ static slurm_fd_t _slurm_create_socket ( slurm_socket_type_t type );
 static int _slurm_vfcntl(int fd, int cmd, va_list va );
 static int _slurm_fcntl(int fd, int cmd, ... );
 static int _slurm_socket (int __domain, int __type, int __protocol);
-static ssize_t _slurm_send (int __fd, __const void *__buf, size_t __n,
-			    int __flags);
+static ssize_t _msg_sendto_iov(slurm_fd_t fd, struct iovec *iov, int iov_cnt,
+			       uint32_t flags, int timeout);
+static ssize_t _slurm_sendmsg (int __fd, __const struct msghdr *__msg,
+			       int __flags);
 static ssize_t _slurm_recv (int __fd, void *__buf, size_t __n, int __flags);
 static int _slurm_setsockopt (int __fd, int __level, int __optname,
 			      __const void *__optval, socklen_t __optlen);
@@ -197,8 +205,30 @@ extern ssize_t slurm_msg_sendto(slurm_fd_t fd, char *buffer, size_t size,
 ssize_t slurm_msg_sendto_timeout(slurm_fd_t fd, char *buffer, size_t size,
 				 uint32_t flags, int timeout)
 {
-	int   len;
+	struct iovec iov;
+
+	iov.iov_base = buffer;
+	iov.iov_len = size;
+	return _msg_sendto_iov(fd, &iov, 1, flags, timeout);
+}
+
+extern ssize_t slurm_msg_sendto_iov(slurm_fd_t fd, struct iovec *iov,
+				    int iov_cnt, uint32_t flags)
+{
+	return _msg_sendto_iov(fd, iov, iov_cnt, flags,
+			       (slurm_get_msg_timeout() * 1000));
+}
+
+/* Send the length of a message and the message gathered from iov in one
+ * write where possible
+ * RET message size or SLURM_ERROR on error */
+static ssize_t _msg_sendto_iov(slurm_fd_t fd, struct iovec *iov, int iov_cnt,
+			       uint32_t flags, int timeout)
+{
+	int   i, len;
+	size_t size = 0;
 	uint32_t usize;
+	struct iovec *msg_iov;
 	SigFunc *ohandler;
 
 	/*
@@ -207,18 +237,20 @@ ssize_t slurm_msg_sendto_timeout(slurm_fd_t fd, char *buffer, size_t size,
 	 */
 	ohandler = xsignal(SIGPIPE, SIG_IGN);
 
+	msg_iov = xmalloc(sizeof(struct iovec) * (iov_cnt + 1));
+	for (i = 0; i < iov_cnt; i++) {
+		msg_iov[i + 1] = iov[i];
+		size += iov[i].iov_len;
+	}
 	usize = htonl(size);
+	msg_iov[0].iov_base = &usize;
+	msg_iov[0].iov_len = sizeof(usize);
 
-	if ((len = slurm_send_timeout(
-				fd, (char *)&usize, sizeof(usize), 0,
-				timeout)) < 0)
-		goto done;
-
-	if ((len = slurm_send_timeout(fd, buffer, size, 0, timeout)) < 0)
-		goto done;
+	len = slurm_send_iov_timeout(fd, msg_iov, iov_cnt + 1, 0, timeout);
+	if (len >= 0)
+		len -= sizeof(usize);
 
-
-     done:
+	xfree(msg_iov);
 	xsignal(SIGPIPE, ohandler);
 	return len;
 }
@@ -228,14 +260,32 @@ ssize_t slurm_msg_sendto_timeout(slurm_fd_t fd, char *buffer, size_t size,
 extern int slurm_send_timeout(slurm_fd_t fd, char *buf, size_t size,
 			      uint32_t flags, int timeout)
 {
-	int rc;
+	struct iovec iov;
+
+	iov.iov_base = buf;
+	iov.iov_len = size;
+	return slurm_send_iov_timeout(fd, &iov, 1, flags, timeout);
+}
+
+/* Send data gathered from iov with timeout, iov is modified as data is sent
+ * RET total data size or SLURM_ERROR on error */
+extern int slurm_send_iov_timeout(slurm_fd_t fd, struct iovec *iov,
+				  int iov_cnt, uint32_t flags, int timeout)
+{
+	int i, rc;
 	int sent = 0;
+	size_t size = 0;
 	int fd_flags;
 	struct pollfd ufds;
 	struct timeval tstart;
+	struct msghdr msg;
 	int timeleft = timeout;
 	char temp[2];
 
+	for (i = 0; i < iov_cnt; i++)
+		size += iov[i].iov_len;
+	memset(&msg, 0, sizeof(msg));
+
 	ufds.fd     = fd;
 	ufds.events = POLLOUT;
 
@@ -292,7 +342,14 @@ extern int slurm_send_timeout(slurm_fd_t fd, char *buf, size_t size,
 			      ufds.revents);
 		}
 
-		rc = _slurm_send(fd, &buf[sent], (size - sent), flags);
+		/* Skip buffers already sent */
+		while (iov_cnt && (iov->iov_len == 0)) {
+			iov++;
+			iov_cnt--;
+		}
+		msg.msg_iov = iov;
+		msg.msg_iovlen = MIN(iov_cnt, IOV_MAX);
+		rc = _slurm_sendmsg(fd, &msg, flags);
 		if (rc < 0) {
  			if (errno == EINTR)
 				continue;
@@ -316,6 +373,16 @@ extern int slurm_send_timeout(slurm_fd_t fd, char *buf, size_t size,
 		}
 
 		sent += rc;
+		for (i = 0; (i < iov_cnt) && (rc > 0); i++) {
+			if (rc >= iov[i].iov_len) {
+				rc -= iov[i].iov_len;
+				iov[i].iov_len = 0;
+			} else {
+				iov[i].iov_base = (char *) iov[i].iov_base + rc;
+				iov[i].iov_len -= rc;
+				rc = 0;
+			}
+		}
 	}
 
     done:
@@ -655,11 +722,12 @@ extern int slurm_getpeername (int __fd, struct sockaddr * __addr,
 	return getpeername ( __fd , __addr , __len ) ;
 }
 
-/* Send N bytes of BUF to socket FD.  Returns the number sent or -1.  */
-static ssize_t _slurm_send (int __fd, __const void *__buf, size_t __n,
-			    int __flags)
+/* Send the buffers described by MSG to socket FD.
+ * Returns the number sent or -1.  */
+static ssize_t _slurm_sendmsg (int __fd, __const struct msghdr *__msg,
+			       int __flags)
 {
-	return send ( __fd , __buf , __n , __flags ) ;
+	return sendmsg ( __fd , __msg , __flags ) ;
 }
 
 /* Read N bytes into BUF from socket FD.
@@ -56,6 +56,8 @@
 
 strong_alias(route_split_hostlist_treewidth,
 	     slurm_route_split_hostlist_treewidth);
+strong_alias(route_split_hostlist_adaptive,
+	     slurm_route_split_hostlist_adaptive);
 
 /* ************************************************************************** */
 /*  TAG(                        slurm_route_ops_t                          )  */
@@ -501,6 +503,44 @@ extern int route_split_hostlist_treewidth(hostlist_t hl,
 	return SLURM_SUCCESS;
 }
 
+/* ************************************************************************** */
+/*  TAG(                      route_split_hostlist_adaptive                )  */
+/* ************************************************************************** */
+/*
+ * route_split_hostlist_adaptive - logic to split an input hostlist into
+ *                                 a set of hostlists to forward to.
+ *
+ * IN: hl        - hostlist_t   - list of every node to send message to
+ *                                will be empty on return
+ * OUT: sp_hl    - hostlist_t** - the array of hostlists that will be malloced
+ * OUT: count    - int*         - the count of created hostlists
+ * RET: SLURM_SUCCESS - int
+ *
+ * Note: created hostlist will have to be freed independently using
+ *       hostlist_destroy by the caller.
+ * Note: the hostlist_t array will have to be xfree.
+ */
+extern int route_split_hostlist_adaptive(hostlist_t hl,
+					 hostlist_t** sp_hl,
+					 int* count)
+{
+	int j;
+	char *buf;
+
+	/* Record node history from the first message forwarded on */
+	forward_history_init();
+	forward_split_hostlist(hl, tree_width, sp_hl, count);
+	if (debug_flags & DEBUG_FLAG_ROUTE) {
+		for (j = 0; j < *count; j++) {
+			buf = hostlist_ranged_string_xmalloc((*sp_hl)[j]);
+			debug("ROUTE: ... sublist[%d] %s", j, buf);
+			xfree(buf);
+		}
+	}
+
+	return SLURM_SUCCESS;
+}
+
 /* ************************************************************************** */
 /*  TAG(                      route_next_collector                         )  */
 /* ************************************************************************** */
@@ -133,6 +133,28 @@ extern int route_split_hostlist_treewidth(hostlist_t hl,
 					  hostlist_t** sp_hl,
 					  int* count);
 
+/*
+ * route_split_hostlist_adaptive - logic to split an input hostlist into
+ *                                 a set of hostlists to forward to.
+ *
+ * The fan-out is chosen at each level of the tree, up to TreeWidth, and
+ * the forwarder of each sublist is chosen from the round trip time and
+ * failure history of the nodes, see forward_split_hostlist().
+ *
+ * IN: hl        - hostlist_t   - list of every node to send message to
+ *                                will be empty on return
+ * OUT: sp_hl    - hostlist_t** - the array of hostlists that will be malloced
+ * OUT: count    - int*         - the count of created hostlists
+ * RET: SLURM_SUCCESS - int
+ *
+ * Note: created hostlist will have to be freed independently using
+ *       hostlist_destroy by the caller.
+ * Note: the hostlist_t array will have to be xfree.
+ */
+extern int route_split_hostlist_adaptive(hostlist_t hl,
+					 hostlist_t** sp_hl,
+					 int* count);
+
 /*
  * route_next_collector - return address of next collector
  *
@@ -79,6 +79,7 @@
 
 /* bitstring.[ch] functions*/
 #define	bit_alloc		slurm_bit_alloc
+#define	bit_alloc_sparse	slurm_bit_alloc_sparse
 #define	bit_test		slurm_bit_test
 #define	bit_set			slurm_bit_set
 #define	bit_clear		slurm_bit_clear
@@ -92,6 +93,7 @@
 #define	bit_realloc		slurm_bit_realloc
 #define	bit_size		slurm_bit_size
 #define	bit_and			slurm_bit_and
+#define	bit_and_not		slurm_bit_and_not
 #define	bit_not			slurm_bit_not
 #define	bit_or			slurm_bit_or
 #define	bit_set_count		slurm_bit_set_count
@@ -117,6 +119,8 @@
 #define bit_noc			slurm_bit_noc
 #define bit_nffs		slurm_bit_nffs
 #define bit_copybits		slurm_bit_copybits
+#define	bit_overlap		slurm_bit_overlap
+#define	bit_overlap_any		slurm_bit_overlap_any
 
 /* fd.[ch] functions */
 #define fd_read_n		slurm_fd_read_n
@@ -138,6 +142,7 @@
 				slurm_hostlist_deranged_string_xmalloc
 #define	hostlist_destroy	slurm_hostlist_destroy
 #define	hostlist_find		slurm_hostlist_find
+#define	hostlist_for_each_range	slurm_hostlist_for_each_range
 #define	hostlist_iterator_create  slurm_hostlist_iterator_create
 #define	hostlist_iterator_destroy slurm_hostlist_iterator_destroy
 #define	hostlist_iterator_reset	slurm_hostlist_iterator_reset
@@ -148,6 +153,7 @@
 #define	hostlist_pop_range      slurm_hostlist_pop_range
 #define	hostlist_push		slurm_hostlist_push
 #define	hostlist_push_host	slurm_hostlist_push_host
+#define	hostlist_push_host_range	slurm_hostlist_push_host_range
 #define	hostlist_push_list	slurm_hostlist_push_list
 #define	hostlist_ranged_string	slurm_hostlist_ranged_string
 #define	hostlist_ranged_string_malloc \
@@ -235,6 +241,8 @@
 #define	free_buf		slurm_free_buf
 #define grow_buf		slurm_grow_buf
 #define	init_buf		slurm_init_buf
+#define	init_buf_refs		slurm_init_buf_refs
+#define	get_buf_iovec		slurm_get_buf_iovec
 #define	xfer_buf_data		slurm_xfer_buf_data
 #define	pack_time		slurm_pack_time
 #define	unpack_time		slurm_unpack_time
@@ -258,6 +266,7 @@
 #define	packstr_array		slurm_packstr_array
 #define	unpackstr_array		slurm_unpackstr_array
 #define	packmem_array		slurm_packmem_array
+#define	packmem_array_ref	slurm_packmem_array_ref
 #define	unpackmem_array		slurm_unpackmem_array
 
 /* env.[ch] functions */
@@ -391,6 +400,7 @@
 
 /* slurm_step_route.[ch] functions */
 #define route_split_hostlist_treewidth	slurm_route_split_hostlist_treewidth
+#define route_split_hostlist_adaptive	slurm_route_split_hostlist_adaptive
 
 
 #define eio_handle_create		slurm_eio_handle_create
@@ -2122,6 +2122,7 @@ extern int bb_p_job_begin(struct job_record *job_ptr)
 					"Burst buffer pre_run error");
 			job_ptr->state_reason = FAIL_BAD_CONSTRAINTS;
 			last_job_update = now;
+			JOB_DELTA_TOUCH(job_ptr);
 			bb_ptr->state = BB_STATE_TEARDOWN;
 			bb_ptr->state_time = now;
 			_queue_teardown(job_ptr->job_id, true);
@@ -335,6 +335,7 @@ static void _timeout_bb_rec(void)
 					job_ptr->state_desc = xstrdup(
 						"Burst buffer stage-in timeout");
 					last_job_update = now;
+					JOB_DELTA_TOUCH(job_ptr);
 				} else {
 					error("%s: StageIn timed out for "
 					      "vestigial job %u ",
@@ -70,6 +70,7 @@
 #include "src/common/xmalloc.h"
 #include "src/slurmctld/agent.h"
 #include "src/slurmctld/acct_policy.h"
+#include "src/slurmctld/job_scheduler.h"
 #include "src/slurmctld/slurmctld.h"
 #include "src/slurmctld/locks.h"
 #include "src/slurmd/slurmstepd/slurmstepd_job.h"
@@ -81,8 +82,12 @@
 #if defined (__APPLE__)
 void acct_policy_add_job_submit(struct job_record *job_ptr)
 	__attribute__((weak_import));
+uint32_t job_delta_next_gen __attribute__((weak_import)) = 1;
+bool job_delta_changed __attribute__((weak_import)) = false;
 #else
 void acct_policy_add_job_submit(struct job_record *job_ptr);
+uint32_t job_delta_next_gen = 1;
+bool job_delta_changed = false;
 #endif
 
 #define MAX_PATH_LEN 1024
@@ -634,7 +639,8 @@ static void _requeue_when_finished(uint32_t job_id)
 		lock_slurmctld(job_write_lock);
 		job_ptr = find_job_record(job_id);
 		if (IS_JOB_FINISHED(job_ptr)) {
-			job_ptr->job_state = JOB_PENDING;
+			JOB_STATE_SET(job_ptr, JOB_PENDING);
+			pend_job_add(job_ptr);
 			job_ptr->details->submit_time = time(NULL);
 			job_ptr->restart_cnt++;
 			/* Since the job completion logger
@@ -50,6 +50,7 @@
 #  include <stdint.h>
 #endif /* HAVE_CONFIG_H */
 
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -67,6 +68,8 @@
 
 #define RETRY_COUNT		20
 #define RETRY_USEC		100000
+#define SIGN_THREADS		8	/* concurrent munge_encode() calls by
+					 * crypto_sign_batch() */
 
 /*
  * These variables are required by the generic plugin interface.  If they
@@ -257,20 +260,123 @@ crypto_str_error(int errnum)
 		return munge_strerror ((munge_err_t) errnum);
 }
 
+typedef struct sign_batch {
+	munge_ctx_t ctx;
+	pthread_mutex_t *mutex;
+	int *next;		/* next buffer to sign, protected by mutex */
+	int cnt;
+	char **buffers;
+	int *buf_sizes;
+	char **sig_pp;
+	unsigned int *sig_size_p;
+	int rc;
+} sign_batch_t;
+
+static int _sign(munge_ctx_t ctx, char *buffer, int buf_size, char **sig_pp,
+		 unsigned int *sig_size_p);
+
 /* NOTE: Caller must xfree the signature returned by sig_pp */
 extern int
 crypto_sign(void * key, char *buffer, int buf_size, char **sig_pp,
 	    unsigned int *sig_size_p)
 {
-	int retry = RETRY_COUNT, auth_ttl;
-	char *cred;
-	munge_err_t err;
+	int auth_ttl;
+	munge_ctx_t ctx = (munge_ctx_t) key;
+
+	auth_ttl = slurm_get_auth_ttl();
+	if (auth_ttl)
+		(void) munge_ctx_set(ctx, MUNGE_OPT_TTL, auth_ttl);
+
+	return _sign(ctx, buffer, buf_size, sig_pp, sig_size_p);
+}
+
+static void *_sign_thread(void *arg)
+{
+	sign_batch_t *batch = (sign_batch_t *) arg;
+	int i, rc;
+
+	while (1) {
+		slurm_mutex_lock(batch->mutex);
+		i = (*batch->next)++;
+		slurm_mutex_unlock(batch->mutex);
+		if (i >= batch->cnt)
+			break;
+		rc = _sign(batch->ctx, batch->buffers[i], batch->buf_sizes[i],
+			   &batch->sig_pp[i], &batch->sig_size_p[i]);
+		if (rc)
+			batch->rc = rc;
+	}
+	return NULL;
+}
+
+/*
+ * Sign cnt buffers. Each munge_encode() call is a round trip to munged,
+ * so up to SIGN_THREADS signatures are requested concurrently, each thread
+ * using its own copy of the munge context.
+ * NOTE: Caller must xfree the signatures returned by sig_pp
+ */
+extern int
+crypto_sign_batch(void *key, int cnt, char **buffers, int *buf_sizes,
+		  char **sig_pp, unsigned int *sig_size_p)
+{
 	munge_ctx_t ctx = (munge_ctx_t) key;
+	pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+	pthread_attr_t attr;
+	pthread_t thread_id[SIGN_THREADS];
+	sign_batch_t batch[SIGN_THREADS];
+	int auth_ttl, i, next = 0, rc = 0, thread_cnt;
 
 	auth_ttl = slurm_get_auth_ttl();
 	if (auth_ttl)
 		(void) munge_ctx_set(ctx, MUNGE_OPT_TTL, auth_ttl);
 
+	thread_cnt = MIN(cnt, SIGN_THREADS);
+	slurm_attr_init(&attr);
+	for (i = 0; i < thread_cnt; i++) {
+		batch[i].ctx        = NULL;
+		batch[i].mutex      = &mutex;
+		batch[i].next       = &next;
+		batch[i].cnt        = cnt;
+		batch[i].buffers    = buffers;
+		batch[i].buf_sizes  = buf_sizes;
+		batch[i].sig_pp     = sig_pp;
+		batch[i].sig_size_p = sig_size_p;
+		batch[i].rc         = 0;
+		thread_id[i]        = 0;
+		if ((i == 0) || !(batch[i].ctx = munge_ctx_copy(ctx)))
+			continue;
+		if (pthread_create(&thread_id[i], &attr, _sign_thread,
+				   &batch[i])) {
+			thread_id[i] = 0;
+			munge_ctx_destroy(batch[i].ctx);
+			batch[i].ctx = NULL;
+		}
+	}
+	slurm_attr_destroy(&attr);
+
+	/* This thread signs with the original context */
+	batch[0].ctx = ctx;
+	_sign_thread(&batch[0]);
+
+	for (i = 0; i < thread_cnt; i++) {
+		if (thread_id[i])
+			pthread_join(thread_id[i], NULL);
+		if (i && batch[i].ctx)
+			munge_ctx_destroy(batch[i].ctx);
+		if (batch[i].rc)
+			rc = batch[i].rc;
+	}
+
+	return rc;
+}
+
+static int _sign(munge_ctx_t ctx, char *buffer, int buf_size, char **sig_pp,
+		 unsigned int *sig_size_p)
+{
+	int retry = RETRY_COUNT;
+	char *cred;
+	munge_err_t err;
+
     again:
 	err = munge_encode(&cred, ctx, buffer, buf_size);
 	if (err != EMUNGE_SUCCESS) {
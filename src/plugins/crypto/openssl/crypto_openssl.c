@@ -207,6 +207,24 @@ crypto_sign(void * key, char *buffer, int buf_size, char **sig_pp,
 	return rc;
 }
 
+/* Signing with a local key costs no round trip, so sign in turn.
+ * NOTE: Caller must xfree the signatures returned by sig_pp */
+extern int
+crypto_sign_batch(void *key, int cnt, char **buffers, int *buf_sizes,
+		  char **sig_pp, unsigned int *sig_size_p)
+{
+	int i, rc = SLURM_SUCCESS;
+
+	for (i = 0; i < cnt; i++) {
+		if (crypto_sign(key, buffers[i], buf_sizes[i], &sig_pp[i],
+				&sig_size_p[i]) != SLURM_SUCCESS) {
+			xfree(sig_pp[i]);
+			rc = SLURM_ERROR;
+		}
+	}
+	return rc;
+}
+
 extern int
 crypto_verify_sign(void * key, char *buffer, unsigned int buf_size,
 		char *signature, unsigned int sig_size)
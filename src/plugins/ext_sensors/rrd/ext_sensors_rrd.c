@@ -450,6 +450,7 @@ static int _update_node_data(void)
 	if (ext_sensors_cnf->dataopts & EXT_SENSORS_OPT_NODE_ENERGY) {
 		for (i=0; i < node_record_count; i++) {
 			ext_sensors = node_record_table_ptr[i].ext_sensors;
+			NODE_DELTA_TOUCH(node_record_table_ptr + i);
 			if (ext_sensors->energy_update_time == 0) {
 				ext_sensors->energy_update_time = now;
 				ext_sensors->consumed_energy = 0;
@@ -489,6 +490,7 @@ static int _update_node_data(void)
 	if (ext_sensors_cnf->dataopts & EXT_SENSORS_OPT_NODE_TEMP) {
 		for (i=0; i < node_record_count; i++) {
 			ext_sensors = node_record_table_ptr[i].ext_sensors;
+			NODE_DELTA_TOUCH(node_record_table_ptr + i);
 			if (!(path = _get_node_rrd_path(
 				      node_record_table_ptr[i].name,
 				      EXT_SENSORS_VALUE_TEMPERATURE))) {
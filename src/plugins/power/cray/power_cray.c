@@ -78,10 +78,14 @@
 struct node_record *node_record_table_ptr __attribute__((weak_import)) = NULL;
 List job_list __attribute__((weak_import)) = NULL;
 int node_record_count __attribute__((weak_import)) = 0;
+uint32_t node_delta_next_gen __attribute__((weak_import)) = 1;
+bool node_delta_changed __attribute__((weak_import)) = false;
 #else
 struct node_record *node_record_table_ptr = NULL;
 List job_list = NULL;
 int node_record_count = 0;
+uint32_t node_delta_next_gen = 1;
+bool node_delta_changed = false;
 #endif
 
 typedef struct power_config_nodes {
@@ -743,6 +747,7 @@ static void _get_caps(void)
 					xmalloc(sizeof(power_mgmt_data_t));
 			}
 			node_ptr->power->cap_watts = ents[i].cap_watts;
+			NODE_DELTA_TOUCH(node_ptr);
 		}
 		xfree(ents[i].node_name[0]);
 		xfree(ents[i].node_name);
@@ -1599,6 +1604,7 @@ static void _set_power_caps(void)
 		     node_ptr->power->new_cap_watts))
 			continue;
 		node_ptr->power->cap_watts = node_ptr->power->new_cap_watts;
+		NODE_DELTA_TOUCH(node_ptr);
 		if (json)
 			xstrcat(json, ",\n ");
 		else
@@ -1639,6 +1645,7 @@ static void _set_power_caps(void)
 		     node_ptr->power->new_cap_watts))
 			continue;
 		node_ptr->power->cap_watts = node_ptr->power->new_cap_watts;
+		NODE_DELTA_TOUCH(node_ptr);
 		if (json)
 			xstrcat(json, ",\n ");
 		else
@@ -100,6 +100,7 @@ static void _ft_decay_apply_new_usage(struct job_record *job, time_t *start)
 
 	set_priority_factors(*start, job);
 	last_job_update = time(NULL);
+	JOB_DELTA_TOUCH(job);
 }
 
 
@@ -92,6 +92,8 @@ void *acct_db_conn  __attribute__((weak_import)) = NULL;
 uint32_t cluster_cpus __attribute__((weak_import)) = NO_VAL;
 List job_list  __attribute__((weak_import)) = NULL;
 time_t last_job_update __attribute__((weak_import)) = (time_t) 0;
+uint32_t job_delta_next_gen __attribute__((weak_import)) = 1;
+bool job_delta_changed __attribute__((weak_import)) = false;
 uint16_t part_max_priority __attribute__((weak_import)) = 0;
 slurm_ctl_conf_t slurmctld_conf __attribute__((weak_import));
 #else
@@ -99,6 +101,8 @@ void *acct_db_conn = NULL;
 uint32_t cluster_cpus = NO_VAL;
 List job_list = NULL;
 time_t last_job_update = (time_t) 0;
+uint32_t job_delta_next_gen = 1;
+bool job_delta_changed = false;
 uint16_t part_max_priority = 0;
 slurm_ctl_conf_t slurmctld_conf;
 #endif
@@ -1128,6 +1132,7 @@ static void _ticket_based_decay(List job_list, time_t start_time)
 
 		job_ptr->priority = _get_priority_internal(start_time, job_ptr);
 		last_job_update = time(NULL);
+		JOB_DELTA_TOUCH(job_ptr);
 		debug2("priority for job %u is now %u",
 		       job_ptr->job_id, job_ptr->priority);
 	}
@@ -1881,6 +1886,7 @@ extern void decay_apply_weighted_factors(struct job_record *job_ptr,
 
 	job_ptr->priority = _get_priority_internal(*start_time_ptr, job_ptr);
 	last_job_update = time(NULL);
+	JOB_DELTA_TOUCH(job_ptr);
 	debug2("priority for job %u is now %u",
 	       job_ptr->job_id, job_ptr->priority);
 
@@ -0,0 +1,160 @@
+/*****************************************************************************\
+ *  route_adaptive.c - adaptive version of route plugin, chooses the fan-out
+ *	and forwarding nodes from the response history of the nodes
+ *****************************************************************************
+ *  Copyright (C) 2015 SchedMD LLC.
+ *
+ *  This file is part of SLURM, a resource management program.
+ *  For details, see <http://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  SLURM is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  SLURM is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with SLURM; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#if     HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <signal.h>
+#include <sys/types.h>
+
+#include "slurm/slurm_errno.h"
+#include "src/common/slurm_xlator.h"
+#include "src/common/forward.h"
+#include "src/common/node_conf.h"
+#include "src/common/slurm_protocol_defs.h"
+
+/*
+ * These variables are required by the generic plugin interface.  If they
+ * are not found in the plugin, the plugin loader will ignore it.
+ *
+ * plugin_name - a string giving a human-readable description of the
+ * plugin.  There is no maximum length, but the symbol must refer to
+ * a valid string.
+ *
+ * plugin_type - a string suggesting the type of the plugin or its
+ * applicability to a particular form of data or method of data handling.
+ * If the low-level plugin API is used, the contents of this string are
+ * unimportant and may be anything.  SLURM uses the higher-level plugin
+ * interface which requires this string to be of the form
+ *
+ *      <application>/<method>
+ *
+ * where <application> is a description of the intended application of
+ * the plugin (e.g., "task" for task control) and <method> is a description
+ * of how this plugin satisfies that application.  SLURM will only load
+ * a task plugin if the plugin_type string has a prefix of "task/".
+ *
+ * plugin_version - an unsigned 32-bit integer giving the version number
+ * of the plugin.  If major and minor revisions are desired, the major
+ * version number may be multiplied by a suitable magnitude constant such
+ * as 100 or 1000.  Various SLURM versions will likely require a certain
+ * minimum version for their plugins as this API matures.
+ */
+const char plugin_name[]        = "route adaptive plugin";
+const char plugin_type[]        = "route/adaptive";
+const uint32_t plugin_version   = 101;
+
+
+/*****************************************************************************\
+ *  Functions required of all plugins
+\*****************************************************************************/
+/*
+ * init() is called when the plugin is loaded, before any other functions
+ *	are called.  Put global initialization here.
+ */
+extern int init(void)
+{
+	verbose("%s loaded", plugin_name);
+	return SLURM_SUCCESS;
+}
+/*
+ * fini() is called when the plugin is removed. Clear any allocated
+ *	storage here.
+ */
+extern int fini(void)
+{
+	return SLURM_SUCCESS;
+}
+
+/*****************************************************************************\
+ *  Plugin API Implementations
+\*****************************************************************************/
+
+/*
+ * route_p_split_hostlist  - logic to split an input hostlist into
+ *                           a set of hostlists to forward to.
+ *
+ * IN: hl        - hostlist_t   - list of every node to send message to
+ *                                will be empty on return;
+ * OUT: sp_hl    - hostlist_t** - the array of hostlist that will be malloced
+ * OUT: count    - int*         - the count of created hostlist
+ * RET: SLURM_SUCCESS - int
+ *
+ * Note: created hostlist will have to be freed independently using
+ *       hostlist_destroy by the caller.
+ * Note: the hostlist_t array will have to be xfree.
+ */
+extern int route_p_split_hostlist(hostlist_t hl,
+				  hostlist_t** sp_hl,
+				  int* count)
+{
+	return route_split_hostlist_adaptive(hl, sp_hl, count);
+}
+
+/*
+ * route_g_reconfigure - reset during reconfigure
+ *
+ * RET: SLURM_SUCCESS - int
+ */
+extern int route_p_reconfigure (void)
+{
+	return SLURM_SUCCESS;
+}
+
+/*
+ * route_p_next_collector - return address of next collector
+ *
+ * IN: is_collector - bool* - flag indication if this node is a collector
+ *
+ * RET: slurm_addr_t* - address of node to send messages to be aggregated.
+ */
+extern slurm_addr_t* route_p_next_collector ( bool *is_collector )
+{
+	return route_next_collector(is_collector);
+}
+
+/*
+ * route_g_next_collector_backup
+ *
+ * RET: slurm_addr_t* - address of backup node to send messages to be aggregated.
+ */
+extern slurm_addr_t* route_p_next_collector_backup ( void )
+{
+	return route_next_collector_backup();
+}
+
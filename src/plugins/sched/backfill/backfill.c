@@ -98,6 +98,10 @@
 #define BF_MAX_USERS		1000
 #define BF_MAX_JOB_ARRAY_RESV	20
 
+#define BF_MAX_THREADS		64
+#define BF_SPEC_PER_THREAD	4	/* jobs per thread in each batch */
+#define BF_SHAPE_HASH_SIZE	1024
+
 #define SLURMCTLD_THREAD_LIMIT	5
 #define SCHED_TIMEOUT		2000000	/* time in micro-seconds */
 #define YIELD_SLEEP		500000;	/* time in micro-seconds */
@@ -109,6 +113,92 @@ typedef struct node_space_map {
 	int next;	/* next record, by time, zero termination */
 } node_space_map_t;
 
+/* A job tested by a backfill worker thread ahead of the main loop reaching
+ * it. The result is used only if the main loop tests the job with identical
+ * input, otherwise the job is tested again. */
+typedef struct bf_spec {
+	struct job_record *job_ptr;
+	struct part_record *part_ptr;
+	uint32_t time_limit;
+	uint32_t min_nodes;
+	uint32_t max_nodes;
+	uint32_t req_nodes;
+	bitstr_t *test_bitmap;		/* nodes offered to _try_sched */
+	bitstr_t *exc_core_bitmap;
+	/* Results of _try_sched */
+	int rc;
+	bitstr_t *avail_bitmap;
+	time_t start_time;
+	uint32_t total_cpus;
+	bool best_switch;
+} bf_spec_t;
+
+/* Resource request of a job which found no start time within the backfill
+ * window in this pass. Reservations made later in the pass only remove
+ * nodes from node_space, so jobs behind it with an identical request get
+ * the same result without being tested again. Cleared whenever the locks
+ * are released, since running jobs may end. */
+typedef struct bf_shape_key {
+	struct part_record *part_ptr;
+	slurmdb_qos_rec_t *qos_ptr;	/* QOS flags and limits */
+	uint32_t time_limit;
+	uint32_t min_nodes;
+	uint32_t max_nodes;
+	uint32_t req_nodes;
+	uint32_t min_cpus;
+	uint32_t max_cpus;
+	uint32_t num_tasks;
+	uint32_t pn_min_cpus;
+	uint32_t pn_min_memory;
+	uint32_t pn_min_tmp_disk;
+	uint16_t contiguous;
+	uint16_t core_spec;
+	uint16_t cpus_per_task;
+	uint16_t ntasks_per_node;
+	uint16_t plane_size;
+	uint16_t task_dist;
+	uint8_t overcommit;
+	uint8_t share_res;
+	uint8_t whole_node;
+	bool mc_set;
+	multi_core_data_t mc;
+} bf_shape_key_t;
+
+typedef struct bf_shape {
+	bf_shape_key_t key;
+	uint32_t hash;
+	char *features;
+	char *gres;
+	char *network;
+	bitstr_t *exc_node_bitmap;
+	bitstr_t *req_node_bitmap;
+	uint32_t job_id;		/* job which was tested */
+	time_t start_time;		/* expected start, 0 if not runable */
+	struct bf_shape *next;
+} bf_shape_t;
+
+/* A job tested by backfill, in the order tested. With bf_incremental, the
+ * next pass replays the start time and node reservation of each job while
+ * the job queue and job requests match those tested and nothing else has
+ * changed, then tests jobs from the first difference on. */
+typedef struct bf_plan {
+	uint32_t job_id;
+	struct part_record *part_ptr;
+	uint32_t req_hash;		/* hash of the job's request */
+	time_t start_time;		/* expected start time */
+	uint32_t resv_start;		/* reservation added to node_space */
+	uint32_t resv_end;
+	bitstr_t *resv_bitmap;		/* nodes not reserved, NULL if none */
+} bf_plan_t;
+
+/* Nodes of a partition which are up and not completing. Built when a job in
+ * the partition is first tested and cleared whenever the locks are released,
+ * since node states may change. */
+typedef struct bf_part_nodes {
+	struct part_record *part_ptr;
+	bitstr_t *node_bitmap;
+} bf_part_nodes_t;
+
 /* Diag statistics */
 extern diag_stats_t slurmctld_diag_stats;
 int bf_last_yields = 0;
@@ -134,6 +224,35 @@ static bool backfill_continue = false;
 static int defer_rpc_cnt = 0;
 static int sched_timeout = SCHED_TIMEOUT;
 static int yield_sleep   = YIELD_SLEEP;
+static int bf_threads = 1;
+static bool bf_spec_ok = false;	/* select plugin safe to call in parallel */
+static bf_spec_t *bf_spec = NULL;
+static int bf_spec_cnt = 0, bf_spec_next = 0;
+static pthread_mutex_t bf_spec_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Index of the node_space records in time order. ns_tree is a segment tree
+ * over the records: ns_tree[ns_size + i] is the avail_bitmap of record
+ * ns_rec[i] and ns_tree[i] (i < ns_size) is the AND of its two children, so
+ * the nodes available over any span of records are found with O(log n)
+ * bitmap operations. ns_cnt is zero when node_space changed since the index
+ * was built. The tree is only built once the linear scans done since the
+ * last change would have paid for it. */
+static int ns_cnt = 0, ns_rec_size = 0, ns_size = 0;
+static int *ns_rec = NULL;
+static bitstr_t **ns_tree = NULL;
+static bool ns_tree_valid = false;
+static int ns_linear_ops = 0;
+static bf_shape_t **bf_shape_hash = NULL;
+static int bf_incremental = 0;		/* maximum plan age in seconds */
+static bf_plan_t *bf_plan = NULL;
+static int bf_plan_cnt = 0, bf_plan_size = 0;
+static bool bf_plan_open = false;	/* recording jobs tested */
+static bool bf_plan_cur = false;	/* bf_plan[bf_plan_cnt] being tested */
+static time_t bf_plan_start = 0;	/* start of first pass of the plan */
+static time_t bf_plan_config = 0, bf_plan_node = 0;
+static time_t bf_plan_part = 0, bf_plan_resv = 0;
+static bf_part_nodes_t *bf_part_nodes = NULL;
+static int bf_part_nodes_cnt = 0, bf_part_nodes_size = 0;
 
 /*********************** local functions *********************/
 static void _add_reservation(uint32_t start_time, uint32_t end_reserve,
@@ -141,6 +260,23 @@ static void _add_reservation(uint32_t start_time, uint32_t end_reserve,
 			     node_space_map_t *node_space,
 			     int *node_space_recs);
 static int  _attempt_backfill(void);
+static bool _bf_avail_nodes(struct job_record *job_ptr,
+			    struct part_record *part_ptr,
+			    node_space_map_t *node_space, time_t start_res,
+			    uint32_t end_time, uint32_t min_nodes,
+			    bitstr_t *non_cg_bitmap, bitstr_t *avail_bitmap,
+			    time_t *later_start);
+static bool _bf_node_limits(struct job_record *job_ptr,
+			    struct part_record *part_ptr, uint32_t *min_nodes,
+			    uint32_t *max_nodes, uint32_t *req_nodes);
+static bool _bf_time_limit(struct job_record *job_ptr,
+			   struct part_record *part_ptr, uint32_t *time_limit,
+			   uint32_t *comp_time_limit);
+static int  _bf_try_sched(struct job_record *job_ptr, bitstr_t **avail_bitmap,
+			  uint32_t min_nodes, uint32_t max_nodes,
+			  uint32_t req_nodes, bitstr_t *exc_core_bitmap,
+			  List job_queue, node_space_map_t *node_space,
+			  bitstr_t *non_cg_bitmap, time_t now);
 static void _clear_job_start_times(void);
 static int  _delta_tv(struct timeval *tv);
 static bool _job_is_completing(void);
@@ -150,9 +286,37 @@ static void _load_config(void);
 static bool _many_pending_rpcs(void);
 static bool _more_work(time_t last_backfill_time);
 static void _my_sleep(int usec);
+static void _ns_and(node_space_map_t *node_space, time_t start_res,
+		    time_t end_time, bitstr_t *avail_bitmap,
+		    time_t *later_start);
+static void _ns_free(void);
+static bitstr_t *_part_nodes(struct part_record *part_ptr,
+			     bitstr_t *non_cg_bitmap);
+static void _part_nodes_clear(void);
+static void _plan_add(struct job_record *job_ptr,
+		      struct part_record *part_ptr);
+static bool _plan_begin(time_t sched_start);
+static void _plan_commit(struct job_record *job_ptr);
+static bool _plan_replay(struct job_record *job_ptr,
+			 struct part_record *part_ptr, int inx,
+			 node_space_map_t *node_space, int *node_space_recs);
+static void _plan_resv(uint32_t start_time, uint32_t end_reserve,
+		       bitstr_t *res_bitmap);
+static void _plan_stop(void);
+static void _plan_truncate(int cnt);
 static int  _num_feature_count(struct job_record *job_ptr);
 static void _reset_job_time_limit(struct job_record *job_ptr, time_t now,
 				  node_space_map_t *node_space);
+static void _shape_add(bf_shape_key_t *key, uint32_t hash,
+		       struct job_record *job_ptr, time_t start_time);
+static void _shape_clear(void);
+static bf_shape_t *_shape_find(struct job_record *job_ptr,
+			       struct part_record *part_ptr,
+			       uint32_t time_limit, uint32_t min_nodes,
+			       uint32_t max_nodes, uint32_t req_nodes,
+			       bf_shape_key_t *key, uint32_t *hash);
+static void _spec_clear(void);
+static void _spec_drop(struct job_record *job_ptr);
 static int  _start_job(struct job_record *job_ptr, bitstr_t *avail_bitmap);
 static bool _test_resv_overlap(node_space_map_t *node_space,
 			       bitstr_t *use_bitmap, uint32_t start_time,
@@ -212,6 +376,131 @@ static void _dump_node_space_table(node_space_map_t *node_space_ptr)
 	info("=========================================");
 }
 
+/* Index node_space records in time order */
+static void _ns_index(node_space_map_t *node_space)
+{
+	int j;
+
+	ns_cnt = 0;
+	for (j = 0; ; ) {
+		if (ns_cnt >= ns_rec_size) {
+			ns_rec_size = MAX(ns_rec_size * 2, 64);
+			xrealloc(ns_rec, sizeof(int) * ns_rec_size);
+		}
+		ns_rec[ns_cnt++] = j;
+		if ((j = node_space[j].next) == 0)
+			break;
+	}
+	ns_tree_valid = false;
+	ns_linear_ops = 0;
+}
+
+/* Build the segment tree over the indexed node_space records */
+static void _ns_build_tree(node_space_map_t *node_space)
+{
+	bitstr_t *left;
+	int first, i, last, size = 1, span;
+
+	while (size < ns_cnt)
+		size *= 2;
+	if (size != ns_size) {
+		for (i = 1; i < ns_size; i++)
+			FREE_NULL_BITMAP(ns_tree[i]);
+		xfree(ns_tree);
+		ns_tree = xmalloc(sizeof(bitstr_t *) * size * 2);
+		ns_size = size;
+	}
+	for (i = 0; i < ns_cnt; i++)
+		ns_tree[ns_size + i] = node_space[ns_rec[i]].avail_bitmap;
+
+	/* Only nodes covering at least one record are built */
+	for (first = ns_size / 2, span = 2; first; first /= 2, span *= 2) {
+		last = first + (ns_cnt + span - 1) / span;
+		for (i = first; i < last; i++) {
+			left = ns_tree[i * 2];
+			if (!ns_tree[i] ||
+			    (bit_size(ns_tree[i]) != bit_size(left))) {
+				FREE_NULL_BITMAP(ns_tree[i]);
+				ns_tree[i] = bit_copy(left);
+			} else
+				bit_copybits(ns_tree[i], left);
+			if (((i - first) * span + span / 2) < ns_cnt)
+				bit_and(ns_tree[i], ns_tree[i * 2 + 1]);
+		}
+	}
+	ns_tree_valid = true;
+}
+
+/* AND avail_bitmap with the nodes available in every node_space record
+ * overlapping start_res through end_time.
+ * later_start IN/OUT - if zero, set to the end of the first such record
+ *	unless it is the last one */
+static void _ns_and(node_space_map_t *node_space, time_t start_res,
+		    time_t end_time, bitstr_t *avail_bitmap,
+		    time_t *later_start)
+{
+	int first, hi, i, last, lo, mid;
+
+	if (ns_cnt == 0)
+		_ns_index(node_space);
+
+	lo = 0;
+	hi = ns_cnt;
+	while (lo < hi) {	/* First record ending after start_res */
+		mid = (lo + hi) / 2;
+		if (node_space[ns_rec[mid]].end_time > start_res)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+	if ((first = lo) >= ns_cnt)
+		return;
+	if ((first < (ns_cnt - 1)) && (*later_start == 0))
+		*later_start = node_space[ns_rec[first]].end_time;
+
+	hi = ns_cnt;
+	while (lo < hi) {	/* First record beginning after end_time */
+		mid = (lo + hi) / 2;
+		if (node_space[ns_rec[mid]].begin_time > end_time)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+	if ((last = lo - 1) < first)
+		return;
+
+	if (!ns_tree_valid && (ns_linear_ops < (ns_cnt * 2))) {
+		for (i = first; i <= last; i++) {
+			bit_and(avail_bitmap,
+				node_space[ns_rec[i]].avail_bitmap);
+		}
+		ns_linear_ops += last - first + 1;
+		return;
+	}
+	if (!ns_tree_valid)
+		_ns_build_tree(node_space);
+
+	for (first += ns_size, last += ns_size + 1; first < last;
+	     first /= 2, last /= 2) {
+		if (first & 1)
+			bit_and(avail_bitmap, ns_tree[first++]);
+		if (last & 1)
+			bit_and(avail_bitmap, ns_tree[--last]);
+	}
+}
+
+static void _ns_free(void)
+{
+	int i;
+
+	for (i = 1; i < ns_size; i++)
+		FREE_NULL_BITMAP(ns_tree[i]);
+	xfree(ns_tree);
+	xfree(ns_rec);
+	ns_cnt = ns_rec_size = ns_size = 0;
+	ns_tree_valid = false;
+}
+
 /*
  * _job_is_completing - Determine if jobs are in the process of completing.
  *	This is a variant of job_is_completing in slurmctld/job_scheduler.c.
@@ -448,7 +737,7 @@ static void _my_sleep(int usec)
 
 static void _load_config(void)
 {
-	char *sched_params, *tmp_ptr;
+	char *sched_params, *select_type, *tmp_ptr;
 
 	sched_params = slurm_get_sched_params();
 	debug_flags  = slurm_get_debug_flags();
@@ -563,7 +852,41 @@ static void _load_config(void)
 		defer_rpc_cnt = 0;
 	}
 
+	if (sched_params &&
+	    (tmp_ptr=strstr(sched_params, "bf_incremental=")))
+		bf_incremental = atoi(tmp_ptr + 15);
+	else
+		bf_incremental = 0;
+	if (bf_incremental < 0) {
+		error("Invalid SchedulerParameters bf_incremental: %d",
+		      bf_incremental);
+		bf_incremental = 0;
+	}
+
+	if (sched_params && (tmp_ptr=strstr(sched_params, "bf_threads=")))
+		bf_threads = atoi(tmp_ptr + 11);
+	else
+		bf_threads = 1;
+	if ((bf_threads < 1) || (bf_threads > BF_MAX_THREADS)) {
+		error("Invalid SchedulerParameters bf_threads: %d",
+		      bf_threads);
+		bf_threads = 1;
+	}
+
 	xfree(sched_params);
+
+	/* Other select plugins keep state which select_g_job_test() changes
+	 * even when only testing when a job could start */
+	select_type = slurm_get_select_type();
+	if (!strcmp(select_type, "select/cons_res") ||
+	    !strcmp(select_type, "select/linear")   ||
+	    !strcmp(select_type, "select/serial"))
+		bf_spec_ok = true;
+	else
+		bf_spec_ok = false;
+	if ((bf_threads > 1) && !bf_spec_ok)
+		info("backfill: bf_threads not supported with %s", select_type);
+	xfree(select_type);
 }
 
 /* Note that slurm.conf has changed */
@@ -680,6 +1003,10 @@ static int _yield_locks(int usec)
 	node_update = last_node_update;
 	part_update = last_part_update;
 
+	_spec_clear();	/* system state may change */
+	_shape_clear();
+	_part_nodes_clear();
+	_plan_stop();
 	unlock_slurmctld(all_locks);
 	bf_last_yields++;
 	_my_sleep(usec);
@@ -724,6 +1051,720 @@ static bool _job_part_valid(struct job_record *job_ptr,
 	return rc;
 }
 
+/* Determine a job's minimum, maximum and requested node counts in a
+ * partition. RET false if the job can not fit in the partition */
+static bool _bf_node_limits(struct job_record *job_ptr,
+			    struct part_record *part_ptr, uint32_t *min_nodes,
+			    uint32_t *max_nodes, uint32_t *req_nodes)
+{
+	*min_nodes = MAX(job_ptr->details->min_nodes, part_ptr->min_nodes);
+	if (job_ptr->details->max_nodes == 0)
+		*max_nodes = part_ptr->max_nodes;
+	else
+		*max_nodes = MIN(job_ptr->details->max_nodes,
+				 part_ptr->max_nodes);
+	*max_nodes = MIN(*max_nodes, 500000);	/* prevent overflows */
+	if (job_ptr->details->max_nodes)
+		*req_nodes = *max_nodes;
+	else
+		*req_nodes = *min_nodes;
+	if (*min_nodes > *max_nodes)
+		return false;
+	return true;
+}
+
+/* Determine the time limit to test a job with in a partition and its
+ * complete time limit.
+ * RET true if the job's time_limit must be set to the tested time limit */
+static bool _bf_time_limit(struct job_record *job_ptr,
+			   struct part_record *part_ptr, uint32_t *time_limit,
+			   uint32_t *comp_time_limit)
+{
+	slurmdb_qos_rec_t *qos_ptr = job_ptr->qos_ptr;
+	uint32_t part_time_limit;
+
+	if (part_ptr->max_time == INFINITE)
+		part_time_limit = YEAR_MINUTES;
+	else
+		part_time_limit = part_ptr->max_time;
+	if (job_ptr->time_limit == NO_VAL) {
+		*time_limit = part_time_limit;
+	} else {
+		if (part_ptr->max_time == INFINITE)
+			*time_limit = job_ptr->time_limit;
+		else
+			*time_limit = MIN(job_ptr->time_limit,
+					  part_time_limit);
+	}
+	*comp_time_limit = *time_limit;
+	if (qos_ptr && (qos_ptr->flags & QOS_FLAG_NO_RESERVE) &&
+	    slurm_get_preempt_mode()) {
+		*time_limit = 1;
+		return true;
+	} else if (job_ptr->time_min && (job_ptr->time_min < *time_limit)) {
+		*time_limit = job_ptr->time_min;
+		return true;
+	}
+	return false;
+}
+
+/* Return the nodes of a partition which are up and not completing */
+static bitstr_t *_part_nodes(struct part_record *part_ptr,
+			     bitstr_t *non_cg_bitmap)
+{
+	bf_part_nodes_t *part_nodes;
+	int i;
+
+	for (i = 0; i < bf_part_nodes_cnt; i++) {
+		if (bf_part_nodes[i].part_ptr == part_ptr)
+			return bf_part_nodes[i].node_bitmap;
+	}
+	if (bf_part_nodes_cnt >= bf_part_nodes_size) {
+		bf_part_nodes_size += 16;
+		xrealloc(bf_part_nodes,
+			 sizeof(bf_part_nodes_t) * bf_part_nodes_size);
+	}
+	part_nodes = &bf_part_nodes[bf_part_nodes_cnt++];
+	part_nodes->part_ptr = part_ptr;
+	part_nodes->node_bitmap = bit_copy(part_ptr->node_bitmap);
+	bit_and(part_nodes->node_bitmap, up_node_bitmap);
+	bit_and(part_nodes->node_bitmap, non_cg_bitmap);
+	return part_nodes->node_bitmap;
+}
+
+/* Free the nodes cached for each partition */
+static void _part_nodes_clear(void)
+{
+	int i;
+
+	for (i = 0; i < bf_part_nodes_cnt; i++)
+		FREE_NULL_BITMAP(bf_part_nodes[i].node_bitmap);
+	xfree(bf_part_nodes);
+	bf_part_nodes_cnt = 0;
+	bf_part_nodes_size = 0;
+}
+
+/* Remove from avail_bitmap the nodes a job can not use from start_res to
+ * end_time, including nodes reserved for higher priority pending jobs.
+ * later_start IN/OUT - if zero, set to the next time reserved nodes are
+ *	released
+ * RET false if the job can not use the remaining nodes */
+static bool _bf_avail_nodes(struct job_record *job_ptr,
+			    struct part_record *part_ptr,
+			    node_space_map_t *node_space, time_t start_res,
+			    uint32_t end_time, uint32_t min_nodes,
+			    bitstr_t *non_cg_bitmap, bitstr_t *avail_bitmap,
+			    time_t *later_start)
+{
+	bit_and(avail_bitmap, _part_nodes(part_ptr, non_cg_bitmap));
+	_ns_and(node_space, start_res, end_time, avail_bitmap, later_start);
+
+	if (job_ptr->details->exc_node_bitmap) {
+		bit_and_not(avail_bitmap,
+			    job_ptr->details->exc_node_bitmap);
+	}
+
+	if ((bit_set_count(avail_bitmap) < min_nodes) ||
+	    ((job_ptr->details->req_node_bitmap) &&
+	     (!bit_super_set(job_ptr->details->req_node_bitmap,
+			     avail_bitmap))) ||
+	    (job_req_node_filter(job_ptr, avail_bitmap)))
+		return false;
+	return true;
+}
+
+/* Free all records of jobs tested by the worker threads */
+static void _spec_clear(void)
+{
+	int i;
+
+	for (i = 0; i < bf_spec_cnt; i++) {
+		FREE_NULL_BITMAP(bf_spec[i].test_bitmap);
+		FREE_NULL_BITMAP(bf_spec[i].exc_core_bitmap);
+		FREE_NULL_BITMAP(bf_spec[i].avail_bitmap);
+	}
+	bf_spec_cnt = 0;
+}
+
+/* Discard any worker thread test of a job which will not be tested */
+static void _spec_drop(struct job_record *job_ptr)
+{
+	int i;
+
+	for (i = 0; i < bf_spec_cnt; i++) {
+		if (bf_spec[i].job_ptr == job_ptr)
+			bf_spec[i].job_ptr = NULL;
+	}
+}
+
+static bool _shape_bitmap_equal(bitstr_t *b1, bitstr_t *b2)
+{
+	if (!b1 || !b2)
+		return (b1 == b2);
+	return bit_equal(b1, b2);
+}
+
+/* FNV-1a hash of len bytes at data, continuing from hash */
+static uint32_t _hash_data(uint32_t hash, void *data, int len)
+{
+	unsigned char *ptr = (unsigned char *) data;
+	int i;
+
+	for (i = 0; i < len; i++)
+		hash = (hash ^ ptr[i]) * 16777619;
+	return hash;
+}
+
+static uint32_t _hash_str(uint32_t hash, char *str)
+{
+	unsigned char none = 0xff;
+
+	if (!str)
+		return _hash_data(hash, &none, 1);
+	return _hash_data(hash, str, strlen(str) + 1);
+}
+
+/* Fill in the numeric part of a job's resource request
+ * RET hash of the key */
+static uint32_t _shape_key_set(bf_shape_key_t *key,
+			       struct job_record *job_ptr,
+			       struct part_record *part_ptr,
+			       uint32_t time_limit, uint32_t min_nodes,
+			       uint32_t max_nodes, uint32_t req_nodes)
+{
+	struct job_details *detail_ptr = job_ptr->details;
+
+	memset(key, 0, sizeof(bf_shape_key_t));
+	key->part_ptr        = part_ptr;
+	key->qos_ptr         = job_ptr->qos_ptr;
+	key->time_limit      = time_limit;
+	key->min_nodes       = min_nodes;
+	key->max_nodes       = max_nodes;
+	key->req_nodes       = req_nodes;
+	key->min_cpus        = detail_ptr->min_cpus;
+	key->max_cpus        = detail_ptr->max_cpus;
+	key->num_tasks       = detail_ptr->num_tasks;
+	key->pn_min_cpus     = detail_ptr->pn_min_cpus;
+	key->pn_min_memory   = detail_ptr->pn_min_memory;
+	key->pn_min_tmp_disk = detail_ptr->pn_min_tmp_disk;
+	key->contiguous      = detail_ptr->contiguous;
+	key->core_spec       = detail_ptr->core_spec;
+	key->cpus_per_task   = detail_ptr->cpus_per_task;
+	key->ntasks_per_node = detail_ptr->ntasks_per_node;
+	key->plane_size      = detail_ptr->plane_size;
+	key->task_dist       = detail_ptr->task_dist;
+	key->overcommit      = detail_ptr->overcommit;
+	key->share_res       = detail_ptr->share_res;
+	key->whole_node      = detail_ptr->whole_node;
+	if (detail_ptr->mc_ptr) {
+		key->mc_set = true;
+		memcpy(&key->mc, detail_ptr->mc_ptr,
+		       sizeof(multi_core_data_t));
+	}
+	/* Strings and bitmaps are compared, not hashed */
+	return _hash_data(2166136261U, key, sizeof(bf_shape_key_t));
+}
+
+/* Find a job request identical to that of job_ptr which found no start
+ * time. The request key and its hash are returned for use by _shape_add().
+ * RET NULL if not found or if the job can not share results with others */
+static bf_shape_t *_shape_find(struct job_record *job_ptr,
+			       struct part_record *part_ptr,
+			       uint32_t time_limit, uint32_t min_nodes,
+			       uint32_t max_nodes, uint32_t req_nodes,
+			       bf_shape_key_t *key, uint32_t *hash)
+{
+	struct job_details *detail_ptr = job_ptr->details;
+	bf_shape_t *shape;
+
+	*hash = 0;
+	if (job_ptr->resv_name || job_ptr->burst_buffer ||
+	    detail_ptr->expanding_jobid ||
+	    job_ptr->req_switch || job_ptr->wait4switch)
+		return NULL;	/* start depends upon this job's own state */
+	/* Preemption candidates depend upon the job's priority, account,
+	 * etc., which are not part of the key */
+	if (slurm_preemption_enabled())
+		return NULL;
+
+	*hash = _shape_key_set(key, job_ptr, part_ptr, time_limit, min_nodes,
+			       max_nodes, req_nodes);
+	if (!bf_shape_hash)
+		return NULL;
+	for (shape = bf_shape_hash[*hash % BF_SHAPE_HASH_SIZE]; shape;
+	     shape = shape->next) {
+		if ((shape->hash == *hash) &&
+		    !memcmp(&shape->key, key, sizeof(bf_shape_key_t)) &&
+		    !xstrcmp(shape->features, detail_ptr->features) &&
+		    !xstrcmp(shape->gres, job_ptr->gres) &&
+		    !xstrcmp(shape->network, job_ptr->network) &&
+		    _shape_bitmap_equal(shape->exc_node_bitmap,
+					detail_ptr->exc_node_bitmap) &&
+		    _shape_bitmap_equal(shape->req_node_bitmap,
+					detail_ptr->req_node_bitmap))
+			return shape;
+	}
+	return NULL;
+}
+
+/* Record that a job request found no start time within the window.
+ * start_time IN - expected start time, 0 if the job can not run */
+static void _shape_add(bf_shape_key_t *key, uint32_t hash,
+		       struct job_record *job_ptr, time_t start_time)
+{
+	struct job_details *detail_ptr = job_ptr->details;
+	bf_shape_t *shape;
+	int inx;
+
+	if (!hash)
+		return;		/* request can not be shared */
+	if (!bf_shape_hash) {
+		bf_shape_hash = xmalloc(sizeof(bf_shape_t *) *
+					BF_SHAPE_HASH_SIZE);
+	}
+	shape = xmalloc(sizeof(bf_shape_t));
+	memcpy(&shape->key, key, sizeof(bf_shape_key_t));
+	shape->hash = hash;
+	shape->features = xstrdup(detail_ptr->features);
+	shape->gres = xstrdup(job_ptr->gres);
+	shape->network = xstrdup(job_ptr->network);
+	if (detail_ptr->exc_node_bitmap)
+		shape->exc_node_bitmap = bit_copy(detail_ptr->exc_node_bitmap);
+	if (detail_ptr->req_node_bitmap)
+		shape->req_node_bitmap = bit_copy(detail_ptr->req_node_bitmap);
+	shape->job_id = job_ptr->job_id;
+	shape->start_time = start_time;
+	inx = hash % BF_SHAPE_HASH_SIZE;
+	shape->next = bf_shape_hash[inx];
+	bf_shape_hash[inx] = shape;
+}
+
+static void _shape_clear(void)
+{
+	bf_shape_t *shape, *next;
+	int i;
+
+	if (!bf_shape_hash)
+		return;
+	for (i = 0; i < BF_SHAPE_HASH_SIZE; i++) {
+		for (shape = bf_shape_hash[i]; shape; shape = next) {
+			next = shape->next;
+			xfree(shape->features);
+			xfree(shape->gres);
+			xfree(shape->network);
+			FREE_NULL_BITMAP(shape->exc_node_bitmap);
+			FREE_NULL_BITMAP(shape->req_node_bitmap);
+			xfree(shape);
+		}
+	}
+	xfree(bf_shape_hash);
+}
+
+/* Hash of everything in a job's request which backfill tests use */
+static uint32_t _plan_hash(struct job_record *job_ptr,
+			   struct part_record *part_ptr)
+{
+	struct job_details *detail_ptr = job_ptr->details;
+	bf_shape_key_t key;
+	uint32_t hash;
+
+	hash = _shape_key_set(&key, job_ptr, part_ptr, job_ptr->time_limit,
+			      detail_ptr->min_nodes, detail_ptr->max_nodes, 0);
+	hash = _hash_data(hash, &job_ptr->time_min, sizeof(uint32_t));
+	hash = _hash_str(hash, detail_ptr->features);
+	hash = _hash_str(hash, detail_ptr->exc_nodes);
+	hash = _hash_str(hash, detail_ptr->req_nodes);
+	hash = _hash_str(hash, detail_ptr->dependency);
+	hash = _hash_str(hash, job_ptr->burst_buffer);
+	hash = _hash_str(hash, job_ptr->gres);
+	hash = _hash_str(hash, job_ptr->licenses);
+	hash = _hash_str(hash, job_ptr->network);
+	hash = _hash_str(hash, job_ptr->resv_name);
+	return hash;
+}
+
+/* Stop recording the jobs tested, the system state may change */
+static void _plan_stop(void)
+{
+	if (bf_plan_cur)
+		FREE_NULL_BITMAP(bf_plan[bf_plan_cnt].resv_bitmap);
+	bf_plan_cur = false;
+	bf_plan_open = false;
+}
+
+/* Discard plan records from cnt on */
+static void _plan_truncate(int cnt)
+{
+	int i;
+
+	if (bf_plan_cur)
+		FREE_NULL_BITMAP(bf_plan[bf_plan_cnt].resv_bitmap);
+	for (i = cnt; i < bf_plan_cnt; i++)
+		FREE_NULL_BITMAP(bf_plan[i].resv_bitmap);
+	bf_plan_cnt = cnt;
+	bf_plan_cur = false;
+}
+
+/* Start recording the jobs tested by a backfill pass.
+ * RET true if the pass can resume the plan of the previous pass */
+static bool _plan_begin(time_t sched_start)
+{
+	bool resume = true;
+
+	/* Per user and partition test limits depend upon all jobs tested,
+	 * which a resumed pass would not count */
+	if (!bf_incremental || max_backfill_job_per_part ||
+	    max_backfill_job_per_user ||
+	    (bf_plan_config != slurmctld_conf.last_update) ||
+	    (bf_plan_node   != last_node_update) ||
+	    (bf_plan_part   != last_part_update) ||
+	    (bf_plan_resv   != last_resv_update) ||
+	    (difftime(sched_start, bf_plan_start) > bf_incremental)) {
+		_plan_truncate(0);
+		resume = false;
+	}
+	if (bf_plan_cnt == 0) {
+		bf_plan_start = sched_start;
+		resume = false;
+	}
+	if (!bf_incremental) {
+		xfree(bf_plan);
+		bf_plan_size = 0;
+	}
+
+	bf_plan_config = slurmctld_conf.last_update;
+	bf_plan_node   = last_node_update;
+	bf_plan_part   = last_part_update;
+	bf_plan_resv   = last_resv_update;
+	bf_plan_open   = (bf_incremental != 0);
+	bf_plan_cur    = false;
+	return resume;
+}
+
+/* Apply the result of a job tested by the previous pass, if the job is
+ * the next one tested there and its request is unchanged.
+ * RET false if the job needs to be tested */
+static bool _plan_replay(struct job_record *job_ptr,
+			 struct part_record *part_ptr, int inx,
+			 node_space_map_t *node_space, int *node_space_recs)
+{
+	bf_plan_t *plan = &bf_plan[inx];
+
+	if ((inx >= bf_plan_cnt) ||
+	    (plan->job_id   != job_ptr->job_id) ||
+	    (plan->part_ptr != part_ptr) ||
+	    !IS_JOB_PENDING(job_ptr) || job_ptr->preempt_in_progress ||
+	    !_job_part_valid(job_ptr, part_ptr) ||
+	    (plan->req_hash != _plan_hash(job_ptr, part_ptr)))
+		return false;
+
+	if (plan->resv_bitmap &&
+	    (plan->resv_end > node_space[0].begin_time)) {
+		if (*node_space_recs >= max_backfill_job_cnt)
+			return false;
+		_add_reservation(plan->resv_start, plan->resv_end,
+				 plan->resv_bitmap, node_space,
+				 node_space_recs);
+	}
+	job_ptr->start_time = plan->start_time;
+	return true;
+}
+
+/* Record the start of a job's test. Recording stops at job arrays, whose
+ * tasks are tested together. */
+static void _plan_add(struct job_record *job_ptr,
+		      struct part_record *part_ptr)
+{
+	bf_plan_t *plan;
+
+	if (!bf_plan_open)
+		return;
+	if ((job_ptr->array_task_id != NO_VAL) || job_ptr->array_recs) {
+		bf_plan_open = false;
+		return;
+	}
+	if (bf_plan_cnt >= bf_plan_size) {
+		bf_plan_size = MAX(bf_plan_size * 2, 256);
+		xrealloc(bf_plan, sizeof(bf_plan_t) * bf_plan_size);
+	}
+	plan = &bf_plan[bf_plan_cnt];
+	plan->job_id = job_ptr->job_id;
+	plan->part_ptr = part_ptr;
+	plan->req_hash = _plan_hash(job_ptr, part_ptr);
+	plan->resv_bitmap = NULL;
+	bf_plan_cur = true;
+}
+
+/* Record the node_space reservation made for the job being tested */
+static void _plan_resv(uint32_t start_time, uint32_t end_reserve,
+		       bitstr_t *res_bitmap)
+{
+	if (!bf_plan_cur)
+		return;
+	bf_plan[bf_plan_cnt].resv_start = start_time;
+	bf_plan[bf_plan_cnt].resv_end = end_reserve;
+	bf_plan[bf_plan_cnt].resv_bitmap = bit_copy(res_bitmap);
+}
+
+/* Record the result of a job's test once it is complete */
+static void _plan_commit(struct job_record *job_ptr)
+{
+	if (!bf_plan_cur)
+		return;
+	bf_plan[bf_plan_cnt++].start_time = job_ptr->start_time;
+	bf_plan_cur = false;
+}
+
+/* Set up a worker thread test of a job which is further down the queue,
+ * using the input the main loop will have when it first tests the job,
+ * unless other jobs are scheduled first.
+ * RET false if the job would not reach _try_sched() */
+static bool _spec_prepare(bf_spec_t *spec, struct job_record *job_ptr,
+			  struct part_record *part_ptr,
+			  node_space_map_t *node_space,
+			  bitstr_t *non_cg_bitmap, time_t now)
+{
+	uint32_t time_limit, comp_time_limit, orig_time_limit, end_time;
+	bitstr_t *avail_bitmap = NULL, *exc_core_bitmap = NULL;
+	time_t start_res = now, later_start = 0;
+	bool resv_overlap = false;
+	int rc;
+
+	/* Jobs in a reservation may be held by job_test_resv() */
+	if (!IS_JOB_PENDING(job_ptr) || job_ptr->preempt_in_progress ||
+	    job_ptr->resv_name || !job_ptr->details ||
+	    !_job_part_valid(job_ptr, part_ptr) ||
+	    ((part_ptr->state_up & PARTITION_SCHED) == 0) ||
+	    (part_ptr->node_bitmap == NULL))
+		return false;
+	if (!_bf_node_limits(job_ptr, part_ptr, &spec->min_nodes,
+			     &spec->max_nodes, &spec->req_nodes))
+		return false;
+
+	orig_time_limit = job_ptr->time_limit;
+	if (_bf_time_limit(job_ptr, part_ptr, &time_limit, &comp_time_limit))
+		job_ptr->time_limit = time_limit;
+	spec->time_limit = job_ptr->time_limit;
+	rc = job_test_resv(job_ptr, &start_res, true, &avail_bitmap,
+			   &exc_core_bitmap, &resv_overlap);
+	job_ptr->time_limit = orig_time_limit;
+	if (rc != SLURM_SUCCESS) {
+		FREE_NULL_BITMAP(avail_bitmap);
+		FREE_NULL_BITMAP(exc_core_bitmap);
+		return false;
+	}
+	if (start_res > now)
+		end_time = (time_limit * 60) + start_res;
+	else
+		end_time = (time_limit * 60) + now;
+	if (!_bf_avail_nodes(job_ptr, part_ptr, node_space, start_res,
+			     end_time, spec->min_nodes, non_cg_bitmap,
+			     avail_bitmap, &later_start)) {
+		FREE_NULL_BITMAP(avail_bitmap);
+		FREE_NULL_BITMAP(exc_core_bitmap);
+		return false;
+	}
+
+	spec->job_ptr = job_ptr;
+	spec->part_ptr = part_ptr;
+	spec->test_bitmap = avail_bitmap;
+	spec->exc_core_bitmap = exc_core_bitmap;
+	return true;
+}
+
+/* Test one job in a worker thread. The job record is returned to its
+ * original state and the results saved for the main loop to use */
+static void _spec_test(bf_spec_t *spec)
+{
+	struct job_record *job_ptr = spec->job_ptr;
+	struct part_record *orig_part_ptr = job_ptr->part_ptr;
+	uint32_t orig_time_limit = job_ptr->time_limit;
+	uint32_t orig_total_cpus = job_ptr->total_cpus;
+	time_t orig_start_time = job_ptr->start_time;
+	bool orig_best_switch = job_ptr->best_switch;
+
+	job_ptr->part_ptr = spec->part_ptr;
+	job_ptr->time_limit = spec->time_limit;
+	spec->avail_bitmap = bit_copy(spec->test_bitmap);
+	spec->rc = _try_sched(job_ptr, &spec->avail_bitmap, spec->min_nodes,
+			      spec->max_nodes, spec->req_nodes,
+			      spec->exc_core_bitmap);
+	spec->start_time = job_ptr->start_time;
+	spec->total_cpus = job_ptr->total_cpus;
+	spec->best_switch = job_ptr->best_switch;
+
+	job_ptr->part_ptr = orig_part_ptr;
+	job_ptr->time_limit = orig_time_limit;
+	job_ptr->total_cpus = orig_total_cpus;
+	job_ptr->start_time = orig_start_time;
+	job_ptr->best_switch = orig_best_switch;
+}
+
+/* Worker thread, test jobs until the batch is done */
+static void *_spec_thread(void *no_data)
+{
+	int i;
+
+	while (1) {
+		slurm_mutex_lock(&bf_spec_lock);
+		i = bf_spec_next++;
+		slurm_mutex_unlock(&bf_spec_lock);
+		if (i >= bf_spec_cnt)
+			break;
+		_spec_test(&bf_spec[i]);
+	}
+	return NULL;
+}
+
+/* Test the current job and the next jobs in the queue in parallel.
+ * The caller holds the slurmctld locks for the whole batch, so the jobs
+ * are all tested against the same system state. */
+static void _spec_run(struct job_record *job_ptr, bitstr_t *avail_bitmap,
+		      uint32_t min_nodes, uint32_t max_nodes,
+		      uint32_t req_nodes, bitstr_t *exc_core_bitmap,
+		      List job_queue, node_space_map_t *node_space,
+		      bitstr_t *non_cg_bitmap, time_t now)
+{
+	pthread_t thread_id[BF_MAX_THREADS];
+	pthread_attr_t attr;
+	ListIterator job_iterator;
+	job_queue_rec_t *job_queue_rec;
+	int i, max_spec, thread_cnt = 0;
+	bf_spec_t *spec;
+	DEF_TIMERS;
+
+	START_TIMER;
+	max_spec = bf_threads * BF_SPEC_PER_THREAD;
+	if (!bf_spec)
+		bf_spec = xmalloc(sizeof(bf_spec_t) * max_spec);
+
+	spec = &bf_spec[bf_spec_cnt++];
+	memset(spec, 0, sizeof(bf_spec_t));
+	spec->job_ptr = job_ptr;
+	spec->part_ptr = job_ptr->part_ptr;
+	spec->time_limit = job_ptr->time_limit;
+	spec->min_nodes = min_nodes;
+	spec->max_nodes = max_nodes;
+	spec->req_nodes = req_nodes;
+	spec->test_bitmap = bit_copy(avail_bitmap);
+	if (exc_core_bitmap)
+		spec->exc_core_bitmap = bit_copy(exc_core_bitmap);
+
+	job_iterator = list_iterator_create(job_queue);
+	while ((bf_spec_cnt < max_spec) &&
+	       (job_queue_rec = (job_queue_rec_t *) list_next(job_iterator))) {
+		if ((job_queue_rec->job_ptr->magic  != JOB_MAGIC) ||
+		    (job_queue_rec->job_ptr->job_id != job_queue_rec->job_id))
+			continue;
+		/* Skip jobs already in the batch, a job record can only be
+		 * tested by one thread at a time */
+		for (i = 0; i < bf_spec_cnt; i++) {
+			if (bf_spec[i].job_ptr == job_queue_rec->job_ptr)
+				break;
+		}
+		if (i < bf_spec_cnt)
+			continue;
+		spec = &bf_spec[bf_spec_cnt];
+		memset(spec, 0, sizeof(bf_spec_t));
+		if (_spec_prepare(spec, job_queue_rec->job_ptr,
+				  job_queue_rec->part_ptr, node_space,
+				  non_cg_bitmap, now))
+			bf_spec_cnt++;
+	}
+	list_iterator_destroy(job_iterator);
+
+	bf_spec_next = 0;
+	slurm_attr_init(&attr);
+	for (i = 1; (i < bf_threads) && (i < bf_spec_cnt); i++) {
+		if (pthread_create(&thread_id[thread_cnt], &attr,
+				   _spec_thread, NULL)) {
+			error("backfill: pthread_create: %m");
+			break;
+		}
+		thread_cnt++;
+	}
+	slurm_attr_destroy(&attr);
+	(void) _spec_thread(NULL);
+	for (i = 0; i < thread_cnt; i++)
+		pthread_join(thread_id[i], NULL);
+
+	slurmctld_diag_stats.bf_spec_tests += bf_spec_cnt;
+	END_TIMER;
+	if (debug_flags & DEBUG_FLAG_BACKFILL) {
+		info("backfill: tested %d jobs with %d threads, %s",
+		     bf_spec_cnt, thread_cnt + 1, TIME_STR);
+	}
+}
+
+/* Test when and where a job can start, using the result of a worker thread
+ * test if one was made with the same input. Otherwise, when the worker
+ * results are used up, test this job and the following jobs in the queue in
+ * parallel. Results are always used in queue order, so the schedule is the
+ * same as when testing one job at a time. */
+static int _bf_try_sched(struct job_record *job_ptr, bitstr_t **avail_bitmap,
+			 uint32_t min_nodes, uint32_t max_nodes,
+			 uint32_t req_nodes, bitstr_t *exc_core_bitmap,
+			 List job_queue, node_space_map_t *node_space,
+			 bitstr_t *non_cg_bitmap, time_t now)
+{
+	bf_spec_t *spec = NULL;
+	int i, rc;
+
+	if (slurmctld_diag_stats.bf_threads < 2)
+		return _try_sched(job_ptr, avail_bitmap, min_nodes, max_nodes,
+				  req_nodes, exc_core_bitmap);
+
+	for (i = 0; i < bf_spec_cnt; i++) {
+		if ((bf_spec[i].job_ptr == job_ptr) &&
+		    (bf_spec[i].part_ptr == job_ptr->part_ptr)) {
+			spec = &bf_spec[i];
+			break;
+		}
+	}
+	if (spec &&
+	    ((spec->time_limit != job_ptr->time_limit) ||
+	     (spec->min_nodes  != min_nodes) ||
+	     (spec->max_nodes  != max_nodes) ||
+	     (spec->req_nodes  != req_nodes) ||
+	     !bit_equal(spec->test_bitmap, *avail_bitmap) ||
+	     (!spec->exc_core_bitmap != !exc_core_bitmap) ||
+	     (exc_core_bitmap &&
+	      !bit_equal(spec->exc_core_bitmap, exc_core_bitmap)))) {
+		/* Higher priority jobs changed the nodes available to this
+		 * job since it was tested */
+		spec->job_ptr = NULL;
+		spec = NULL;
+	}
+	if (!spec) {
+		for (i = 0; i < bf_spec_cnt; i++) {
+			if (bf_spec[i].job_ptr)
+				break;
+		}
+		if (i < bf_spec_cnt) {
+			/* Results for following jobs are still pending use */
+			return _try_sched(job_ptr, avail_bitmap, min_nodes,
+					  max_nodes, req_nodes,
+					  exc_core_bitmap);
+		}
+		_spec_clear();
+		_spec_run(job_ptr, *avail_bitmap, min_nodes, max_nodes,
+			  req_nodes, exc_core_bitmap, job_queue, node_space,
+			  non_cg_bitmap, now);
+		spec = &bf_spec[0];
+	}
+
+	slurmctld_diag_stats.bf_spec_used++;
+	FREE_NULL_BITMAP(*avail_bitmap);
+	*avail_bitmap = spec->avail_bitmap;
+	spec->avail_bitmap = NULL;
+	job_ptr->start_time = spec->start_time;
+	job_ptr->total_cpus = spec->total_cpus;
+	job_ptr->best_switch = spec->best_switch;
+	rc = spec->rc;
+	spec->job_ptr = NULL;	/* test each job once */
+	return rc;
+}
+
 static int _attempt_backfill(void)
 {
 	DEF_TIMERS;
@@ -731,11 +1772,11 @@ static int _attempt_backfill(void)
 	List job_queue;
 	job_queue_rec_t *job_queue_rec;
 	slurmdb_qos_rec_t *qos_ptr = NULL;
-	int bb, i, j, node_space_recs;
-	struct job_record *job_ptr;
+	int bb, i, j, node_space_recs, plan_inx = -1;
+	struct job_record *job_ptr = NULL;
 	struct part_record *part_ptr, **bf_part_ptr = NULL;
 	uint32_t end_time, end_reserve;
-	uint32_t time_limit, comp_time_limit, orig_time_limit, part_time_limit;
+	uint32_t time_limit, comp_time_limit, orig_time_limit;
 	uint32_t min_nodes, max_nodes, req_nodes;
 	bitstr_t *avail_bitmap = NULL, *resv_bitmap = NULL;
 	bitstr_t *exc_core_bitmap = NULL, *non_cg_bitmap = NULL;
@@ -756,7 +1797,10 @@ static int _attempt_backfill(void)
 	struct timeval start_tv;
 	uint32_t test_array_job_id = 0;
 	uint32_t test_array_count = 0;
-	bool resv_overlap = false;
+	bool resv_overlap = false, usable;
+	bf_shape_key_t shape_key;
+	bf_shape_t *shape;
+	uint32_t shape_hash;
 
 	bf_last_yields = 0;
 #ifdef HAVE_ALPS_CRAY
@@ -816,6 +1860,11 @@ static int _attempt_backfill(void)
 	slurmctld_diag_stats.bf_last_depth_try = 0;
 	slurmctld_diag_stats.bf_when_last_cycle = now;
 	slurmctld_diag_stats.bf_active = 1;
+	/* Preemption tests change the records of running jobs */
+	if (bf_spec_ok && !slurm_preemption_enabled())
+		slurmctld_diag_stats.bf_threads = bf_threads;
+	else
+		slurmctld_diag_stats.bf_threads = 1;
 
 	node_space = xmalloc(sizeof(node_space_map_t) *
 			     (max_backfill_job_cnt * 2 + 1));
@@ -825,8 +1874,11 @@ static int _attempt_backfill(void)
 	node_space[0].avail_bitmap = bit_copy(avail_node_bitmap);
 	node_space[0].next = 0;
 	node_space_recs = 1;
+	ns_cnt = 0;
 	if (debug_flags & DEBUG_FLAG_BACKFILL_MAP)
 		_dump_node_space_table(node_space);
+	if (_plan_begin(sched_start))
+		plan_inx = 0;
 
 	if (max_backfill_job_per_part) {
 		ListIterator part_iterator;
@@ -848,6 +1900,7 @@ static int _attempt_backfill(void)
 	}
 	sort_job_queue(job_queue);
 	while (1) {
+		_plan_commit(job_ptr);
 		job_queue_rec = (job_queue_rec_t *) list_pop(job_queue);
 		if (!job_queue_rec) {
 			if (debug_flags & DEBUG_FLAG_BACKFILL)
@@ -905,10 +1958,28 @@ static int _attempt_backfill(void)
 		part_ptr = job_queue_rec->part_ptr;
 		xfree(job_queue_rec);
 
+		if ((plan_inx >= 0) && bf_plan_open) {
+			if (_plan_replay(job_ptr, part_ptr, plan_inx,
+					 node_space, &node_space_recs)) {
+				plan_inx++;
+				continue;
+			}
+			/* Test jobs from the first difference on */
+			_plan_truncate(plan_inx);
+		}
+		if (plan_inx >= 0) {
+			if (debug_flags & DEBUG_FLAG_BACKFILL) {
+				info("backfill: resumed previous plan for "
+				     "%d jobs", plan_inx);
+			}
+			plan_inx = -1;
+		}
+
 next_task:
 		job_test_count++;
 		slurmctld_diag_stats.bf_last_depth++;
 		already_counted = false;
+		_plan_add(job_ptr, part_ptr);
 
 		if (!IS_JOB_PENDING(job_ptr))
 			continue;	/* started in another partition */
@@ -1021,19 +2092,8 @@ next_task:
 		}
 
 		/* Determine minimum and maximum node counts */
-		min_nodes = MAX(job_ptr->details->min_nodes,
-				part_ptr->min_nodes);
-		if (job_ptr->details->max_nodes == 0)
-			max_nodes = part_ptr->max_nodes;
-		else
-			max_nodes = MIN(job_ptr->details->max_nodes,
-					part_ptr->max_nodes);
-		max_nodes = MIN(max_nodes, 500000);     /* prevent overflows */
-		if (job_ptr->details->max_nodes)
-			req_nodes = max_nodes;
-		else
-			req_nodes = min_nodes;
-		if (min_nodes > max_nodes) {
+		if (!_bf_node_limits(job_ptr, part_ptr, &min_nodes, &max_nodes,
+				     &req_nodes)) {
 			if (debug_flags & DEBUG_FLAG_BACKFILL)
 				info("backfill: job %u node count too high",
 				     job_ptr->job_id);
@@ -1041,26 +2101,35 @@ next_task:
 		}
 
 		/* Determine job's expected completion time */
-		if (part_ptr->max_time == INFINITE)
-			part_time_limit = YEAR_MINUTES;
-		else
-			part_time_limit = part_ptr->max_time;
-		if (job_ptr->time_limit == NO_VAL) {
-			time_limit = part_time_limit;
-		} else {
-			if (part_ptr->max_time == INFINITE)
-				time_limit = job_ptr->time_limit;
+		qos_ptr = job_ptr->qos_ptr;
+		if (_bf_time_limit(job_ptr, part_ptr, &time_limit,
+				   &comp_time_limit))
+			job_ptr->time_limit = time_limit;
+
+		/* Skip jobs identical to one which found no start time */
+		shape = _shape_find(job_ptr, part_ptr, time_limit, min_nodes,
+				    max_nodes, req_nodes, &shape_key,
+				    &shape_hash);
+		if (shape) {
+			if (debug_flags & DEBUG_FLAG_BACKFILL) {
+				info("backfill: job %u has the same request "
+				     "as job %u, skipping",
+				     job_ptr->job_id, shape->job_id);
+			}
+			_spec_drop(job_ptr);
+			job_ptr->time_limit = orig_time_limit;
+			if (shape->start_time)
+				job_ptr->start_time = shape->start_time;
 			else
-				time_limit = MIN(job_ptr->time_limit,
-						 part_time_limit);
+				job_ptr->start_time = 0;
+			if ((orig_start_time != 0) &&
+			    ((job_ptr->start_time == 0) ||
+			     (orig_start_time < job_ptr->start_time))) {
+				/* Can start earlier in different partition */
+				job_ptr->start_time = orig_start_time;
+			}
+			continue;
 		}
-		comp_time_limit = time_limit;
-		qos_ptr = job_ptr->qos_ptr;
-		if (qos_ptr && (qos_ptr->flags & QOS_FLAG_NO_RESERVE) &&
-		    slurm_get_preempt_mode())
-			time_limit = job_ptr->time_limit = 1;
-		else if (job_ptr->time_min && (job_ptr->time_min < time_limit))
-			time_limit = job_ptr->time_limit = job_ptr->time_min;
 
 		/* Determine impact of any resource reservations */
 		later_start = now;
@@ -1135,45 +2204,21 @@ next_task:
 			end_time = (time_limit * 60) + now;
 		resv_end = find_resv_end(start_res);
 		/* Identify usable nodes for this job */
-		bit_and(avail_bitmap, part_ptr->node_bitmap);
-		bit_and(avail_bitmap, up_node_bitmap);
-		bit_and(avail_bitmap, non_cg_bitmap);
-		for (j=0; ; ) {
-			if ((node_space[j].end_time > start_res) &&
-			     node_space[j].next && (later_start == 0))
-				later_start = node_space[j].end_time;
-			if (node_space[j].end_time <= start_res)
-				;
-			else if (node_space[j].begin_time <= end_time) {
-				bit_and(avail_bitmap,
-					node_space[j].avail_bitmap);
-			} else
-				break;
-			if ((j = node_space[j].next) == 0)
-				break;
-		}
+		usable = _bf_avail_nodes(job_ptr, part_ptr, node_space,
+					 start_res, end_time, min_nodes,
+					 non_cg_bitmap, avail_bitmap,
+					 &later_start);
 		if (resv_end && (++resv_end < window_end) &&
 		    ((later_start == 0) || (resv_end < later_start))) {
 			later_start = resv_end;
 		}
 
-		if (job_ptr->details->exc_node_bitmap) {
-			bit_not(job_ptr->details->exc_node_bitmap);
-			bit_and(avail_bitmap,
-				job_ptr->details->exc_node_bitmap);
-			bit_not(job_ptr->details->exc_node_bitmap);
-		}
-
 		/* Test if insufficient nodes remain OR
 		 *	required nodes missing OR
 		 *	nodes lack features OR
 		 *	no change since previously tested nodes (only changes
 		 *	in other partition nodes) */
-		if ((bit_set_count(avail_bitmap) < min_nodes) ||
-		    ((job_ptr->details->req_node_bitmap) &&
-		     (!bit_super_set(job_ptr->details->req_node_bitmap,
-				     avail_bitmap))) ||
-		    (job_req_node_filter(job_ptr, avail_bitmap))) {
+		if (!usable) {
 			if (later_start) {
 				job_ptr->start_time = 0;
 				goto TRY_LATER;
@@ -1182,6 +2227,8 @@ next_task:
 			/* Job can not start until too far in the future */
 			job_ptr->time_limit = orig_time_limit;
 			job_ptr->start_time = sched_start + backfill_window;
+			_shape_add(&shape_key, shape_hash, job_ptr,
+				   job_ptr->start_time);
 			if ((orig_start_time != 0) &&
 			    (orig_start_time < job_ptr->start_time)) {
 				/* Can start earlier in different partition */
@@ -1206,11 +2253,13 @@ next_task:
 
 		if (debug_flags & DEBUG_FLAG_BACKFILL_MAP)
 			_dump_job_test(job_ptr, avail_bitmap, start_res);
-		j = _try_sched(job_ptr, &avail_bitmap, min_nodes, max_nodes,
-			       req_nodes, exc_core_bitmap);
+		j = _bf_try_sched(job_ptr, &avail_bitmap, min_nodes, max_nodes,
+				  req_nodes, exc_core_bitmap, job_queue,
+				  node_space, non_cg_bitmap, now);
 
 		now = time(NULL);
 		if (j != SLURM_SUCCESS) {
+			_shape_add(&shape_key, shape_hash, job_ptr, 0);
 			job_ptr->time_limit = orig_time_limit;
 			if (orig_start_time != 0)  /* Can start in other part */
 				job_ptr->start_time = orig_start_time;
@@ -1222,6 +2271,7 @@ next_task:
 		if (start_res > job_ptr->start_time) {
 			job_ptr->start_time = start_res;
 			last_job_update = now;
+			JOB_DELTA_TOUCH(job_ptr);
 		}
 		if ((job_ptr->start_time <= now) &&
 		    ((bb = bb_g_job_test_stage_in(job_ptr, true)) != 1)) {
@@ -1241,6 +2291,7 @@ next_task:
 			       job_reason_string(job_ptr->state_reason),
 			       job_ptr->priority);
 			last_job_update = now;
+			JOB_DELTA_TOUCH(job_ptr);
 			job_ptr->time_limit = orig_time_limit;
 			later_start = 0;
 		} else if (job_ptr->start_time <= now) { /* Can start now */
@@ -1365,6 +2416,8 @@ next_task:
 			if (debug_flags & DEBUG_FLAG_BACKFILL)
 				_dump_job_sched(job_ptr, end_reserve,
 						avail_bitmap);
+			_shape_add(&shape_key, shape_hash, job_ptr,
+				   job_ptr->start_time);
 			if ((orig_start_time != 0) &&
 			    (orig_start_time < job_ptr->start_time)) {
 				/* Can start earlier in different partition */
@@ -1414,6 +2467,7 @@ next_task:
 		bit_not(avail_bitmap);
 		_add_reservation(start_time, end_reserve,
 				 avail_bitmap, node_space, &node_space_recs);
+		_plan_resv(start_time, end_reserve, avail_bitmap);
 		if (debug_flags & DEBUG_FLAG_BACKFILL_MAP)
 			_dump_node_space_table(node_space);
 		if ((orig_start_time != 0) &&
@@ -1442,6 +2496,14 @@ next_task:
 	FREE_NULL_BITMAP(exc_core_bitmap);
 	FREE_NULL_BITMAP(resv_bitmap);
 	FREE_NULL_BITMAP(non_cg_bitmap);
+	_spec_clear();
+	xfree(bf_spec);
+	_ns_free();
+	_shape_clear();
+	_part_nodes_clear();
+	_plan_stop();
+	if ((plan_inx > 0) && (debug_flags & DEBUG_FLAG_BACKFILL))
+		info("backfill: resumed previous plan for %d jobs", plan_inx);
 
 	for (i=0; ; ) {
 		FREE_NULL_BITMAP(node_space[i].avail_bitmap);
@@ -1468,6 +2530,8 @@ static int _start_job(struct job_record *job_ptr, bitstr_t *resv_bitmap)
 	bitstr_t *orig_exc_nodes = NULL;
 	static uint32_t fail_jobid = 0;
 
+	_spec_clear();	/* job allocations will change */
+	_plan_stop();
 	if (job_ptr->details->exc_node_bitmap) {
 		orig_exc_nodes = bit_copy(job_ptr->details->exc_node_bitmap);
 		bit_or(job_ptr->details->exc_node_bitmap, resv_bitmap);
@@ -1483,6 +2547,7 @@ static int _start_job(struct job_record *job_ptr, bitstr_t *resv_bitmap)
 	if (rc == SLURM_SUCCESS) {
 		/* job initiated */
 		last_job_update = time(NULL);
+		JOB_DELTA_TOUCH(job_ptr);
 		if (job_ptr->array_task_id == NO_VAL) {
 			info("backfill: Started JobId=%u on %s",
 			     job_ptr->job_id, job_ptr->nodes);
@@ -1585,6 +2650,8 @@ static void _add_reservation(uint32_t start_time, uint32_t end_reserve,
 	bool placed = false;
 	int i, j;
 
+	ns_cnt = 0;
+
 #if 0	
 	info("add job start:%u end:%u", start_time, end_reserve);
 	for (j = 0; ; ) {
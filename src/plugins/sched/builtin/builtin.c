@@ -217,6 +217,7 @@ static void _compute_start_times(void)
 				       exc_core_bitmap);
 		if (rc == SLURM_SUCCESS) {
 			last_job_update = now;
+			JOB_DELTA_TOUCH(job_ptr);
 			if (job_ptr->time_limit == INFINITE)
 				time_limit = 365 * 24 * 60 * 60;
 			else if (job_ptr->time_limit != NO_VAL)
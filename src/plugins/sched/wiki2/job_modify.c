@@ -86,6 +86,7 @@ static int	_job_modify(uint32_t jobid, char *bank_ptr,
 		xfree(job_ptr->comment);
 		job_ptr->comment = xstrdup(comment_ptr);
 		last_job_update = now;
+		JOB_DELTA_TOUCH(job_ptr);
 	}
 
 	if (depend_ptr) {
@@ -192,6 +193,7 @@ static int	_job_modify(uint32_t jobid, char *bank_ptr,
 				((job_ptr->time_limit -
 				  old_time) * 60);
 		last_job_update = now;
+		JOB_DELTA_TOUCH(job_ptr);
 	}
 
 	if (bank_ptr &&
@@ -205,6 +207,7 @@ static int	_job_modify(uint32_t jobid, char *bank_ptr,
 				jobid, feature_ptr);
 			job_ptr->details->features = xstrdup(feature_ptr);
 			last_job_update = now;
+			JOB_DELTA_TOUCH(job_ptr);
 		} else {
 			error("wiki: MODIFYJOB features of non-pending "
 				"job %u", jobid);
@@ -220,6 +223,7 @@ static int	_job_modify(uint32_t jobid, char *bank_ptr,
 				jobid, begin_time);
 			job_ptr->details->begin_time = begin_time;
 			last_job_update = now;
+			JOB_DELTA_TOUCH(job_ptr);
 			update_accounting = true;
 		} else {
 			error("wiki: MODIFYJOB begin_time of non-pending "
@@ -234,6 +238,7 @@ static int	_job_modify(uint32_t jobid, char *bank_ptr,
 			xfree(job_ptr->name);
 			job_ptr->name = xstrdup(name_ptr);
 			last_job_update = now;
+			JOB_DELTA_TOUCH(job_ptr);
 			update_accounting = true;
 		} else {
 			error("wiki: MODIFYJOB name of non-pending job %u",
@@ -319,6 +324,7 @@ host_fini:	if (rc) {
 		job_ptr->partition = xstrdup(part_name_ptr);
 		job_ptr->part_ptr = part_ptr;
 		last_job_update = now;
+		JOB_DELTA_TOUCH(job_ptr);
 		update_accounting = true;
 	}
 
@@ -373,6 +379,7 @@ host_fini:	if (rc) {
 					    geometry);
 #endif
 		last_job_update = now;
+		JOB_DELTA_TOUCH(job_ptr);
 		update_accounting = true;
 	}
 
@@ -216,9 +216,7 @@ static char *	_will_run_test(uint32_t jobid, time_t start_time,
 		return NULL;
 	}
 	if (job_ptr->details->exc_node_bitmap) {
-		bit_not(job_ptr->details->exc_node_bitmap);
-		bit_and(avail_bitmap, job_ptr->details->exc_node_bitmap);
-		bit_not(job_ptr->details->exc_node_bitmap);
+		bit_and_not(avail_bitmap, job_ptr->details->exc_node_bitmap);
 	}
 	if ((job_ptr->details->req_node_bitmap) &&
 	    (!bit_super_set(job_ptr->details->req_node_bitmap,
@@ -506,9 +504,7 @@ static char *	_will_run_test2(uint32_t jobid, time_t start_time,
 		return NULL;
 	}
 	if (job_ptr->details->exc_node_bitmap) {
-		bit_not(job_ptr->details->exc_node_bitmap);
-		bit_and(avail_bitmap, job_ptr->details->exc_node_bitmap);
-		bit_not(job_ptr->details->exc_node_bitmap);
+		bit_and_not(avail_bitmap, job_ptr->details->exc_node_bitmap);
 	}
 	if ((job_ptr->details->req_node_bitmap) &&
 	    (!bit_super_set(job_ptr->details->req_node_bitmap,
@@ -312,6 +312,7 @@ extern int basil_inventory(void)
 				   ((now - node_ptr->down_time) <
 				    slurmctld_conf.slurmd_timeout)) {
 				node_ptr->node_state |= NODE_STATE_NO_RESPOND;
+				NODE_DELTA_TOUCH(node_ptr);
 				bit_clear(avail_node_bitmap, node_inx);
 			} else {
 				xfree(node_ptr->reason);
@@ -329,6 +330,7 @@ extern int basil_inventory(void)
 			node_ptr->node_state &= NODE_STATE_FLAGS;
 			node_ptr->node_state &= (~NODE_STATE_NO_RESPOND);
 			node_ptr->node_state |= NODE_STATE_UNKNOWN;
+			NODE_DELTA_TOUCH(node_ptr);
 
 			make_node_idle(node_ptr, NULL);
 			if (!IS_NODE_DRAIN(node_ptr) &&
@@ -341,6 +343,7 @@ extern int basil_inventory(void)
 			}
 		} else if (IS_NODE_NO_RESPOND(node_ptr)) {
 			node_ptr->node_state &= (~NODE_STATE_NO_RESPOND);
+			NODE_DELTA_TOUCH(node_ptr);
 			if (!IS_NODE_DRAIN(node_ptr) &&
 			    !IS_NODE_FAIL(node_ptr)) {
 				bit_set(avail_node_bitmap, node_inx);
@@ -625,6 +628,7 @@ extern int basil_geometry(struct node_record *node_ptr_array, int node_cnt)
 		 * NOTE: The node bitmaps are not defined when this code is
 		 * initially executed. */
 		node_ptr->node_state &= NODE_STATE_FLAGS;
+		NODE_DELTA_TOUCH(node_ptr);
 		if (reason) {
 			if (node_ptr->down_time == 0)
 				node_ptr->down_time = now;
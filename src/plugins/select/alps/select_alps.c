@@ -69,6 +69,8 @@ List part_list __attribute__((weak_import));
 List job_list __attribute__((weak_import));
 int node_record_count __attribute__((weak_import));
 time_t last_node_update __attribute__((weak_import));
+uint32_t node_delta_next_gen __attribute__((weak_import));
+bool node_delta_changed __attribute__((weak_import));
 int slurmctld_primary __attribute__((weak_import));
 struct switch_record *switch_record_table __attribute__((weak_import));
 int switch_record_cnt __attribute__((weak_import));
@@ -83,6 +85,8 @@ List part_list;
 List job_list;
 int node_record_count;
 time_t last_node_update;
+uint32_t node_delta_next_gen;
+bool node_delta_changed;
 int slurmctld_primary;
 struct switch_record *switch_record_table;
 int switch_record_cnt;
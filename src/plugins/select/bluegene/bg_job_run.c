@@ -160,8 +160,9 @@ static void _sync_agent(bg_action_t *bg_action_ptr, bg_record_t *bg_record)
 
 	if (bg_record->state == BG_BLOCK_INITED) {
 		int sync_user_rc;
-		job_ptr->job_state &= (~JOB_CONFIGURING);
+		JOB_STATE_FLAG_CLEAR(job_ptr, JOB_CONFIGURING);
 		last_job_update = time(NULL);
+		JOB_DELTA_TOUCH(job_ptr);
 		/* Just in case reset the boot flags */
 		bg_record->boot_state = 0;
 		bg_record->boot_count = 0;
@@ -569,8 +570,9 @@ no_reboot:
 		slurmctld_lock_t job_write_lock = {
 			NO_LOCK, WRITE_LOCK, NO_LOCK, NO_LOCK };
 		lock_slurmctld(job_write_lock);
-		bg_action_ptr->job_ptr->job_state &= (~JOB_CONFIGURING);
+		JOB_STATE_FLAG_CLEAR(bg_action_ptr->job_ptr, JOB_CONFIGURING);
 		last_job_update = time(NULL);
+		JOB_DELTA_TOUCH(bg_action_ptr->job_ptr);
 		unlock_slurmctld(job_write_lock);
 	}
 
@@ -697,7 +699,7 @@ extern int start_job(struct job_record *job_ptr)
 		bg_record->job_ptr = job_ptr;
 	}
 
-	job_ptr->job_state |= JOB_CONFIGURING;
+	JOB_STATE_FLAG_SET(job_ptr, JOB_CONFIGURING);
 
 	bg_action_ptr = xmalloc(sizeof(bg_action_t));
 	bg_action_ptr->op = START_OP;
@@ -310,6 +310,7 @@ extern int select_nodeinfo_set_all(void)
 		list_flush(nodeinfo->subgrp_list);
 		if (nodeinfo->bitmap_size != g_bitmap_size)
 			nodeinfo->bitmap_size = g_bitmap_size;
+		NODE_DELTA_TOUCH(node_ptr);
 	}
 
 	itr = list_iterator_create(bg_lists->main);
@@ -1974,6 +1974,7 @@ static int _check_all_blocks_error(int node_inx, time_t event_time,
 			node_ptr->reason = xstrdup(reason);
 			node_ptr->reason_time = event_time;
 			node_ptr->reason_uid = slurm_get_slurm_user_id();
+			NODE_DELTA_TOUCH(node_ptr);
 		}
 		send_node.node_state = NODE_STATE_ERROR;
 		rc = clusteracct_storage_g_node_down(acct_db_conn,
@@ -232,9 +232,10 @@ nochange_state:
 				       "to configuring",
 				       bg_record->job_ptr->job_id,
 				       bg_record->bg_block_id);
-				bg_record->job_ptr->job_state |=
-					JOB_CONFIGURING;
+				JOB_STATE_FLAG_SET(bg_record->job_ptr,
+						   JOB_CONFIGURING);
 				last_job_update = time(NULL);
+				JOB_DELTA_TOUCH(bg_record->job_ptr);
 			} else if (bg_record->job_list
 				   && list_count(bg_record->job_list)) {
 				struct job_record *job_ptr;
@@ -251,7 +252,9 @@ nochange_state:
 						list_delete_item(job_itr);
 						continue;
 					}
-					job_ptr->job_state |= JOB_CONFIGURING;
+					JOB_STATE_FLAG_SET(job_ptr,
+							   JOB_CONFIGURING);
+					JOB_DELTA_TOUCH(job_ptr);
 				}
 				list_iterator_destroy(job_itr);
 				last_job_update = time(NULL);
@@ -298,9 +301,10 @@ nochange_state:
 			      bg_record->bg_block_id);
 			if (bg_record->job_ptr
 			    && IS_JOB_CONFIGURING(bg_record->job_ptr)) {
-				bg_record->job_ptr->job_state &=
-					(~JOB_CONFIGURING);
+				JOB_STATE_FLAG_CLEAR(bg_record->job_ptr,
+						     JOB_CONFIGURING);
 				last_job_update = time(NULL);
+				JOB_DELTA_TOUCH(bg_record->job_ptr);
 			} else if (bg_record->job_list
 				   && list_count(bg_record->job_list)) {
 				struct job_record *job_ptr;
@@ -317,8 +321,9 @@ nochange_state:
 						list_delete_item(job_itr);
 						continue;
 					}
-					job_ptr->job_state &=
-						(~JOB_CONFIGURING);
+					JOB_STATE_FLAG_CLEAR(job_ptr,
+							     JOB_CONFIGURING);
+					JOB_DELTA_TOUCH(job_ptr);
 				}
 				list_iterator_destroy(job_itr);
 				last_job_update = time(NULL);
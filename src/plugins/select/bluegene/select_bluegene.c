@@ -65,6 +65,8 @@ int bg_recover __attribute__((weak_import)) = NOT_FROM_CONTROLLER;
 List part_list  __attribute__((weak_import)) = NULL;
 int node_record_count __attribute__((weak_import));
 time_t last_node_update __attribute__((weak_import));
+uint32_t node_delta_next_gen __attribute__((weak_import));
+bool node_delta_changed __attribute__((weak_import));
 time_t last_job_update __attribute__((weak_import));
 char *alpha_num  __attribute__((weak_import)) =
 	"0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
@@ -81,6 +83,8 @@ int bg_recover = NOT_FROM_CONTROLLER;
 List part_list = NULL;
 int node_record_count;
 time_t last_node_update;
+uint32_t node_delta_next_gen;
+bool node_delta_changed;
 time_t last_job_update;
 char *alpha_num = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
 void *acct_db_conn = NULL;
@@ -1747,8 +1751,9 @@ extern int select_p_job_ready(struct job_record *job_ptr)
 				   && (bg_record->state == BG_BLOCK_INITED)) {
 				/* Clear the state just incase we
 				 * missed it somehow. */
-				job_ptr->job_state &= (~JOB_CONFIGURING);
+				JOB_STATE_FLAG_CLEAR(job_ptr, JOB_CONFIGURING);
 				last_job_update = time(NULL);
+				JOB_DELTA_TOUCH(job_ptr);
 				rc = 1;
 			} else if (uid != job_ptr->user_id)
 				rc = 0;
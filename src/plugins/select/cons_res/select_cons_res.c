@@ -121,6 +121,8 @@ List part_list __attribute__((weak_import));
 List job_list __attribute__((weak_import));
 int node_record_count __attribute__((weak_import));
 time_t last_node_update __attribute__((weak_import));
+uint32_t node_delta_next_gen __attribute__((weak_import));
+bool node_delta_changed __attribute__((weak_import));
 struct switch_record *switch_record_table __attribute__((weak_import));
 int switch_record_cnt __attribute__((weak_import));
 bitstr_t *avail_node_bitmap __attribute__((weak_import));
@@ -134,6 +136,8 @@ List part_list;
 List job_list;
 int node_record_count;
 time_t last_node_update;
+uint32_t node_delta_next_gen;
+bool node_delta_changed;
 struct switch_record *switch_record_table;
 int switch_record_cnt;
 bitstr_t *avail_node_bitmap;
@@ -191,6 +195,7 @@ static bool select_state_initializing = true;
 static int select_node_cnt = 0;
 static int preempt_reorder_cnt = 1;
 static bool preempt_strict_order = false;
+static bool sparse_core_bitmaps = false;
 
 struct select_nodeinfo {
 	uint16_t magic;		/* magic number */
@@ -479,6 +484,19 @@ static void _destroy_node_data(struct node_use_record *node_usage,
 }
 
 
+/* Add a job's cores to a partition row's core bitmap, creating it if needed.
+ * On large systems a sparse bitmap holds long runs of idle or busy cores
+ * in little space. */
+static void _add_job_to_cores(struct job_resources *job,
+			      bitstr_t **row_bitmap)
+{
+	if (sparse_core_bitmaps && (*row_bitmap == NULL)) {
+		*row_bitmap = bit_alloc_sparse(
+			cr_node_cores_offset[select_node_cnt]);
+	}
+	add_job_to_cores(job, row_bitmap, cr_node_num_cores);
+}
+
 static void _add_job_to_row(struct job_resources *job,
 			    struct part_row_data *r_ptr)
 {
@@ -488,7 +506,7 @@ static void _add_job_to_row(struct job_resources *job,
 		uint32_t size = bit_size(r_ptr->row_bitmap);
 		bit_nclear(r_ptr->row_bitmap, 0, size-1);
 	}
-	add_job_to_cores(job, &(r_ptr->row_bitmap), cr_node_num_cores);
+	_add_job_to_cores(job, &(r_ptr->row_bitmap));
 
 	/*  add the job to the job_list */
 	if (r_ptr->num_jobs >= r_ptr->job_list_size) {
@@ -597,9 +615,8 @@ static void _build_row_bitmaps(struct part_res_record *p_ptr,
 				size = bit_size(this_row->row_bitmap);
 				bit_nclear(this_row->row_bitmap, 0, size-1);
 				for (j = 0; j < this_row->num_jobs; j++) {
-					add_job_to_cores(this_row->job_list[j],
-							 &(this_row->row_bitmap),
-							 cr_node_num_cores);
+					_add_job_to_cores(this_row->job_list[j],
+							  &(this_row->row_bitmap));
 				}
 			}
 		}
@@ -728,9 +745,8 @@ static void _build_row_bitmaps(struct part_res_record *p_ptr,
 			if (p_ptr->row[i].num_jobs == 0)
 				continue;
 			for (j = 0; j < p_ptr->row[i].num_jobs; j++) {
-				add_job_to_cores(p_ptr->row[i].job_list[j],
-						 &(p_ptr->row[i].row_bitmap),
-						 cr_node_num_cores);
+				_add_job_to_cores(p_ptr->row[i].job_list[j],
+						  &(p_ptr->row[i].row_bitmap));
 			}
 		}
 	}
@@ -1653,8 +1669,8 @@ top:	orig_map = bit_copy(save_bitmap);
 				    (mode != PREEMPT_MODE_CHECKPOINT) &&
 				    (mode != PREEMPT_MODE_CANCEL))
 					continue;
-				if (bit_overlap(bitmap,
-						tmp_job_ptr->node_bitmap) == 0)
+				if (!bit_overlap_any(bitmap,
+						tmp_job_ptr->node_bitmap))
 					continue;
 				list_append(*preemptee_job_list,
 					    tmp_job_ptr);
@@ -1825,8 +1841,8 @@ static int _will_run_test(struct job_record *job_ptr, bitstr_t *bitmap,
 		preemptee_iterator =list_iterator_create(preemptee_candidates);
 		while ((tmp_job_ptr = (struct job_record *)
 			list_next(preemptee_iterator))) {
-			if (bit_overlap(bitmap,
-					tmp_job_ptr->node_bitmap) == 0)
+			if (!bit_overlap_any(bitmap,
+					     tmp_job_ptr->node_bitmap))
 				continue;
 			list_append(*preemptee_job_list, tmp_job_ptr);
 		}
@@ -1976,6 +1992,10 @@ extern int select_p_node_init(struct node_record *node_ptr, int node_cnt)
 		backfill_busy_nodes = true;
 	else
 		backfill_busy_nodes = false;
+	if (sched_params && strstr(sched_params, "sparse_core_bitmaps"))
+		sparse_core_bitmaps = true;
+	else
+		sparse_core_bitmaps = false;
 	xfree(sched_params);
 
 	preempt_type = slurm_get_preempt_type();
@@ -2335,7 +2355,7 @@ extern int select_p_select_nodeinfo_set_all(void)
 	int i=0, n=0, start, end;
 	uint16_t tmp, tmp_16 = 0, tmp_part;
 	static time_t last_set_all = 0;
-	uint32_t node_threads, node_cpus;
+	uint32_t node_threads, node_cpus, alloc_memory;
 
 	/* only set this once when the last_node_update is newer than
 	 * the last time we set things up. */
@@ -2392,12 +2412,15 @@ extern int select_p_select_nodeinfo_set_all(void)
 		if ((end - start) < node_cpus)
 			tmp_16 *= node_threads;
 
-		nodeinfo->alloc_cpus = tmp_16;
-		if (select_node_record) {
-			nodeinfo->alloc_memory =
-				select_node_usage[n].alloc_memory;
-		} else {
-			nodeinfo->alloc_memory = 0;
+		if (select_node_record)
+			alloc_memory = select_node_usage[n].alloc_memory;
+		else
+			alloc_memory = 0;
+		if ((nodeinfo->alloc_cpus != tmp_16) ||
+		    (nodeinfo->alloc_memory != alloc_memory)) {
+			nodeinfo->alloc_cpus = tmp_16;
+			nodeinfo->alloc_memory = alloc_memory;
+			NODE_DELTA_TOUCH(node_ptr);
 		}
 	}
 
@@ -136,6 +136,8 @@ slurmdb_cluster_rec_t *working_cluster_rec  __attribute__((weak_import)) = NULL;
 struct node_record *node_record_table_ptr __attribute__((weak_import));
 int node_record_count __attribute__((weak_import));
 time_t last_node_update __attribute__((weak_import));
+uint32_t node_delta_next_gen __attribute__((weak_import));
+bool node_delta_changed __attribute__((weak_import));
 #else
 slurm_ctl_conf_t slurmctld_conf;
 int bg_recover = NOT_FROM_CONTROLLER;
@@ -143,6 +145,8 @@ slurmdb_cluster_rec_t *working_cluster_rec = NULL;
 struct node_record *node_record_table_ptr;
 int node_record_count;
 time_t last_node_update;
+uint32_t node_delta_next_gen;
+bool node_delta_changed;
 #endif
 
 static blade_info_t *blade_array = NULL;
@@ -1963,10 +1967,13 @@ extern int select_p_select_nodeinfo_set_all(void)
 	/* clear all marks */
 	for (i=0; i<node_record_count; i++) {
 		struct node_record *node_ptr = &(node_record_table_ptr[i]);
+		uint32_t node_state = node_ptr->node_state;
 		if (bit_test(blade_nodes_running_npc, i))
 			node_ptr->node_state |= NODE_STATE_NET;
 		else
 			node_ptr->node_state &= (~NODE_STATE_NET);
+		if (node_ptr->node_state != node_state)
+			NODE_DELTA_TOUCH(node_ptr);
 	}
 
 	slurm_mutex_unlock(&blade_mutex);
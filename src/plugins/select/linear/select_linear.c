@@ -94,6 +94,8 @@ List part_list __attribute__((weak_import));
 List job_list __attribute__((weak_import));
 int node_record_count __attribute__((weak_import));
 time_t last_node_update __attribute__((weak_import));
+uint32_t node_delta_next_gen __attribute__((weak_import));
+bool node_delta_changed __attribute__((weak_import));
 struct switch_record *switch_record_table __attribute__((weak_import));
 int switch_record_cnt __attribute__((weak_import));
 
@@ -109,6 +111,8 @@ List part_list;
 List job_list;
 int node_record_count;
 time_t last_node_update;
+uint32_t node_delta_next_gen;
+bool node_delta_changed;
 struct switch_record *switch_record_table;
 int switch_record_cnt;
 
@@ -3060,8 +3064,8 @@ top:	if ((rc != SLURM_SUCCESS) && preemptee_candidates &&
 				preemptee_candidates);
 			while ((tmp_job_ptr = (struct job_record *)
 				list_next(preemptee_iterator))) {
-				if (bit_overlap(bitmap,
-						tmp_job_ptr->node_bitmap) == 0)
+				if (!bit_overlap_any(bitmap,
+						tmp_job_ptr->node_bitmap))
 					continue;
 				if (tmp_job_ptr->details->usable_nodes == 0)
 					continue;
@@ -3205,7 +3209,7 @@ static int _will_run_test(struct job_record *job_ptr, bitstr_t *bitmap,
 		preemptee_iterator =list_iterator_create(preemptee_candidates);
 		while ((tmp_job_ptr = (struct job_record *)
 			list_next(preemptee_iterator))) {
-			if (bit_overlap(bitmap, tmp_job_ptr->node_bitmap) == 0)
+			if (!bit_overlap_any(bitmap, tmp_job_ptr->node_bitmap))
 				continue;
 
 			list_append(*preemptee_job_list, tmp_job_ptr);
@@ -3653,6 +3657,8 @@ extern int select_p_select_nodeinfo_set_all(void)
 	struct node_record *node_ptr = NULL;
 	int n;
 	static time_t last_set_all = 0;
+	uint16_t alloc_cpus;
+	uint32_t alloc_memory;
 
 	/* only set this once when the last_node_update is newer than
 	 * the last time we set things up. */
@@ -3680,16 +3686,21 @@ extern int select_p_select_nodeinfo_set_all(void)
 
 		if (IS_NODE_COMPLETING(node_ptr) || IS_NODE_ALLOCATED(node_ptr)) {
 			if (slurmctld_conf.fast_schedule)
-				nodeinfo->alloc_cpus =
-					node_ptr->config_ptr->cpus;
+				alloc_cpus = node_ptr->config_ptr->cpus;
 			else
-				nodeinfo->alloc_cpus = node_ptr->cpus;
+				alloc_cpus = node_ptr->cpus;
 		} else
-			nodeinfo->alloc_cpus = 0;
+			alloc_cpus = 0;
 		if (cr_ptr && cr_ptr->nodes) {
-			nodeinfo->alloc_memory = cr_ptr->nodes[n].alloc_memory;
+			alloc_memory = cr_ptr->nodes[n].alloc_memory;
 		} else {
-			nodeinfo->alloc_memory = 0;
+			alloc_memory = 0;
+		}
+		if ((nodeinfo->alloc_cpus != alloc_cpus) ||
+		    (nodeinfo->alloc_memory != alloc_memory)) {
+			nodeinfo->alloc_cpus = alloc_cpus;
+			nodeinfo->alloc_memory = alloc_memory;
+			NODE_DELTA_TOUCH(node_ptr);
 		}
 	}
 
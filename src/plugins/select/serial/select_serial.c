@@ -62,6 +62,8 @@ List part_list __attribute__((weak_import));
 List job_list __attribute__((weak_import));
 int node_record_count __attribute__((weak_import));
 time_t last_node_update __attribute__((weak_import));
+uint32_t node_delta_next_gen __attribute__((weak_import));
+bool node_delta_changed __attribute__((weak_import));
 struct switch_record *switch_record_table __attribute__((weak_import));
 int switch_record_cnt __attribute__((weak_import));
 bitstr_t *avail_node_bitmap __attribute__((weak_import));
@@ -75,6 +77,8 @@ List part_list;
 List job_list;
 int node_record_count;
 time_t last_node_update;
+uint32_t node_delta_next_gen;
+bool node_delta_changed;
 struct switch_record *switch_record_table;
 int switch_record_cnt;
 bitstr_t *avail_node_bitmap;
@@ -1336,8 +1340,8 @@ static int _will_run_test(struct job_record *job_ptr, bitstr_t *bitmap,
 		preemptee_iterator =list_iterator_create(preemptee_candidates);
 		while ((tmp_job_ptr = (struct job_record *)
 			list_next(preemptee_iterator))) {
-			if (bit_overlap(bitmap,
-					tmp_job_ptr->node_bitmap) == 0)
+			if (!bit_overlap_any(bitmap,
+					     tmp_job_ptr->node_bitmap))
 				continue;
 			list_append(*preemptee_job_list, tmp_job_ptr);
 		}
@@ -1897,7 +1901,10 @@ extern int select_p_select_nodeinfo_set_all(void)
 		if ((end - start) < node_cpus)
 			tmp_16 *= node_threads;
 
-		nodeinfo->alloc_cpus = tmp_16;
+		if (nodeinfo->alloc_cpus != tmp_16) {
+			nodeinfo->alloc_cpus = tmp_16;
+			NODE_DELTA_TOUCH(node_ptr);
+		}
 	}
 
 	return SLURM_SUCCESS;
@@ -188,6 +188,7 @@
 #define LONG_OPT_PARSABLE        0x157
 #define LONG_OPT_CPU_FREQ        0x158
 #define LONG_OPT_PRIORITY        0x160
+#define LONG_OPT_MANIFEST        0x161
 
 /*---- global variables, defined in opt.h ----*/
 opt_t opt;
@@ -749,6 +750,7 @@ static struct option long_options[] = {
 	{"linux-image",   required_argument, 0, LONG_OPT_LINUX_IMAGE},
 	{"mail-type",     required_argument, 0, LONG_OPT_MAIL_TYPE},
 	{"mail-user",     required_argument, 0, LONG_OPT_MAIL_USER},
+	{"manifest",      required_argument, 0, LONG_OPT_MANIFEST},
 	{"mem",           required_argument, 0, LONG_OPT_MEM},
 	{"mem-per-cpu",   required_argument, 0, LONG_OPT_MEM_PER_CPU},
 	{"mem_bind",      required_argument, 0, LONG_OPT_MEM_BIND},
@@ -856,6 +858,10 @@ char *process_options_first_pass(int argc, char **argv)
 		case LONG_OPT_WRAP:
 			opt.wrap = xstrdup(optarg);
 			break;
+		case LONG_OPT_MANIFEST:
+			xfree(opt.manifest);
+			opt.manifest = xstrdup(optarg);
+			break;
 		default:
 			/* will be parsed in second pass function */
 			break;
@@ -869,6 +875,11 @@ char *process_options_first_pass(int argc, char **argv)
 		      " --wrap option.");
 		exit(error_exit);
 	}
+	if (opt.manifest && ((argc > optind) || opt.wrap)) {
+		error("Script arguments and --wrap are not permitted with the"
+		      " --manifest option.");
+		exit(error_exit);
+	}
 	if (argc > optind) {
 		int i;
 		char **leftover;
@@ -1624,6 +1635,7 @@ static void _set_options(int argc, char **argv)
 			opt.reboot = true;
 			break;
 		case LONG_OPT_WRAP:
+		case LONG_OPT_MANIFEST:
 			/* handled in process_options_first_pass() */
 			break;
 		case LONG_OPT_GET_USER_ENV:
@@ -2977,7 +2989,8 @@ static void _usage(void)
 "              [--switches=max-switches{@max-time-to-wait}]\n"
 "              [--core-spec=cores] [--reboot] [--bb=burst_buffer_spec]\n"
 "              [--array=index_values] [--profile=...] [--ignore-pbs]\n"
-"              [--export[=names]] [--export-file=file|fd] executable [args...]\n");
+"              [--export[=names]] [--export-file=file|fd] executable [args...]\n"
+"       sbatch [OPTIONS...] --manifest=file\n");
 }
 
 static void _help(void)
@@ -3022,6 +3035,8 @@ static void _help(void)
 "      --mail-type=type        notify on state change: BEGIN, END, FAIL or ALL\n"
 "      --mail-user=user        who to send email notification for job state\n"
 "                              changes\n"
+"      --manifest=file         submit each batch script listed in file, one\n"
+"                              per line, with a single request\n"
 "  -n, --ntasks=ntasks         number of tasks to run\n"
 "      --nice[=value]          decrease scheduling priority by value\n"
 "      --no-requeue            if set, do not permit the job to be requeued\n"
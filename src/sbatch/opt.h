@@ -132,6 +132,7 @@ typedef struct sbatch_options {
 	int  verbose;
 	uint16_t wait_all_nodes;  /* --wait-nodes-ready=val	*/
 	char *wrap;
+	char *manifest;		/* --manifest=file		*/
 
 	/* constraint options */
 	int mincpus;		/* --mincpus=n			*/
@@ -42,9 +42,11 @@
 #endif
 
 #include <sys/resource.h> /* for RLIMIT_NOFILE */
+#include <ctype.h>
 #include <pwd.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -70,6 +72,7 @@ static void  _env_merge_filter(job_desc_msg_t *desc);
 static int   _fill_job_desc_from_opts(job_desc_msg_t *desc);
 static int   _check_cluster_specific_settings(job_desc_msg_t *desc);
 static void *_get_script_buffer(const char *filename, int *size);
+static int   _read_manifest(const char *filename, char ***script_names);
 static char *_script_wrap(char *command_string);
 static void  _set_exit_code(void);
 static void  _set_prio_process_env(void);
@@ -77,6 +80,8 @@ static int   _set_rlimit_env(void);
 static void  _set_spank_env(void);
 static void  _set_submit_dir_env(void);
 static int   _set_umask_env(void);
+static int   _submit_manifest(int argc, char *argv[]);
+static bool  _submit_retry(int *retries);
 
 int main(int argc, char *argv[])
 {
@@ -111,6 +116,9 @@ int main(int argc, char *argv[])
 		log_alter(logopt, 0, NULL);
 	}
 
+	if (opt.manifest)
+		exit(_submit_manifest(argc, argv));
+
 	if (opt.wrap != NULL) {
 		script_body = _script_wrap(opt.wrap);
 	} else {
@@ -180,30 +188,10 @@ int main(int argc, char *argv[])
 	}
 
 	while (slurm_submit_batch_job(&desc, &resp) < 0) {
-		static char *msg;
-
-		if (errno == ESLURM_ERROR_ON_DESC_TO_RECORD_COPY)
-			msg = "Slurm job queue full, sleeping and retrying.";
-		else if (errno == ESLURM_NODES_BUSY) {
-			msg = "Job step creation temporarily disabled, "
-			      "retrying";
-		} else if (errno == EAGAIN) {
-			msg = "Slurm temporarily unable to accept job, "
-			      "sleeping and retrying.";
-		} else
-			msg = NULL;
-		if ((msg == NULL) || (retries >= MAX_RETRIES)) {
+		if (!_submit_retry(&retries)) {
 			error("Batch job submission failed: %m");
 			exit(error_exit);
 		}
-
-		if (retries)
-			debug("%s", msg);
-		else if (errno == ESLURM_NODES_BUSY)
-			info("%s", msg); /* Not an error, powering up nodes */
-		else
-			error("%s", msg);
-		sleep (++retries);
         }
 
 	if (!opt.parsable){
@@ -223,6 +211,171 @@ int main(int argc, char *argv[])
 	return 0;
 }
 
+/* Log why a job submission failed and sleep before it is retried
+ * IN/OUT retries - count of retries made so far
+ * RET false if the error is not transient or too many retries were made,
+ *	errno is preserved */
+static bool _submit_retry(int *retries)
+{
+	char *msg;
+
+	if (errno == ESLURM_ERROR_ON_DESC_TO_RECORD_COPY)
+		msg = "Slurm job queue full, sleeping and retrying.";
+	else if (errno == ESLURM_NODES_BUSY) {
+		msg = "Job step creation temporarily disabled, "
+		      "retrying";
+	} else if (errno == EAGAIN) {
+		msg = "Slurm temporarily unable to accept job, "
+		      "sleeping and retrying.";
+	} else
+		msg = NULL;
+	if ((msg == NULL) || (*retries >= MAX_RETRIES))
+		return false;
+
+	if (*retries)
+		debug("%s", msg);
+	else if (errno == ESLURM_NODES_BUSY)
+		info("%s", msg); /* Not an error, powering up nodes */
+	else
+		error("%s", msg);
+	sleep(++(*retries));
+	return true;
+}
+
+/* Submit the batch scripts named in the --manifest file with one RPC.
+ * Options from the command line apply to every job, options from each script
+ * (e.g. "#SBATCH") only to that script's job.
+ * RET exit code */
+static int _submit_manifest(int argc, char *argv[])
+{
+	extern char **environ;
+	char **script_names = NULL, **save_env;
+	job_desc_msg_t **desc;
+	submit_response_multi_msg_t *resp = NULL;
+	void *script_body;
+	int script_cnt, script_size, i, rc = 0, retries = 0;
+
+	if (opt.clusters || opt.test_only) {
+		error("--clusters and --test-only are not supported with "
+		      "--manifest");
+		return error_exit;
+	}
+	script_cnt = _read_manifest(opt.manifest, &script_names);
+	if (script_cnt < 0)
+		return error_exit;
+	if (script_cnt == 0) {
+		error("No batch scripts listed in %s", opt.manifest);
+		return error_exit;
+	}
+
+	save_env = env_array_copy((const char **) environ);
+	desc = xmalloc(sizeof(job_desc_msg_t *) * script_cnt);
+	for (i = 0; i < script_cnt; i++) {
+		if (i) {
+			/* Discard options and environment variables set
+			 * for the previous script */
+			env_unset_environment();
+			env_array_set_environment(save_env);
+			(void) process_options_first_pass(argc, argv);
+		}
+		script_body = _get_script_buffer(script_names[i],
+						 &script_size);
+		if (script_body == NULL)
+			return error_exit;
+		if (process_options_second_pass(argc, argv,
+						xbasename(script_names[i]),
+						script_body, script_size) < 0) {
+			error("sbatch parameter parsing");
+			return error_exit;
+		}
+		if ((i == 0) && (spank_init_post_opt() < 0)) {
+			error("Plugin stack post-option processing failed");
+			return error_exit;
+		}
+		if (opt.get_user_env_time < 0)
+			(void) _set_rlimit_env();
+		if (opt.export_file != NULL)
+			env_unset_environment();
+		_set_prio_process_env();
+		_set_spank_env();
+		_set_submit_dir_env();
+		_set_umask_env();
+
+		desc[i] = xmalloc(sizeof(job_desc_msg_t));
+		slurm_init_job_desc_msg(desc[i]);
+		if (_fill_job_desc_from_opts(desc[i]) == -1)
+			return error_exit;
+		desc[i]->script = (char *) script_body;
+		if (_check_cluster_specific_settings(desc[i]) != SLURM_SUCCESS)
+			return error_exit;
+	}
+	env_array_free(save_env);
+
+	while (slurm_submit_batch_job_multi(desc, script_cnt, &resp) < 0) {
+		if (!_submit_retry(&retries)) {
+			error("Batch job submission failed: %m");
+			return error_exit;
+		}
+	}
+
+	for (i = 0; i < script_cnt; i++) {
+		if (resp->err_msg && resp->err_msg[i])
+			error("%s: %s", script_names[i], resp->err_msg[i]);
+		if (resp->job_id[i] == 0) {
+			error("Batch job submission failed for %s: %s",
+			      script_names[i],
+			      slurm_strerror(resp->error_code[i]));
+			rc = error_exit;
+		} else if (opt.parsable)
+			printf("%u\n", resp->job_id[i]);
+		else
+			printf("Submitted batch job %u\n", resp->job_id[i]);
+		xfree(desc[i]->script);
+		xfree(script_names[i]);
+	}
+	slurm_free_submit_response_multi_msg(resp);
+	xfree(script_names);
+	xfree(desc);
+
+	return rc;
+}
+
+/* Read the names of batch scripts from a --manifest file, one per line.
+ * Blank lines and lines starting with "#" are ignored.
+ * OUT script_names - xmalloc'ed array of xmalloc'ed names
+ * RET count of names or -1 on error */
+static int _read_manifest(const char *filename, char ***script_names)
+{
+	FILE *fp;
+	char line[MAXPATHLEN + 2], *name, *end;
+	int cnt = 0;
+
+	if (strcmp(filename, "-") == 0)
+		fp = stdin;
+	else if ((fp = fopen(filename, "r")) == NULL) {
+		error("Unable to open manifest file %s: %m", filename);
+		return -1;
+	}
+
+	while (fgets(line, sizeof(line), fp)) {
+		name = line;
+		while (isspace((int) name[0]))
+			name++;
+		end = name + strlen(name);
+		while ((end > name) && isspace((int) end[-1]))
+			end--;
+		end[0] = '\0';
+		if ((name[0] == '\0') || (name[0] == '#'))
+			continue;
+		xrealloc(*script_names, sizeof(char *) * (cnt + 1));
+		(*script_names)[cnt++] = xstrdup(name);
+	}
+
+	if (fp != stdin)
+		fclose(fp);
+	return cnt;
+}
+
 static char *_find_quote_token(char *tmp, char *sep, char **last)
 {
 	char *start, *quote_single = 0, *quote_double = 0;
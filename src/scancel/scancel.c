@@ -74,6 +74,8 @@
 
 
 static void  _cancel_jobs (int filter_cnt);
+static int   _kill_jobs (kill_jobs_msg_t *req, bool report_done);
+static int   _kill_jobs_by_filter (void);
 static void *_cancel_job_id (void *cancel_info);
 static void *_cancel_step_id (void *cancel_info);
 
@@ -84,6 +86,7 @@ static int  _multi_cluster(List clusters);
 static int  _proc_cluster(void);
 static int  _verify_job_ids (void);
 static int  _signal_job_by_str(void);
+static bool _use_kill_jobs(void);
 
 static job_info_msg_t * job_buffer_ptr = NULL;
 
@@ -99,6 +102,16 @@ typedef struct job_cancel_info {
 	pthread_cond_t  *num_active_threads_cond;
 } job_cancel_info_t;
 
+/* Jobs to be signaled using a single REQUEST_KILL_JOBS RPC */
+typedef struct kill_job_list {
+	uint32_t *job_id;
+	uint32_t cnt;
+	uint32_t size;
+} kill_job_list_t;
+
+static	kill_job_list_t kill_arrays;	/* entire job arrays */
+static	kill_job_list_t kill_jobs;	/* individual jobs */
+
 static	pthread_attr_t  attr;
 static	int num_active_threads = 0;
 static	pthread_mutex_t  num_active_threads_lock;
@@ -155,6 +168,12 @@ _proc_cluster(void)
 		return rc;
 	}
 
+	/* The controller can apply all filters except node list and wckey
+	 * itself, which avoids loading every job record */
+	if (_use_kill_jobs() && (opt.job_cnt == 0) &&
+	    (opt.nodelist == NULL) && (opt.wckey == NULL))
+		return _kill_jobs_by_filter();
+
 	_load_job_records();
 	rc = _verify_job_ids();
 	if ((opt.account) ||
@@ -391,6 +410,151 @@ _filter_job_records (void)
 	return filter_cnt;
 }
 
+/* _use_kill_jobs - return true if job signals can be sent using a single
+ * REQUEST_KILL_JOBS RPC. Other signals are sent directly to the slurmd
+ * daemons, and interactive mode confirms every job separately. */
+static bool
+_use_kill_jobs(void)
+{
+	if (opt.interactive)
+		return false;
+	if ((opt.signal == (uint16_t) -1) || (opt.signal == SIGKILL) ||
+	    (opt.signal == SIGSTOP) || (opt.signal == SIGCONT) ||
+	    opt.ctld || opt.clusters)
+		return true;
+	return false;
+}
+
+static void
+_queue_kill_job(kill_job_list_t *list, uint32_t job_id,
+		uint32_t array_job_id, uint32_t array_task_id)
+{
+	if (opt.signal == (uint16_t) -1) {
+		if (array_job_id) {
+			verbose("Terminating job %u_%u",
+				array_job_id, array_task_id);
+		} else
+			verbose("Terminating job %u", job_id);
+	} else {
+		if (array_job_id) {
+			verbose("Signal %u to job %u_%u",
+				opt.signal, array_job_id, array_task_id);
+		} else
+			verbose("Signal %u to job %u", opt.signal, job_id);
+	}
+
+	if (list->cnt >= list->size) {
+		list->size = MAX(64, list->size * 2);
+		xrealloc(list->job_id, sizeof(uint32_t) * list->size);
+	}
+	list->job_id[list->cnt++] = job_id;
+}
+
+/* _kill_job_list - signal the queued jobs, then empty the list */
+static void
+_kill_job_list(kill_job_list_t *list, uint16_t flags)
+{
+	kill_jobs_msg_t req;
+
+	if (list->cnt) {
+		memset(&req, 0, sizeof(kill_jobs_msg_t));
+		req.flags   = flags;
+		req.job_cnt = list->cnt;
+		req.job_id  = list->job_id;
+		(void) _kill_jobs(&req, false);
+	}
+	xfree(list->job_id);
+	list->cnt = list->size = 0;
+}
+
+/* _kill_jobs - send a REQUEST_KILL_JOBS RPC, then resend it for any jobs which
+ *	were in a transitional state and report the jobs which failed
+ * IN req - job list or filters, signal and flags are set here
+ * IN report_done - report jobs which were already done or not found
+ * RET 0 if all jobs were signaled, otherwise 1
+ */
+static int
+_kill_jobs(kill_jobs_msg_t *req, bool report_done)
+{
+	kill_jobs_resp_msg_t *resp = NULL;
+	uint32_t *retry_id = NULL, retry_cnt;
+	int error_code, i, j, rc = 0;
+
+	req->signal = opt.signal;
+	if (req->signal == (uint16_t) -1)
+		req->signal = SIGKILL;
+	if (opt.batch)
+		req->flags |= KILL_JOB_BATCH;
+
+	for (i = 0; i < MAX_CANCEL_RETRY; i++) {
+		if (slurm_kill_jobs(req, &resp) != SLURM_SUCCESS) {
+			error("Kill jobs error: %s",
+			      slurm_strerror(slurm_get_errno()));
+			rc = 1;
+			break;
+		}
+		if (resp == NULL)
+			break;
+
+		retry_cnt = 0;
+		xfree(retry_id);
+		for (j = 0; j < resp->err_cnt; j++) {
+			error_code = resp->error_code[j];
+			if ((error_code == ESLURM_TRANSITION_STATE_NO_UPDATE) &&
+			    (i < (MAX_CANCEL_RETRY - 1))) {
+				xrealloc(retry_id,
+					 sizeof(uint32_t) * (retry_cnt + 1));
+				retry_id[retry_cnt++] = resp->job_id[j];
+				continue;
+			}
+			rc = 1;
+			if (report_done || (opt.verbose > 0) ||
+			    ((error_code != ESLURM_ALREADY_DONE) &&
+			     (error_code != ESLURM_INVALID_JOB_ID)))
+				error("Kill job error on job id %u: %s",
+				      resp->job_id[j],
+				      slurm_strerror(error_code));
+		}
+		slurm_free_kill_jobs_resp_msg(resp);
+		resp = NULL;
+		if (retry_cnt == 0)
+			break;
+
+		/* Only retry the listed jobs in a transitional state */
+		req->job_cnt = retry_cnt;
+		req->job_id  = retry_id;
+		verbose("Job is in transistional state, retrying");
+		sleep(5 + i);
+	}
+	xfree(retry_id);
+
+	return rc;
+}
+
+/* _kill_jobs_by_filter - signal every job matching the user's filters with
+ *	a single RPC
+ * RET 0 if all jobs were signaled, otherwise 1
+ */
+static int
+_kill_jobs_by_filter(void)
+{
+	kill_jobs_msg_t req;
+
+	memset(&req, 0, sizeof(kill_jobs_msg_t));
+	req.account     = opt.account;
+	req.job_name    = opt.job_name;
+	req.partition   = opt.partition;
+	req.qos         = opt.qos;
+	req.reservation = opt.reservation;
+	req.state       = opt.state;
+	if (opt.user_name)
+		req.user_id = opt.user_id;
+	else
+		req.user_id = NO_VAL;
+
+	return _kill_jobs(&req, false);
+}
+
 static void
 _cancel_jobs_by_state(uint16_t job_state, int filter_cnt)
 {
@@ -398,9 +562,11 @@ _cancel_jobs_by_state(uint16_t job_state, int filter_cnt)
 	job_cancel_info_t *cancel_info;
 	job_info_t *job_ptr = job_buffer_ptr->job_array;
 	pthread_t  dummy;
+	bool use_kill_jobs = _use_kill_jobs();
 
-	/* Spawn a thread to cancel each job or job step marked for
-	 * cancellation */
+	/* Spawn a thread to cancel each job step marked for cancellation.
+	 * Jobs are queued and signaled together by _cancel_jobs() if
+	 * possible, otherwise a thread is spawned for each of them too. */
 	for (i = 0; i < job_buffer_ptr->record_count; i++) {
 		if (job_ptr[i].job_id == 0)
 			continue;
@@ -420,6 +586,25 @@ _cancel_jobs_by_state(uint16_t job_state, int filter_cnt)
 				    (_confirmation(i, opt.step_id[j]) == 0))
 					continue;
 
+				if (use_kill_jobs &&
+				    (opt.step_id[j] == SLURM_BATCH_SCRIPT)) {
+					if ((filter_cnt == 0) &&
+					    (opt.array_id[j] == NO_VAL) &&
+					    (opt.job_id[j] ==
+					     job_ptr[i].array_job_id)) {
+						opt.job_id[j] = NO_VAL;
+						_queue_kill_job(&kill_arrays,
+							job_ptr[i].array_job_id,
+							0, NO_VAL);
+					} else {
+						_queue_kill_job(&kill_jobs,
+							job_ptr[i].job_id,
+							job_ptr[i].array_job_id,
+							job_ptr[i].array_task_id);
+					}
+					break;
+				}
+
 				cancel_info =
 					(job_cancel_info_t *)
 					xmalloc(sizeof(job_cancel_info_t));
@@ -477,6 +662,9 @@ _cancel_jobs_by_state(uint16_t job_state, int filter_cnt)
 					 * are cancelled. */
 				}
 			}
+		} else if (use_kill_jobs) {
+			_queue_kill_job(&kill_jobs, job_ptr[i].job_id, 0,
+					NO_VAL);
 		} else {
 			if (opt.interactive &&
 			    (_confirmation(i, SLURM_BATCH_SCRIPT) == 0))
@@ -529,6 +717,11 @@ _cancel_jobs (int filter_cnt)
 	_cancel_jobs_by_state(JOB_PENDING, filter_cnt);
 	_cancel_jobs_by_state(JOB_END, filter_cnt);
 
+	/* Pending jobs were queued first, so they are signaled before the
+	 * running jobs release their resources */
+	_kill_job_list(&kill_jobs, 0);
+	_kill_job_list(&kill_arrays, KILL_JOB_ARRAY);
+
 	/* Wait for any spawned threads that have not finished */
 	pthread_mutex_lock( &num_active_threads_lock );
 	while (num_active_threads > 0) {
@@ -739,11 +932,39 @@ _signal_job_by_str(void)
 {
 	int cc, i;
 	int rc = 0;
+	kill_jobs_msg_t req;
+	char *end_ptr;
+	long int job_id;
 
 	if (opt.signal == (uint16_t) - 1)
 		opt.signal = SIGKILL;
 
+	/* Plain job IDs are signaled together, each of them may be a job
+	 * array. Job array expressions are sent one at a time. */
 	for (i = 0; opt.job_list[i]; i++) {
+		job_id = strtol(opt.job_list[i], &end_ptr, 10);
+		if ((job_id <= 0) || (job_id >= NO_VAL) || (end_ptr[0] != '\0'))
+			continue;
+		verbose("Terminating job %s", opt.job_list[i]);
+		xrealloc(kill_arrays.job_id,
+			 sizeof(uint32_t) * (kill_arrays.cnt + 1));
+		kill_arrays.job_id[kill_arrays.cnt++] = (uint32_t) job_id;
+	}
+	if (kill_arrays.cnt) {
+		memset(&req, 0, sizeof(kill_jobs_msg_t));
+		req.flags   = KILL_JOB_ARRAY;
+		req.job_cnt = kill_arrays.cnt;
+		req.job_id  = kill_arrays.job_id;
+		if (_kill_jobs(&req, (opt.verbose != -1)))
+			rc = -1;
+		xfree(kill_arrays.job_id);
+		kill_arrays.cnt = 0;
+	}
+
+	for (i = 0; opt.job_list[i]; i++) {
+		job_id = strtol(opt.job_list[i], &end_ptr, 10);
+		if ((job_id > 0) && (job_id < NO_VAL) && (end_ptr[0] == '\0'))
+			continue;
 		verbose("Terminating job %s", opt.job_list[i]);
 
 		cc = slurm_kill_job2(opt.job_list[i], opt.signal, 0);
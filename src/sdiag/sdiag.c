@@ -62,6 +62,7 @@ stats_info_response_msg_t *buf;
 uint32_t *rpc_type_ave_time = NULL, *rpc_user_ave_time = NULL;
 
 static int  _print_stats(void);
+static void _print_lock_stats(void);
 static void _sort_rpc(void);
 
 stats_info_request_msg_t req;
@@ -117,7 +118,17 @@ static int _print_stats(void)
 	printf("*******************************************************\n");
 
 	printf("Server thread count: %d\n", buf->server_thread_count);
-	printf("Agent queue size:    %d\n\n", buf->agent_queue_size);
+	printf("Agent queue size:    %d\n", buf->agent_queue_size);
+	printf("Agent queue max:     %u\n", buf->agent_queue_max);
+	printf("Agent count:         %u\n", buf->agent_count);
+	printf("Agent thread count:  %u\n", buf->agent_thread_count);
+	printf("Agent messages sent: %"PRIu64"\n", buf->agent_msg_count);
+	if (buf->req_time > buf->req_time_start) {
+		printf("Agent messages/sec:  %.2f\n",
+		       (double) buf->agent_msg_count /
+		       (buf->req_time - buf->req_time_start));
+	}
+	printf("\n");
 	printf("Jobs submitted: %d\n", buf->jobs_submitted);
 	printf("Jobs started:   %d\n", buf->jobs_started);
 	printf("Jobs completed: %d\n", buf->jobs_completed);
@@ -171,6 +182,29 @@ static int _print_stats(void)
 		printf("\tQueue length mean: %u\n",
 		       buf->bf_queue_len_sum / buf->bf_cycle_counter);
 	}
+	if (buf->bf_threads > 1) {
+		printf("\tThreads: %u\n", buf->bf_threads);
+		printf("\tParallel tests: %"PRIu64"\n", buf->bf_spec_tests);
+		printf("\tParallel tests used: %"PRIu64"\n",
+		       buf->bf_spec_used);
+	}
+
+	_print_lock_stats();
+
+	if (buf->job_hash_size) {
+		printf("\nJob hash table statistics\n");
+		printf("\tTable size:   %u\n", buf->job_hash_size);
+		printf("\tJob records:  %u\n", buf->job_hash_cnt);
+		printf("\tLoad factor:  %.2f\n",
+		       (double) buf->job_hash_cnt / buf->job_hash_size);
+		printf("\tLookups:      %"PRIu64"\n", buf->job_hash_lookups);
+		if (buf->job_hash_lookups) {
+			printf("\tMean probes:  %.2f\n",
+			       (double) buf->job_hash_probes /
+			       buf->job_hash_lookups);
+		}
+		printf("\tMax probes:   %u\n", buf->job_hash_probe_max);
+	}
 
 	printf("\nRemote Procedure Call statistics by message type\n");
 	for (i = 0; i < buf->rpc_type_size; i++) {
@@ -195,6 +229,41 @@ static int _print_stats(void)
 	return 0;
 }
 
+static void _print_lock_stats(void)
+{
+	static char *lock_names[] = {
+		"config read", "config write", "job read", "job write",
+		"node read", "node write", "partition read", "partition write"
+	};
+	static char *hist_names[] = {
+		"<10us", "<100us", "<1ms", "<10ms", "<100ms", "<1s", ">=1s"
+	};
+	int i, j;
+
+	if (!buf->lock_stat_size ||
+	    (buf->lock_stat_size > (sizeof(lock_names) / sizeof(char *))) ||
+	    (buf->lock_hist_size > (sizeof(hist_names) / sizeof(char *))))
+		return;
+
+	printf("\nLock wait statistics (microseconds)\n");
+	printf("\t%-16s %10s %8s %10s", "", "count", "ave_wait", "max_wait");
+	for (j = 0; j < buf->lock_hist_size; j++)
+		printf(" %8s", hist_names[j]);
+	printf("\n");
+	for (i = 0; i < buf->lock_stat_size; i++) {
+		printf("\t%-16s %10u %8"PRIu64" %10u", lock_names[i],
+		       buf->lock_cnt[i],
+		       buf->lock_cnt[i] ?
+		       (buf->lock_wait_time[i] / buf->lock_cnt[i]) : 0,
+		       buf->lock_wait_max[i]);
+		for (j = 0; j < buf->lock_hist_size; j++) {
+			printf(" %8u",
+			       buf->lock_wait_hist[i * buf->lock_hist_size + j]);
+		}
+		printf("\n");
+	}
+}
+
 static void _sort_rpc(void)
 {
 	int i, j;
@@ -1355,6 +1355,7 @@ static int _qos_job_time_out(struct job_record *job_ptr,
 
 		if (usage_mins >= qos_ptr->grp_cpu_mins) {
 			last_job_update = now;
+			JOB_DELTA_TOUCH(job_ptr);
 			info("Job %u timed out, "
 			     "the job is at or exceeds QOS %s's "
 			     "group max cpu minutes of %"PRIu64" "
@@ -1376,6 +1377,7 @@ static int _qos_job_time_out(struct job_record *job_ptr,
 
 		if (wall_mins >= qos_ptr->grp_wall) {
 			last_job_update = now;
+			JOB_DELTA_TOUCH(job_ptr);
 			info("Job %u timed out, "
 			     "the job is at or exceeds QOS %s's "
 			     "group wall limit of %u with %u",
@@ -1395,6 +1397,7 @@ static int _qos_job_time_out(struct job_record *job_ptr,
 
 		if (job_cpu_usage_mins >= qos_ptr->max_cpu_mins_pj) {
 			last_job_update = now;
+			JOB_DELTA_TOUCH(job_ptr);
 			info("Job %u timed out, "
 			     "the job is at or exceeds QOS %s's "
 			     "max cpu minutes of %"PRIu64" "
@@ -2569,6 +2572,7 @@ extern int acct_policy_update_pending_job(struct job_record *job_ptr)
 
 	if (update_accounting) {
 		last_job_update = time(NULL);
+		JOB_DELTA_TOUCH(job_ptr);
 		debug("limits changed for job %u: updating accounting",
 		      job_ptr->job_id);
 		if (details_ptr->begin_time) {
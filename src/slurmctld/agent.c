@@ -51,10 +51,19 @@
  *  be possible to execute the agent as an pthread, process, or even a daemon
  *  on some other computer.
  *
+ *  Requests are placed on a queue by agent_queue_request(). A single
+ *  dispatcher thread starts agents for queued requests as soon as the
+ *  MAX_AGENT_CNT limit permits, and re-issues requests queued for retry
+ *  after RPC_RETRY_INTERVAL seconds. Queued ping-type requests for the same
+ *  RPC are merged into one request rather than issued separately, and queued
+ *  job termination and prolog requests for the same node are sent together
+ *  as one REQUEST_NODE_MULTI_MSG.
+ *
  *  The main agent thread creates a separate thread for each node to be
- *  communicated with up to AGENT_THREAD_COUNT. A special watchdog thread
- *  sends SIGLARM to any threads that have been active (in DSH_ACTIVE state)
- *  for more than COMMAND_TIMEOUT seconds.
+ *  communicated with up to AGENT_THREAD_COUNT. While waiting for those
+ *  threads the agent itself acts as the watchdog, sending SIGUSR1 to any
+ *  threads that have been active (in DSH_ACTIVE state) for more than
+ *  COMMAND_TIMEOUT seconds.
  *  The agent responds to slurmctld via a function call or an RPC as required.
  *  For example, informing slurmctld that some node is not responding.
  *
@@ -89,6 +98,7 @@
 #include "src/common/parse_time.h"
 #include "src/common/slurm_protocol_api.h"
 #include "src/common/slurm_protocol_interface.h"
+#include "src/common/timers.h"
 #include "src/common/uid.h"
 #include "src/common/xsignal.h"
 #include "src/common/xassert.h"
@@ -172,6 +182,12 @@ typedef struct mail_info {
 	char *message;
 } mail_info_t;
 
+static void *_agent_mgr(void *no_data);
+static void *_agent_run(agent_arg_t *agent_arg_ptr);
+static void  _agent_wakeup(void);
+static int   _agent_dequeue(int min_wait, agent_arg_t **agent_arg_pptr);
+static bool  _coalesce_request(agent_arg_t *agent_arg_ptr);
+static bool  _merge_node_msg(agent_arg_t *agent_arg_ptr);
 static void _sig_handler(int dummy);
 static int  _batch_launch_defer(queued_request_t *queued_req_ptr);
 static inline int _comm_err(char *node_name, slurm_msg_type_t msg_type);
@@ -182,13 +198,17 @@ static void _notify_slurmctld_jobs(agent_info_t *agent_ptr);
 static void _notify_slurmctld_nodes(agent_info_t *agent_ptr,
 		int no_resp_cnt, int retry_cnt);
 static void _purge_agent_args(agent_arg_t *agent_arg_ptr);
+static void _requeue_request(agent_arg_t *agent_arg_ptr);
 static void _queue_agent_retry(agent_info_t * agent_info_ptr, int count);
 static int _setup_requeue(agent_arg_t *agent_arg_ptr, thd_t *thread_ptr,
 			  int count, int *spot);
 static void _spawn_retry_agent(agent_arg_t * agent_arg_ptr);
+static int  _sign_agent_creds(agent_arg_t **agent_args, int arg_cnt);
 static void *_thread_per_group_rpc(void *args);
+static void _update_node_data(List ret_list, uint16_t protocol_version);
 static int   _valid_agent_arg(agent_arg_t *agent_arg_ptr);
-static void *_wdog(void *args);
+static void  _wdog(agent_info_t *agent_ptr);
+static void  _wdog_scan(agent_info_t *agent_ptr, thd_complete_t *thd_comp);
 
 static mail_info_t *_mail_alloc(void);
 static void  _mail_free(void *arg);
@@ -203,6 +223,13 @@ static List mail_list = NULL;		/* pending e-mail requests */
 static pthread_mutex_t agent_cnt_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t  agent_cnt_cond  = PTHREAD_COND_INITIALIZER;
 static int agent_cnt = 0;
+static int agent_thread_cnt = 0;	/* active _thread_per_group_rpc */
+
+/* State of the dispatcher thread, see _agent_mgr() */
+static pthread_mutex_t agent_mgr_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  agent_mgr_cond  = PTHREAD_COND_INITIALIZER;
+static bool agent_mgr_running = false;
+static bool agent_mgr_work = false;
 
 static bool run_scheduler    = false;
 static bool wiki2_sched      = false;
@@ -218,16 +245,6 @@ static bool wiki2_sched_test = false;
  */
 void *agent(void *args)
 {
-	int i, delay, rc, retries = 0;
-	pthread_attr_t attr_wdog;
-	pthread_t thread_wdog = 0;
-	agent_arg_t *agent_arg_ptr = args;
-	agent_info_t *agent_info_ptr = NULL;
-	thd_t *thread_ptr;
-	task_info_t *task_specific_ptr;
-	time_t begin_time;
-	bool spawn_retry_agent = false;
-
 #if HAVE_SYS_PRCTL_H
 	if (prctl(PR_SET_NAME, "slurmctld_agent", NULL, NULL, NULL) < 0) {
 		error("%s: cannot set my name to %s %m",
@@ -237,17 +254,9 @@ void *agent(void *args)
 
 #if 0
 	info("Agent_cnt is %d of %d with msg_type %d",
-	     agent_cnt, MAX_AGENT_CNT, agent_arg_ptr->msg_type);
+	     agent_cnt, MAX_AGENT_CNT, ((agent_arg_t *)args)->msg_type);
 #endif
 	slurm_mutex_lock(&agent_cnt_mutex);
-	if (!wiki2_sched_test) {
-		char *sched_type = slurm_get_sched_type();
-		if (strcmp(sched_type, "sched/wiki2") == 0)
-			wiki2_sched = true;
-		xfree(sched_type);
-		wiki2_sched_test = true;
-	}
-
 	while (1) {
 		if (slurmctld_config.shutdown_time ||
 		    (agent_cnt < MAX_AGENT_CNT)) {
@@ -258,9 +267,55 @@ void *agent(void *args)
 		}
 	}
 	slurm_mutex_unlock(&agent_cnt_mutex);
+
+	return _agent_run((agent_arg_t *) args);
+}
+
+/* Agent started by the dispatcher thread, which has already counted it in
+ * agent_cnt */
+static void *_agent_reserved(void *args)
+{
+#if HAVE_SYS_PRCTL_H
+	if (prctl(PR_SET_NAME, "slurmctld_agent", NULL, NULL, NULL) < 0) {
+		error("%s: cannot set my name to %s %m",
+		      __func__, "slurmctld_agent");
+	}
+#endif
+	return _agent_run((agent_arg_t *) args);
+}
+
+/* Issue the RPCs of one request and process the responses. The caller must
+ * have incremented agent_cnt. */
+static void *_agent_run(agent_arg_t *agent_arg_ptr)
+{
+	int i, delay, rc;
+	agent_info_t *agent_info_ptr = NULL;
+	thd_t *thread_ptr;
+	task_info_t *task_specific_ptr;
+	time_t begin_time;
+	struct timespec ts = {0, 0};
+	thd_complete_t thd_comp;
+
+	slurm_mutex_lock(&agent_cnt_mutex);
+	if (!wiki2_sched_test) {
+		char *sched_type = slurm_get_sched_type();
+		if (strcmp(sched_type, "sched/wiki2") == 0)
+			wiki2_sched = true;
+		xfree(sched_type);
+		wiki2_sched_test = true;
+	}
+	slurm_mutex_unlock(&agent_cnt_mutex);
 	if (slurmctld_config.shutdown_time)
 		goto cleanup;
 
+	/* Credentials are normally signed in batches by the dispatcher,
+	 * this covers requests started by agent_retry() */
+	if (_sign_agent_creds(&agent_arg_ptr, 1) != SLURM_SUCCESS) {
+		_requeue_request(agent_arg_ptr);
+		agent_arg_ptr = NULL;
+		goto cleanup;
+	}
+
 	/* basic argument value tests */
 	begin_time = time(NULL);
 	if (_valid_agent_arg(agent_arg_ptr))
@@ -270,19 +325,6 @@ void *agent(void *args)
 	agent_info_ptr = _make_agent_info(agent_arg_ptr);
 	thread_ptr = agent_info_ptr->thread_struct;
 
-	/* start the watchdog thread */
-	slurm_attr_init(&attr_wdog);
-	if (pthread_attr_setdetachstate
-	    (&attr_wdog, PTHREAD_CREATE_JOINABLE))
-		error("pthread_attr_setdetachstate error %m");
-	while (pthread_create(&thread_wdog, &attr_wdog, _wdog,
-			      (void *) agent_info_ptr)) {
-		error("pthread_create error %m");
-		if (++retries > MAX_RETRIES)
-			fatal("Can't create pthread");
-		usleep(10000);	/* sleep and retry */
-	}
-	slurm_attr_destroy(&attr_wdog);
 #if 	AGENT_THREAD_COUNT < 1
 	fatal("AGENT_THREAD_COUNT value is invalid");
 #endif
@@ -290,12 +332,21 @@ void *agent(void *args)
 	/* start all the other threads (up to AGENT_THREAD_COUNT active) */
 	for (i = 0; i < agent_info_ptr->thread_count; i++) {
 
-		/* wait until "room" for another thread */
+		/* wait until "room" for another thread, signalling any
+		 * threads which have been active too long meanwhile */
 		slurm_mutex_lock(&agent_info_ptr->thread_mutex);
 		while (agent_info_ptr->threads_active >=
 		       AGENT_THREAD_COUNT) {
-			pthread_cond_wait(&agent_info_ptr->thread_cond,
-					  &agent_info_ptr->thread_mutex);
+			ts.tv_sec = time(NULL) + 1;
+			pthread_cond_timedwait(&agent_info_ptr->thread_cond,
+					       &agent_info_ptr->thread_mutex,
+					       &ts);
+			if (agent_info_ptr->threads_active <
+			    AGENT_THREAD_COUNT)
+				break;
+			memset(&thd_comp, 0, sizeof(thd_complete_t));
+			thd_comp.now = time(NULL);
+			_wdog_scan(agent_info_ptr, &thd_comp);
 		}
 
 		/* create thread specific data, NOTE: freed from
@@ -327,10 +378,13 @@ void *agent(void *args)
 		slurm_attr_destroy(&thread_ptr[i].attr);
 		agent_info_ptr->threads_active++;
 		slurm_mutex_unlock(&agent_info_ptr->thread_mutex);
+		slurm_mutex_lock(&agent_cnt_mutex);
+		agent_thread_cnt++;
+		slurm_mutex_unlock(&agent_cnt_mutex);
 	}
 
 	/* Wait for termination of remaining threads */
-	pthread_join(thread_wdog, NULL);
+	_wdog(agent_info_ptr);
 	delay = (int) difftime(time(NULL), begin_time);
 	if (delay > (slurm_get_msg_timeout() * 2)) {
 		info("agent msg_type=%u ran for %d seconds",
@@ -359,14 +413,11 @@ void *agent(void *args)
 		agent_cnt = 0;
 	}
 
-	if (agent_cnt && (agent_cnt < MAX_AGENT_CNT))
-		spawn_retry_agent = true;
-
 	pthread_cond_broadcast(&agent_cnt_cond);
 	slurm_mutex_unlock(&agent_cnt_mutex);
 
-	if (spawn_retry_agent)
-		agent_retry(RPC_RETRY_INTERVAL, true);
+	/* Let the dispatcher start another queued request */
+	_agent_wakeup();
 
 	return NULL;
 }
@@ -534,22 +585,51 @@ static void _update_wdog_state(thd_t *thread_ptr,
 }
 
 /*
- * _wdog - Watchdog thread. Send SIGUSR1 to threads which have been active
- *	for too long.
- * IN args - pointer to agent_info_t with info on threads to watch
- * Sleep between polls with exponential times (from 0.125 to 1.0 second)
+ * _wdog_scan - Update thd_comp with the state of every thread of an agent and
+ *	send SIGUSR1 to threads which have been active for too long.
+ *	Call with agent_ptr->thread_mutex locked.
  */
-static void *_wdog(void *args)
+static void _wdog_scan(agent_info_t *agent_ptr, thd_complete_t *thd_comp)
 {
-	bool srun_agent = false;
 	int i;
-	agent_info_t *agent_ptr = (agent_info_t *) args;
 	thd_t *thread_ptr = agent_ptr->thread_struct;
-	unsigned long usec = 5000;
 	ListIterator itr;
-	thd_complete_t thd_comp;
 	ret_data_info_t *ret_data_info = NULL;
 
+	for (i = 0; i < agent_ptr->thread_count; i++) {
+		//info("thread name %s",thread_ptr[i].node_name);
+		if (!thread_ptr[i].ret_list) {
+			_update_wdog_state(&thread_ptr[i],
+					   &thread_ptr[i].state,
+					   thd_comp);
+		} else {
+			itr = list_iterator_create(thread_ptr[i].ret_list);
+			while ((ret_data_info = list_next(itr))) {
+				_update_wdog_state(&thread_ptr[i],
+						   &ret_data_info->err,
+						   thd_comp);
+			}
+			list_iterator_destroy(itr);
+		}
+	}
+}
+
+/*
+ * _wdog - Wait for all threads of an agent to complete, sending SIGUSR1 to
+ *	threads which have been active for too long, then process the results.
+ *	Executed by the agent thread itself once all of its threads have been
+ *	started.
+ * IN agent_ptr - pointer to agent_info_t with info on threads to watch
+ * Threads signal thread_cond on completion, otherwise rescan every second
+ */
+static void _wdog(agent_info_t *agent_ptr)
+{
+	bool srun_agent = false;
+	int i;
+	thd_t *thread_ptr = agent_ptr->thread_struct;
+	thd_complete_t thd_comp;
+	struct timespec ts = {0, 0};
+
 	if ( (agent_ptr->msg_type == SRUN_JOB_COMPLETE)			||
 	     (agent_ptr->msg_type == SRUN_REQUEST_SUSPEND)		||
 	     (agent_ptr->msg_type == SRUN_STEP_MISSING)			||
@@ -564,6 +644,7 @@ static void *_wdog(void *args)
 
 	thd_comp.max_delay = 0;
 
+	slurm_mutex_lock(&agent_ptr->thread_mutex);
 	while (1) {
 		thd_comp.work_done   = true;/* assume all threads complete */
 		thd_comp.fail_cnt    = 0;   /* assume no threads failures */
@@ -571,31 +652,13 @@ static void *_wdog(void *args)
 		thd_comp.retry_cnt   = 0;   /* assume no required retries */
 		thd_comp.now         = time(NULL);
 
-		usleep(usec);
-		usec = MIN((usec * 2), 1000000);
-
-		slurm_mutex_lock(&agent_ptr->thread_mutex);
-		for (i = 0; i < agent_ptr->thread_count; i++) {
-			//info("thread name %s",thread_ptr[i].node_name);
-			if (!thread_ptr[i].ret_list) {
-				_update_wdog_state(&thread_ptr[i],
-						   &thread_ptr[i].state,
-						   &thd_comp);
-			} else {
-				itr = list_iterator_create(
-					thread_ptr[i].ret_list);
-				while((ret_data_info = list_next(itr))) {
-					_update_wdog_state(&thread_ptr[i],
-							   &ret_data_info->err,
-							   &thd_comp);
-				}
-				list_iterator_destroy(itr);
-			}
-		}
+		_wdog_scan(agent_ptr, &thd_comp);
 		if (thd_comp.work_done)
 			break;
 
-		slurm_mutex_unlock(&agent_ptr->thread_mutex);
+		ts.tv_sec = thd_comp.now + 1;
+		pthread_cond_timedwait(&agent_ptr->thread_cond,
+				       &agent_ptr->thread_mutex, &ts);
 	}
 
 	if (srun_agent) {
@@ -616,7 +679,6 @@ static void *_wdog(void *args)
 		debug2("agent maximum delay %d seconds", thd_comp.max_delay);
 
 	slurm_mutex_unlock(&agent_ptr->thread_mutex);
-	return (void *) NULL;
 }
 
 static void _notify_slurmctld_jobs(agent_info_t *agent_ptr)
@@ -793,6 +855,76 @@ static int _wif_status(void)
 	return rc;
 }
 
+/*
+ * _update_node_data - Record the CPU load, energy data and registrations
+ *	returned by a group of nodes. The forward tree returns the replies of
+ *	many nodes together, so apply them with one hold of the locks rather
+ *	than one per node.
+ * IN ret_list - ret_data_info_t replies to the RPC
+ * IN protocol_version - version of the RPC, and so of the nodes replying
+ *	with a registration
+ */
+static void _update_node_data(List ret_list, uint16_t protocol_version)
+{
+	ListIterator itr;
+	ret_data_info_t *ret_data_info;
+	ping_slurmd_resp_msg_t *ping_resp;
+	slurm_node_registration_status_msg_t *reg_msg;
+	List reg_list = NULL;
+	bool node_data = false;
+	/* Lock: Write node */
+	slurmctld_lock_t node_write_lock = {
+		NO_LOCK, NO_LOCK, WRITE_LOCK, NO_LOCK };
+
+	itr = list_iterator_create(ret_list);
+	while ((ret_data_info = list_next(itr))) {
+		if ((ret_data_info->type == RESPONSE_PING_SLURMD) ||
+		    (ret_data_info->type == RESPONSE_ACCT_GATHER_UPDATE)) {
+			node_data = true;
+		} else if (ret_data_info->type ==
+			   MESSAGE_NODE_REGISTRATION_STATUS) {
+			reg_msg = (slurm_node_registration_status_msg_t *)
+				  ret_data_info->data;
+			/* A node may only register itself */
+			if (xstrcmp(reg_msg->node_name,
+				    ret_data_info->node_name)) {
+				error("%s: registration of node %s returned "
+				      "by node %s, ignored", __func__,
+				      reg_msg->node_name,
+				      ret_data_info->node_name);
+				continue;
+			}
+			if (!reg_list)
+				reg_list = list_create(NULL);
+			list_append(reg_list, ret_data_info->data);
+		}
+	}
+
+	if (node_data) {
+		list_iterator_reset(itr);
+		lock_slurmctld(node_write_lock);
+		while ((ret_data_info = list_next(itr))) {
+			if (ret_data_info->type == RESPONSE_PING_SLURMD) {
+				ping_resp = (ping_slurmd_resp_msg_t *)
+					    ret_data_info->data;
+				reset_node_load(ret_data_info->node_name,
+						ping_resp->cpu_load);
+			} else if (ret_data_info->type ==
+				   RESPONSE_ACCT_GATHER_UPDATE) {
+				update_node_record_acct_gather_data(
+					ret_data_info->data);
+			}
+		}
+		unlock_slurmctld(node_write_lock);
+	}
+	list_iterator_destroy(itr);
+
+	if (reg_list) {
+		validate_node_reg_list(reg_list, protocol_version);
+		list_destroy(reg_list);
+	}
+}
+
 /*
  * _thread_per_group_rpc - thread to issue an RPC for a group of nodes
  *                         sending message out to one and forwarding it to
@@ -826,9 +958,6 @@ static void *_thread_per_group_rpc(void *args)
 	/* Lock: Read node */
 	slurmctld_lock_t node_read_lock = {
 		NO_LOCK, NO_LOCK, READ_LOCK, NO_LOCK };
-	/* Lock: Write node */
-	slurmctld_lock_t node_write_lock = {
-		NO_LOCK, NO_LOCK, WRITE_LOCK, NO_LOCK };
 
 	xassert(args != NULL);
 	xsignal(SIGUSR1, _sig_handler);
@@ -861,6 +990,10 @@ static void *_thread_per_group_rpc(void *args)
 
 	msg.msg_type = msg_type;
 	msg.data     = task_ptr->msg_args_ptr;
+	/* Registrations returned as replies are validated by
+	 * _update_node_data() */
+	if (msg_type == REQUEST_NODE_REGISTRATION_STATUS)
+		msg.flags |= SLURM_NODE_REG_REPLY;
 #if 0
  	info("sending message type %u to %s", msg_type, thread_ptr->nodelist);
 #endif
@@ -914,20 +1047,11 @@ static void *_thread_per_group_rpc(void *args)
 	}
 
 	//info("got %d messages back", list_count(ret_list));
+	_update_node_data(ret_list, msg.protocol_version);
 	itr = list_iterator_create(ret_list);
 	while ((ret_data_info = list_next(itr)) != NULL) {
 		rc = slurm_get_return_code(ret_data_info->type,
 					   ret_data_info->data);
-		/* SPECIAL CASE: Record node's CPU load */
-		if (ret_data_info->type == RESPONSE_PING_SLURMD) {
-			ping_slurmd_resp_msg_t *ping_resp;
-			ping_resp = (ping_slurmd_resp_msg_t *)
-				    ret_data_info->data;
-			lock_slurmctld(node_write_lock);
-			reset_node_load(ret_data_info->node_name,
-					ping_resp->cpu_load);
-			unlock_slurmctld(node_write_lock);
-		}
 		/* SPECIAL CASE: Mark node as IDLE if job already complete */
 		if (is_kill_msg &&
 		    (rc == ESLURMD_KILL_JOB_ALREADY_COMPLETE)) {
@@ -944,14 +1068,6 @@ static void *_thread_per_group_rpc(void *args)
 			unlock_slurmctld(job_write_lock);
 		}
 
-		/* SPECIAL CASE: Record node's CPU load */
-		if (ret_data_info->type == RESPONSE_ACCT_GATHER_UPDATE) {
-			lock_slurmctld(node_write_lock);
-			update_node_record_acct_gather_data(
-				ret_data_info->data);
-			unlock_slurmctld(node_write_lock);
-		}
-
 		/* SPECIAL CASE: Kill non-startable batch job,
 		 * Requeue the job on ESLURMD_PROLOG_FAILED */
 		if ((msg_type == REQUEST_BATCH_JOB_LAUNCH) &&
@@ -1044,6 +1160,14 @@ cleanup:
 
 	/* handled at end of thread just in case resend is needed */
 	destroy_forward(&msg.forward);
+	slurm_mutex_lock(&agent_cnt_mutex);
+	if (ret_list)
+		slurmctld_diag_stats.agent_msg_cnt += list_count(ret_list);
+	else if (thread_state == DSH_DONE)
+		slurmctld_diag_stats.agent_msg_cnt++;
+	if (agent_thread_cnt > 0)
+		agent_thread_cnt--;
+	slurm_mutex_unlock(&agent_cnt_mutex);
 	slurm_mutex_lock(thread_mutex_ptr);
 	thread_ptr->ret_list = ret_list;
 	thread_ptr->state = thread_state;
@@ -1154,6 +1278,9 @@ static void _queue_agent_retry(agent_info_t * agent_info_ptr, int count)
 	}
 	if (list_append(retry_list, (void *) queued_req_ptr) == 0)
 		fatal("list_append failed");
+	slurmctld_diag_stats.agent_queue_max =
+		MAX(slurmctld_diag_stats.agent_queue_max,
+		    list_count(retry_list));
 	slurm_mutex_unlock(&retry_mutex);
 }
 
@@ -1183,6 +1310,35 @@ static void _list_delete_retry(void *retry_entry)
  * RET count of queued requests remaining
  */
 extern int agent_retry (int min_wait, bool mail_too)
+{
+	int list_size;
+	agent_arg_t *agent_arg_ptr = NULL;
+
+	list_size = _agent_dequeue(min_wait, &agent_arg_ptr);
+	if (agent_arg_ptr)
+		_spawn_retry_agent(agent_arg_ptr);
+	else if (mail_too) {
+		mail_info_t *mi = NULL;
+		slurm_mutex_lock(&mail_mutex);
+		if (mail_list)
+			mi = (mail_info_t *) list_dequeue(mail_list);
+		slurm_mutex_unlock(&mail_mutex);
+		if (mi)
+			_mail_proc(mi);
+	}
+
+	return list_size;
+}
+
+/*
+ * _agent_dequeue - Remove one queued request from retry_list, if any request
+ *	is ready and the count of agents permits. The agent for the request
+ *	is counted in agent_cnt, it must be started with _spawn_retry_agent()
+ * IN min_wait - Minimum wait time between re-issue of a pending RPC
+ * OUT agent_arg_pptr - the request to start or NULL
+ * RET count of queued requests remaining
+ */
+static int _agent_dequeue(int min_wait, agent_arg_t **agent_arg_pptr)
 {
 	int list_size = 0, rc;
 	time_t now = time(NULL);
@@ -1190,6 +1346,8 @@ extern int agent_retry (int min_wait, bool mail_too)
 	agent_arg_t *agent_arg_ptr = NULL;
 	ListIterator retry_iter;
 
+	*agent_arg_pptr = NULL;
+
 	slurm_mutex_lock(&retry_mutex);
 	if (retry_list) {
 		static time_t last_msg_time = (time_t) 0;
@@ -1216,12 +1374,15 @@ extern int agent_retry (int min_wait, bool mail_too)
 		}
 	}
 
+	/* Count the agent now, with the same hold of agent_cnt_mutex as the
+	 * test, so no more than MAX_AGENT_CNT agents are started */
 	slurm_mutex_lock(&agent_cnt_mutex);
 	if (agent_cnt >= MAX_AGENT_CNT) {	/* too much work already */
 		slurm_mutex_unlock(&agent_cnt_mutex);
 		slurm_mutex_unlock(&retry_mutex);
 		return list_size;
 	}
+	agent_cnt++;
 	slurm_mutex_unlock(&agent_cnt_mutex);
 
 	if (retry_list) {
@@ -1284,23 +1445,245 @@ extern int agent_retry (int min_wait, bool mail_too)
 	if (queued_req_ptr) {
 		agent_arg_ptr = queued_req_ptr->agent_arg_ptr;
 		xfree(queued_req_ptr);
-		if (agent_arg_ptr) {
-			_spawn_retry_agent(agent_arg_ptr);
-		} else
+		if (agent_arg_ptr)
+			*agent_arg_pptr = agent_arg_ptr;
+		else
 			error("agent_retry found record with no agent_args");
-	} else if (mail_too) {
-		mail_info_t *mi = NULL;
-		slurm_mutex_lock(&mail_mutex);
-		if (mail_list)
-			mi = (mail_info_t *) list_dequeue(mail_list);
-		slurm_mutex_unlock(&mail_mutex);
-		if (mi)
-			_mail_proc(mi);
+	}
+	if (!*agent_arg_pptr) {
+		/* No agent to start, release its count */
+		slurm_mutex_lock(&agent_cnt_mutex);
+		if (agent_cnt > 0)
+			agent_cnt--;
+		pthread_cond_broadcast(&agent_cnt_cond);
+		slurm_mutex_unlock(&agent_cnt_mutex);
 	}
 
 	return list_size;
 }
 
+/* Wake the dispatcher thread to start queued requests, starting the thread
+ * if it is not running yet */
+static void _agent_wakeup(void)
+{
+	pthread_attr_t attr_agent;
+	pthread_t thread_agent;
+
+	slurm_mutex_lock(&agent_mgr_mutex);
+	agent_mgr_work = true;
+	if (agent_mgr_running) {
+		pthread_cond_signal(&agent_mgr_cond);
+	} else if (!slurmctld_config.shutdown_time) {
+		slurm_attr_init(&attr_agent);
+		if (pthread_attr_setdetachstate(&attr_agent,
+						PTHREAD_CREATE_DETACHED))
+			error("pthread_attr_setdetachstate error %m");
+		if (pthread_create(&thread_agent, &attr_agent, _agent_mgr,
+				   NULL))
+			error("pthread_create error %m");
+		else
+			agent_mgr_running = true;
+		slurm_attr_destroy(&attr_agent);
+	}
+	slurm_mutex_unlock(&agent_mgr_mutex);
+}
+
+/*
+ * _agent_mgr - Dispatcher thread. Start agents for queued requests whenever
+ *	new work is queued or an agent completes, for as long as MAX_AGENT_CNT
+ *	permits. Also wake every second so that requests queued for retry and
+ *	deferred batch job launches are started when due.
+ */
+static void *_agent_mgr(void *no_data)
+{
+	struct timespec ts = {0, 0};
+	agent_arg_t *agent_args[MAX_AGENT_CNT];
+	int cnt, i;
+
+#if HAVE_SYS_PRCTL_H
+	if (prctl(PR_SET_NAME, "slurmctld_agmgr", NULL, NULL, NULL) < 0) {
+		error("%s: cannot set my name to %s %m",
+		      __func__, "slurmctld_agmgr");
+	}
+#endif
+
+	slurm_mutex_lock(&agent_mgr_mutex);
+	while (!slurmctld_config.shutdown_time) {
+		if (!agent_mgr_work) {
+			ts.tv_sec = time(NULL) + 1;
+			pthread_cond_timedwait(&agent_mgr_cond,
+					       &agent_mgr_mutex, &ts);
+		}
+		agent_mgr_work = false;
+		slurm_mutex_unlock(&agent_mgr_mutex);
+
+		/* Take every request that can be started now, so their
+		 * credentials are signed together */
+		do {
+			for (cnt = 0; cnt < MAX_AGENT_CNT; cnt++) {
+				(void) _agent_dequeue(RPC_RETRY_INTERVAL,
+						      &agent_args[cnt]);
+				if (!agent_args[cnt])
+					break;
+			}
+			if (cnt)
+				(void) _sign_agent_creds(agent_args, cnt);
+			for (i = 0; i < cnt; i++)
+				_spawn_retry_agent(agent_args[i]);
+		} while (cnt && !slurmctld_config.shutdown_time);
+
+		slurm_mutex_lock(&agent_mgr_mutex);
+	}
+	agent_mgr_running = false;
+	slurm_mutex_unlock(&agent_mgr_mutex);
+
+	return NULL;
+}
+
+/*
+ * _coalesce_request - Merge a request into an identical request which is
+ *	queued but not yet started, so each node is only sent the RPC once.
+ *	Only done for ping-type RPCs without arguments, each of which is
+ *	paired with a ping_begin() call. Call with retry_mutex locked.
+ * IN agent_arg_ptr - new request, purged if merged
+ * RET true if merged
+ */
+static bool _coalesce_request(agent_arg_t *agent_arg_ptr)
+{
+	queued_request_t *queued_req_ptr;
+	agent_arg_t *queued_arg_ptr;
+	ListIterator retry_iter;
+	bool merged = false;
+
+	if (((agent_arg_ptr->msg_type != REQUEST_PING) &&
+	     (agent_arg_ptr->msg_type != REQUEST_HEALTH_CHECK) &&
+	     (agent_arg_ptr->msg_type != REQUEST_ACCT_GATHER_UPDATE) &&
+	     (agent_arg_ptr->msg_type != REQUEST_NODE_REGISTRATION_STATUS)) ||
+	    agent_arg_ptr->msg_args || agent_arg_ptr->addr || !retry_list)
+		return false;
+
+	retry_iter = list_iterator_create(retry_list);
+	while ((queued_req_ptr = (queued_request_t *)
+				 list_next(retry_iter))) {
+		queued_arg_ptr = queued_req_ptr->agent_arg_ptr;
+		if ((queued_req_ptr->last_attempt != 0) ||
+		    (queued_arg_ptr->msg_type != agent_arg_ptr->msg_type) ||
+		    (queued_arg_ptr->protocol_version !=
+		     agent_arg_ptr->protocol_version) ||
+		    (queued_arg_ptr->retry != agent_arg_ptr->retry) ||
+		    queued_arg_ptr->msg_args || queued_arg_ptr->addr)
+			continue;
+		hostlist_push_list(queued_arg_ptr->hostlist,
+				   agent_arg_ptr->hostlist);
+		hostlist_uniq(queued_arg_ptr->hostlist);
+		queued_arg_ptr->node_count =
+			hostlist_count(queued_arg_ptr->hostlist);
+		merged = true;
+		break;
+	}
+	list_iterator_destroy(retry_iter);
+
+	if (merged) {
+		debug2("Merged RPC msg_type=%u into queued request for %u nodes",
+		       agent_arg_ptr->msg_type, queued_arg_ptr->node_count);
+		_purge_agent_args(agent_arg_ptr);
+		ping_end();	/* The queued request's ping_end covers it */
+	}
+	return merged;
+}
+
+/* Return true if a request is a single node job termination or prolog
+ * request which may be sent as part of a REQUEST_NODE_MULTI_MSG */
+static bool _node_msg_mergeable(agent_arg_t *agent_arg_ptr)
+{
+	if ((agent_arg_ptr->node_count != 1) || agent_arg_ptr->addr ||
+	    !agent_arg_ptr->msg_args)
+		return false;
+	/* An unknown (zero) version may be an older slurmd */
+	if (agent_arg_ptr->protocol_version < SLURM_15_08_PROTOCOL_VERSION)
+		return false;
+	return node_multi_msg_type(agent_arg_ptr->msg_type);
+}
+
+/*
+ * _merge_node_msg - Merge a single node job termination or prolog request
+ *	into a request for the same node which is queued but not yet started,
+ *	so several jobs ending or starting on a node cost one RPC.
+ *	Call with retry_mutex locked.
+ * IN agent_arg_ptr - new request, its hostlist is purged if merged
+ * RET true if merged
+ */
+static bool _merge_node_msg(agent_arg_t *agent_arg_ptr)
+{
+	queued_request_t *queued_req_ptr;
+	agent_arg_t *queued_arg_ptr;
+	node_multi_msg_t *multi_msg;
+	ListIterator retry_iter;
+	char *host, *queued_host;
+	bool merged = false;
+
+	if (!retry_list || !_node_msg_mergeable(agent_arg_ptr))
+		return false;
+
+	host = hostlist_nth(agent_arg_ptr->hostlist, 0);
+	retry_iter = list_iterator_create(retry_list);
+	while ((queued_req_ptr = (queued_request_t *)
+				 list_next(retry_iter))) {
+		queued_arg_ptr = queued_req_ptr->agent_arg_ptr;
+		if ((queued_req_ptr->last_attempt != 0) ||
+		    (queued_arg_ptr->protocol_version !=
+		     agent_arg_ptr->protocol_version) ||
+		    (queued_arg_ptr->retry != agent_arg_ptr->retry))
+			continue;
+		if (queued_arg_ptr->msg_type == REQUEST_NODE_MULTI_MSG) {
+			multi_msg = queued_arg_ptr->msg_args;
+			if (multi_msg->msg_cnt >= MULTI_MSG_MAX)
+				continue;
+		} else if (!_node_msg_mergeable(queued_arg_ptr)) {
+			continue;
+		} else
+			multi_msg = NULL;
+		queued_host = hostlist_nth(queued_arg_ptr->hostlist, 0);
+		if (xstrcmp(host, queued_host)) {
+			free(queued_host);
+			continue;
+		}
+		free(queued_host);
+
+		if (!multi_msg) {
+			/* Convert the queued request into a multi message */
+			multi_msg = xmalloc(sizeof(node_multi_msg_t));
+			multi_msg->msg_type = xmalloc(sizeof(uint16_t) *
+						      MULTI_MSG_MAX);
+			multi_msg->msg_data = xmalloc(sizeof(void *) *
+						      MULTI_MSG_MAX);
+			multi_msg->msg_type[0] = queued_arg_ptr->msg_type;
+			multi_msg->msg_data[0] = queued_arg_ptr->msg_args;
+			multi_msg->msg_cnt = 1;
+			queued_arg_ptr->msg_type = REQUEST_NODE_MULTI_MSG;
+			queued_arg_ptr->msg_args = multi_msg;
+		}
+		multi_msg->msg_type[multi_msg->msg_cnt] =
+			agent_arg_ptr->msg_type;
+		multi_msg->msg_data[multi_msg->msg_cnt] =
+			agent_arg_ptr->msg_args;
+		multi_msg->msg_cnt++;
+		merged = true;
+		break;
+	}
+	list_iterator_destroy(retry_iter);
+
+	if (merged) {
+		debug2("Merged RPC msg_type=%u to node %s into queued request "
+		       "of %u messages", agent_arg_ptr->msg_type, host,
+		       multi_msg->msg_cnt);
+		agent_arg_ptr->msg_args = NULL;	/* now owned by multi_msg */
+		_purge_agent_args(agent_arg_ptr);
+	}
+	free(host);
+	return merged;
+}
+
 /*
  * agent_queue_request - put a new request on the queue for execution or
  * 	execute now if not too busy
@@ -1328,23 +1711,31 @@ void agent_queue_request(agent_arg_t *agent_arg_ptr)
 		}
 	}
 
+	slurm_mutex_lock(&retry_mutex);
+	if (_coalesce_request(agent_arg_ptr) ||
+	    _merge_node_msg(agent_arg_ptr)) {
+		slurm_mutex_unlock(&retry_mutex);
+		return;
+	}
+
 	queued_req_ptr = xmalloc(sizeof(queued_request_t));
 	queued_req_ptr->agent_arg_ptr = agent_arg_ptr;
 /*	queued_req_ptr->last_attempt  = 0; Implicit */
 
-	slurm_mutex_lock(&retry_mutex);
-
 	if (retry_list == NULL) {
 		retry_list = list_create(_list_delete_retry);
 		if (retry_list == NULL)
 			fatal("list_create failed");
 	}
 	list_append(retry_list, (void *)queued_req_ptr);
+	slurmctld_diag_stats.agent_queue_max =
+		MAX(slurmctld_diag_stats.agent_queue_max,
+		    list_count(retry_list));
 	slurm_mutex_unlock(&retry_mutex);
 
 	/* now process the request in a separate pthread
 	 * (if we can create another pthread to do so) */
-	agent_retry(999, false);
+	_agent_wakeup();
 }
 
 /* _spawn_retry_agent - pthread_create an agent for the given task */
@@ -1364,7 +1755,7 @@ static void _spawn_retry_agent(agent_arg_t * agent_arg_ptr)
 					PTHREAD_CREATE_DETACHED))
 		error("pthread_attr_setdetachstate error %m");
 	while (pthread_create(&thread_agent, &attr_agent,
-			agent, (void *) agent_arg_ptr)) {
+			_agent_reserved, (void *) agent_arg_ptr)) {
 		error("pthread_create error %m");
 		if (++retries > MAX_RETRIES)
 			fatal("Can't create pthread");
@@ -1373,6 +1764,86 @@ static void _spawn_retry_agent(agent_arg_t * agent_arg_ptr)
 	slurm_attr_destroy(&attr_agent);
 }
 
+/* Return a request whose credentials could not be signed to retry_list, it
+ * is tried again after RPC_RETRY_INTERVAL */
+static void _requeue_request(agent_arg_t *agent_arg_ptr)
+{
+	queued_request_t *queued_req_ptr;
+
+	queued_req_ptr = xmalloc(sizeof(queued_request_t));
+	queued_req_ptr->agent_arg_ptr = agent_arg_ptr;
+	queued_req_ptr->last_attempt  = time(NULL);
+
+	slurm_mutex_lock(&retry_mutex);
+	if (retry_list == NULL)
+		retry_list = list_create(_list_delete_retry);
+	list_append(retry_list, queued_req_ptr);
+	slurm_mutex_unlock(&retry_mutex);
+}
+
+static void _add_cred(slurm_cred_t *cred, slurm_cred_t ***creds, int *cnt)
+{
+	if (!cred || slurm_cred_signed(cred))
+		return;
+	xrealloc(*creds, sizeof(slurm_cred_t *) * (*cnt + 1));
+	(*creds)[(*cnt)++] = cred;
+}
+
+/*
+ * _sign_agent_creds - Sign the job credentials of a set of requests with one
+ *	call to the crypto plugin. Credentials are built unsigned while the job
+ *	locks are held and signed here, just before they are sent.
+ * IN agent_args - requests to be started
+ * IN arg_cnt - count of agent_args
+ * RET SLURM_SUCCESS or error code if any credential could not be signed
+ */
+static int _sign_agent_creds(agent_arg_t **agent_args, int arg_cnt)
+{
+	slurm_cred_t **creds = NULL;
+	node_multi_msg_t *multi_msg;
+	prolog_launch_msg_t *prolog_msg;
+	batch_job_launch_msg_t *launch_msg;
+	int cred_cnt = 0, i, j, rc = SLURM_SUCCESS;
+	DEF_TIMERS;
+
+	for (i = 0; i < arg_cnt; i++) {
+		if (!agent_args[i]->msg_args)
+			continue;
+		switch (agent_args[i]->msg_type) {
+		case REQUEST_BATCH_JOB_LAUNCH:
+			launch_msg = agent_args[i]->msg_args;
+			_add_cred(launch_msg->cred, &creds, &cred_cnt);
+			break;
+		case REQUEST_LAUNCH_PROLOG:
+			prolog_msg = agent_args[i]->msg_args;
+			_add_cred(prolog_msg->cred, &creds, &cred_cnt);
+			break;
+		case REQUEST_NODE_MULTI_MSG:
+			multi_msg = agent_args[i]->msg_args;
+			for (j = 0; j < multi_msg->msg_cnt; j++) {
+				if (multi_msg->msg_type[j] !=
+				    REQUEST_LAUNCH_PROLOG)
+					continue;
+				prolog_msg = multi_msg->msg_data[j];
+				_add_cred(prolog_msg->cred, &creds, &cred_cnt);
+			}
+			break;
+		default:
+			break;
+		}
+	}
+	if (cred_cnt == 0)
+		return rc;
+
+	START_TIMER;
+	rc = slurm_cred_sign_batch(slurmctld_config.cred_ctx, creds, cred_cnt);
+	END_TIMER2("_sign_agent_creds");
+	debug3("%s: signed %d credentials %s", __func__, cred_cnt, TIME_STR);
+	xfree(creds);
+
+	return rc;
+}
+
 /* slurmctld_free_batch_job_launch_msg is a variant of
  *	slurm_free_job_launch_msg because all environment variables currently
  *	loaded in one xmalloc buffer (see get_job_env()), which is different
@@ -1404,6 +1875,9 @@ void agent_purge(void)
 		mail_list = NULL;
 		slurm_mutex_unlock(&mail_mutex);
 	}
+	slurm_mutex_lock(&agent_mgr_mutex);
+	pthread_cond_signal(&agent_mgr_cond);
+	slurm_mutex_unlock(&agent_mgr_mutex);
 }
 extern int get_agent_count(void)
 {
@@ -1416,6 +1890,17 @@ extern int get_agent_count(void)
 	return cnt;
 }
 
+extern int get_agent_thread_count(void)
+{
+	int cnt;
+
+	slurm_mutex_lock(&agent_cnt_mutex);
+	cnt = agent_thread_cnt;
+	slurm_mutex_unlock(&agent_cnt_mutex);
+
+	return cnt;
+}
+
 static void _purge_agent_args(agent_arg_t *agent_arg_ptr)
 {
 	if (agent_arg_ptr == NULL)
@@ -1452,6 +1937,8 @@ static void _purge_agent_args(agent_arg_t *agent_arg_ptr)
 			slurm_free_job_notify_msg(agent_arg_ptr->msg_args);
 		else if (agent_arg_ptr->msg_type == REQUEST_SUSPEND_INT)
 			slurm_free_suspend_int_msg(agent_arg_ptr->msg_args);
+		else if (agent_arg_ptr->msg_type == REQUEST_NODE_MULTI_MSG)
+			slurm_free_node_multi_msg(agent_arg_ptr->msg_args);
 		else
 			xfree(agent_arg_ptr->msg_args);
 	}
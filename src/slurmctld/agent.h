@@ -46,11 +46,13 @@
 
 #define AGENT_THREAD_COUNT	10	/* maximum active threads per agent */
 #define COMMAND_TIMEOUT 	30	/* command requeue or error, seconds */
-#define MAX_AGENT_CNT		(MAX_SERVER_THREADS / (AGENT_THREAD_COUNT + 2))
+#define MULTI_MSG_MAX		32	/* maximum requests merged into one
+					 * REQUEST_NODE_MULTI_MSG */
+#define MAX_AGENT_CNT		(MAX_SERVER_THREADS / (AGENT_THREAD_COUNT + 1))
 					/* maximum simultaneous agents, note
 					 *   total thread count is product of
 					 *   MAX_AGENT_CNT and
-					 *   (AGENT_THREAD_COUNT + 2) */
+					 *   (AGENT_THREAD_COUNT + 1) */
 
 typedef struct agent_arg {
 	uint32_t	node_count;	/* number of nodes to communicate
@@ -99,6 +101,10 @@ extern void agent_purge (void);
 /* get_agent_count - find out how many active agents we have */
 extern int get_agent_count(void);
 
+/* get_agent_thread_count - find out how many threads the agents are using to
+ *	communicate with nodes */
+extern int get_agent_thread_count(void);
+
 /*
  * mail_job_info - Send e-mail notice of job state change
  * IN job_ptr - job identification
@@ -199,6 +199,8 @@ static char	node_name[MAX_SLURM_NAME];
 static int	recover   = DEFAULT_RECOVER;
 static pthread_mutex_t sched_cnt_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t server_thread_cond = PTHREAD_COND_INITIALIZER;
+static List	server_conn_queue = NULL;  /* connections waiting for a
+					    * server thread */
 static pid_t	slurmctld_pid;
 static char *	slurm_conf_filename;
 
@@ -221,6 +223,7 @@ inline static void  _free_server_thread(void);
 static void         _init_config(void);
 static void         _init_pidfile(void);
 static void         _kill_old_slurmctld(void);
+static connection_arg_t *_next_connection(void);
 static void         _parse_commandline(int argc, char *argv[]);
 inline static int   _ping_backup_controller(void);
 static void         _remove_assoc(slurmdb_assoc_rec_t *rec);
@@ -229,6 +232,7 @@ static void         _update_assoc(slurmdb_assoc_rec_t *rec);
 static void         _update_qos(slurmdb_qos_rec_t *rec);
 inline static int   _report_locks_set(void);
 static void *       _service_connection(void *arg);
+static void         _service_one_connection(connection_arg_t *conn);
 static void         _set_work_dir(void);
 static int          _shutdown_backup_controller(int wait_time);
 static void *       _slurmctld_background(void *no_data);
@@ -660,6 +664,13 @@ int main(int argc, char *argv[])
 	xfree(dir_name);
 	reserve_port_config(NULL);
 	free_rpc_stats();
+	free_dump_cache();
+	/* A server thread still running may dequeue from the list, leave it
+	 * allocated in that case */
+	slurm_mutex_lock(&slurmctld_config.thread_count_lock);
+	if (slurmctld_config.server_thread_count == 0)
+		FREE_NULL_LIST(server_conn_queue);
+	slurm_mutex_unlock(&slurmctld_config.thread_count_lock);
 
 	/* Some plugins are needed to purge job/node data structures,
 	 * unplug after other data structures are purged */
@@ -883,7 +894,10 @@ static void _sig_handler(int signal)
 {
 }
 
-/* _slurmctld_rpc_mgr - Read incoming RPCs and create pthread for each */
+/* _slurmctld_rpc_mgr - Read incoming RPCs and hand each connection to a
+ *	server thread. Once MAX_SERVER_THREADS are busy, further connections
+ *	are queued and serviced by the existing threads as they finish their
+ *	current RPC rather than blocking accept() */
 static void *_slurmctld_rpc_mgr(void *no_data)
 {
 	slurm_fd_t newsockfd;
@@ -893,7 +907,7 @@ static void *_slurmctld_rpc_mgr(void *no_data)
 	char ip[32];
 	pthread_t thread_id_rpc_req;
 	pthread_attr_t thread_attr_rpc_req;
-	int no_thread;
+	int no_thread, new_thread;
 	int fd_next = 0, i, nports;
 	fd_set rfds;
 	connection_arg_t *conn_arg = NULL;
@@ -914,6 +928,9 @@ static void *_slurmctld_rpc_mgr(void *no_data)
 	(void) pthread_setcanceltype(PTHREAD_CANCEL_ASYNCHRONOUS, NULL);
 	debug3("_slurmctld_rpc_mgr pid = %u", getpid());
 
+	if (!server_conn_queue)
+		server_conn_queue = list_create(NULL);
+
 	/* threads to process individual RPC's are detached */
 	slurm_attr_init(&thread_attr_rpc_req);
 	if (pthread_attr_setdetachstate
@@ -977,7 +994,6 @@ static void *_slurmctld_rpc_mgr(void *no_data)
 		if (select(max_fd+1, &rfds, NULL, NULL, NULL) == -1) {
 			if (errno != EINTR)
 				error("slurm_accept_msg_conn select: %m");
-			_free_server_thread();
 			continue;
 		}
 		/* find one to process */
@@ -998,7 +1014,6 @@ static void *_slurmctld_rpc_mgr(void *no_data)
 		    SLURM_SOCKET_ERROR) {
 			if (errno != EINTR)
 				error("slurm_accept_msg_conn: %m");
-			_free_server_thread();
 			continue;
 		}
 		fd_set_close_on_exec(newsockfd);
@@ -1015,6 +1030,20 @@ static void *_slurmctld_rpc_mgr(void *no_data)
 			info("%s: accept() connection from %s", __func__, inetbuf);
 		}
 
+		/* Start a new server thread if below the limit, otherwise
+		 * queue the connection for the next free server thread */
+		slurm_mutex_lock(&slurmctld_config.thread_count_lock);
+		if (slurmctld_config.server_thread_count < max_server_threads) {
+			slurmctld_config.server_thread_count++;
+			new_thread = 1;
+		} else {
+			list_enqueue(server_conn_queue, conn_arg);
+			new_thread = 0;
+		}
+		slurm_mutex_unlock(&slurmctld_config.thread_count_lock);
+		if (!new_thread)
+			continue;
+
 		if (slurmctld_config.shutdown_time)
 			no_thread = 1;
 		else if (pthread_create(&thread_id_rpc_req,
@@ -1027,9 +1056,12 @@ static void *_slurmctld_rpc_mgr(void *no_data)
 			no_thread = 0;
 
 		if (no_thread) {
+			/* Service only this connection here, queued ones are
+			 * left to the running server threads */
 			slurmctld_diag_stats.proc_req_raw++;
-		       	_service_connection((void *) conn_arg);
-	       	}
+			_service_one_connection(conn_arg);
+			_free_server_thread();
+		}
 	}
 
 	debug3("_slurmctld_rpc_mgr shutting down");
@@ -1043,7 +1075,8 @@ static void *_slurmctld_rpc_mgr(void *no_data)
 }
 
 /*
- * _service_connection - service the RPC
+ * _service_connection - service the RPC, then any connections queued for a
+ *	server thread
  * IN/OUT arg - really just the connection's file descriptor, freed
  *	upon completion
  * RET - NULL
@@ -1052,7 +1085,6 @@ static void *_service_connection(void *arg)
 {
 	connection_arg_t *conn = (connection_arg_t *) arg;
 	void *return_code = NULL;
-	slurm_msg_t *msg = xmalloc(sizeof(slurm_msg_t));
 
 #if HAVE_SYS_PRCTL_H
 	if (prctl(PR_SET_NAME, "slurmctld_srvcn", NULL, NULL, NULL) < 0) {
@@ -1060,6 +1092,22 @@ static void *_service_connection(void *arg)
 		      __func__, "slurmctld_srvcn");
 	}
 #endif
+
+	do {
+		_service_one_connection(conn);
+	} while ((conn = _next_connection()));
+	return return_code;
+}
+
+/*
+ * _service_one_connection - service the RPC of one connection
+ * IN/OUT conn - the connection, freed upon completion
+ */
+static void _service_one_connection(connection_arg_t *conn)
+{
+	slurm_msg_t *msg;
+
+	msg = xmalloc(sizeof(slurm_msg_t));
 	slurm_msg_t_init(msg);
 	/*
 	 * slurm_receive_msg sets msg connection fd to accepted fd. This allows
@@ -1087,13 +1135,32 @@ static void *_service_connection(void *arg)
 
 cleanup:
 	slurm_free_msg(msg);
-	xfree(arg);
-	_free_server_thread();
-	return return_code;
+	xfree(conn);
+}
+
+/* Return the next queued connection for this server thread to service.
+ * If there are none, release the server thread and return NULL. */
+static connection_arg_t *_next_connection(void)
+{
+	connection_arg_t *conn;
+
+	slurm_mutex_lock(&slurmctld_config.thread_count_lock);
+	conn = (connection_arg_t *) list_dequeue(server_conn_queue);
+	if (!conn) {
+		if (slurmctld_config.server_thread_count > 0)
+			slurmctld_config.server_thread_count--;
+		else
+			error("slurmctld_config.server_thread_count underflow");
+	}
+	pthread_cond_broadcast(&server_thread_cond);
+	slurm_mutex_unlock(&slurmctld_config.thread_count_lock);
+
+	return conn;
 }
 
-/* Increment slurmctld_config.server_thread_count and don't return
- * until its value is no larger than MAX_SERVER_THREADS,
+/* Don't return until a new connection can either be given a server thread
+ * (slurmctld_config.server_thread_count below MAX_SERVER_THREADS) or be
+ * queued for one (fewer than MAX_SERVER_QUEUE connections waiting),
  * RET true unless shutdown in progress */
 static bool _wait_for_server_thread(void)
 {
@@ -1106,8 +1173,9 @@ static bool _wait_for_server_thread(void)
 			rc = false;
 			break;
 		}
-		if (slurmctld_config.server_thread_count < max_server_threads) {
-			slurmctld_config.server_thread_count++;
+		if ((slurmctld_config.server_thread_count <
+		     max_server_threads) ||
+		    (list_count(server_conn_queue) < MAX_SERVER_QUEUE)) {
 			break;
 		} else {
 			/* wait for state change and retry,
@@ -1120,9 +1188,11 @@ static bool _wait_for_server_thread(void)
 				time_t now = time(NULL);
 				if (difftime(now, last_print_time) > 2) {
 					verbose("server_thread_count over "
-						"limit (%d), waiting",
+						"limit (%d) with %d queued "
+						"connections, waiting",
 						slurmctld_config.
-						server_thread_count);
+						server_thread_count,
+						list_count(server_conn_queue));
 					last_print_time = now;
 				}
 				print_it = false;
@@ -1348,6 +1418,7 @@ static void _queue_reboot_msg(void)
 		node_ptr->node_state &=  NODE_STATE_FLAGS;
 		node_ptr->node_state |=  NODE_STATE_DOWN;
 		node_ptr->reason = xstrdup("Scheduled reboot");
+		NODE_DELTA_TOUCH(node_ptr);
 		bit_clear(avail_node_bitmap, i);
 		bit_clear(idle_node_bitmap, i);
 		node_ptr->last_response = now;
@@ -982,8 +982,8 @@ extern void sync_front_end_state(void)
 				error("front end node %s has vanished, "
 				      "killing job %u",
 				      job_ptr->batch_host, job_ptr->job_id);
-				job_ptr->job_state = JOB_NODE_FAIL |
-						     JOB_COMPLETING;
+				JOB_STATE_SET(job_ptr, JOB_NODE_FAIL |
+						       JOB_COMPLETING);
 			} else if (job_ptr->front_end_ptr == NULL) {
 				info("front end node %s has vanished",
 				     job_ptr->batch_host);
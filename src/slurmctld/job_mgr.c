@@ -115,6 +115,11 @@
 
 #define JOB_CKPT_VERSION      "PROTOCOL_VERSION"
 
+/* Seconds to remember purged jobs for pack_all_jobs_delta() */
+#ifndef JOB_DELTA_PURGE_AGE
+#define JOB_DELTA_PURGE_AGE	600
+#endif
+
 typedef struct {
 	int resp_array_cnt;
 	int resp_array_size;
@@ -122,9 +127,17 @@ typedef struct {
 	bitstr_t **resp_array_task_id;
 } resp_array_struct_t;
 
+typedef struct {
+	uint32_t delta_gen;	/* generation in which the job was purged */
+	uint32_t job_id;
+	time_t purge_time;
+} job_delta_purge_t;
+
 /* Global variables */
 List   job_list = NULL;		/* job_record list */
 time_t last_job_update;		/* time of last update to job records */
+uint32_t job_delta_next_gen = 1;
+bool   job_delta_changed = false;
 
 /* Local variables */
 static int      bf_min_age_reserve = 0;
@@ -148,6 +161,13 @@ static uint32_t num_hold;
 static int32_t  *requeue_exit_hold;
 static bool     kill_invalid_dep;
 
+/* Job record generations, see pack_all_jobs_delta() */
+static pthread_mutex_t job_delta_mutex = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t job_delta_full_gen = 0;	/* older generations get all jobs */
+static uint32_t job_delta_gen = 0;	/* latest generation seen by clients */
+static time_t   job_delta_part_update = (time_t) 0;
+static List     job_delta_purge_list = NULL;
+
 /* Local functions */
 static void _add_job_hash(struct job_record *job_ptr);
 static void _add_job_array_hash(struct job_record *job_ptr);
@@ -181,6 +201,7 @@ static int  _job_create(job_desc_msg_t * job_specs, int allocate, int will_run,
 			char **err_msg, uint16_t protocol_version);
 static void _job_timed_out(struct job_record *job_ptr);
 static void _kill_dependent(struct job_record *job_ptr);
+static void _job_delta_purge(uint32_t job_id);
 static void _list_delete_job(void *job_entry);
 static int  _list_find_job_id(void *job_entry, void *key);
 static int  _list_find_job_old(void *job_entry, void *key);
@@ -460,6 +481,7 @@ static struct job_record *_create_job_record(int *error_code, uint32_t num_jobs)
 	detail_ptr = (struct job_details *)xmalloc(sizeof(struct job_details));
 
 	job_ptr->magic = JOB_MAGIC;
+	JOB_DELTA_TOUCH(job_ptr);
 	job_ptr->array_task_id = NO_VAL;
 	job_ptr->details = detail_ptr;
 	job_ptr->prio_factors = xmalloc(sizeof(priority_factors_object_t));
@@ -470,6 +492,7 @@ static struct job_record *_create_job_record(int *error_code, uint32_t num_jobs)
 	job_ptr->requid = -1; /* force to -1 for sacct to know this
 			       * hasn't been set yet  */
 	(void) list_append(job_list, job_ptr);
+	pend_job_add(job_ptr);
 
 	return job_ptr;
 }
@@ -1437,7 +1460,7 @@ static int _load_job_state(Buf buffer, uint16_t protocol_version)
 		safe_unpack16(&details, buffer);
 		if ((details == DETAILS_FLAG) &&
 		    (_load_job_details(job_ptr, buffer, protocol_version))) {
-			job_ptr->job_state = JOB_FAILED;
+			JOB_STATE_SET(job_ptr, JOB_FAILED);
 			job_ptr->exit_code = 1;
 			job_ptr->state_reason = FAIL_SYSTEM;
 			xfree(job_ptr->state_desc);
@@ -1614,7 +1637,7 @@ static int _load_job_state(Buf buffer, uint16_t protocol_version)
 		safe_unpack16(&details, buffer);
 		if ((details == DETAILS_FLAG) &&
 		    (_load_job_details(job_ptr, buffer, protocol_version))) {
-			job_ptr->job_state = JOB_FAILED;
+			JOB_STATE_SET(job_ptr, JOB_FAILED);
 			job_ptr->exit_code = 1;
 			job_ptr->state_reason = FAIL_SYSTEM;
 			xfree(job_ptr->state_desc);
@@ -1636,7 +1659,7 @@ static int _load_job_state(Buf buffer, uint16_t protocol_version)
 		if (job_id > 0x7fffffff) {
 			error("JobID %u can not be recovered, JobID too high",
 			      job_id);
-			job_ptr->job_state = JOB_FAILED;
+			JOB_STATE_SET(job_ptr, JOB_FAILED);
 			job_ptr->exit_code = 1;
 			job_ptr->state_reason = FAIL_SYSTEM;
 			xfree(job_ptr->state_desc);
@@ -1785,7 +1808,7 @@ static int _load_job_state(Buf buffer, uint16_t protocol_version)
 		safe_unpack16(&details, buffer);
 		if ((details == DETAILS_FLAG) &&
 		    (_load_job_details(job_ptr, buffer, protocol_version))) {
-			job_ptr->job_state = JOB_FAILED;
+			JOB_STATE_SET(job_ptr, JOB_FAILED);
 			job_ptr->exit_code = 1;
 			job_ptr->state_reason = FAIL_SYSTEM;
 			xfree(job_ptr->state_desc);
@@ -1807,7 +1830,7 @@ static int _load_job_state(Buf buffer, uint16_t protocol_version)
 		if (job_id > 0x7fffffff) {
 			error("JobID %u can not be recovered, JobID too high",
 			      job_id);
-			job_ptr->job_state = JOB_FAILED;
+			JOB_STATE_SET(job_ptr, JOB_FAILED);
 			job_ptr->exit_code = 1;
 			job_ptr->state_reason = FAIL_SYSTEM;
 			xfree(job_ptr->state_desc);
@@ -1878,7 +1901,7 @@ static int _load_job_state(Buf buffer, uint16_t protocol_version)
 	job_ptr->end_time     = end_time;
 	job_ptr->exit_code    = exit_code;
 	job_ptr->group_id     = group_id;
-	job_ptr->job_state    = job_state;
+	JOB_STATE_SET(job_ptr, job_state);
 	job_ptr->kill_on_node_fail = kill_on_node_fail;
 	xfree(job_ptr->licenses);
 	job_ptr->licenses     = licenses;
@@ -2699,15 +2722,38 @@ extern struct job_record *find_job_array_rec(uint32_t array_job_id,
 struct job_record *find_job_record(uint32_t job_id)
 {
 	struct job_record *job_ptr;
+	uint32_t probes = 0, probe_max;
 
 	job_ptr = job_hash[JOB_HASH_INX(job_id)];
 	while (job_ptr) {
+		probes++;
 		if (job_ptr->job_id == job_id)
-			return job_ptr;
+			break;
 		job_ptr = job_ptr->job_next;
 	}
 
-	return NULL;
+	/* Many threads may look up jobs at once under the job read lock */
+	__sync_fetch_and_add(&slurmctld_diag_stats.job_hash_lookups, 1);
+	__sync_fetch_and_add(&slurmctld_diag_stats.job_hash_probes, probes);
+	probe_max = slurmctld_diag_stats.job_hash_probe_max;
+	while ((probe_max < probes) &&
+	       !__sync_bool_compare_and_swap(
+			&slurmctld_diag_stats.job_hash_probe_max,
+			probe_max, probes))
+		probe_max = slurmctld_diag_stats.job_hash_probe_max;
+
+	return job_ptr;
+}
+
+/*
+ * get_job_hash_size - report the size and usage of the job hash table
+ * OUT table_size - number of hash table buckets
+ * OUT record_cnt - number of job records in the hash table
+ */
+extern void get_job_hash_size(uint32_t *table_size, uint32_t *record_cnt)
+{
+	*table_size = hash_table_size;
+	*record_cnt = job_list ? list_count(job_list) : 0;
 }
 
 /* rebuild a job's partition name list based upon the contents of its
@@ -2741,6 +2787,7 @@ static void _rebuild_part_name_list(struct job_record  *job_ptr)
 	}
 	list_iterator_destroy(part_iterator);
 	last_job_update = time(NULL);
+	JOB_DELTA_TOUCH(job_ptr);
 }
 
 /*
@@ -2800,16 +2847,17 @@ extern int kill_job_by_part_name(char *part_name)
 			/* we can't have it as suspended when we call the
 			 * accounting stuff.
 			 */
-			job_ptr->job_state = JOB_CANCELLED;
+			JOB_STATE_SET(job_ptr, JOB_CANCELLED);
 			jobacct_storage_g_job_suspend(acct_db_conn, job_ptr);
-			job_ptr->job_state = suspend_job_state;
+			JOB_STATE_SET(job_ptr, suspend_job_state);
 			suspended = true;
 		}
 		if (IS_JOB_RUNNING(job_ptr) || suspended) {
 			kill_job_cnt++;
+			JOB_DELTA_TOUCH(job_ptr);
 			info("Killing job_id %u on defunct partition %s",
 			     job_ptr->job_id, part_name);
-			job_ptr->job_state = JOB_NODE_FAIL | JOB_COMPLETING;
+			JOB_STATE_SET(job_ptr, JOB_NODE_FAIL | JOB_COMPLETING);
 			build_cg_bitmap(job_ptr);
 			job_ptr->exit_code = MAX(job_ptr->exit_code, 1);
 			job_ptr->state_reason = FAIL_DOWN_PARTITION;
@@ -2826,9 +2874,10 @@ extern int kill_job_by_part_name(char *part_name)
 						 false);
 		} else if (pending) {
 			kill_job_cnt++;
+			JOB_DELTA_TOUCH(job_ptr);
 			info("Killing job_id %u on defunct partition %s",
 			     job_ptr->job_id, part_name);
-			job_ptr->job_state	= JOB_CANCELLED;
+			JOB_STATE_SET(job_ptr, JOB_CANCELLED);
 			job_ptr->start_time	= now;
 			job_ptr->end_time	= now;
 			job_ptr->exit_code	= 1;
@@ -2879,13 +2928,14 @@ extern int kill_job_by_front_end_name(char *node_name)
 			/* we can't have it as suspended when we call the
 			 * accounting stuff.
 			 */
-			job_ptr->job_state = JOB_CANCELLED;
+			JOB_STATE_SET(job_ptr, JOB_CANCELLED);
 			jobacct_storage_g_job_suspend(acct_db_conn, job_ptr);
-			job_ptr->job_state = suspend_job_state;
+			JOB_STATE_SET(job_ptr, suspend_job_state);
 			suspended = true;
 		}
 		if (IS_JOB_COMPLETING(job_ptr)) {
 			kill_job_cnt++;
+			JOB_DELTA_TOUCH(job_ptr);
 			while ((i = bit_ffs(job_ptr->node_bitmap_cg)) >= 0) {
 				bit_clear(job_ptr->node_bitmap_cg, i);
 				job_update_cpu_cnt(job_ptr, i);
@@ -2897,7 +2947,8 @@ extern int kill_job_by_front_end_name(char *node_name)
 				}
 				if (job_ptr->node_cnt == 0) {
 					delete_step_records(job_ptr);
-					job_ptr->job_state &= (~JOB_COMPLETING);
+					JOB_STATE_FLAG_CLEAR(job_ptr,
+							     JOB_COMPLETING);
 					slurm_sched_g_schedule();
 				}
 				node_ptr = &node_record_table_ptr[i];
@@ -2911,6 +2962,7 @@ extern int kill_job_by_front_end_name(char *node_name)
 			}
 		} else if (IS_JOB_RUNNING(job_ptr) || suspended) {
 			kill_job_cnt++;
+			JOB_DELTA_TOUCH(job_ptr);
 			if (job_ptr->batch_flag && job_ptr->details &&
 			    slurmctld_conf.job_requeue &&
 			    (job_ptr->details->requeue > 0)) {
@@ -2941,7 +2993,7 @@ extern int kill_job_by_front_end_name(char *node_name)
 				 * was terminated in the accounting logs.
 				 * Set a new submit time so the restarted
 				 * job looks like a new job. */
-				job_ptr->job_state  = JOB_NODE_FAIL;
+				JOB_STATE_SET(job_ptr, JOB_NODE_FAIL);
 				build_cg_bitmap(job_ptr);
 				job_completion_logger(job_ptr, true);
 				deallocate_nodes(job_ptr, false, suspended,
@@ -2952,9 +3004,11 @@ extern int kill_job_by_front_end_name(char *node_name)
 				//job_ptr->db_index = 0;
 				//job_ptr->details->submit_time = now;
 
-				job_ptr->job_state = JOB_PENDING;
+				JOB_STATE_SET(job_ptr, JOB_PENDING);
 				if (job_ptr->node_cnt)
-					job_ptr->job_state |= JOB_COMPLETING;
+					JOB_STATE_FLAG_SET(job_ptr,
+							   JOB_COMPLETING);
+				pend_job_add(job_ptr);
 
 				/* restart from periodic checkpoint */
 				if (job_ptr->ckpt_interval &&
@@ -2981,8 +3035,8 @@ extern int kill_job_by_front_end_name(char *node_name)
 				info("Killing job_id %u on failed node %s",
 				     job_ptr->job_id, node_name);
 				srun_node_fail(job_ptr->job_id, node_name);
-				job_ptr->job_state = JOB_NODE_FAIL |
-						     JOB_COMPLETING;
+				JOB_STATE_SET(job_ptr, JOB_NODE_FAIL |
+						       JOB_COMPLETING);
 				build_cg_bitmap(job_ptr);
 				job_ptr->exit_code = MAX(job_ptr->exit_code, 1);
 				job_ptr->state_reason = FAIL_DOWN_NODE;
@@ -3107,9 +3161,9 @@ extern int kill_running_job_by_node_name(char *node_name)
 			/* we can't have it as suspended when we call the
 			 * accounting stuff.
 			 */
-			job_ptr->job_state = JOB_CANCELLED;
+			JOB_STATE_SET(job_ptr, JOB_CANCELLED);
 			jobacct_storage_g_job_suspend(acct_db_conn, job_ptr);
-			job_ptr->job_state = suspend_job_state;
+			JOB_STATE_SET(job_ptr, suspend_job_state);
 			suspended = true;
 		}
 
@@ -3117,6 +3171,7 @@ extern int kill_running_job_by_node_name(char *node_name)
 			if (!bit_test(job_ptr->node_bitmap_cg, bit_position))
 				continue;
 			kill_job_cnt++;
+			JOB_DELTA_TOUCH(job_ptr);
 			bit_clear(job_ptr->node_bitmap_cg, bit_position);
 			job_update_cpu_cnt(job_ptr, bit_position);
 			if (job_ptr->node_cnt)
@@ -3127,7 +3182,7 @@ extern int kill_running_job_by_node_name(char *node_name)
 			}
 			if (job_ptr->node_cnt == 0) {
 				delete_step_records(job_ptr);
-				job_ptr->job_state &= (~JOB_COMPLETING);
+				JOB_STATE_FLAG_CLEAR(job_ptr, JOB_COMPLETING);
 				slurm_sched_g_schedule();
 			}
 			if (node_ptr->comp_job_cnt)
@@ -3139,6 +3194,7 @@ extern int kill_running_job_by_node_name(char *node_name)
 			}
 		} else if (IS_JOB_RUNNING(job_ptr) || suspended) {
 			kill_job_cnt++;
+			JOB_DELTA_TOUCH(job_ptr);
 			if ((job_ptr->details) &&
 			    (job_ptr->kill_on_node_fail == 0) &&
 			    (job_ptr->node_cnt > 1)) {
@@ -3178,7 +3234,7 @@ extern int kill_running_job_by_node_name(char *node_name)
 				 * was terminated in the accounting logs.
 				 * Set a new submit time so the restarted
 				 * job looks like a new job. */
-				job_ptr->job_state  = JOB_NODE_FAIL;
+				JOB_STATE_SET(job_ptr, JOB_NODE_FAIL);
 				build_cg_bitmap(job_ptr);
 				job_completion_logger(job_ptr, true);
 				deallocate_nodes(job_ptr, false, suspended,
@@ -3189,9 +3245,11 @@ extern int kill_running_job_by_node_name(char *node_name)
 				//job_ptr->db_index = 0;
 				//job_ptr->details->submit_time = now;
 
-				job_ptr->job_state = JOB_PENDING;
+				JOB_STATE_SET(job_ptr, JOB_PENDING);
 				if (job_ptr->node_cnt)
-					job_ptr->job_state |= JOB_COMPLETING;
+					JOB_STATE_FLAG_SET(job_ptr,
+							   JOB_COMPLETING);
+				pend_job_add(job_ptr);
 
 				/* restart from periodic checkpoint */
 				if (job_ptr->ckpt_interval &&
@@ -3218,8 +3276,8 @@ extern int kill_running_job_by_node_name(char *node_name)
 				info("Killing job_id %u on failed node %s",
 				     job_ptr->job_id, node_name);
 				srun_node_fail(job_ptr->job_id, node_name);
-				job_ptr->job_state = JOB_NODE_FAIL |
-						     JOB_COMPLETING;
+				JOB_STATE_SET(job_ptr, JOB_NODE_FAIL |
+						       JOB_COMPLETING);
 				build_cg_bitmap(job_ptr);
 				job_ptr->exit_code = MAX(job_ptr->exit_code, 1);
 				job_ptr->state_reason = FAIL_DOWN_NODE;
@@ -3509,6 +3567,9 @@ int init_job_conf(void)
  */
 extern void rehash_jobs(void)
 {
+	struct job_record *job_ptr;
+	ListIterator job_iterator;
+
 	if (job_hash == NULL) {
 		hash_table_size = slurmctld_conf.max_job_cnt;
 		job_hash = (struct job_record **)
@@ -3518,12 +3579,34 @@ extern void rehash_jobs(void)
 		job_array_hash_t = (struct job_record **)
 			xmalloc(hash_table_size * sizeof(struct job_record *));
 	} else if (hash_table_size < (slurmctld_conf.max_job_cnt / 2)) {
-		/* If the MaxJobCount grows by too much, the hash table will
-		 * be ineffective without rebuilding. We don't presently bother
-		 * to rebuild the hash table, but cut MaxJobCount back as
-		 * needed. */
-		error ("MaxJobCount reset too high, restart slurmctld");
-		slurmctld_conf.max_job_cnt = hash_table_size;
+		/* If the MaxJobCount grows by too much, the hash chains
+		 * become long and lookups slow. Rebuild the hash tables
+		 * sized for the new MaxJobCount. */
+		info("%s: growing job hash table from %d to %u entries",
+		     __func__, hash_table_size, slurmctld_conf.max_job_cnt);
+		xfree(job_hash);
+		xfree(job_array_hash_j);
+		xfree(job_array_hash_t);
+		hash_table_size = slurmctld_conf.max_job_cnt;
+		job_hash = (struct job_record **)
+			xmalloc(hash_table_size * sizeof(struct job_record *));
+		job_array_hash_j = (struct job_record **)
+			xmalloc(hash_table_size * sizeof(struct job_record *));
+		job_array_hash_t = (struct job_record **)
+			xmalloc(hash_table_size * sizeof(struct job_record *));
+		if (!job_list)
+			return;
+		job_iterator = list_iterator_create(job_list);
+		while ((job_ptr = (struct job_record *)
+				  list_next(job_iterator))) {
+			job_ptr->job_next = NULL;
+			job_ptr->job_array_next_j = NULL;
+			job_ptr->job_array_next_t = NULL;
+			_add_job_hash(job_ptr);
+			_add_job_array_hash(job_ptr);
+		}
+		list_iterator_destroy(job_iterator);
+		slurmctld_diag_stats.job_hash_probe_max = 0;
 	}
 }
 
@@ -3537,6 +3620,7 @@ extern struct job_record *job_array_split(struct job_record *job_ptr)
 	struct job_record *job_ptr_pend = NULL, *save_job_next;
 	struct job_details *job_details, *details_new, *save_details;
 	uint32_t save_job_id, save_db_index = job_ptr->db_index;
+	uint32_t save_pend_inx;
 	priority_factors_object_t *save_prio_factors;
 	List save_step_list;
 	int error_code = SLURM_SUCCESS;
@@ -3569,6 +3653,7 @@ extern struct job_record *job_array_split(struct job_record *job_ptr)
 	 * This could be done in parallel, but performance was worse. */
 	save_job_id   = job_ptr_pend->job_id;
 	save_job_next = job_ptr_pend->job_next;
+	save_pend_inx = job_ptr_pend->pend_inx;
 	save_details  = job_ptr_pend->details;
 	save_prio_factors = job_ptr_pend->prio_factors;
 	save_step_list = job_ptr_pend->step_list;
@@ -3576,6 +3661,7 @@ extern struct job_record *job_array_split(struct job_record *job_ptr)
 
 	job_ptr_pend->job_id   = save_job_id;
 	job_ptr_pend->job_next = save_job_next;
+	job_ptr_pend->pend_inx = save_pend_inx;
 	job_ptr_pend->details  = save_details;
 	job_ptr_pend->step_list = save_step_list;
 	job_ptr_pend->db_index = save_db_index;
@@ -3871,7 +3957,7 @@ extern int job_allocate(job_desc_msg_t * job_specs, int immediate,
 	if (error_code) {
 		if (job_ptr && (immediate || will_run)) {
 			/* this should never really happen here */
-			job_ptr->job_state = JOB_FAILED;
+			JOB_STATE_SET(job_ptr, JOB_FAILED);
 			job_ptr->exit_code = 1;
 			job_ptr->state_reason = FAIL_BAD_CONSTRAINTS;
 			xfree(job_ptr->state_desc);
@@ -3936,7 +4022,7 @@ extern int job_allocate(job_desc_msg_t * job_specs, int immediate,
 					 * it is not runable anyway */
 
 	if (immediate && (too_fragmented || (!top_prio) || (!independent))) {
-		job_ptr->job_state  = JOB_FAILED;
+		JOB_STATE_SET(job_ptr, JOB_FAILED);
 		job_ptr->exit_code  = 1;
 		job_ptr->state_reason = FAIL_BAD_CONSTRAINTS;
 		xfree(job_ptr->state_desc);
@@ -3956,7 +4042,7 @@ extern int job_allocate(job_desc_msg_t * job_specs, int immediate,
 		memset(&job_desc_msg, 0, sizeof(job_desc_msg_t));
 		job_desc_msg.job_id = job_ptr->job_id;
 		rc = job_start_data(&job_desc_msg, resp);
-		job_ptr->job_state  = JOB_FAILED;
+		JOB_STATE_SET(job_ptr, JOB_FAILED);
 		job_ptr->exit_code  = 1;
 		job_ptr->start_time = job_ptr->end_time = now;
 		_purge_job_record(job_ptr->job_id);
@@ -3972,6 +4058,7 @@ extern int job_allocate(job_desc_msg_t * job_specs, int immediate,
 	error_code = _select_nodes_parts(job_ptr, no_alloc, NULL, err_msg);
 	if (!test_only) {
 		last_job_update = now;
+		JOB_DELTA_TOUCH(job_ptr);
 		slurm_sched_g_schedule();	/* work for external scheduler */
 	}
 
@@ -3988,7 +4075,7 @@ extern int job_allocate(job_desc_msg_t * job_specs, int immediate,
 	    (error_code == ESLURM_REQUESTED_PART_CONFIG_UNAVAILABLE)) {
 		/* Not fatal error, but job can't be scheduled right now */
 		if (immediate) {
-			job_ptr->job_state  = JOB_FAILED;
+			JOB_STATE_SET(job_ptr, JOB_FAILED);
 			job_ptr->exit_code  = 1;
 			job_ptr->state_reason = FAIL_BAD_CONSTRAINTS;
 			xfree(job_ptr->state_desc);
@@ -4006,7 +4093,7 @@ extern int job_allocate(job_desc_msg_t * job_specs, int immediate,
 	}
 
 	if (error_code) {	/* fundamental flaw in job request */
-		job_ptr->job_state  = JOB_FAILED;
+		JOB_STATE_SET(job_ptr, JOB_FAILED);
 		job_ptr->exit_code  = 1;
 		job_ptr->state_reason = FAIL_BAD_CONSTRAINTS;
 		xfree(job_ptr->state_desc);
@@ -4016,7 +4103,7 @@ extern int job_allocate(job_desc_msg_t * job_specs, int immediate,
 	}
 
 	if (will_run) {		/* job would run, flag job destruction */
-		job_ptr->job_state  = JOB_FAILED;
+		JOB_STATE_SET(job_ptr, JOB_FAILED);
 		job_ptr->exit_code  = 1;
 		job_ptr->start_time = job_ptr->end_time = now;
 		_purge_job_record(job_ptr->job_id);
@@ -4058,9 +4145,9 @@ extern int job_fail(uint32_t job_id, uint16_t job_state)
 		/* we can't have it as suspended when we call the
 		 * accounting stuff.
 		 */
-		job_ptr->job_state = JOB_CANCELLED;
+		JOB_STATE_SET(job_ptr, JOB_CANCELLED);
 		jobacct_storage_g_job_suspend(acct_db_conn, job_ptr);
-		job_ptr->job_state = suspend_job_state;
+		JOB_STATE_SET(job_ptr, suspend_job_state);
 		suspended = true;
 	}
 
@@ -4074,7 +4161,8 @@ extern int job_fail(uint32_t job_id, uint16_t job_state)
 		} else
 			job_ptr->end_time       = now;
 		last_job_update                 = now;
-		job_ptr->job_state = job_state | JOB_COMPLETING;
+		JOB_DELTA_TOUCH(job_ptr);
+		JOB_STATE_SET(job_ptr, job_state | JOB_COMPLETING);
 		job_ptr->exit_code = 1;
 		job_ptr->state_reason = FAIL_LAUNCH;
 		xfree(job_ptr->state_desc);
@@ -4116,7 +4204,7 @@ static int _job_signal(struct job_record *job_ptr, uint16_t signal,
 	    (signal == SIGKILL)) {
 		if ((job_ptr->job_state & JOB_STATE_BASE) == JOB_PENDING) {
 			/* Prevent job requeue, otherwise preserve state */
-			job_ptr->job_state = JOB_CANCELLED | JOB_COMPLETING;
+			JOB_STATE_SET(job_ptr, JOB_CANCELLED | JOB_COMPLETING);
 		}
 		/* build_cg_bitmap() not needed, job already completing */
 		verbose("%s: of requeuing %s successful",
@@ -4126,7 +4214,8 @@ static int _job_signal(struct job_record *job_ptr, uint16_t signal,
 
 	if (IS_JOB_PENDING(job_ptr) && (signal == SIGKILL)) {
 		last_job_update		= now;
-		job_ptr->job_state	= JOB_CANCELLED;
+		JOB_DELTA_TOUCH(job_ptr);
+		JOB_STATE_SET(job_ptr, JOB_CANCELLED);
 		job_ptr->start_time	= now;
 		job_ptr->end_time	= now;
 		srun_allocate_abort(job_ptr);
@@ -4142,9 +4231,10 @@ static int _job_signal(struct job_record *job_ptr, uint16_t signal,
 		job_term_state = JOB_CANCELLED;
 	if (IS_JOB_SUSPENDED(job_ptr) && (signal == SIGKILL)) {
 		last_job_update         = now;
+		JOB_DELTA_TOUCH(job_ptr);
 		job_ptr->end_time       = job_ptr->suspend_time;
 		job_ptr->tot_sus_time  += difftime(now, job_ptr->suspend_time);
-		job_ptr->job_state      = job_term_state | JOB_COMPLETING;
+		JOB_STATE_SET(job_ptr, job_term_state | JOB_COMPLETING);
 		build_cg_bitmap(job_ptr);
 		jobacct_storage_g_job_suspend(acct_db_conn, job_ptr);
 		job_completion_logger(job_ptr, false);
@@ -4157,9 +4247,9 @@ static int _job_signal(struct job_record *job_ptr, uint16_t signal,
 
 	if (IS_JOB_RUNNING(job_ptr)) {
 		if (signal == SIGSTOP)
-			job_ptr->job_state |= JOB_STOPPED;
+			JOB_STATE_FLAG_SET(job_ptr, JOB_STOPPED);
 		else if (signal == SIGCONT)
-			job_ptr->job_state &= (~JOB_STOPPED);
+			JOB_STATE_FLAG_CLEAR(job_ptr, JOB_STOPPED);
 
 		if ((signal == SIGKILL)
 		    && !(flags & KILL_STEPS_ONLY)
@@ -4169,7 +4259,8 @@ static int _job_signal(struct job_record *job_ptr, uint16_t signal,
 			job_ptr->time_last_active	= now;
 			job_ptr->end_time		= now;
 			last_job_update			= now;
-			job_ptr->job_state = job_term_state | JOB_COMPLETING;
+			JOB_DELTA_TOUCH(job_ptr);
+			JOB_STATE_SET(job_ptr, job_term_state | JOB_COMPLETING);
 			build_cg_bitmap(job_ptr);
 			job_completion_logger(job_ptr, false);
 			deallocate_nodes(job_ptr, false, false, preempt);
@@ -4442,7 +4533,8 @@ extern int job_str_signal(char *job_id_str, uint16_t signal, uint16_t flags,
 			job_count -= (orig_task_cnt - new_task_count);
 			if (job_ptr->array_recs->task_cnt == 0) {
 				last_job_update		= now;
-				job_ptr->job_state	= JOB_CANCELLED;
+				JOB_DELTA_TOUCH(job_ptr);
+				JOB_STATE_SET(job_ptr, JOB_CANCELLED);
 				job_ptr->start_time	= now;
 				job_ptr->end_time	= now;
 				job_ptr->requid		= uid;
@@ -4645,9 +4737,9 @@ extern int job_complete(uint32_t job_id, uid_t uid, bool requeue,
 		/* we can't have it as suspended when we call the
 		 * accounting stuff.
 		 */
-		job_ptr->job_state = JOB_CANCELLED;
+		JOB_STATE_SET(job_ptr, JOB_CANCELLED);
 		jobacct_storage_g_job_suspend(acct_db_conn, job_ptr);
-		job_ptr->job_state = suspend_job_state;
+		JOB_STATE_SET(job_ptr, suspend_job_state);
 		job_comp_flag = JOB_COMPLETING;
 		suspended = true;
 	}
@@ -4658,7 +4750,7 @@ extern int job_complete(uint32_t job_id, uid_t uid, bool requeue,
 		 * Set a new submit time so the restarted
 		 * job looks like a new job. */
 		job_ptr->end_time = now;
-		job_ptr->job_state  = JOB_NODE_FAIL;
+		JOB_STATE_SET(job_ptr, JOB_NODE_FAIL);
 		job_completion_logger(job_ptr, true);
 		/* do this after the epilog complete, setting it here
 		 * is too early */
@@ -4675,7 +4767,8 @@ extern int job_complete(uint32_t job_id, uid_t uid, bool requeue,
 		if (!use_cloud)
 			job_ptr->batch_flag++;	/* only one retry */
 		job_ptr->restart_cnt++;
-		job_ptr->job_state = JOB_PENDING | job_comp_flag;
+		JOB_STATE_SET(job_ptr, JOB_PENDING | job_comp_flag);
+		pend_job_add(job_ptr);
 		/* Since the job completion logger removes the job submit
 		 * information, we need to add it again. */
 		acct_policy_add_job_submit(job_ptr);
@@ -4690,7 +4783,7 @@ extern int job_complete(uint32_t job_id, uid_t uid, bool requeue,
 		 * attempts hold the job with HoldMaxRequeue reason.
 		 */
 		if (job_ptr->batch_flag > MAX_BATCH_REQUEUE) {
-			job_ptr->job_state |= JOB_REQUEUE_HOLD;
+			JOB_STATE_FLAG_SET(job_ptr, JOB_REQUEUE_HOLD);
 			job_ptr->state_reason = WAIT_MAX_REQUEUE;
 			job_ptr->batch_flag = 1;
 			job_ptr->priority = 0;
@@ -4705,14 +4798,14 @@ extern int job_complete(uint32_t job_id, uid_t uid, bool requeue,
 		return SLURM_SUCCESS;
 	} else {
 		if (node_fail) {
-			job_ptr->job_state = JOB_NODE_FAIL | job_comp_flag;
+			JOB_STATE_SET(job_ptr, JOB_NODE_FAIL | job_comp_flag);
 			job_ptr->requid = uid;
 		} else if (job_return_code == NO_VAL) {
-			job_ptr->job_state = JOB_CANCELLED | job_comp_flag;
+			JOB_STATE_SET(job_ptr, JOB_CANCELLED | job_comp_flag);
 			job_ptr->requid = uid;
 		} else if (WIFEXITED(job_return_code) &&
 			   WEXITSTATUS(job_return_code)) {
-			job_ptr->job_state = JOB_FAILED   | job_comp_flag;
+			JOB_STATE_SET(job_ptr, JOB_FAILED   | job_comp_flag);
 			job_ptr->exit_code = job_return_code;
 			job_ptr->state_reason = FAIL_EXIT_CODE;
 			xfree(job_ptr->state_desc);
@@ -4722,12 +4815,12 @@ extern int job_complete(uint32_t job_id, uid_t uid, bool requeue,
 			/* Test if the job has finished before its allowed
 			 * over time has expired.
 			 */
-			job_ptr->job_state = JOB_TIMEOUT  | job_comp_flag;
+			JOB_STATE_SET(job_ptr, JOB_TIMEOUT  | job_comp_flag);
 			job_ptr->exit_code = MAX(job_ptr->exit_code, 1);
 			job_ptr->state_reason = FAIL_TIMEOUT;
 			xfree(job_ptr->state_desc);
 		} else {
-			job_ptr->job_state = JOB_COMPLETE | job_comp_flag;
+			JOB_STATE_SET(job_ptr, JOB_COMPLETE | job_comp_flag);
 			job_ptr->exit_code = job_return_code;
 			if (nonstop_ops.job_fini)
 				(nonstop_ops.job_fini)(job_ptr);
@@ -4743,6 +4836,7 @@ extern int job_complete(uint32_t job_id, uid_t uid, bool requeue,
 	}
 
 	last_job_update = now;
+	JOB_DELTA_TOUCH(job_ptr);
 	job_ptr->time_last_active = now;   /* Timer for resending kill RPC */
 	if (job_comp_flag) {	/* job was running */
 		build_cg_bitmap(job_ptr);
@@ -5726,7 +5820,7 @@ static int _job_create(job_desc_msg_t *job_desc, int allocate, int will_run,
 
 cleanup_fail:
 	if (job_ptr) {
-		job_ptr->job_state = JOB_FAILED;
+		JOB_STATE_SET(job_ptr, JOB_FAILED);
 		job_ptr->exit_code = 1;
 		job_ptr->state_reason = FAIL_SYSTEM;
 		xfree(job_ptr->state_desc);
@@ -6558,7 +6652,7 @@ _copy_job_desc_to_job_record(job_desc_msg_t * job_desc,
 
 	job_ptr->user_id    = (uid_t) job_desc->user_id;
 	job_ptr->group_id   = (gid_t) job_desc->group_id;
-	job_ptr->job_state  = JOB_PENDING;
+	JOB_STATE_SET(job_ptr, JOB_PENDING);
 	job_ptr->time_limit = job_desc->time_limit;
 	if (job_desc->time_min != NO_VAL)
 		job_ptr->time_min = job_desc->time_min;
@@ -6871,7 +6965,7 @@ void job_time_limit(void)
 				debug("%s: Configuration for job %u is "
 				      "complete",
 				      __func__, job_ptr->job_id);
-				job_ptr->job_state &= (~JOB_CONFIGURING);
+				JOB_STATE_FLAG_CLEAR(job_ptr, JOB_CONFIGURING);
 			}
 		}
 #endif
@@ -6896,11 +6990,12 @@ void job_time_limit(void)
 			}
 			if (job_ptr->end_time <= now) {
 				last_job_update = now;
+				JOB_DELTA_TOUCH(job_ptr);
 				info("%s: Preemption GraceTime reached JobId=%u",
 				     __func__, job_ptr->job_id);
 				_job_timed_out(job_ptr);
-				job_ptr->job_state = JOB_PREEMPTED |
-						     JOB_COMPLETING;
+				JOB_STATE_SET(job_ptr, JOB_PREEMPTED |
+						       JOB_COMPLETING);
 				xfree(job_ptr->state_desc);
 			}
 			continue;
@@ -6970,6 +7065,7 @@ void job_time_limit(void)
 			}
 			if (job_ptr->end_time <= over_run) {
 				last_job_update = now;
+				JOB_DELTA_TOUCH(job_ptr);
 				info("Time limit exhausted for JobId=%u",
 				     job_ptr->job_id);
 				_job_timed_out(job_ptr);
@@ -6981,6 +7077,7 @@ void job_time_limit(void)
 
 		if (resv_status != SLURM_SUCCESS) {
 			last_job_update = now;
+			JOB_DELTA_TOUCH(job_ptr);
 			info("Reservation ended for JobId=%u",
 			     job_ptr->job_id);
 			_job_timed_out(job_ptr);
@@ -6999,6 +7096,7 @@ void job_time_limit(void)
 
 		if (job_ptr->state_reason == FAIL_TIMEOUT) {
 			last_job_update = now;
+			JOB_DELTA_TOUCH(job_ptr);
 			_job_timed_out(job_ptr);
 			xfree(job_ptr->state_desc);
 			continue;
@@ -7077,7 +7175,7 @@ static void _job_timed_out(struct job_record *job_ptr)
 		time_t now      = time(NULL);
 		job_ptr->end_time           = now;
 		job_ptr->time_last_active   = now;
-		job_ptr->job_state          = JOB_TIMEOUT | JOB_COMPLETING;
+		JOB_STATE_SET(job_ptr, JOB_TIMEOUT | JOB_COMPLETING);
 		build_cg_bitmap(job_ptr);
 		job_ptr->exit_code = MAX(job_ptr->exit_code, 1);
 		job_completion_logger(job_ptr, false);
@@ -7225,6 +7323,9 @@ static void _list_delete_job(void *job_entry)
 	xassert (job_ptr->magic == JOB_MAGIC);
 	job_ptr->magic = 0;	/* make sure we don't delete record twice */
 
+	_job_delta_purge(job_ptr->job_id);
+	pend_job_remove(job_ptr);
+
 	/* Remove the record from job hash table */
 	job_pptr = &job_hash[JOB_HASH_INX(job_ptr->job_id)];
 	while ((job_pptr != NULL) && (*job_pptr != NULL) &&
@@ -7563,6 +7664,182 @@ extern void pack_all_jobs(char **buffer_ptr, int *buffer_size,
 	buffer_ptr[0] = xfer_buf_data(buffer);
 }
 
+static void _job_delta_purge_del(void *x)
+{
+	xfree(x);
+}
+
+/* Record the removal of a job for pack_all_jobs_delta() */
+static void _job_delta_purge(uint32_t job_id)
+{
+	job_delta_purge_t *purge_ptr;
+	time_t now = time(NULL);
+
+	slurm_mutex_lock(&job_delta_mutex);
+	if (job_delta_gen == 0) {	/* No generations assigned yet */
+		slurm_mutex_unlock(&job_delta_mutex);
+		return;
+	}
+	if (!job_delta_purge_list)
+		job_delta_purge_list = list_create(_job_delta_purge_del);
+	purge_ptr = xmalloc(sizeof(job_delta_purge_t));
+	purge_ptr->delta_gen = job_delta_next_gen;
+	job_delta_changed = true;
+	purge_ptr->job_id = job_id;
+	purge_ptr->purge_time = now;
+	list_append(job_delta_purge_list, purge_ptr);
+
+	/* Clients with older generations must load all jobs */
+	while ((purge_ptr = list_peek(job_delta_purge_list)) &&
+	       (difftime(now, purge_ptr->purge_time) > JOB_DELTA_PURGE_AGE)) {
+		job_delta_full_gen = MAX(job_delta_full_gen,
+					 purge_ptr->delta_gen);
+		purge_ptr = list_dequeue(job_delta_purge_list);
+		xfree(purge_ptr);
+	}
+	slurm_mutex_unlock(&job_delta_mutex);
+}
+
+/* Make the generation of job records changed since the previous call visible
+ * to clients, so later changes get the next generation. Called with the job
+ * read lock set, which excludes the writers of job_delta_next_gen.
+ * OUT full_gen - clients with an older generation must load all jobs
+ * RET latest generation */
+static uint32_t _job_delta_close(uint32_t *full_gen)
+{
+	uint32_t gen;
+
+	slurm_mutex_lock(&job_delta_mutex);
+	if (job_delta_part_update != last_part_update) {
+		/* Partition changes alter which jobs are visible */
+		job_delta_part_update = last_part_update;
+		job_delta_full_gen = job_delta_next_gen;
+		job_delta_changed = true;
+	}
+	if (job_delta_changed || (job_delta_gen == 0)) {
+		job_delta_gen = job_delta_next_gen++;
+		job_delta_changed = false;
+	}
+	gen = job_delta_gen;
+	*full_gen = job_delta_full_gen;
+	slurm_mutex_unlock(&job_delta_mutex);
+
+	return gen;
+}
+
+/* Add a job ID to the removed job list of pack_all_jobs_delta() */
+static void _job_delta_removed(uint32_t **removed_id, uint32_t *removed_cnt,
+			       uint32_t *removed_size, uint32_t job_id)
+{
+	if (*removed_cnt >= *removed_size) {
+		*removed_size += 64;
+		xrealloc(*removed_id, sizeof(uint32_t) * (*removed_size));
+	}
+	(*removed_id)[(*removed_cnt)++] = job_id;
+}
+
+/*
+ * pack_all_jobs_delta - dump information for jobs changed since a client's
+ *	generation in machine independent form (for network transmission)
+ * OUT buffer_ptr - the pointer is set to the allocated buffer, NULL if no
+ *	job changed since the client's generation
+ * OUT buffer_size - set to size of the buffer in bytes
+ * IN generation - generation of the client's job information, 0 if none
+ * IN show_flags - job filtering options
+ * IN uid - uid of user making request (for partition filtering)
+ * IN protocol_version - slurm protocol version of client
+ * global: job_list - global list of job records
+ * NOTE: the buffer at *buffer_ptr must be xfreed by the caller
+ * NOTE: change _unpack_job_info_delta_msg() in common/slurm_protocol_pack.c
+ *	whenever the data format changes
+ */
+extern void pack_all_jobs_delta(char **buffer_ptr, int *buffer_size,
+				uint64_t generation, uint16_t show_flags,
+				uid_t uid, uint16_t protocol_version)
+{
+	ListIterator iter;
+	struct job_record *job_ptr;
+	job_delta_purge_t *purge_ptr;
+	uint32_t jobs_packed = 0, tmp_offset, client_gen, delta_gen, full_gen;
+	uint32_t removed_cnt = 0, removed_size = 0, *removed_id = NULL;
+	uint32_t boot_time = (uint32_t) slurmctld_config.boot_time;
+	uint16_t full;
+	Buf buffer;
+
+	buffer_ptr[0] = NULL;
+	*buffer_size = 0;
+
+	delta_gen = _job_delta_close(&full_gen);
+	client_gen = (uint32_t) generation;
+	if (((uint32_t) (generation >> 32) != boot_time) ||
+	    (client_gen < full_gen) || (client_gen > delta_gen))
+		full = 1;
+	else if (client_gen == delta_gen)
+		return;		/* no change */
+	else
+		full = 0;
+
+	buffer = init_buf(BUF_SIZE);
+
+	/* write message body header : size and time */
+	/* put in a place holder job record count of 0 for now */
+	pack32(jobs_packed, buffer);
+	pack_time(time(NULL), buffer);
+
+	/* write individual job records */
+	part_filter_set(uid);
+	iter = list_iterator_create(job_list);
+	while ((job_ptr = (struct job_record *) list_next(iter))) {
+		xassert (job_ptr->magic == JOB_MAGIC);
+
+		if (!full && (job_ptr->delta_gen <= client_gen))
+			continue;
+
+		if ((((show_flags & SHOW_ALL) == 0) && (uid != 0) &&
+		     _all_parts_hidden(job_ptr)) ||
+		    _hide_job(job_ptr, uid)) {
+			/* The client may have this job from when visible */
+			if (!full) {
+				_job_delta_removed(&removed_id, &removed_cnt,
+						   &removed_size,
+						   job_ptr->job_id);
+			}
+			continue;
+		}
+
+		pack_job(job_ptr, show_flags, buffer, protocol_version, uid);
+		jobs_packed++;
+	}
+	list_iterator_destroy(iter);
+	part_filter_clear();
+
+	if (!full && job_delta_purge_list) {
+		iter = list_iterator_create(job_delta_purge_list);
+		while ((purge_ptr = (job_delta_purge_t *) list_next(iter))) {
+			if (purge_ptr->delta_gen <= client_gen)
+				continue;
+			_job_delta_removed(&removed_id, &removed_cnt,
+					   &removed_size, purge_ptr->job_id);
+		}
+		list_iterator_destroy(iter);
+	}
+
+	/* put the real record count in the message body header */
+	tmp_offset = get_buf_offset(buffer);
+	set_buf_offset(buffer, 0);
+	pack32(jobs_packed, buffer);
+	set_buf_offset(buffer, tmp_offset);
+
+	/* write trailer: generation, full flag and removed job IDs */
+	pack64((((uint64_t) boot_time) << 32) | delta_gen, buffer);
+	pack16(full, buffer);
+	pack32_array(removed_id, removed_cnt, buffer);
+	xfree(removed_id);
+
+	*buffer_size = get_buf_offset(buffer);
+	buffer_ptr[0] = xfer_buf_data(buffer);
+}
+
 /*
  * pack_one_job - dump information for one jobs in
  *	machine independent form (for network transmission)
@@ -8668,6 +8945,7 @@ void reset_job_bitmaps(void)
 	job_iterator = list_iterator_create(job_list);
 	while ((job_ptr = (struct job_record *) list_next(job_iterator))) {
 		xassert (job_ptr->magic == JOB_MAGIC);
+		JOB_DELTA_TOUCH(job_ptr);
 		job_fail = false;
 
 		if (job_ptr->partition == NULL) {
@@ -8742,16 +9020,16 @@ void reset_job_bitmaps(void)
 			if (IS_JOB_PENDING(job_ptr)) {
 				job_ptr->start_time =
 					job_ptr->end_time = time(NULL);
-				job_ptr->job_state = JOB_NODE_FAIL;
+				JOB_STATE_SET(job_ptr, JOB_NODE_FAIL);
 			} else if (IS_JOB_RUNNING(job_ptr)) {
 				job_ptr->end_time = time(NULL);
-				job_ptr->job_state = JOB_NODE_FAIL |
-						     JOB_COMPLETING;
+				JOB_STATE_SET(job_ptr, JOB_NODE_FAIL |
+						       JOB_COMPLETING);
 				build_cg_bitmap(job_ptr);
 			} else if (IS_JOB_SUSPENDED(job_ptr)) {
 				job_ptr->end_time = job_ptr->suspend_time;
-				job_ptr->job_state = JOB_NODE_FAIL |
-						     JOB_COMPLETING;
+				JOB_STATE_SET(job_ptr, JOB_NODE_FAIL |
+						       JOB_COMPLETING);
 				build_cg_bitmap(job_ptr);
 				job_ptr->tot_sus_time +=
 					difftime(now, job_ptr->suspend_time);
@@ -9210,6 +9488,7 @@ static int _update_job(struct job_record *job_ptr, job_desc_msg_t * job_specs,
 	if (detail_ptr)
 		mc_ptr = detail_ptr->mc_ptr;
 	last_job_update = now;
+	JOB_DELTA_TOUCH(job_ptr);
 
 	if (job_specs->account
 	    && !xstrcmp(job_specs->account, job_ptr->account)) {
@@ -10046,7 +10325,7 @@ static int _update_job(struct job_record *job_ptr, job_desc_msg_t * job_specs,
 			info("sched: update_job: releasing hold for job_id %u",
 			     job_ptr->job_id);
 			job_ptr->state_reason = WAIT_NO_REASON;
-			job_ptr->job_state &= ~JOB_SPECIAL_EXIT;
+			JOB_STATE_FLAG_CLEAR(job_ptr, JOB_SPECIAL_EXIT);
 			xfree(job_ptr->state_desc);
 			job_ptr->exit_code = 0;
 		} else if ((job_ptr->priority == 0) &&
@@ -11197,7 +11476,7 @@ extern void job_pre_resize_acctg(struct job_record *job_ptr)
 	    && !job_ptr->resize_time)
 		jobacct_storage_g_job_start(acct_db_conn, job_ptr);
 
-	job_ptr->job_state |= JOB_RESIZING;
+	JOB_STATE_FLAG_SET(job_ptr, JOB_RESIZING);
 	/* NOTE: job_completion_logger() calls
 	 *	 acct_policy_remove_job_submit() */
 	job_completion_logger(job_ptr, false);
@@ -11231,7 +11510,7 @@ extern void job_post_resize_acctg(struct job_record *job_ptr)
 	jobacct_storage_g_job_start(acct_db_conn, job_ptr);
 
 	job_ptr->details->submit_time = org_submit;
-	job_ptr->job_state &= (~JOB_RESIZING);
+	JOB_STATE_FLAG_CLEAR(job_ptr, JOB_RESIZING);
 }
 
 /*
@@ -11257,6 +11536,7 @@ validate_jobs_on_node(slurm_node_registration_status_msg_t *reg_msg)
 		return;
 	}
 
+	NODE_DELTA_TOUCH(node_ptr);
 	if (reg_msg->energy)
 		memcpy(node_ptr->energy, reg_msg->energy,
 		       sizeof(acct_gather_energy_t));
@@ -11617,7 +11897,7 @@ job_alloc_info(uint32_t uid, uint32_t job_id, struct job_record **job_pptr)
 	if (job_ptr->alias_list && !strcmp(job_ptr->alias_list, "TBD") &&
 	    job_ptr->node_bitmap &&
 	    (bit_overlap(power_node_bitmap, job_ptr->node_bitmap) == 0)) {
-		job_ptr->job_state &= (~JOB_CONFIGURING);
+		JOB_STATE_FLAG_CLEAR(job_ptr, JOB_CONFIGURING);
 		set_job_alias_list(job_ptr);
 	}
 
@@ -11726,7 +12006,7 @@ static void _validate_job_files(List batch_dirs)
 		if ((del_cnt == 0) && IS_JOB_PENDING(job_ptr)) {
 			error("Script for job %u lost, state set to FAILED",
 			      job_ptr->job_id);
-			job_ptr->job_state = JOB_FAILED;
+			JOB_STATE_SET(job_ptr, JOB_FAILED);
 			job_ptr->exit_code = 1;
 			job_ptr->state_reason = FAIL_SYSTEM;
 			xfree(job_ptr->state_desc);
@@ -12027,6 +12307,8 @@ void job_fini (void)
 		list_destroy(job_list);
 		job_list = NULL;
 	}
+	pend_job_fini();
+	FREE_NULL_LIST(job_delta_purge_list);
 	xfree(job_hash);
 	xfree(job_array_hash_j);
 	xfree(job_array_hash_t);
@@ -12110,6 +12392,7 @@ extern void job_completion_logger(struct job_record *job_ptr, bool requeue)
 
 	xassert(job_ptr);
 
+	JOB_DELTA_TOUCH(job_ptr);
 	acct_policy_remove_job_submit(job_ptr);
 	(void) bb_g_job_start_stage_out(job_ptr);
 
@@ -12118,7 +12401,7 @@ extern void job_completion_logger(struct job_record *job_ptr, bool requeue)
 	     test_job_array_finished(job_ptr->array_job_id))) {
 		/* Remove configuring state just to make sure it isn't there
 		 * since it will throw off displays of the job. */
-		job_ptr->job_state &= (~JOB_CONFIGURING);
+		JOB_STATE_FLAG_CLEAR(job_ptr, JOB_CONFIGURING);
 
 		/* make sure all parts of the job are notified */
 		srun_job_complete(job_ptr);
@@ -12284,7 +12567,7 @@ extern int job_node_ready(uint32_t job_id, int *ready)
 	    job_ptr->alias_list && !strcmp(job_ptr->alias_list, "TBD") &&
 	    job_ptr->node_bitmap &&
 	    (bit_overlap(power_node_bitmap, job_ptr->node_bitmap) == 0)) {
-		job_ptr->job_state &= (~JOB_CONFIGURING);
+		JOB_STATE_FLAG_CLEAR(job_ptr, JOB_CONFIGURING);
 		set_job_alias_list(job_ptr);
 	}
 
@@ -12513,8 +12796,10 @@ static int _suspend_job_nodes(struct job_record *job_ptr, bool indf_susp)
 			node_ptr->node_state = NODE_STATE_IDLE | node_flags;
 			node_ptr->last_idle  = now;
 		}
+		NODE_DELTA_TOUCH(node_ptr);
 	}
 	last_job_update = last_node_update = now;
+	JOB_DELTA_TOUCH(job_ptr);
 	return rc;
 }
 
@@ -12561,8 +12846,10 @@ static int _resume_job_nodes(struct job_record *job_ptr, bool indf_susp)
 		bit_clear(idle_node_bitmap, i);
 		node_flags = node_ptr->node_state & NODE_STATE_FLAGS;
 		node_ptr->node_state = NODE_STATE_ALLOCATED | node_flags;
+		NODE_DELTA_TOUCH(node_ptr);
 	}
 	last_job_update = last_node_update = time(NULL);
+	JOB_DELTA_TOUCH(job_ptr);
 	return rc;
 }
 
@@ -12658,7 +12945,7 @@ static int _job_suspend(struct job_record *job_ptr, uint16_t op, bool indf_susp)
 		if (rc != SLURM_SUCCESS)
 			return rc;
 		_suspend_job(job_ptr, op, indf_susp);
-		job_ptr->job_state = JOB_SUSPENDED;
+		JOB_STATE_SET(job_ptr, JOB_SUSPENDED);
 		if (indf_susp)
 			job_ptr->priority = 0;
 		if (job_ptr->suspend_time) {
@@ -12679,7 +12966,7 @@ static int _job_suspend(struct job_record *job_ptr, uint16_t op, bool indf_susp)
 		_suspend_job(job_ptr, op, indf_susp);
 		if (job_ptr->priority == 0)
 			set_job_prio(job_ptr);
-		job_ptr->job_state = JOB_RUNNING;
+		JOB_STATE_SET(job_ptr, JOB_RUNNING);
 		job_ptr->tot_sus_time +=
 			difftime(now, job_ptr->suspend_time);
 		if (!wiki_sched_test) {
@@ -12978,6 +13265,7 @@ static int _job_requeue(uid_t uid, struct job_record *job_ptr, bool preempt,
 
 	slurm_sched_g_requeue(job_ptr, "Job requeued by user/admin");
 	last_job_update = now;
+	JOB_DELTA_TOUCH(job_ptr);
 
 	/* In the job is in the process of completing
 	 * return SLURM_SUCCESS and set the status
@@ -12987,7 +13275,8 @@ static int _job_requeue(uid_t uid, struct job_record *job_ptr, bool preempt,
 	if (IS_JOB_COMPLETING(job_ptr)) {
 		uint32_t flags;
 		flags = job_ptr->job_state & JOB_STATE_FLAGS;
-		job_ptr->job_state = JOB_PENDING | flags;
+		JOB_STATE_SET(job_ptr, JOB_PENDING | flags);
+		pend_job_add(job_ptr);
 		goto reply;
 	}
 
@@ -12996,9 +13285,9 @@ static int _job_requeue(uid_t uid, struct job_record *job_ptr, bool preempt,
 		/* we can't have it as suspended when we call the
 		 * accounting stuff.
 		 */
-		job_ptr->job_state = JOB_REQUEUE;
+		JOB_STATE_SET(job_ptr, JOB_REQUEUE);
 		jobacct_storage_g_job_suspend(acct_db_conn, job_ptr);
-		job_ptr->job_state = suspend_job_state;
+		JOB_STATE_SET(job_ptr, suspend_job_state);
 		is_suspended = true;
 	}
 
@@ -13018,16 +13307,16 @@ static int _job_requeue(uid_t uid, struct job_record *job_ptr, bool preempt,
 	/* We want this job to have the requeued state in the
 	 * accounting logs. Set a new submit time so the restarted
 	 * job looks like a new job. */
-	job_ptr->job_state  = JOB_REQUEUE;
+	JOB_STATE_SET(job_ptr, JOB_REQUEUE);
 	build_cg_bitmap(job_ptr);
 	job_completion_logger(job_ptr, true);
 
 	/* Deallocate resources only if the job has some.
 	 * JOB_COMPLETING is needed to properly clean up steps. */
 	if (is_running) {
-		job_ptr->job_state |= JOB_COMPLETING;
+		JOB_STATE_FLAG_SET(job_ptr, JOB_COMPLETING);
 		deallocate_nodes(job_ptr, false, is_suspended, preempt);
-		job_ptr->job_state &= (~JOB_COMPLETING);
+		JOB_STATE_FLAG_CLEAR(job_ptr, JOB_COMPLETING);
 	}
 
 	xfree(job_ptr->details->req_node_layout);
@@ -13036,9 +13325,10 @@ static int _job_requeue(uid_t uid, struct job_record *job_ptr, bool preempt,
 	//job_ptr->db_index = 0;
 	//job_ptr->details->submit_time = now;
 
-	job_ptr->job_state = JOB_PENDING;
+	JOB_STATE_SET(job_ptr, JOB_PENDING);
 	if (job_ptr->node_cnt)
-		job_ptr->job_state |= JOB_COMPLETING;
+		JOB_STATE_FLAG_SET(job_ptr, JOB_COMPLETING);
+	pend_job_add(job_ptr);
 
 reply:
 	job_ptr->pre_sus_time = (time_t) 0;
@@ -13051,7 +13341,7 @@ reply:
 	acct_policy_add_job_submit(job_ptr);
 
 	if (state & JOB_SPECIAL_EXIT) {
-		job_ptr->job_state |= JOB_SPECIAL_EXIT;
+		JOB_STATE_FLAG_SET(job_ptr, JOB_SPECIAL_EXIT);
 		job_ptr->state_reason = WAIT_HELD_USER;
 		xfree(job_ptr->state_desc);
 		job_ptr->state_desc =
@@ -13485,6 +13775,7 @@ extern int update_job_account(char *module, struct job_record *job_ptr,
 	job_ptr->assoc_id = assoc_rec.id;
 
 	last_job_update = time(NULL);
+	JOB_DELTA_TOUCH(job_ptr);
 
 	return SLURM_SUCCESS;
 }
@@ -13549,6 +13840,7 @@ extern int update_job_wckey(char *module, struct job_record *job_ptr,
 	}
 
 	last_job_update = time(NULL);
+	JOB_DELTA_TOUCH(job_ptr);
 
 	return SLURM_SUCCESS;
 }
@@ -13677,6 +13969,7 @@ extern int job_checkpoint(checkpoint_msg_t *ckpt_ptr, uid_t uid,
 		info("checkpoint_op %u of %u.%u complete, rc=%d",
 		     ckpt_ptr->op, ckpt_ptr->job_id, ckpt_ptr->step_id, rc);
 		last_job_update = time(NULL);
+		JOB_DELTA_TOUCH(job_ptr);
 	} else {		/* operate on all of a job's steps */
 		int update_rc = -2;
 		ListIterator step_iterator;
@@ -13709,8 +14002,10 @@ extern int job_checkpoint(checkpoint_msg_t *ckpt_ptr, uid_t uid,
 			rc = MAX(rc, update_rc);
 			xfree(image_dir);
 		}
-		if (update_rc != -2)	/* some work done */
+		if (update_rc != -2) {	/* some work done */
 			last_job_update = time(NULL);
+			JOB_DELTA_TOUCH(job_ptr);
+		}
 		list_iterator_destroy (step_iterator);
 	}
 
@@ -14136,6 +14431,7 @@ extern int job_restart(checkpoint_msg_t *ckpt_ptr, uid_t uid, slurm_fd_t conn_fd
 		image_dir = NULL;	/* Nothing left to xfree */
 
 		last_job_update = time(NULL);
+		JOB_DELTA_TOUCH(job_ptr);
 	}
 
  unpack_error:
@@ -14206,11 +14502,11 @@ extern void build_cg_bitmap(struct job_record *job_ptr)
 	if (job_ptr->node_bitmap) {
 		job_ptr->node_bitmap_cg = bit_copy(job_ptr->node_bitmap);
 		if (bit_set_count(job_ptr->node_bitmap_cg) == 0)
-			job_ptr->job_state &= (~JOB_COMPLETING);
+			JOB_STATE_FLAG_CLEAR(job_ptr, JOB_COMPLETING);
 	} else {
 		error("build_cg_bitmap: node_bitmap is NULL");
 		job_ptr->node_bitmap_cg = bit_alloc(node_record_count);
-		job_ptr->job_state &= (~JOB_COMPLETING);
+		JOB_STATE_FLAG_CLEAR(job_ptr, JOB_COMPLETING);
 	}
 }
 
@@ -14255,7 +14551,8 @@ extern void job_hold_requeue(struct job_record *job_ptr)
 	/* Set the job pending
 	 */
 	flags = job_ptr->job_state & JOB_STATE_FLAGS;
-	job_ptr->job_state = JOB_PENDING | flags;
+	JOB_STATE_SET(job_ptr, JOB_PENDING | flags);
+	pend_job_add(job_ptr);
 	job_ptr->restart_cnt++;
 
 	/* Test if user wants to requeue the job
@@ -14266,12 +14563,12 @@ extern void job_hold_requeue(struct job_record *job_ptr)
 		 * the job, put it on hold and display
 		 * it as JOB_SPECIAL_EXIT.
 		 */
-		job_ptr->job_state |= JOB_SPECIAL_EXIT;
+		JOB_STATE_FLAG_SET(job_ptr, JOB_SPECIAL_EXIT);
 		job_ptr->state_reason = WAIT_HELD_USER;
 		job_ptr->priority = 0;
 	}
 
-	job_ptr->job_state &= ~JOB_REQUEUE;
+	JOB_STATE_FLAG_CLEAR(job_ptr, JOB_REQUEUE);
 
 	debug("%s: job %u state 0x%x reason %u priority %d", __func__,
 	      job_ptr->job_id, job_ptr->job_state,
@@ -14390,7 +14687,7 @@ _set_job_requeue_exit_value(struct job_record *job_ptr)
 		if (exit_code == requeue_exit[cc]) {
 			debug2("%s: job %d exit code %d state JOB_REQUEUE",
 			       __func__, job_ptr->job_id, exit_code);
-			job_ptr->job_state |= JOB_REQUEUE;
+			JOB_STATE_FLAG_SET(job_ptr, JOB_REQUEUE);
 			return;
 		}
 	}
@@ -14403,8 +14700,8 @@ _set_job_requeue_exit_value(struct job_record *job_ptr)
 			 */
 			debug2("%s: job %d exit code %d state JOB_SPECIAL_EXIT",
 			       __func__, job_ptr->job_id, exit_code);
-			job_ptr->job_state |= JOB_REQUEUE;
-			job_ptr->job_state |= JOB_SPECIAL_EXIT;
+			JOB_STATE_FLAG_SET(job_ptr, JOB_REQUEUE);
+			JOB_STATE_FLAG_SET(job_ptr, JOB_SPECIAL_EXIT);
 			return;
 		}
 	}
@@ -14542,7 +14839,7 @@ extern void job_array_post_sched(struct job_record *job_ptr)
 	} else {
 		new_job_ptr = job_array_split(job_ptr);
 		if (new_job_ptr) {
-			new_job_ptr->job_state = JOB_PENDING;
+			JOB_STATE_SET(new_job_ptr, JOB_PENDING);
 			new_job_ptr->start_time = (time_t) 0;
 			/* Do NOT clear db_index here, it is handled when
 			 * task_id_str is created elsewhere */
@@ -14620,11 +14917,12 @@ _kill_dependent(struct job_record *job_ptr)
 
 	info("%s: Job dependency can't be satisfied, cancelling "
 	     "job %s", __func__, jobid2str(job_ptr, jbuf, sizeof(jbuf)));
-	job_ptr->job_state = JOB_CANCELLED;
+	JOB_STATE_SET(job_ptr, JOB_CANCELLED);
 	xfree(job_ptr->state_desc);
 	job_ptr->start_time = now;
 	job_ptr->end_time = now;
 	job_completion_logger(job_ptr, false);
 	last_job_update = now;
+	JOB_DELTA_TOUCH(job_ptr);
 	srun_allocate_abort(job_ptr);
 }
@@ -118,6 +118,15 @@ static void *	_wait_boot(void *arg);
 static int	build_queue_timeout = BUILD_TIMEOUT;
 static int	save_last_part_update = 0;
 
+/* Index of job records which may be pending. With large numbers of running
+ * and completed jobs this spares build_job_queue() walking all of job_list on
+ * every scheduling pass. Records enter the index when created or requeued and
+ * leave it when build_job_queue() finds them in some other state or when
+ * purged. job_ptr->pend_inx is the record's position in the array plus one. */
+static struct job_record **pend_job_array = NULL;
+static uint32_t	pend_job_cnt = 0;
+static uint32_t	pend_job_size = 0;
+
 extern diag_stats_t slurmctld_diag_stats;
 
 /*
@@ -168,6 +177,49 @@ static void _job_queue_rec_del(void *x)
 	xfree(x);
 }
 
+/*
+ * pend_job_add - add a job record to the index of possibly pending jobs
+ *	scanned by build_job_queue(). Call when a job record is created or a
+ *	job is requeued. Jobs found not pending are dropped from the index by
+ *	build_job_queue().
+ */
+extern void pend_job_add(struct job_record *job_ptr)
+{
+	if (job_ptr->pend_inx)
+		return;
+	if (pend_job_cnt >= pend_job_size) {
+		pend_job_size = MAX(pend_job_size * 2, 1024);
+		xrealloc(pend_job_array,
+			 sizeof(struct job_record *) * pend_job_size);
+	}
+	pend_job_array[pend_job_cnt++] = job_ptr;
+	job_ptr->pend_inx = pend_job_cnt;
+}
+
+/* pend_job_remove - remove a job record from the pending job index */
+extern void pend_job_remove(struct job_record *job_ptr)
+{
+	uint32_t inx;
+
+	if (!job_ptr->pend_inx)
+		return;
+	inx = job_ptr->pend_inx - 1;
+	xassert(pend_job_array[inx] == job_ptr);
+	job_ptr->pend_inx = 0;
+	if (inx != --pend_job_cnt) {
+		pend_job_array[inx] = pend_job_array[pend_job_cnt];
+		pend_job_array[inx]->pend_inx = inx + 1;
+	}
+}
+
+/* pend_job_fini - free memory used by the pending job index */
+extern void pend_job_fini(void)
+{
+	xfree(pend_job_array);
+	pend_job_cnt = 0;
+	pend_job_size = 0;
+}
+
 /* Job test for ability to run now, excludes partition specific tests */
 static bool _job_runnable_test1(struct job_record *job_ptr, bool sched_plugin)
 {
@@ -200,6 +252,7 @@ static bool _job_runnable_test1(struct job_record *job_ptr, bool sched_plugin)
 		job_ptr->state_reason = WAIT_NO_REASON;
 		xfree(job_ptr->state_desc);
 		last_job_update = now;
+		JOB_DELTA_TOUCH(job_ptr);
 	}
 #endif
 
@@ -214,6 +267,7 @@ static bool _job_runnable_test1(struct job_record *job_ptr, bool sched_plugin)
 			job_ptr->state_reason = WAIT_HELD;
 			xfree(job_ptr->state_desc);
 			last_job_update = now;
+			JOB_DELTA_TOUCH(job_ptr);
 		}
 		debug3("sched: JobId=%u. State=%s. Reason=%s. Priority=%u.",
 		       job_ptr->job_id,
@@ -301,10 +355,11 @@ static int _delta_tv(struct timeval *tv)
 extern List build_job_queue(bool clear_start, bool backfill)
 {
 	List job_queue;
-	ListIterator job_iterator, part_iterator;
+	ListIterator part_iterator;
 	struct job_record *job_ptr = NULL, *new_job_ptr;
 	struct part_record *part_ptr;
 	int i, pend_cnt, reason;
+	uint32_t pend_inx;
 	struct timeval start_tv = {0, 0};
 	int tested_jobs = 0;
 	char jobid_buf[32];
@@ -313,9 +368,10 @@ extern List build_job_queue(bool clear_start, bool backfill)
 	job_queue = list_create(_job_queue_rec_del);
 
 	/* Create individual job records for job arrays that need burst buffer
-	 * staging */
-	job_iterator = list_iterator_create(job_list);
-	while ((job_ptr = (struct job_record *) list_next(job_iterator))) {
+	 * staging. Records split out here are added to the end of the pending
+	 * job index, so re-read the array on each iteration. */
+	for (pend_inx = 0; pend_inx < pend_job_cnt; pend_inx++) {
+		job_ptr = pend_job_array[pend_inx];
 		if (!job_ptr->burst_buffer || !job_ptr->array_recs ||
 		    !job_ptr->array_recs->task_id_bitmap ||
 		    (job_ptr->array_task_id != NO_VAL))
@@ -337,7 +393,7 @@ extern List build_job_queue(bool clear_start, bool backfill)
 		if (new_job_ptr) {
 			debug("%s: Split out %s for burst buffer use", __func__,
 			      jobid2fmt(job_ptr, jobid_buf, sizeof(jobid_buf)));
-			new_job_ptr->job_state = JOB_PENDING;
+			JOB_STATE_SET(new_job_ptr, JOB_PENDING);
 			new_job_ptr->start_time = (time_t) 0;
 			/* Do NOT clear db_index here, it is handled when
 			 * task_id_str is created elsewhere */
@@ -347,16 +403,22 @@ extern List build_job_queue(bool clear_start, bool backfill)
 			      jobid2fmt(job_ptr, jobid_buf, sizeof(jobid_buf)));
 		}
 	}
-	list_iterator_destroy(job_iterator);
 
-	job_iterator = list_iterator_create(job_list);
-	while ((job_ptr = (struct job_record *) list_next(job_iterator))) {
+	pend_inx = 0;
+	while (pend_inx < pend_job_cnt) {
+		job_ptr = pend_job_array[pend_inx];
+		xassert(job_ptr->magic == JOB_MAGIC);
+		if (!IS_JOB_PENDING(job_ptr)) {
+			/* Moves the last record into this position */
+			pend_job_remove(job_ptr);
+			continue;
+		}
+		pend_inx++;
 		if (((tested_jobs % 100) == 0) &&
 		    (_delta_tv(&start_tv) >= build_queue_timeout)) {
 			info("build_job_queue has been running for %d usec, "
-			     "exiting with %d of %d jobs tested",
-			     build_queue_timeout, tested_jobs,
-			     list_count(job_list));
+			     "exiting with %d of %u pending jobs tested",
+			     build_queue_timeout, tested_jobs, pend_job_cnt);
 			break;
 		}
 		tested_jobs++;
@@ -415,7 +477,6 @@ extern List build_job_queue(bool clear_start, bool backfill)
 					  job_ptr->part_ptr, job_ptr->priority);
 		}
 	}
-	list_iterator_destroy(job_iterator);
 
 	return job_queue;
 }
@@ -652,6 +713,7 @@ next_part:		part_ptr = (struct part_record *)
 				xfree(job_ptr->state_desc);
 				job_ptr->assoc_id = assoc_rec.id;
 				last_job_update = now;
+				JOB_DELTA_TOUCH(job_ptr);
 			} else {
 				continue;
 			}
@@ -668,11 +730,13 @@ next_part:		part_ptr = (struct part_record *)
 				xfree(job_ptr->state_desc);
 				job_ptr->state_reason = FAIL_QOS;
 				last_job_update = now;
+				JOB_DELTA_TOUCH(job_ptr);
 				continue;
 			} else if (job_ptr->state_reason == FAIL_QOS) {
 				xfree(job_ptr->state_desc);
 				job_ptr->state_reason = WAIT_NO_REASON;
 				last_job_update = now;
+				JOB_DELTA_TOUCH(job_ptr);
 			}
 		}
 
@@ -683,6 +747,7 @@ next_part:		part_ptr = (struct part_record *)
 			job_ptr->state_reason = WAIT_NO_REASON;
 			xfree(job_ptr->state_desc);
 			last_job_update = now;
+			JOB_DELTA_TOUCH(job_ptr);
 		}
 
 		if ((job_ptr->state_reason == WAIT_NODE_NOT_AVAIL) &&
@@ -702,6 +767,7 @@ next_part:		part_ptr = (struct part_record *)
 			job_ptr->state_reason = WAIT_LICENSES;
 			xfree(job_ptr->state_desc);
 			last_job_update = now;
+			JOB_DELTA_TOUCH(job_ptr);
 			continue;
 		}
 
@@ -715,6 +781,7 @@ next_part:		part_ptr = (struct part_record *)
 			info("sched: JobId=%u has invalid account",
 			     job_ptr->job_id);
 			last_job_update = now;
+			JOB_DELTA_TOUCH(job_ptr);
 			job_ptr->state_reason = FAIL_ACCOUNT;
 			xfree(job_ptr->state_desc);
 			continue;
@@ -746,6 +813,7 @@ next_part:		part_ptr = (struct part_record *)
 		job_ptr->details->exc_node_bitmap = orig_exc_bitmap;
 		if (error_code == SLURM_SUCCESS) {
 			last_job_update = now;
+			JOB_DELTA_TOUCH(job_ptr);
 			info("sched: Allocate JobId=%u NodeList=%s #CPUs=%u",
 			     job_ptr->job_id, job_ptr->nodes,
 			     job_ptr->total_cpus);
@@ -763,6 +831,18 @@ next_part:		part_ptr = (struct part_record *)
 		list_iterator_destroy(part_iterator);
 
 send_reply:
+	if (launch_msg &&
+	    slurm_cred_sign_batch(slurmctld_config.cred_ctx,
+				  &launch_msg->cred, 1)) {
+		error("Can not sign job credential, attempting to requeue "
+		      "batch job %u", launch_msg->job_id);
+		lock_slurmctld(job_write_lock);
+		(void) job_complete(launch_msg->job_id, getuid(), true, false,
+				    0);
+		unlock_slurmctld(job_write_lock);
+		slurmctld_free_batch_job_launch_msg(launch_msg);
+		launch_msg = NULL;
+	}
 	if (launch_msg) {
 		slurm_msg_t response_msg;
 		slurm_msg_t_init(&response_msg);
@@ -1098,6 +1178,7 @@ extern int schedule(uint32_t job_limit)
 				job_ptr->state_reason = WAIT_FRONT_END;
 				xfree(job_ptr->state_desc);
 				last_job_update = now;
+				JOB_DELTA_TOUCH(job_ptr);
 				continue;
 			}
 			if (!_job_runnable_test1(job_ptr, false))
@@ -1132,6 +1213,7 @@ next_part:			part_ptr = (struct part_record *)
 				job_ptr->state_reason = WAIT_FRONT_END;
 				xfree(job_ptr->state_desc);
 				last_job_update = now;
+				JOB_DELTA_TOUCH(job_ptr);
 				continue;
 			}
 			if (!IS_JOB_PENDING(job_ptr))
@@ -1233,6 +1315,7 @@ next_task:
 				job_ptr->state_reason = WAIT_PRIORITY;
 				xfree(job_ptr->state_desc);
 				last_job_update = now;
+				JOB_DELTA_TOUCH(job_ptr);
 			}
 			debug("sched: JobId=%u. State=PENDING. "
 			       "Reason=%s(Priority), Priority=%u, "
@@ -1261,6 +1344,7 @@ next_task:
 				xfree(job_ptr->state_desc);
 				job_ptr->assoc_id = assoc_rec.id;
 				last_job_update = now;
+				JOB_DELTA_TOUCH(job_ptr);
 			} else {
 				debug("sched: JobId=%u has invalid association",
 				      job_ptr->job_id);
@@ -1282,11 +1366,13 @@ next_task:
 				xfree(job_ptr->state_desc);
 				job_ptr->state_reason = FAIL_QOS;
 				last_job_update = now;
+				JOB_DELTA_TOUCH(job_ptr);
 				continue;
 			} else if (job_ptr->state_reason == FAIL_QOS) {
 				xfree(job_ptr->state_desc);
 				job_ptr->state_reason = WAIT_NO_REASON;
 				last_job_update = now;
+				JOB_DELTA_TOUCH(job_ptr);
 			}
 		}
 
@@ -1312,6 +1398,7 @@ next_task:
 			job_ptr->state_reason = WAIT_RESOURCES;
 			xfree(job_ptr->state_desc);
 			last_job_update = now;
+			JOB_DELTA_TOUCH(job_ptr);
 			debug3("sched: JobId=%u. State=%s. Reason=%s. "
 			       "Priority=%u. Partition=%s.",
 			       job_ptr->job_id,
@@ -1325,6 +1412,7 @@ next_task:
 			job_ptr->state_reason = WAIT_LICENSES;
 			xfree(job_ptr->state_desc);
 			last_job_update = now;
+			JOB_DELTA_TOUCH(job_ptr);
 			debug3("sched: JobId=%u. State=%s. Reason=%s. "
 			       "Priority=%u.",
 			       job_ptr->job_id,
@@ -1344,6 +1432,7 @@ next_task:
 			info("sched: JobId=%u has invalid account",
 			     job_ptr->job_id);
 			last_job_update = now;
+			JOB_DELTA_TOUCH(job_ptr);
 			job_ptr->state_reason = FAIL_ACCOUNT;
 			xfree(job_ptr->state_desc);
 			continue;
@@ -1449,6 +1538,7 @@ next_task:
 			/* job initiated */
 			debug3("sched: JobId=%u initiated", job_ptr->job_id);
 			last_job_update = now;
+			JOB_DELTA_TOUCH(job_ptr);
 			reject_array_job_id = 0;
 			reject_array_part   = NULL;
 #ifdef HAVE_BG
@@ -1502,7 +1592,8 @@ next_task:
 			     slurm_strerror(error_code));
 			if (!wiki_sched) {
 				last_job_update = now;
-				job_ptr->job_state = JOB_PENDING;
+				JOB_DELTA_TOUCH(job_ptr);
+				JOB_STATE_SET(job_ptr, JOB_PENDING);
 				job_ptr->state_reason = FAIL_BAD_CONSTRAINTS;
 				xfree(job_ptr->state_desc);
 				job_ptr->start_time = job_ptr->end_time = now;
@@ -1797,6 +1888,8 @@ extern void launch_job(struct job_record *job_ptr)
 
 /*
  * make_batch_job_cred - add a job credential to the batch_job_launch_msg
+ *	The credential is not signed so that it can be signed after the job
+ *	locks are released, by the agent or slurm_cred_sign_batch()
  * IN/OUT launch_msg_ptr - batch_job_launch_msg in which job_id, step_id,
  *                         uid and nodes have already been set
  * IN job_ptr - pointer to job record
@@ -1840,8 +1933,9 @@ extern int make_batch_job_cred(batch_job_launch_msg_t *launch_msg_ptr,
 	cred_arg.sockets_per_node    = job_resrcs_ptr->sockets_per_node;
 	cred_arg.sock_core_rep_count = job_resrcs_ptr->sock_core_rep_count;
 
-	launch_msg_ptr->cred = slurm_cred_create(slurmctld_config.cred_ctx,
-						 &cred_arg, protocol_version);
+	launch_msg_ptr->cred = slurm_cred_create_unsigned(
+				slurmctld_config.cred_ctx, &cred_arg,
+				protocol_version);
 
 	if (launch_msg_ptr->cred)
 		return SLURM_SUCCESS;
@@ -2955,6 +3049,7 @@ extern int reboot_job_nodes(struct job_record *job_ptr)
 		hostlist_push_host(reboot_agent_args->hostlist, node_ptr->name);
 		reboot_agent_args->node_count++;
 		node_ptr->node_state |= NODE_STATE_NO_RESPOND;
+		NODE_DELTA_TOUCH(node_ptr);
 		bit_clear(avail_node_bitmap, i);
 		node_ptr->last_response = now + resume_timeout;
 	}
@@ -3185,6 +3280,7 @@ static void *_run_prolog(void *arg)
 				continue;
 			node_record_table_ptr[i].node_state &=
 				(~NODE_STATE_POWER_UP);
+			NODE_DELTA_TOUCH(node_record_table_ptr + i);
 		}
 	} else if (node_bitmap) {
 		for (i=0; i<node_record_count; i++) {
@@ -3192,6 +3288,7 @@ static void *_run_prolog(void *arg)
 				continue;
 			node_record_table_ptr[i].node_state &=
 				(~NODE_STATE_POWER_UP);
+			NODE_DELTA_TOUCH(node_record_table_ptr + i);
 		}
 	}
 	unlock_slurmctld(config_read_lock);
@@ -3472,7 +3569,7 @@ cleanup_completing(struct job_record *job_ptr)
 	}
 
 	delete_step_records(job_ptr);
-	job_ptr->job_state &= (~JOB_COMPLETING);
+	JOB_STATE_FLAG_CLEAR(job_ptr, JOB_COMPLETING);
 	job_hold_requeue(job_ptr);
 
 	slurm_sched_g_schedule();
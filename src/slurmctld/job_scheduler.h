@@ -60,6 +60,20 @@ typedef struct job_queue_rec {
  */
 extern int build_feature_list(struct job_record *job_ptr);
 
+/*
+ * pend_job_add - add a job record to the index of possibly pending jobs
+ *	scanned by build_job_queue(). Call when a job record is created or a
+ *	job is requeued. Jobs found not pending are dropped from the index by
+ *	build_job_queue().
+ */
+extern void pend_job_add(struct job_record *job_ptr);
+
+/* pend_job_remove - remove a job record from the pending job index */
+extern void pend_job_remove(struct job_record *job_ptr);
+
+/* pend_job_fini - free memory used by the pending job index */
+extern void pend_job_fini(void);
+
 /*
  * build_job_queue - build (non-priority ordered) list of pending jobs
  * IN clear_start - if set then clear the start_time for pending jobs
@@ -105,6 +119,8 @@ extern void launch_job(struct job_record *job_ptr);
 
 /*
  * make_batch_job_cred - add a job credential to the batch_job_launch_msg
+ *	The credential is not signed so that it can be signed after the job
+ *	locks are released, by the agent or slurm_cred_sign_batch()
  * IN/OUT launch_msg_ptr - batch_job_launch_msg in which job_id, step_id,
  *                         uid and nodes have already been set
  * IN job_ptr - pointer to job record
@@ -47,6 +47,7 @@
 
 #include <errno.h>
 #include <string.h>
+#include <sys/time.h>
 #include <sys/types.h>
 
 #include "src/slurmctld/locks.h"
@@ -57,8 +58,12 @@ static pthread_cond_t locks_cond = PTHREAD_COND_INITIALIZER;
 static pthread_mutex_t state_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 static slurmctld_lock_flags_t slurmctld_locks;
+static slurmctld_lock_stats_t slurmctld_lock_stats;
 static int kill_thread = 0;
 
+static void _lock_stat_add(lock_datatype_t datatype, bool write,
+			   struct timeval *tv_start);
+
 static bool _wr_rdlock(lock_datatype_t datatype, bool wait_lock);
 static void _wr_rdunlock(lock_datatype_t datatype);
 static bool _wr_wrlock(lock_datatype_t datatype, bool wait_lock);
@@ -196,7 +201,9 @@ extern void unlock_slurmctld(slurmctld_lock_t lock_levels)
 static bool _wr_rdlock(lock_datatype_t datatype, bool wait_lock)
 {
 	bool success = true;
+	struct timeval tv_start;
 
+	gettimeofday(&tv_start, NULL);
 	slurm_mutex_lock(&locks_mutex);
 	while (1) {
 #if 1
@@ -210,6 +217,7 @@ static bool _wr_rdlock(lock_datatype_t datatype, bool wait_lock)
 #endif
 			slurmctld_locks.entity[read_lock(datatype)]++;
 			slurmctld_locks.entity[write_cnt_lock(datatype)] = 0;
+			_lock_stat_add(datatype, false, &tv_start);
 			break;
 		} else if (!wait_lock) {
 			success = false;
@@ -237,7 +245,9 @@ static void _wr_rdunlock(lock_datatype_t datatype)
 static bool _wr_wrlock(lock_datatype_t datatype, bool wait_lock)
 {
 	bool success = true;
+	struct timeval tv_start;
 
+	gettimeofday(&tv_start, NULL);
 	slurm_mutex_lock(&locks_mutex);
 	slurmctld_locks.entity[write_wait_lock(datatype)]++;
 
@@ -247,6 +257,7 @@ static bool _wr_wrlock(lock_datatype_t datatype, bool wait_lock)
 			slurmctld_locks.entity[write_lock(datatype)]++;
 			slurmctld_locks.entity[write_wait_lock(datatype)]--;
 			slurmctld_locks.entity[write_cnt_lock(datatype)]++;
+			_lock_stat_add(datatype, true, &tv_start);
 			break;
 		} else if (!wait_lock) {
 			slurmctld_locks.entity[write_wait_lock(datatype)]--;
@@ -280,6 +291,54 @@ void get_lock_values(slurmctld_lock_flags_t * lock_flags)
 	       sizeof(slurmctld_locks));
 }
 
+/* _lock_stat_add - Record the time spent waiting for a lock which has just
+ *	been granted. Caller must hold locks_mutex. */
+static void _lock_stat_add(lock_datatype_t datatype, bool write,
+			   struct timeval *tv_start)
+{
+	struct timeval tv_now;
+	uint32_t delta_t, limit;
+	int inx, bucket;
+
+	gettimeofday(&tv_now, NULL);
+	delta_t  = (tv_now.tv_sec  - tv_start->tv_sec) * 1000000;
+	delta_t += (tv_now.tv_usec - tv_start->tv_usec);
+
+	inx = lock_stat_inx(datatype, write);
+	slurmctld_lock_stats.lock_cnt[inx]++;
+	slurmctld_lock_stats.wait_time[inx] += delta_t;
+	if (slurmctld_lock_stats.wait_max[inx] < delta_t)
+		slurmctld_lock_stats.wait_max[inx] = delta_t;
+
+	/* Buckets are <10us, <100us, <1ms, <10ms, <100ms, <1s and longer */
+	for (bucket = 0, limit = 10; bucket < (LOCK_HIST_BUCKETS - 1);
+	     bucket++, limit *= 10) {
+		if (delta_t < limit)
+			break;
+	}
+	slurmctld_lock_stats.wait_hist[inx][bucket]++;
+}
+
+/* get_lock_stats - Get a copy of the lock wait statistics
+ * OUT lock_stats - a copy of the current lock wait statistics */
+extern void get_lock_stats(slurmctld_lock_stats_t *lock_stats)
+{
+	xassert(lock_stats);
+	slurm_mutex_lock(&locks_mutex);
+	memcpy((void *) lock_stats, (void *) &slurmctld_lock_stats,
+	       sizeof(slurmctld_lock_stats));
+	slurm_mutex_unlock(&locks_mutex);
+}
+
+/* reset_lock_stats - Clear all lock wait statistics */
+extern void reset_lock_stats(void)
+{
+	slurm_mutex_lock(&locks_mutex);
+	memset((void *) &slurmctld_lock_stats, 0,
+	       sizeof(slurmctld_lock_stats));
+	slurm_mutex_unlock(&locks_mutex);
+}
+
 /* kill_locked_threads - Kill all threads waiting on semaphores */
 extern void kill_locked_threads(void)
 {
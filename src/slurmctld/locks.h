@@ -91,6 +91,19 @@
 #ifndef _SLURMCTLD_LOCKS_H
 #define _SLURMCTLD_LOCKS_H
 
+#if HAVE_CONFIG_H
+#  include "config.h"
+#if HAVE_INTTYPES_H
+#  include <inttypes.h>
+#else  /* !HAVE_INTTYPES_H */
+#  if HAVE_STDINT_H
+#    include <stdint.h>
+#  endif
+#endif  /* HAVE_INTTYPES_H */
+#else   /* !HAVE_CONFIG_H */
+#include <stdint.h>
+#endif  /* HAVE_CONFIG_H */
+
 /* levels of locking required for each data structure */
 typedef enum {
 	NO_LOCK,
@@ -132,11 +145,37 @@ typedef struct {
 	int entity[ENTITY_COUNT * 4];
 }	slurmctld_lock_flags_t;
 
+/* Lock wait statistics, reported by sdiag
+ * each data type has a read and a write record, see lock_stat_inx() below
+ *	lock_cnt	count of locks granted
+ *	wait_time	total time spent waiting for the lock, in usec
+ *	wait_max	longest time spent waiting for the lock, in usec
+ *	wait_hist	histogram of wait times, buckets of <10us, <100us,
+ *			<1ms, <10ms, <100ms, <1s and >=1s
+ */
+#define LOCK_STAT_COUNT		(ENTITY_COUNT * 2)
+#define LOCK_HIST_BUCKETS	7
+#define lock_stat_inx(data_type, write)	(data_type * 2 + (write ? 1 : 0))
+
+typedef struct {
+	uint32_t lock_cnt[LOCK_STAT_COUNT];
+	uint64_t wait_time[LOCK_STAT_COUNT];
+	uint32_t wait_max[LOCK_STAT_COUNT];
+	uint32_t wait_hist[LOCK_STAT_COUNT][LOCK_HIST_BUCKETS];
+}	slurmctld_lock_stats_t;
+
 
 /* get_lock_values - Get the current value of all locks
  * OUT lock_flags - a copy of the current lock values */
 extern void get_lock_values (slurmctld_lock_flags_t *lock_flags);
 
+/* get_lock_stats - Get a copy of the lock wait statistics
+ * OUT lock_stats - a copy of the current lock wait statistics */
+extern void get_lock_stats (slurmctld_lock_stats_t *lock_stats);
+
+/* reset_lock_stats - Clear all lock wait statistics */
+extern void reset_lock_stats (void);
+
 /* init_locks - create locks used for slurmctld data structure access
  *	control */
 extern void init_locks ( void );
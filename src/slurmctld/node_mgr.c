@@ -71,6 +71,7 @@
 #include "src/slurmctld/agent.h"
 #include "src/slurmctld/front_end.h"
 #include "src/slurmctld/locks.h"
+#include "src/slurmctld/node_scheduler.h"
 #include "src/slurmctld/ping_nodes.h"
 #include "src/slurmctld/proc_req.h"
 #include "src/slurmctld/reservation.h"
@@ -88,6 +89,13 @@
 /* No need to change we always pack SLURM_PROTOCOL_VERSION */
 #define NODE_STATE_VERSION        "PROTOCOL_VERSION"
 
+/* Node record generations, see pack_all_node_delta() */
+static uint32_t node_delta_full_gen = 0; /* older generations get all nodes */
+static uint32_t node_delta_gen = 0;
+static time_t   node_delta_part_update = (time_t) 0;
+static struct node_record *node_delta_table_ptr = NULL;
+static int      node_delta_table_cnt = 0;
+
 /* Global variables */
 bitstr_t *avail_node_bitmap = NULL;	/* bitmap of available nodes */
 bitstr_t *cg_node_bitmap    = NULL;	/* bitmap of completing nodes */
@@ -107,6 +115,10 @@ static bool	_node_is_hidden(struct node_record *node_ptr);
 static int	_open_node_state_file(char **state_file);
 static void 	_pack_node(struct node_record *dump_node_ptr, Buf buffer,
 			   uint16_t protocol_version, uint16_t show_flags);
+static void	_pack_node_filtered(struct node_record *node_ptr, Buf buffer,
+				    uint16_t protocol_version,
+				    uint16_t show_flags, uid_t uid);
+static void	_node_delta_touch_bitmap(bitstr_t *node_bitmap);
 static void	_sync_bitmaps(struct node_record *node_ptr, int job_count);
 static void	_update_config_ptr(bitstr_t *bitmap,
 				struct config_record *config_ptr);
@@ -730,7 +742,6 @@ extern void pack_all_node (char **buffer_ptr, int *buffer_size,
 	Buf buffer;
 	time_t now = time(NULL);
 	struct node_record *node_ptr = node_record_table_ptr;
-	bool hidden;
 
 	buffer_ptr[0] = NULL;
 	*buffer_size = 0;
@@ -753,33 +764,8 @@ extern void pack_all_node (char **buffer_ptr, int *buffer_size,
 			xassert (node_ptr->magic == NODE_MAGIC);
 			xassert (node_ptr->config_ptr->magic ==
 				 CONFIG_MAGIC);
-
-			/* We can't avoid packing node records without breaking
-			 * the node index pointers. So pack a node
-			 * with a name of NULL and let the caller deal
-			 * with it. */
-			hidden = false;
-			if (((show_flags & SHOW_ALL) == 0) && (uid != 0) &&
-			    (_node_is_hidden(node_ptr)))
-				hidden = true;
-			else if (IS_NODE_FUTURE(node_ptr))
-				hidden = true;
-			else if (_is_cloud_hidden(node_ptr))
-				hidden = true;
-			else if ((node_ptr->name == NULL) ||
-				 (node_ptr->name[0] == '\0'))
-				hidden = true;
-
-			if (hidden) {
-				char *orig_name = node_ptr->name;
-				node_ptr->name = NULL;
-				_pack_node(node_ptr, buffer, protocol_version,
-				           show_flags);
-				node_ptr->name = orig_name;
-			} else {
-				_pack_node(node_ptr, buffer, protocol_version,
-					   show_flags);
-			}
+			_pack_node_filtered(node_ptr, buffer, protocol_version,
+					    show_flags, uid);
 			nodes_packed++;
 		}
 		part_filter_clear();
@@ -797,6 +783,159 @@ extern void pack_all_node (char **buffer_ptr, int *buffer_size,
 	buffer_ptr[0] = xfer_buf_data (buffer);
 }
 
+/* Pack a node record as seen by a specific user. We can't avoid packing node
+ * records without breaking the node index pointers. So pack a hidden node
+ * with a name of NULL and let the caller deal with it. */
+static void _pack_node_filtered(struct node_record *node_ptr, Buf buffer,
+				uint16_t protocol_version,
+				uint16_t show_flags, uid_t uid)
+{
+	bool hidden = false;
+
+	if (((show_flags & SHOW_ALL) == 0) && (uid != 0) &&
+	    (_node_is_hidden(node_ptr)))
+		hidden = true;
+	else if (IS_NODE_FUTURE(node_ptr))
+		hidden = true;
+	else if (_is_cloud_hidden(node_ptr))
+		hidden = true;
+	else if ((node_ptr->name == NULL) ||
+		 (node_ptr->name[0] == '\0'))
+		hidden = true;
+
+	if (hidden) {
+		char *orig_name = node_ptr->name;
+		node_ptr->name = NULL;
+		_pack_node(node_ptr, buffer, protocol_version, show_flags);
+		node_ptr->name = orig_name;
+	} else {
+		_pack_node(node_ptr, buffer, protocol_version, show_flags);
+	}
+}
+
+/* Close the generation of node record changes made since the last call and
+ * note changes which require clients to reload all nodes. Node records are
+ * stamped with node_delta_next_gen by NODE_DELTA_TOUCH() as they change. */
+static void _node_delta_close(void)
+{
+	if ((node_delta_part_update != last_part_update) ||
+	    (node_delta_table_ptr != node_record_table_ptr) ||
+	    (node_delta_table_cnt != node_record_count)) {
+		/* Partition changes alter which nodes are visible and
+		 * reconfiguration rebuilds the node table */
+		node_delta_part_update = last_part_update;
+		node_delta_table_ptr = node_record_table_ptr;
+		node_delta_table_cnt = node_record_count;
+		node_delta_full_gen = node_delta_next_gen;
+		node_delta_changed = true;
+	}
+	if (node_delta_changed || (node_delta_gen == 0)) {
+		node_delta_gen = node_delta_next_gen++;
+		node_delta_changed = false;
+	}
+}
+
+/* Record a change to every node in a bitmap, see NODE_DELTA_TOUCH() */
+static void _node_delta_touch_bitmap(bitstr_t *node_bitmap)
+{
+	int i, i_first, i_last;
+
+	i_first = bit_ffs(node_bitmap);
+	if (i_first < 0)
+		return;
+	i_last = bit_fls(node_bitmap);
+	for (i = i_first; i <= i_last; i++) {
+		if (bit_test(node_bitmap, i))
+			NODE_DELTA_TOUCH(node_record_table_ptr + i);
+	}
+}
+
+/*
+ * pack_all_node_delta - dump information for nodes changed since a client's
+ *	generation in machine independent form (for network transmission)
+ * OUT buffer_ptr - pointer to the stored data, NULL if no node changed since
+ *	the client's generation
+ * OUT buffer_size - set to size of the buffer in bytes
+ * IN generation - generation of the client's node information, 0 if none
+ * IN show_flags - node filtering options
+ * IN uid - uid of user making request (for partition filtering)
+ * IN protocol_version - slurm protocol version of client
+ * global: node_record_table_ptr - pointer to global node table
+ * NOTE: the caller must xfree the buffer at *buffer_ptr
+ * NOTE: change _unpack_node_info_delta_msg() in common/slurm_protocol_pack.c
+ *	whenever the data format changes
+ * NOTE: READ lock_slurmctld config, WRITE lock node and partition before
+ *	entry
+ */
+extern void pack_all_node_delta(char **buffer_ptr, int *buffer_size,
+				uint64_t generation, uint16_t show_flags,
+				uid_t uid, uint16_t protocol_version)
+{
+	int inx;
+	uint32_t nodes_packed = 0, tmp_offset, node_scaling, client_gen;
+	uint32_t *node_inx = NULL;
+	uint32_t boot_time = (uint32_t) slurmctld_config.boot_time;
+	uint16_t full;
+	Buf buffer;
+	struct node_record *node_ptr;
+
+	buffer_ptr[0] = NULL;
+	*buffer_size = 0;
+
+	_node_delta_close();
+	client_gen = (uint32_t) generation;
+	if (((uint32_t) (generation >> 32) != boot_time) ||
+	    (client_gen < node_delta_full_gen) ||
+	    (client_gen > node_delta_gen))
+		full = 1;
+	else if (client_gen == node_delta_gen)
+		return;		/* no change */
+	else
+		full = 0;
+
+	buffer = init_buf(BUF_SIZE * 16);
+
+	/* write header: count and time */
+	pack32(nodes_packed, buffer);
+	select_g_alter_node_cnt(SELECT_GET_NODE_SCALING, &node_scaling);
+	pack32(node_scaling, buffer);
+	pack_time(time(NULL), buffer);
+
+	/* write node records */
+	if (!full)
+		node_inx = xmalloc(sizeof(uint32_t) * node_record_count);
+	part_filter_set(uid);
+	for (inx = 0, node_ptr = node_record_table_ptr;
+	     inx < node_record_count; inx++, node_ptr++) {
+		xassert (node_ptr->magic == NODE_MAGIC);
+		xassert (node_ptr->config_ptr->magic == CONFIG_MAGIC);
+		if (!full) {
+			if (node_ptr->delta_gen <= client_gen)
+				continue;
+			node_inx[nodes_packed] = inx;
+		}
+		_pack_node_filtered(node_ptr, buffer, protocol_version,
+				    show_flags, uid);
+		nodes_packed++;
+	}
+	part_filter_clear();
+
+	tmp_offset = get_buf_offset(buffer);
+	set_buf_offset(buffer, 0);
+	pack32(nodes_packed, buffer);
+	set_buf_offset(buffer, tmp_offset);
+
+	/* write trailer: generation, full flag and changed node indexes */
+	pack64((((uint64_t) boot_time) << 32) | node_delta_gen, buffer);
+	pack16(full, buffer);
+	pack32((uint32_t) node_record_count, buffer);
+	pack32_array(node_inx, (full ? 0 : nodes_packed), buffer);
+	xfree(node_inx);
+
+	*buffer_size = get_buf_offset(buffer);
+	buffer_ptr[0] = xfer_buf_data(buffer);
+}
+
 /*
  * pack_one_node - dump all configuration and node information for one node
  *	in machine independent form (for network transmission)
@@ -1134,6 +1273,7 @@ void set_slurmd_addr (void)
 		node_ptr->reason = xstrdup("NO NETWORK ADDRESS FOUND");
 		node_ptr->reason_time = time(NULL);
 		node_ptr->reason_uid = getuid();
+		NODE_DELTA_TOUCH(node_ptr);
 	}
 
 	END_TIMER2("set_slurmd_addr");
@@ -1233,6 +1373,7 @@ int update_node ( update_node_msg_t * update_node_msg )
 			free (this_node_name);
 			break;
 		}
+		NODE_DELTA_TOUCH(node_ptr);
 
 		if (hostaddr_list) {
 			char *this_addr = hostlist_shift(hostaddr_list);
@@ -1577,6 +1718,7 @@ extern void restore_node_features(int recover)
 						 &node_ptr->gres_list,
 						 slurmctld_conf.fast_schedule);
 		gres_plugin_node_state_log(node_ptr->gres_list, node_ptr->name);
+		NODE_DELTA_TOUCH(node_ptr);
 	}
 }
 
@@ -1666,8 +1808,11 @@ static int _update_node_weight(char *node_names, uint32_t weight)
 		FREE_NULL_BITMAP(tmp_bitmap);
 	}
 	list_iterator_destroy(config_iterator);
+	_node_delta_touch_bitmap(node_bitmap);
 	FREE_NULL_BITMAP(node_bitmap);
 
+	node_set_cache_clear();
+
 	info("_update_node_weight: nodes %s weight set to: %u",
 		node_names, weight);
 	return SLURM_SUCCESS;
@@ -1739,8 +1884,11 @@ static int _update_node_features(char *node_names, char *features)
 		FREE_NULL_BITMAP(tmp_bitmap);
 	}
 	list_iterator_destroy(config_iterator);
+	_node_delta_touch_bitmap(node_bitmap);
 	FREE_NULL_BITMAP(node_bitmap);
 
+	node_set_cache_clear();
+
 	info("_update_node_features: nodes %s features set to: %s",
 		node_names, features);
 	return SLURM_SUCCESS;
@@ -1824,7 +1972,9 @@ static int _update_node_gres(char *node_names, char *gres)
 						 slurmctld_conf.fast_schedule);
 		gres_plugin_node_state_log(node_ptr->gres_list, node_ptr->name);
 	}
+	_node_delta_touch_bitmap(node_bitmap);
 	FREE_NULL_BITMAP(node_bitmap);
+	node_set_cache_clear();
 
 	info("_update_node_gres: nodes %s gres set to: %s", node_names, gres);
 	return SLURM_SUCCESS;
@@ -1893,6 +2043,7 @@ extern int drain_nodes ( char *nodes, char *reason, uint32_t reason_uid )
 		}
 
 		node_ptr->node_state |= NODE_STATE_DRAIN;
+		NODE_DELTA_TOUCH(node_ptr);
 		bit_clear (avail_node_bitmap, node_inx);
 		info ("drain_nodes: node %s state set to DRAIN",
 			this_node_name);
@@ -2019,6 +2170,7 @@ extern int update_node_record_acct_gather_data(
 		return ENOENT;
 
 	memcpy(node_ptr->energy, msg->energy, sizeof(acct_gather_energy_t));
+	NODE_DELTA_TOUCH(node_ptr);
 
 	return SLURM_SUCCESS;
 }
@@ -2059,6 +2211,7 @@ extern int validate_node_specs(slurm_node_registration_status_msg_t *reg_msg,
 	xfree(node_ptr->version);
 	node_ptr->version = reg_msg->version;
 	reg_msg->version = NULL;
+	NODE_DELTA_TOUCH(node_ptr);
 
 	if (cr_flag == NO_VAL) {
 		cr_flag = 0;  /* call is no-op for select/linear and bluegene */
@@ -2588,6 +2741,7 @@ extern int validate_nodes_via_front_end(
 	     i++, node_ptr++) {
 		config_ptr = node_ptr->config_ptr;
 		node_ptr->last_response = now;
+		NODE_DELTA_TOUCH(node_ptr);
 
 		rc = gres_plugin_node_config_validate(node_ptr->name,
 						      config_ptr->gres,
@@ -2731,6 +2885,65 @@ extern int validate_nodes_via_front_end(
 	return error_code;
 }
 
+/*
+ * validate_node_reg_list - validate the registrations of a group of nodes,
+ *	as returned through the forward tree in reply to
+ *	REQUEST_NODE_REGISTRATION_STATUS, with one hold of the slurmctld locks
+ * IN reg_list - list of slurm_node_registration_status_msg_t
+ * IN protocol_version - Version of Slurm on these nodes
+ * NOTE: Sets own locks
+ */
+extern void validate_node_reg_list(List reg_list, uint16_t protocol_version)
+{
+	slurm_node_registration_status_msg_t *reg_msg;
+	ListIterator iter;
+	bool newly_up = false, node_up;
+	uint32_t hash_val = slurm_get_hash_val();
+	int error_code, reg_cnt = 0;
+	/* Locks: Read config, write job, write node */
+	slurmctld_lock_t job_write_lock = {
+		READ_LOCK, WRITE_LOCK, WRITE_LOCK, NO_LOCK };
+	DEF_TIMERS;
+
+	START_TIMER;
+	lock_slurmctld(job_write_lock);
+	iter = list_iterator_create(reg_list);
+	while ((reg_msg = (slurm_node_registration_status_msg_t *)
+			  list_next(iter))) {
+		if (!(slurmctld_conf.debug_flags & DEBUG_FLAG_NO_CONF_HASH) &&
+		    (reg_msg->hash_val != NO_VAL) &&
+		    (reg_msg->hash_val != hash_val)) {
+			error("Node %s appears to have a different slurm.conf "
+			      "than the slurmctld", reg_msg->node_name);
+		}
+		node_up = false;
+#ifdef HAVE_FRONT_END		/* Operates only on front-end */
+		error_code = validate_nodes_via_front_end(reg_msg,
+							  protocol_version,
+							  &node_up);
+#else
+		validate_jobs_on_node(reg_msg);
+		error_code = validate_node_specs(reg_msg, protocol_version,
+						 &node_up);
+#endif
+		if (error_code) {
+			error("%s: node=%s: %s", __func__, reg_msg->node_name,
+			      slurm_strerror(error_code));
+		}
+		if (node_up)
+			newly_up = true;
+		reg_cnt++;
+	}
+	list_iterator_destroy(iter);
+	unlock_slurmctld(job_write_lock);
+	END_TIMER2("validate_node_reg_list");
+	debug2("%s: validated %d node registrations %s",
+	       __func__, reg_cnt, TIME_STR);
+
+	if (newly_up)
+		queue_job_scheduler();
+}
+
 /* Sync idle, share, and avail_node_bitmaps for a given node */
 static void _sync_bitmaps(struct node_record *node_ptr, int job_count)
 {
@@ -2807,6 +3020,7 @@ static void _node_did_resp(struct node_record *node_ptr)
 		node_ptr->node_state &= (~NODE_STATE_POWER_UP);
 		if (!is_node_in_maint_reservation(node_inx))
 			node_ptr->node_state &= (~NODE_STATE_MAINT);
+		NODE_DELTA_TOUCH(node_ptr);
 		last_node_update = now;
 	}
 	node_flags = node_ptr->node_state & NODE_STATE_FLAGS;
@@ -2817,6 +3031,7 @@ static void _node_did_resp(struct node_record *node_ptr)
 					       node_flags;
 		} else
 			node_ptr->node_state = NODE_STATE_IDLE | node_flags;
+		NODE_DELTA_TOUCH(node_ptr);
 		last_node_update = now;
 		if (!IS_NODE_DRAIN(node_ptr) && !IS_NODE_FAIL(node_ptr)) {
 			clusteracct_storage_g_node_up(acct_db_conn,
@@ -2833,6 +3048,7 @@ static void _node_did_resp(struct node_record *node_ptr)
 		info("node_did_resp: node %s returned to service",
 		     node_ptr->name);
 		trigger_node_up(node_ptr);
+		NODE_DELTA_TOUCH(node_ptr);
 		last_node_update = now;
 		if (!IS_NODE_DRAIN(node_ptr) && !IS_NODE_FAIL(node_ptr)) {
 			/* reason information is handled in
@@ -2931,6 +3147,7 @@ void node_not_resp (char *name, time_t msg_time, slurm_msg_type_t resp_type)
 #ifdef HAVE_FRONT_END
 	last_front_end_update = time(NULL);
 #else
+	NODE_DELTA_TOUCH(node_ptr);
 	last_node_update = time(NULL);
 	bit_clear (avail_node_bitmap, (node_ptr - node_record_table_ptr));
 #endif
@@ -3168,6 +3385,7 @@ extern void make_node_alloc(struct node_record *node_ptr,
 	node_ptr->reason_time = 0;
 	node_ptr->reason_uid = NO_VAL;
 
+	NODE_DELTA_TOUCH(node_ptr);
 	last_node_update = time (NULL);
 }
 
@@ -3237,6 +3455,7 @@ extern void make_node_comp(struct node_record *node_ptr,
 		node_ptr->node_state = NODE_STATE_IDLE | node_flags;
 		node_ptr->last_idle = now;
 	}
+	NODE_DELTA_TOUCH(node_ptr);
 	last_node_update = now;
 }
 
@@ -3258,6 +3477,7 @@ static void _make_node_down(struct node_record *node_ptr, time_t event_time)
 	bit_clear (up_node_bitmap,    inx);
 	select_g_update_node_state(node_ptr);
 	trigger_node_down(node_ptr);
+	NODE_DELTA_TOUCH(node_ptr);
 	last_node_update = time (NULL);
 	clusteracct_storage_g_node_down(acct_db_conn,
 					node_ptr, event_time, NULL,
@@ -3288,9 +3508,11 @@ void make_node_idle(struct node_record *node_ptr,
 	trace_job(job_ptr, __func__, "enter");
 
 	xassert(node_ptr);
+	NODE_DELTA_TOUCH(node_ptr);
 	if (node_bitmap && (bit_test(node_bitmap, inx))) {
 		/* Not a replay */
 		last_job_update = now;
+		JOB_DELTA_TOUCH(job_ptr);
 		bit_clear(node_bitmap, inx);
 
 		job_update_cpu_cnt(job_ptr, inx);
@@ -3500,6 +3722,7 @@ extern void reset_node_load(char *node_name, uint32_t cpu_load)
 		time_t now = time(NULL);
 		node_ptr->cpu_load = cpu_load;
 		node_ptr->cpu_load_time = now;
+		NODE_DELTA_TOUCH(node_ptr);
 		last_node_update = now;
 	} else
 		error("is_node_resp unable to find node %s", node_name);
@@ -101,6 +101,31 @@ struct node_set {		/* set of nodes with same configuration */
 	bitstr_t *my_bitmap;		/* node bitmap */
 };
 
+/* Nodes of each configuration record within a partition, in config_list
+ * order. Records with no nodes in the partition have a NULL bitmap. */
+typedef struct part_node_sets {
+	struct part_record *part_ptr;
+	int config_cnt;
+	struct config_record **config_ptr;
+	bitstr_t **node_bitmap;
+	uint32_t *node_cnt;
+} part_node_sets_t;
+
+/* Nodes satisfying a feature specification without counts */
+typedef struct feature_node_set {
+	char *features;
+	bool has_xor;
+	bitstr_t *node_bitmap;
+} feature_node_set_t;
+
+#define NODE_SET_CACHE_SIZE 64	/* max cached partitions or features */
+
+static part_node_sets_t   part_node_sets[NODE_SET_CACHE_SIZE];
+static feature_node_set_t feature_node_sets[NODE_SET_CACHE_SIZE];
+static int    part_node_sets_cnt = 0, feature_node_sets_cnt = 0;
+static time_t node_set_cache_part = 0, node_set_cache_conf = 0;
+static time_t node_set_cache_time = 0;
+
 static int  _build_node_list(struct job_record *job_ptr,
 			     struct node_set **node_set_pptr,
 			     int *node_set_size, char **err_msg,
@@ -111,12 +136,15 @@ static void _filter_by_node_owner(struct job_record *job_ptr,
 static void _filter_nodes_in_set(struct node_set *node_set_ptr,
 				 struct job_details *detail_ptr,
 				 char **err_msg);
+static feature_node_set_t *_feature_node_set(struct job_details *detail_ptr);
 static bool _first_array_task(struct job_record *job_ptr);
 static void _launch_prolog(struct job_record *job_ptr);
 static int  _match_feature(char *seek, struct node_set *node_set_ptr);
+static void _node_set_cache_test(void);
 static int _nodes_in_sets(bitstr_t *req_bitmap,
 			  struct node_set * node_set_ptr,
 			  int node_set_size);
+static part_node_sets_t *_part_node_sets(struct part_record *part_ptr);
 static int _pick_best_nodes(struct node_set *node_set_ptr,
 			    int node_set_size, bitstr_t ** select_bitmap,
 			    struct job_record *job_ptr,
@@ -598,7 +626,7 @@ extern void deallocate_nodes(struct job_record *job_ptr, bool timeout,
 
 	if ((agent_args->node_count - down_node_cnt) == 0) {
 		delete_step_records(job_ptr);
-		job_ptr->job_state &= (~JOB_COMPLETING);
+		JOB_STATE_FLAG_CLEAR(job_ptr, JOB_COMPLETING);
 		slurm_sched_g_schedule();
 	}
 
@@ -1202,9 +1230,9 @@ _pick_best_nodes(struct node_set *node_set_ptr, int node_set_size,
 					return ESLURM_NODES_BUSY;
 				}
 #ifndef HAVE_BG
-				if (bit_overlap(job_ptr->details->
-						req_node_bitmap,
-						cg_node_bitmap)) {
+				if (bit_overlap_any(job_ptr->details->
+						    req_node_bitmap,
+						    cg_node_bitmap)) {
 					return ESLURM_NODES_BUSY;
 				}
 #endif
@@ -1217,8 +1245,8 @@ _pick_best_nodes(struct node_set *node_set_ptr, int node_set_size,
 				/* Note: IDLE nodes are not COMPLETING */
 			}
 #ifndef HAVE_BG
-		} else if (bit_overlap(job_ptr->details->req_node_bitmap,
-				       cg_node_bitmap)) {
+		} else if (bit_overlap_any(job_ptr->details->req_node_bitmap,
+					   cg_node_bitmap)) {
 			return ESLURM_NODES_BUSY;
 #endif
 		}
@@ -1673,6 +1701,7 @@ extern int select_nodes(struct job_record *job_ptr, bool test_only,
 		xfree(job_ptr->state_desc);
 		job_ptr->state_reason = WAIT_QOS;
 		last_job_update = now;
+		JOB_DELTA_TOUCH(job_ptr);
 		return ESLURM_REQUESTED_PART_CONFIG_UNAVAILABLE;
 	}
 
@@ -1685,6 +1714,7 @@ extern int select_nodes(struct job_record *job_ptr, bool test_only,
 		xfree(job_ptr->state_desc);
 		job_ptr->state_reason = WAIT_ACCOUNT;
 		last_job_update = now;
+		JOB_DELTA_TOUCH(job_ptr);
 		return ESLURM_REQUESTED_PART_CONFIG_UNAVAILABLE;
 	}
 
@@ -1846,6 +1876,7 @@ extern int select_nodes(struct job_record *job_ptr, bool test_only,
 			job_ptr->state_reason = WAIT_PART_NODE_LIMIT;
 			xfree(job_ptr->state_desc);
 			last_job_update = now;
+			JOB_DELTA_TOUCH(job_ptr);
 
 		/* Non-fatal errors for job below */
 		} else if (error_code == ESLURM_NODE_NOT_AVAIL) {
@@ -1863,6 +1894,7 @@ extern int select_nodes(struct job_record *job_ptr, bool test_only,
 				   tmp_nodelist);
 			xfree(tmp_nodelist);
 			last_job_update = now;
+			JOB_DELTA_TOUCH(job_ptr);
 		} else if ((error_code == ESLURM_RESERVATION_NOT_USABLE) ||
 			   (error_code == ESLURM_RESERVATION_BUSY)) {
 			job_ptr->state_reason = WAIT_RESERVATION;
@@ -1956,13 +1988,13 @@ extern int select_nodes(struct job_record *job_ptr, bool test_only,
 	/* This could be set in the select plugin so we want to keep the flag */
 	configuring = IS_JOB_CONFIGURING(job_ptr);
 
-	job_ptr->job_state = JOB_RUNNING;
+	JOB_STATE_SET(job_ptr, JOB_RUNNING);
 	if (nonstop_ops.job_begin)
 		(nonstop_ops.job_begin)(job_ptr);
 
 	if (configuring
 	    || bit_overlap(job_ptr->node_bitmap, power_node_bitmap))
-		job_ptr->job_state |= JOB_CONFIGURING;
+		JOB_STATE_FLAG_SET(job_ptr, JOB_CONFIGURING);
 	if (select_g_select_nodeinfo_set(job_ptr) != SLURM_SUCCESS) {
 		error("select_g_select_nodeinfo_set(%u): %m", job_ptr->job_id);
 		/* not critical ... by now */
@@ -2083,9 +2115,10 @@ static void _launch_prolog(struct job_record *job_ptr)
 #else
 	cred_arg.job_hostlist   = job_ptr->job_resrcs->nodes;
 #endif
-	prolog_msg_ptr->cred = slurm_cred_create(slurmctld_config.cred_ctx,
-						 &cred_arg,
-						 SLURM_15_08_PROTOCOL_VERSION);
+	/* Signed by the agent, outside of the job locks */
+	prolog_msg_ptr->cred = slurm_cred_create_unsigned(
+					slurmctld_config.cred_ctx, &cred_arg,
+					SLURM_15_08_PROTOCOL_VERSION);
 	agent_arg_ptr = (agent_arg_t *) xmalloc(sizeof(agent_arg_t));
 	agent_arg_ptr->retry = 0;
 #ifdef HAVE_FRONT_END
@@ -2415,6 +2448,136 @@ static int _no_reg_nodes(void)
 	return node_count;
 }
 
+/*
+ * node_set_cache_clear - discard the cached partition and feature node sets
+ *	used to build a job's node sets, call when configuration records or
+ *	their features change
+ */
+extern void node_set_cache_clear(void)
+{
+	int i, j;
+
+	for (i = 0; i < part_node_sets_cnt; i++) {
+		for (j = 0; j < part_node_sets[i].config_cnt; j++)
+			FREE_NULL_BITMAP(part_node_sets[i].node_bitmap[j]);
+		xfree(part_node_sets[i].config_ptr);
+		xfree(part_node_sets[i].node_bitmap);
+		xfree(part_node_sets[i].node_cnt);
+	}
+	part_node_sets_cnt = 0;
+
+	for (i = 0; i < feature_node_sets_cnt; i++) {
+		xfree(feature_node_sets[i].features);
+		FREE_NULL_BITMAP(feature_node_sets[i].node_bitmap);
+	}
+	feature_node_sets_cnt = 0;
+}
+
+/* Clear the node set caches if partitions or the configuration changed.
+ * Changes made in the same second as the caches were filled can not be
+ * detected from their time stamps, so the caches are not trusted until
+ * the next second. */
+static void _node_set_cache_test(void)
+{
+	if ((node_set_cache_part == last_part_update) &&
+	    (node_set_cache_conf == slurmctld_conf.last_update) &&
+	    (node_set_cache_time > last_part_update) &&
+	    (node_set_cache_time > slurmctld_conf.last_update))
+		return;
+
+	node_set_cache_clear();
+	node_set_cache_part = last_part_update;
+	node_set_cache_conf = slurmctld_conf.last_update;
+	node_set_cache_time = time(NULL);
+}
+
+/* Return the nodes of each configuration record within a partition,
+ * NULL if they can not be cached */
+static part_node_sets_t *_part_node_sets(struct part_record *part_ptr)
+{
+	part_node_sets_t *sets;
+	struct config_record *config_ptr;
+	ListIterator config_iterator;
+	int i;
+
+	for (i = 0; i < part_node_sets_cnt; i++) {
+		if (part_node_sets[i].part_ptr == part_ptr)
+			return &part_node_sets[i];
+	}
+	if ((part_node_sets_cnt >= NODE_SET_CACHE_SIZE) ||
+	    (part_ptr->node_bitmap == NULL))
+		return NULL;
+
+	sets = &part_node_sets[part_node_sets_cnt++];
+	sets->part_ptr = part_ptr;
+	sets->config_cnt = list_count(config_list);
+	sets->config_ptr = xmalloc(sizeof(struct config_record *) *
+				   sets->config_cnt);
+	sets->node_bitmap = xmalloc(sizeof(bitstr_t *) * sets->config_cnt);
+	sets->node_cnt = xmalloc(sizeof(uint32_t) * sets->config_cnt);
+	i = 0;
+	config_iterator = list_iterator_create(config_list);
+	while ((config_ptr = (struct config_record *)
+			list_next(config_iterator))) {
+		sets->config_ptr[i] = config_ptr;
+		if (bit_overlap_any(config_ptr->node_bitmap,
+				    part_ptr->node_bitmap)) {
+			sets->node_bitmap[i] = bit_copy(config_ptr->node_bitmap);
+			bit_and(sets->node_bitmap[i], part_ptr->node_bitmap);
+			sets->node_cnt[i] = bit_set_count(sets->node_bitmap[i]);
+		}
+		i++;
+	}
+	list_iterator_destroy(config_iterator);
+
+	return sets;
+}
+
+/* Return the nodes satisfying a job's feature specification, NULL if the
+ * specification uses counts or can not be cached */
+static feature_node_set_t *_feature_node_set(struct job_details *detail_ptr)
+{
+	feature_node_set_t *feat_set;
+	ListIterator job_feat_iter;
+	struct feature_record *job_feat_ptr;
+	int i;
+
+	if ((detail_ptr->features == NULL) ||
+	    (detail_ptr->feature_list == NULL))
+		return NULL;
+	for (i = 0; i < feature_node_sets_cnt; i++) {
+		if (!strcmp(feature_node_sets[i].features,
+			    detail_ptr->features))
+			return &feature_node_sets[i];
+	}
+	if (feature_node_sets_cnt >= NODE_SET_CACHE_SIZE)
+		return NULL;
+
+	job_feat_iter = list_iterator_create(detail_ptr->feature_list);
+	while ((job_feat_ptr = (struct feature_record *)
+			list_next(job_feat_iter))) {
+		if (job_feat_ptr->count)
+			break;
+	}
+	list_iterator_destroy(job_feat_iter);
+	if (job_feat_ptr)
+		return NULL;
+
+	/* The specification is evaluated once against all nodes and the
+	 * result is intersected with each job's usable nodes afterwards.
+	 * _valid_feature_counts() ANDs its result into the usable nodes, so
+	 * this yields the same nodes as evaluating from the usable nodes,
+	 * OR operators included. */
+	feat_set = &feature_node_sets[feature_node_sets_cnt++];
+	feat_set->features = xstrdup(detail_ptr->features);
+	feat_set->node_bitmap = bit_alloc(node_record_count);
+	bit_nset(feat_set->node_bitmap, 0, (node_record_count - 1));
+	(void) _valid_feature_counts(detail_ptr, feat_set->node_bitmap,
+				     &feat_set->has_xor);
+
+	return feat_set;
+}
+
 /*
  * _build_node_list - identify which nodes could be allocated to a job
  *	based upon node features, memory, processors, etc. Note that a
@@ -2439,11 +2602,14 @@ static int _build_node_list(struct job_record *job_ptr,
 	int check_node_config;
 	struct job_details *detail_ptr = job_ptr->details;
 	bitstr_t *power_up_bitmap = NULL, *usable_node_mask = NULL;
+	bitstr_t *feature_mask = NULL;
 	multi_core_data_t *mc_ptr = detail_ptr->mc_ptr;
 	bitstr_t *tmp_feature;
 	uint32_t max_weight = 0;
 	bool has_xor = false;
 	bool resv_overlap = false;
+	part_node_sets_t *part_sets;
+	feature_node_set_t *feat_set;
 
 	if (job_ptr->resv_name) {
 		/* Limit node selection to those in selected reservation */
@@ -2493,20 +2659,27 @@ static int _build_node_list(struct job_record *job_ptr,
 	node_set_ptr[node_set_inx+1].my_bitmap = NULL;
 	if (detail_ptr->exc_node_bitmap) {
 		if (usable_node_mask) {
-			bit_not(detail_ptr->exc_node_bitmap);
-			bit_and(usable_node_mask, detail_ptr->exc_node_bitmap);
-			bit_not(detail_ptr->exc_node_bitmap);
+			bit_and_not(usable_node_mask,
+				    detail_ptr->exc_node_bitmap);
 		} else {
 			usable_node_mask =
 				bit_copy(detail_ptr->exc_node_bitmap);
 			bit_not(usable_node_mask);
 		}
-	} else if (usable_node_mask == NULL) {
+	}
+
+	_node_set_cache_test();
+	if ((feat_set = _feature_node_set(detail_ptr))) {
+		/* Feature nodes are ANDed into each set, no copy needed */
+		has_xor = feat_set->has_xor;
+		feature_mask = feat_set->node_bitmap;
+	} else if (detail_ptr->feature_list && (usable_node_mask == NULL)) {
 		usable_node_mask = bit_alloc(node_record_count);
 		bit_nset(usable_node_mask, 0, (node_record_count - 1));
 	}
 
-	if (!_valid_feature_counts(detail_ptr, usable_node_mask, &has_xor)) {
+	if (!feat_set && detail_ptr->feature_list &&
+	    !_valid_feature_counts(detail_ptr, usable_node_mask, &has_xor)) {
 		info("No job %u feature requirements can not be met",
 		     job_ptr->job_id);
 		FREE_NULL_BITMAP(usable_node_mask);
@@ -2518,10 +2691,11 @@ static int _build_node_list(struct job_record *job_ptr,
 		return ESLURM_REQUESTED_NODE_CONFIG_UNAVAILABLE;
 	}
 
+	part_sets = _part_node_sets(part_ptr);
 	config_iterator = list_iterator_create(config_list);
 
-	while ((config_ptr = (struct config_record *)
-			list_next(config_iterator))) {
+	for (i = 0; (config_ptr = (struct config_record *)
+			list_next(config_iterator)); i++) {
 		bool cpus_ok = false, mem_ok = false, disk_ok = false;
 		bool job_mc_ok = false, config_filter = false;
 		adj_cpus = adjust_cpus_nppcu(_get_ntasks_per_core(detail_ptr),
@@ -2561,16 +2735,39 @@ static int _build_node_list(struct job_record *job_ptr,
 		} else
 			check_node_config = 0;
 
-		node_set_ptr[node_set_inx].my_bitmap =
-			bit_copy(config_ptr->node_bitmap);
-		bit_and(node_set_ptr[node_set_inx].my_bitmap,
-			part_ptr->node_bitmap);
+		if (part_sets && ((i >= part_sets->config_cnt) ||
+				  (part_sets->config_ptr[i] != config_ptr))) {
+			error("%s: stale node sets for partition %s",
+			      __func__, part_ptr->name);
+			node_set_cache_time = 0;	/* clear on next use */
+			part_sets = NULL;
+		}
+		if (part_sets) {
+			if (part_sets->node_bitmap[i] == NULL)
+				continue;	/* no nodes in partition */
+			node_set_ptr[node_set_inx].my_bitmap =
+				bit_copy(part_sets->node_bitmap[i]);
+		} else {
+			node_set_ptr[node_set_inx].my_bitmap =
+				bit_copy(config_ptr->node_bitmap);
+			bit_and(node_set_ptr[node_set_inx].my_bitmap,
+				part_ptr->node_bitmap);
+		}
 		if (usable_node_mask) {
 			bit_and(node_set_ptr[node_set_inx].my_bitmap,
 				usable_node_mask);
 		}
-		node_set_ptr[node_set_inx].nodes =
-			bit_set_count(node_set_ptr[node_set_inx].my_bitmap);
+		if (feature_mask) {
+			bit_and(node_set_ptr[node_set_inx].my_bitmap,
+				feature_mask);
+		}
+		if (part_sets && !usable_node_mask && !feature_mask) {
+			node_set_ptr[node_set_inx].nodes =
+				part_sets->node_cnt[i];
+		} else {
+			node_set_ptr[node_set_inx].nodes =
+				bit_set_count(node_set_ptr[node_set_inx].my_bitmap);
+		}
 		if (check_node_config &&
 		    (node_set_ptr[node_set_inx].nodes != 0)) {
 			_filter_nodes_in_set(&node_set_ptr[node_set_inx],
@@ -3004,7 +3201,8 @@ extern void re_kill_job(struct job_record *job_ptr)
 				    ((--job_ptr->node_cnt) == 0)) {
 					last_node_update = time(NULL);
 					delete_step_records(job_ptr);
-					job_ptr->job_state &= (~JOB_COMPLETING);
+					JOB_STATE_FLAG_CLEAR(job_ptr,
+							     JOB_COMPLETING);
 					slurm_sched_g_schedule();
 					batch_requeue_fini(job_ptr);
 					last_node_update = time(NULL);
@@ -3033,7 +3231,7 @@ extern void re_kill_job(struct job_record *job_ptr)
 			if ((job_ptr->node_cnt > 0) &&
 			    ((--job_ptr->node_cnt) == 0)) {
 				delete_step_records(job_ptr);
-				job_ptr->job_state &= (~JOB_COMPLETING);
+				JOB_STATE_FLAG_CLEAR(job_ptr, JOB_COMPLETING);
 				slurm_sched_g_schedule();
 				batch_requeue_fini(job_ptr);
 				last_node_update = time(NULL);
@@ -68,6 +68,13 @@ extern void build_node_details(struct job_record *job_ptr, bool new_alloc);
 extern void deallocate_nodes(struct job_record *job_ptr, bool timeout,
 		bool suspended, bool preempted);
 
+/*
+ * node_set_cache_clear - discard the cached partition and feature node sets
+ *	used to build a job's node sets, call when configuration records or
+ *	their features change
+ */
+extern void node_set_cache_clear(void);
+
 /*
  * re_kill_job - for a given job, deallocate its nodes for a second time,
  *	basically a cleanup for failed deallocate() calls
@@ -1036,6 +1036,27 @@ extern void part_filter_clear(void)
 	list_iterator_destroy(part_iterator);
 }
 
+/* part_filter_uid - Return true if any partition restricts access by group,
+ * in which case the partitions visible to a non-super-user (and the job and
+ * node records packed for them) depend upon that user's identity */
+extern bool part_filter_uid(void)
+{
+	struct part_record *part_ptr;
+	ListIterator part_iterator;
+	bool filtered = false;
+
+	part_iterator = list_iterator_create(part_list);
+	while ((part_ptr = (struct part_record *) list_next(part_iterator))) {
+		if (part_ptr->allow_groups) {
+			filtered = true;
+			break;
+		}
+	}
+	list_iterator_destroy(part_iterator);
+
+	return filtered;
+}
+
 /*
  * pack_all_part - dump all partition information for all partitions in
  *	machine independent form (for network transmission)
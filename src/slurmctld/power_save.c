@@ -170,6 +170,7 @@ static void _do_power_work(time_t now)
 			node_ptr->node_state &= (~NODE_STATE_POWER_SAVE);
 			node_ptr->node_state |=   NODE_STATE_POWER_UP;
 			node_ptr->node_state |=   NODE_STATE_NO_RESPOND;
+			NODE_DELTA_TOUCH(node_ptr);
 			bit_clear(power_node_bitmap, i);
 			bit_clear(avail_node_bitmap, i);
 			node_ptr->last_response = now + resume_timeout;
@@ -197,6 +198,7 @@ static void _do_power_work(time_t now)
 			suspend_cnt_f++;
 			node_ptr->node_state |= NODE_STATE_POWER_SAVE;
 			node_ptr->node_state &= (~NODE_STATE_NO_RESPOND);
+			NODE_DELTA_TOUCH(node_ptr);
 			bit_set(avail_node_bitmap,   i);
 			bit_set(power_node_bitmap,   i);
 			bit_set(sleep_node_bitmap,   i);
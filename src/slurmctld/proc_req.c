@@ -107,6 +107,50 @@ static uint64_t *rpc_user_time = NULL;
 static pthread_mutex_t throttle_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t throttle_cond = PTHREAD_COND_INITIALIZER;
 
+/* Packed responses to REQUEST_JOB_INFO, REQUEST_NODE_INFO,
+ * REQUEST_PARTITION_INFO and REQUEST_JOB_STEP_INFO are cached so that many
+ * clients polling the same information (e.g. monitoring scripts running squeue
+ * or sinfo) can be sent one shared buffer rather than re-packing every record
+ * for each of them. A cached response is valid only while the records it was
+ * packed from are unchanged and for at most dump_cache_max_age seconds, which
+ * bounds the age of data not tracked by last_*_update (e.g. node energy use).
+ *
+ * Cached responses are never modified once published and are reference
+ * counted, so the RPCs look for one before taking any slurmctld locks. Only
+ * the first request after a change packs the records, all other readers are
+ * served without contending with the scheduler for the job and node locks. */
+#define DUMP_CACHE_JOB		0
+#define DUMP_CACHE_NODE		1
+#define DUMP_CACHE_PART		2
+#define DUMP_CACHE_STEP		3
+#define DUMP_CACHE_TYPES	4
+#ifndef DUMP_CACHE_SIZE
+#define DUMP_CACHE_SIZE		8	/* cached responses per RPC type */
+#endif
+#ifndef DUMP_CACHE_MAX_AGE
+#define DUMP_CACHE_MAX_AGE	10	/* seconds */
+#endif
+
+/* Step information includes run times computed when packed, so it is only
+ * shared between requests arriving within the same second */
+static const int dump_cache_max_age[DUMP_CACHE_TYPES] = {
+	DUMP_CACHE_MAX_AGE, DUMP_CACHE_MAX_AGE, DUMP_CACHE_MAX_AGE, 1 };
+
+typedef struct dump_cache {
+	char *data;
+	int data_size;
+	time_t pack_time;
+	uint16_t protocol_version;
+	int ref_cnt;		/* cache slot plus RPCs sending this buffer */
+	uint16_t show_flags;
+	uint32_t uid;		/* NO_VAL if common to all non-root users */
+} dump_cache_t;
+
+static pthread_mutex_t dump_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static dump_cache_t *dump_cache[DUMP_CACHE_TYPES][DUMP_CACHE_SIZE];
+static bool dump_cache_part_filter = false;
+static time_t dump_cache_part_update = 0;
+
 static void         _fill_ctld_conf(slurm_ctl_conf_t * build_ptr);
 static void         _kill_job_on_msg_fail(uint32_t job_id);
 static int          _is_prolog_finished(uint32_t job_id);
@@ -135,10 +179,12 @@ inline static void  _slurm_rpc_complete_prolog(slurm_msg_t * msg);
 inline static void  _slurm_rpc_dump_conf(slurm_msg_t * msg);
 inline static void  _slurm_rpc_dump_front_end(slurm_msg_t * msg);
 inline static void  _slurm_rpc_dump_jobs(slurm_msg_t * msg);
+inline static void  _slurm_rpc_dump_jobs_delta(slurm_msg_t * msg);
 inline static void  _slurm_rpc_dump_jobs_user(slurm_msg_t * msg);
 inline static void  _slurm_rpc_dump_job_single(slurm_msg_t * msg);
 inline static void  _slurm_rpc_dump_licenses(slurm_msg_t * msg);
 inline static void  _slurm_rpc_dump_nodes(slurm_msg_t * msg);
+inline static void  _slurm_rpc_dump_nodes_delta(slurm_msg_t * msg);
 inline static void  _slurm_rpc_dump_node_single(slurm_msg_t * msg);
 inline static void  _slurm_rpc_dump_partitions(slurm_msg_t * msg);
 inline static void  _slurm_rpc_dump_sicp(slurm_msg_t * msg);
@@ -159,6 +205,7 @@ inline static void  _slurm_rpc_job_will_run(slurm_msg_t * msg);
 inline static void  _slurm_rpc_job_alloc_info(slurm_msg_t * msg);
 inline static void  _slurm_rpc_job_alloc_info_lite(slurm_msg_t * msg);
 inline static void  _slurm_rpc_kill_job2(slurm_msg_t *msg);
+inline static void  _slurm_rpc_kill_jobs(slurm_msg_t *msg);
 inline static void  _slurm_rpc_node_registration(slurm_msg_t * msg);
 inline static void  _slurm_rpc_ping(slurm_msg_t * msg);
 inline static void  _slurm_rpc_reboot_nodes(slurm_msg_t * msg);
@@ -179,6 +226,7 @@ inline static void  _slurm_rpc_step_complete(slurm_msg_t * msg);
 inline static void  _slurm_rpc_step_layout(slurm_msg_t * msg);
 inline static void  _slurm_rpc_step_update(slurm_msg_t * msg);
 inline static void  _slurm_rpc_submit_batch_job(slurm_msg_t * msg);
+inline static void  _slurm_rpc_submit_batch_job_multi(slurm_msg_t * msg);
 inline static void  _slurm_rpc_suspend(slurm_msg_t * msg);
 inline static void  _slurm_rpc_trigger_clear(slurm_msg_t * msg);
 inline static void  _slurm_rpc_trigger_get(slurm_msg_t * msg);
@@ -274,6 +322,10 @@ void slurmctld_req(slurm_msg_t *msg, connection_arg_t *arg)
 		_slurm_rpc_dump_jobs_user(msg);
 		slurm_free_job_user_id_msg(msg->data);
 		break;
+	case REQUEST_JOB_INFO_DELTA:
+		_slurm_rpc_dump_jobs_delta(msg);
+		slurm_free_delta_info_request_msg(msg->data);
+		break;
 	case REQUEST_JOB_INFO_SINGLE:
 		_slurm_rpc_dump_job_single(msg);
 		slurm_free_job_id_msg(msg->data);
@@ -302,6 +354,10 @@ void slurmctld_req(slurm_msg_t *msg, connection_arg_t *arg)
 		_slurm_rpc_dump_node_single(msg);
 		slurm_free_node_info_single_msg(msg->data);
 		break;
+	case REQUEST_NODE_INFO_DELTA:
+		_slurm_rpc_dump_nodes_delta(msg);
+		slurm_free_delta_info_request_msg(msg->data);
+		break;
 	case REQUEST_PARTITION_INFO:
 		_slurm_rpc_dump_partitions(msg);
 		slurm_free_part_info_request_msg(msg->data);
@@ -383,6 +439,10 @@ void slurmctld_req(slurm_msg_t *msg, connection_arg_t *arg)
 		_slurm_rpc_submit_batch_job(msg);
 		slurm_free_job_desc_msg(msg->data);
 		break;
+	case REQUEST_SUBMIT_BATCH_JOB_MULTI:
+		_slurm_rpc_submit_batch_job_multi(msg);
+		slurm_free_job_desc_multi_msg(msg->data);
+		break;
 	case REQUEST_UPDATE_FRONT_END:
 		_slurm_rpc_update_front_end(msg);
 		slurm_free_update_front_end_msg(msg->data);
@@ -541,6 +601,10 @@ void slurmctld_req(slurm_msg_t *msg, connection_arg_t *arg)
 		_slurm_rpc_kill_job2(msg);
 		slurm_free_job_step_kill_msg(msg->data);
 		break;
+	case REQUEST_KILL_JOBS:
+		_slurm_rpc_kill_jobs(msg);
+		slurm_free_kill_jobs_msg(msg->data);
+		break;
 	 case REQUEST_CACHE_INFO:
 		 _slurm_rpc_dump_cache(msg);
 		 slurm_free_cache_info_request_msg(msg->data);
@@ -953,8 +1017,9 @@ static int _make_step_cred(struct step_record *step_ptr,
 	cred_arg.sockets_per_node    = job_resrcs_ptr->sockets_per_node;
 	cred_arg.sock_core_rep_count = job_resrcs_ptr->sock_core_rep_count;
 
-	*slurm_cred = slurm_cred_create(slurmctld_config.cred_ctx, &cred_arg,
-					protocol_version);
+	/* Signed once the job locks are released */
+	*slurm_cred = slurm_cred_create_unsigned(slurmctld_config.cred_ctx,
+						 &cred_arg, protocol_version);
 	if (*slurm_cred == NULL) {
 		error("slurm_cred_create error");
 		return ESLURM_INVALID_JOB_CREDENTIAL;
@@ -1188,6 +1253,183 @@ static void _slurm_rpc_dump_conf(slurm_msg_t * msg)
 	}
 }
 
+/* Return the uid a cached dump response is keyed by. Records are only filtered
+ * by user for private data and for partitions restricted by AllowGroups, so
+ * most users can share the same response.
+ * private_data IN - PRIVATE_DATA_* flag hiding other users' records or 0
+ * locked IN - set if the caller holds the partition read lock
+ * OUT cache_uid - the key
+ * RET false if the key can not be determined without the partition lock */
+static bool _dump_cache_uid(uint16_t show_flags, uid_t uid,
+			    uint16_t private_data, bool locked,
+			    uint32_t *cache_uid)
+{
+	bool filter;
+
+	if (private_data && (slurmctld_conf.private_data & private_data)) {
+		*cache_uid = (uint32_t) uid;
+		return true;
+	}
+	if ((show_flags & SHOW_ALL) || (uid == 0)) {
+		*cache_uid = 0;
+		return true;
+	}
+
+	/* Remember whether partitions filter by user until they next change,
+	 * so lookups made without the partition lock can use it */
+	slurm_mutex_lock(&dump_cache_mutex);
+	if (dump_cache_part_update != last_part_update) {
+		if (!locked) {
+			slurm_mutex_unlock(&dump_cache_mutex);
+			return false;
+		}
+		dump_cache_part_filter = part_filter_uid();
+		dump_cache_part_update = last_part_update;
+	}
+	filter = dump_cache_part_filter;
+	slurm_mutex_unlock(&dump_cache_mutex);
+
+	if (filter)
+		*cache_uid = (uint32_t) uid;
+	else
+		*cache_uid = NO_VAL;
+	return true;
+}
+
+/* Drop a reference to a cached dump response, dump_cache_mutex must be set */
+static void _dump_cache_free(dump_cache_t *cache_ptr)
+{
+	if (--cache_ptr->ref_cnt > 0)
+		return;
+	xfree(cache_ptr->data);
+	xfree(cache_ptr);
+}
+
+/* Find a valid cached response to a dump request, purging stale entries.
+ * last_change IN - time the data to be packed was last changed
+ * RET cached response or NULL if none, release with _dump_cache_fini() */
+static dump_cache_t *_dump_cache_find(int type, uint16_t show_flags,
+				      uint32_t uid, uint16_t protocol_version,
+				      time_t last_change)
+{
+	dump_cache_t *cache_ptr = NULL, *ent_ptr;
+	time_t now = time(NULL);
+	int i;
+
+	slurm_mutex_lock(&dump_cache_mutex);
+	for (i = 0; i < DUMP_CACHE_SIZE; i++) {
+		if (!(ent_ptr = dump_cache[type][i]))
+			continue;
+		/* Changes made in the same second as the data was packed
+		 * may not be included in it */
+		if ((last_change >= ent_ptr->pack_time) ||
+		    (now < ent_ptr->pack_time) ||
+		    (difftime(now, ent_ptr->pack_time) >=
+		     dump_cache_max_age[type])) {
+			dump_cache[type][i] = NULL;
+			_dump_cache_free(ent_ptr);
+			continue;
+		}
+		if ((ent_ptr->show_flags == show_flags) &&
+		    (ent_ptr->uid == uid) &&
+		    (ent_ptr->protocol_version == protocol_version)) {
+			cache_ptr = ent_ptr;
+			cache_ptr->ref_cnt++;
+			break;
+		}
+	}
+	slurm_mutex_unlock(&dump_cache_mutex);
+
+	return cache_ptr;
+}
+
+/* Find a valid cached response without holding any slurmctld locks. The
+ * records may be changing while this runs, in which case the response found
+ * is the one published before the change completed.
+ * last_change IN - time the data to be packed was last changed
+ * RET cached response or NULL if the caller must lock and pack the records,
+ *	release with _dump_cache_fini() */
+static dump_cache_t *_dump_cache_find_unlocked(int type, uint16_t show_flags,
+					       uid_t uid, uint16_t private_data,
+					       uint16_t protocol_version,
+					       time_t last_change)
+{
+	uint32_t cache_uid;
+
+	if (!_dump_cache_uid(show_flags, uid, private_data, false, &cache_uid))
+		return NULL;
+	return _dump_cache_find(type, show_flags, cache_uid, protocol_version,
+				last_change);
+}
+
+/* Add a newly packed dump response to the cache, replacing the oldest entry
+ * if the cache is full. The cache takes ownership of the data buffer.
+ * pack_time IN - time at which packing of the data started
+ * RET cached response, release with _dump_cache_fini() */
+static dump_cache_t *_dump_cache_add(int type, uint16_t show_flags,
+				     uint32_t uid, uint16_t protocol_version,
+				     time_t pack_time, char *data,
+				     int data_size)
+{
+	dump_cache_t *cache_ptr;
+	int i, inx = 0;
+
+	cache_ptr = xmalloc(sizeof(dump_cache_t));
+	cache_ptr->data = data;
+	cache_ptr->data_size = data_size;
+	cache_ptr->pack_time = pack_time;
+	cache_ptr->protocol_version = protocol_version;
+	cache_ptr->ref_cnt = 2;
+	cache_ptr->show_flags = show_flags;
+	cache_ptr->uid = uid;
+
+	slurm_mutex_lock(&dump_cache_mutex);
+	for (i = 0; i < DUMP_CACHE_SIZE; i++) {
+		if (!dump_cache[type][i] ||
+		    ((dump_cache[type][i]->show_flags == show_flags) &&
+		     (dump_cache[type][i]->uid == uid) &&
+		     (dump_cache[type][i]->protocol_version ==
+		      protocol_version))) {
+			inx = i;	/* empty or racing identical request */
+			break;
+		}
+		if (dump_cache[type][i]->pack_time <
+		    dump_cache[type][inx]->pack_time)
+			inx = i;
+	}
+	if (dump_cache[type][inx])
+		_dump_cache_free(dump_cache[type][inx]);
+	dump_cache[type][inx] = cache_ptr;
+	slurm_mutex_unlock(&dump_cache_mutex);
+
+	return cache_ptr;
+}
+
+/* Release a response from _dump_cache_find() or _dump_cache_add() */
+static void _dump_cache_fini(dump_cache_t *cache_ptr)
+{
+	slurm_mutex_lock(&dump_cache_mutex);
+	_dump_cache_free(cache_ptr);
+	slurm_mutex_unlock(&dump_cache_mutex);
+}
+
+/* Free memory used to cache job, node and partition information responses */
+extern void free_dump_cache(void)
+{
+	int i, j;
+
+	slurm_mutex_lock(&dump_cache_mutex);
+	for (i = 0; i < DUMP_CACHE_TYPES; i++) {
+		for (j = 0; j < DUMP_CACHE_SIZE; j++) {
+			if (!dump_cache[i][j])
+				continue;
+			_dump_cache_free(dump_cache[i][j]);
+			dump_cache[i][j] = NULL;
+		}
+	}
+	slurm_mutex_unlock(&dump_cache_mutex);
+}
+
 /* _slurm_rpc_dump_jobs - process RPC for job state information */
 static void _slurm_rpc_dump_jobs(slurm_msg_t * msg)
 {
@@ -1195,6 +1437,10 @@ static void _slurm_rpc_dump_jobs(slurm_msg_t * msg)
 	char *dump;
 	int dump_size;
 	slurm_msg_t response_msg;
+	dump_cache_t *cache_ptr = NULL;
+	uint32_t cache_uid = NO_VAL;
+	uint16_t show_flags;
+	time_t pack_time;
 	job_info_request_msg_t *job_info_request_msg =
 		(job_info_request_msg_t *) msg->data;
 	/* Locks: Read config job, write partition (for hiding) */
@@ -1204,18 +1450,51 @@ static void _slurm_rpc_dump_jobs(slurm_msg_t * msg)
 
 	START_TIMER;
 	debug3("Processing RPC: REQUEST_JOB_INFO from uid=%d", uid);
-	lock_slurmctld(job_read_lock);
 
+	/* The batch script is only packed for its owner, so SHOW_DETAIL2
+	 * responses are not cached */
+	show_flags = job_info_request_msg->show_flags;
 	if ((job_info_request_msg->last_update - 1) >= last_job_update) {
-		unlock_slurmctld(job_read_lock);
 		debug3("_slurm_rpc_dump_jobs, no change");
 		slurm_send_rc_msg(msg, SLURM_NO_CHANGE_IN_DATA);
 	} else {
-		pack_all_jobs(&dump, &dump_size,
-			      job_info_request_msg->show_flags,
-			      g_slurm_auth_get_uid(msg->auth_cred, NULL),
-			      NO_VAL, msg->protocol_version);
-		unlock_slurmctld(job_read_lock);
+		if (!(show_flags & SHOW_DETAIL2)) {
+			cache_ptr = _dump_cache_find_unlocked(DUMP_CACHE_JOB,
+					show_flags, uid, PRIVATE_DATA_JOBS,
+					msg->protocol_version,
+					MAX(last_job_update, last_part_update));
+		}
+		if (!cache_ptr) {
+			lock_slurmctld(job_read_lock);
+			/* Another RPC may have packed the records while this
+			 * one was waiting for the locks */
+			if (!(show_flags & SHOW_DETAIL2)) {
+				(void) _dump_cache_uid(show_flags, uid,
+						       PRIVATE_DATA_JOBS, true,
+						       &cache_uid);
+				cache_ptr = _dump_cache_find(DUMP_CACHE_JOB,
+					show_flags, cache_uid,
+					msg->protocol_version,
+					MAX(last_job_update, last_part_update));
+			}
+			if (!cache_ptr) {
+				pack_time = time(NULL);
+				pack_all_jobs(&dump, &dump_size, show_flags,
+					      uid, NO_VAL,
+					      msg->protocol_version);
+			}
+			if (!cache_ptr && !(show_flags & SHOW_DETAIL2)) {
+				cache_ptr = _dump_cache_add(DUMP_CACHE_JOB,
+						show_flags, cache_uid,
+						msg->protocol_version,
+						pack_time, dump, dump_size);
+			}
+			unlock_slurmctld(job_read_lock);
+		}
+		if (cache_ptr) {
+			dump = cache_ptr->data;
+			dump_size = cache_ptr->data_size;
+		}
 		END_TIMER2("_slurm_rpc_dump_jobs");
 #if 0
 		info("_slurm_rpc_dump_jobs, size=%d %s", dump_size, TIME_STR);
@@ -1232,10 +1511,57 @@ static void _slurm_rpc_dump_jobs(slurm_msg_t * msg)
 
 		/* send message */
 		slurm_send_node_msg(msg->conn_fd, &response_msg);
-		xfree(dump);
+		if (cache_ptr)
+			_dump_cache_fini(cache_ptr);
+		else
+			xfree(dump);
 	}
 }
 
+/* _slurm_rpc_dump_jobs_delta - process RPC for job state information changed
+ *	since the client's generation */
+static void _slurm_rpc_dump_jobs_delta(slurm_msg_t * msg)
+{
+	DEF_TIMERS;
+	char *dump;
+	int dump_size;
+	slurm_msg_t response_msg;
+	delta_info_request_msg_t *delta_req_msg =
+		(delta_info_request_msg_t *) msg->data;
+	/* Locks: Read config job, write partition (for hiding) */
+	slurmctld_lock_t job_read_lock = {
+		READ_LOCK, READ_LOCK, NO_LOCK, WRITE_LOCK };
+	uid_t uid = g_slurm_auth_get_uid(msg->auth_cred, NULL);
+
+	START_TIMER;
+	debug3("Processing RPC: REQUEST_JOB_INFO_DELTA from uid=%d", uid);
+	lock_slurmctld(job_read_lock);
+	pack_all_jobs_delta(&dump, &dump_size, delta_req_msg->generation,
+			    delta_req_msg->show_flags, uid,
+			    msg->protocol_version);
+	unlock_slurmctld(job_read_lock);
+	END_TIMER2("_slurm_rpc_dump_jobs_delta");
+
+	if (dump == NULL) {
+		debug3("_slurm_rpc_dump_jobs_delta, no change");
+		slurm_send_rc_msg(msg, SLURM_NO_CHANGE_IN_DATA);
+		return;
+	}
+
+	/* init response_msg structure */
+	slurm_msg_t_init(&response_msg);
+	response_msg.flags = msg->flags;
+	response_msg.protocol_version = msg->protocol_version;
+	response_msg.address = msg->address;
+	response_msg.msg_type = RESPONSE_JOB_INFO_DELTA;
+	response_msg.data = dump;
+	response_msg.data_size = dump_size;
+
+	/* send message */
+	slurm_send_node_msg(msg->conn_fd, &response_msg);
+	xfree(dump);
+}
+
 /* _slurm_rpc_dump_sicp - process RPC for SICP job state information */
 static void _slurm_rpc_dump_sicp(slurm_msg_t * msg)
 {
@@ -1498,37 +1824,57 @@ static void _slurm_rpc_dump_nodes(slurm_msg_t * msg)
 	char *dump;
 	int dump_size;
 	slurm_msg_t response_msg;
+	dump_cache_t *cache_ptr;
+	uint32_t cache_uid;
+	time_t pack_time;
 	node_info_request_msg_t *node_req_msg =
 		(node_info_request_msg_t *) msg->data;
 	/* Locks: Read config, write node (reset allocated CPU count in some
-	 * select plugins) */
+	 * select plugins), write partition (for hiding) */
 	slurmctld_lock_t node_write_lock = {
-		READ_LOCK, NO_LOCK, WRITE_LOCK, NO_LOCK };
+		READ_LOCK, NO_LOCK, WRITE_LOCK, WRITE_LOCK };
 	uid_t uid = g_slurm_auth_get_uid(msg->auth_cred, NULL);
 
 	START_TIMER;
 	debug3("Processing RPC: REQUEST_NODE_INFO from uid=%d", uid);
-	lock_slurmctld(node_write_lock);
 
 	if ((slurmctld_conf.private_data & PRIVATE_DATA_NODES) &&
 	    (!validate_operator(uid))) {
-		unlock_slurmctld(node_write_lock);
 		error("Security violation, REQUEST_NODE_INFO RPC from uid=%d",
 		      uid);
 		slurm_send_rc_msg(msg, ESLURM_ACCESS_DENIED);
 		return;
 	}
 
-	select_g_select_nodeinfo_set_all();
-
 	if ((node_req_msg->last_update - 1) >= last_node_update) {
-		unlock_slurmctld(node_write_lock);
 		debug3("_slurm_rpc_dump_nodes, no change");
 		slurm_send_rc_msg(msg, SLURM_NO_CHANGE_IN_DATA);
 	} else {
-		pack_all_node(&dump, &dump_size, node_req_msg->show_flags,
-			      uid, msg->protocol_version);
-		unlock_slurmctld(node_write_lock);
+		cache_ptr = _dump_cache_find_unlocked(DUMP_CACHE_NODE,
+					node_req_msg->show_flags, uid, 0,
+					msg->protocol_version,
+					MAX(last_node_update, last_part_update));
+		if (!cache_ptr) {
+			lock_slurmctld(node_write_lock);
+			(void) _dump_cache_uid(node_req_msg->show_flags, uid,
+					       0, true, &cache_uid);
+			cache_ptr = _dump_cache_find(DUMP_CACHE_NODE,
+					node_req_msg->show_flags, cache_uid,
+					msg->protocol_version,
+					MAX(last_node_update, last_part_update));
+			if (!cache_ptr) {
+				select_g_select_nodeinfo_set_all();
+				pack_time = time(NULL);
+				pack_all_node(&dump, &dump_size,
+					      node_req_msg->show_flags, uid,
+					      msg->protocol_version);
+				cache_ptr = _dump_cache_add(DUMP_CACHE_NODE,
+					node_req_msg->show_flags, cache_uid,
+					msg->protocol_version, pack_time,
+					dump, dump_size);
+			}
+			unlock_slurmctld(node_write_lock);
+		}
 		END_TIMER2("_slurm_rpc_dump_nodes");
 #if 0
 		info("_slurm_rpc_dump_nodes, size=%d %s", dump_size, TIME_STR);
@@ -1540,15 +1886,71 @@ static void _slurm_rpc_dump_nodes(slurm_msg_t * msg)
 		response_msg.protocol_version = msg->protocol_version;
 		response_msg.address = msg->address;
 		response_msg.msg_type = RESPONSE_NODE_INFO;
-		response_msg.data = dump;
-		response_msg.data_size = dump_size;
+		response_msg.data = cache_ptr->data;
+		response_msg.data_size = cache_ptr->data_size;
 
 		/* send message */
 		slurm_send_node_msg(msg->conn_fd, &response_msg);
-		xfree(dump);
+		_dump_cache_fini(cache_ptr);
 	}
 }
 
+/* _slurm_rpc_dump_nodes_delta - dump RPC for node state information changed
+ *	since the client's generation */
+static void _slurm_rpc_dump_nodes_delta(slurm_msg_t * msg)
+{
+	DEF_TIMERS;
+	char *dump;
+	int dump_size;
+	slurm_msg_t response_msg;
+	delta_info_request_msg_t *delta_req_msg =
+		(delta_info_request_msg_t *) msg->data;
+	/* Locks: Read config, write node (reset allocated CPU count in some
+	 * select plugins), write partition (for hiding) */
+	slurmctld_lock_t node_write_lock = {
+		READ_LOCK, NO_LOCK, WRITE_LOCK, WRITE_LOCK };
+	uid_t uid = g_slurm_auth_get_uid(msg->auth_cred, NULL);
+
+	START_TIMER;
+	debug3("Processing RPC: REQUEST_NODE_INFO_DELTA from uid=%d", uid);
+	lock_slurmctld(node_write_lock);
+
+	if ((slurmctld_conf.private_data & PRIVATE_DATA_NODES) &&
+	    (!validate_operator(uid))) {
+		unlock_slurmctld(node_write_lock);
+		error("Security violation, REQUEST_NODE_INFO_DELTA RPC from "
+		      "uid=%d", uid);
+		slurm_send_rc_msg(msg, ESLURM_ACCESS_DENIED);
+		return;
+	}
+
+	select_g_select_nodeinfo_set_all();
+	pack_all_node_delta(&dump, &dump_size, delta_req_msg->generation,
+			    delta_req_msg->show_flags, uid,
+			    msg->protocol_version);
+	unlock_slurmctld(node_write_lock);
+	END_TIMER2("_slurm_rpc_dump_nodes_delta");
+
+	if (dump == NULL) {
+		debug3("_slurm_rpc_dump_nodes_delta, no change");
+		slurm_send_rc_msg(msg, SLURM_NO_CHANGE_IN_DATA);
+		return;
+	}
+
+	/* init response_msg structure */
+	slurm_msg_t_init(&response_msg);
+	response_msg.flags = msg->flags;
+	response_msg.protocol_version = msg->protocol_version;
+	response_msg.address = msg->address;
+	response_msg.msg_type = RESPONSE_NODE_INFO_DELTA;
+	response_msg.data = dump;
+	response_msg.data_size = dump_size;
+
+	/* send message */
+	slurm_send_node_msg(msg->conn_fd, &response_msg);
+	xfree(dump);
+}
+
 /* _slurm_rpc_dump_node_single - done RPC state information for one node */
 static void _slurm_rpc_dump_node_single(slurm_msg_t * msg)
 {
@@ -1612,6 +2014,9 @@ static void _slurm_rpc_dump_partitions(slurm_msg_t * msg)
 	int dump_size;
 	slurm_msg_t response_msg;
 	part_info_request_msg_t  *part_req_msg;
+	dump_cache_t *cache_ptr;
+	uint32_t cache_uid;
+	time_t pack_time;
 
 	/* Locks: Read configuration and partition */
 	slurmctld_lock_t part_read_lock = {
@@ -1621,25 +2026,43 @@ static void _slurm_rpc_dump_partitions(slurm_msg_t * msg)
 	START_TIMER;
 	debug2("Processing RPC: REQUEST_PARTITION_INFO uid=%d", uid);
 	part_req_msg = (part_info_request_msg_t  *) msg->data;
-	lock_slurmctld(part_read_lock);
 
 	if ((slurmctld_conf.private_data & PRIVATE_DATA_PARTITIONS) &&
 	    !validate_operator(uid)) {
-		unlock_slurmctld(part_read_lock);
 		debug2("Security violation, PARTITION_INFO RPC from uid=%d",
 		       uid);
 		slurm_send_rc_msg(msg, ESLURM_ACCESS_DENIED);
 	} else if ((part_req_msg->last_update - 1) >= last_part_update) {
-		unlock_slurmctld(part_read_lock);
 		debug2("_slurm_rpc_dump_partitions, no change");
 		slurm_send_rc_msg(msg, SLURM_NO_CHANGE_IN_DATA);
 	} else {
-		pack_all_part(&dump, &dump_size, part_req_msg->show_flags,
-			      uid, msg->protocol_version);
-		unlock_slurmctld(part_read_lock);
+		cache_ptr = _dump_cache_find_unlocked(DUMP_CACHE_PART,
+					     part_req_msg->show_flags, uid, 0,
+					     msg->protocol_version,
+					     last_part_update);
+		if (!cache_ptr) {
+			lock_slurmctld(part_read_lock);
+			(void) _dump_cache_uid(part_req_msg->show_flags, uid,
+					       0, true, &cache_uid);
+			cache_ptr = _dump_cache_find(DUMP_CACHE_PART,
+					     part_req_msg->show_flags,
+					     cache_uid, msg->protocol_version,
+					     last_part_update);
+			if (!cache_ptr) {
+				pack_time = time(NULL);
+				pack_all_part(&dump, &dump_size,
+					      part_req_msg->show_flags, uid,
+					      msg->protocol_version);
+				cache_ptr = _dump_cache_add(DUMP_CACHE_PART,
+					part_req_msg->show_flags, cache_uid,
+					msg->protocol_version, pack_time,
+					dump, dump_size);
+			}
+			unlock_slurmctld(part_read_lock);
+		}
 		END_TIMER2("_slurm_rpc_dump_partitions");
 		debug2("_slurm_rpc_dump_partitions, size=%d %s",
-		       dump_size, TIME_STR);
+		       cache_ptr->data_size, TIME_STR);
 
 		/* init response_msg structure */
 		slurm_msg_t_init(&response_msg);
@@ -1647,12 +2070,12 @@ static void _slurm_rpc_dump_partitions(slurm_msg_t * msg)
 		response_msg.protocol_version = msg->protocol_version;
 		response_msg.address = msg->address;
 		response_msg.msg_type = RESPONSE_PARTITION_INFO;
-		response_msg.data = dump;
-		response_msg.data_size = dump_size;
+		response_msg.data = cache_ptr->data;
+		response_msg.data_size = cache_ptr->data_size;
 
 		/* send message */
 		slurm_send_node_msg(msg->conn_fd, &response_msg);
-		xfree(dump);
+		_dump_cache_fini(cache_ptr);
 	}
 }
 
@@ -2220,6 +2643,8 @@ static void _slurm_rpc_job_step_create(slurm_msg_t * msg)
 		slurm_send_rc_msg(msg, error_code);
 	} else {
 		slurm_step_layout_t *layout = step_rec->step_layout;
+		uint32_t job_id = step_rec->job_ptr->job_id;
+		uint32_t step_id = step_rec->step_id;
 
 		if (slurmctld_conf.debug_flags & DEBUG_FLAG_STEPS)
 			info("sched: %s: StepId=%u.%u %s %s",
@@ -2242,6 +2667,19 @@ static void _slurm_rpc_job_step_create(slurm_msg_t * msg)
 
 		unlock_slurmctld(job_write_lock);
 		_throttle_fini(&active_rpc_cnt);
+		if (slurm_cred_sign_batch(slurmctld_config.cred_ctx,
+					  &slurm_cred, 1)) {
+			/* The step can not be launched, release its
+			 * resources rather than leave it to the job's end */
+			lock_slurmctld(job_write_lock);
+			(void) job_step_complete(job_id, step_id, 0, false,
+						 SLURM_ERROR);
+			unlock_slurmctld(job_write_lock);
+			slurm_send_rc_msg(msg, ESLURM_INVALID_JOB_CREDENTIAL);
+			slurm_cred_destroy(slurm_cred);
+			schedule_job_save();	/* Sets own locks */
+			return;
+		}
 		slurm_msg_t_init(&resp);
 		resp.flags = msg->flags;
 		resp.protocol_version = msg->protocol_version;
@@ -2262,6 +2700,10 @@ static void _slurm_rpc_job_step_get_info(slurm_msg_t * msg)
 	void *resp_buffer = NULL;
 	int resp_buffer_size = 0;
 	int error_code = SLURM_SUCCESS;
+	dump_cache_t *cache_ptr = NULL;
+	uint32_t cache_uid = NO_VAL;
+	time_t pack_time;
+	bool cache_ok;
 	job_step_info_request_msg_t *request =
 		(job_step_info_request_msg_t *) msg->data;
 	/* Locks: Read config, job, write partition (for filtering) */
@@ -2273,34 +2715,78 @@ static void _slurm_rpc_job_step_get_info(slurm_msg_t * msg)
 	if (slurmctld_conf.debug_flags & DEBUG_FLAG_STEPS)
 		debug("Processing RPC: REQUEST_JOB_STEP_INFO from uid=%d", uid);
 
-	lock_slurmctld(job_read_lock);
-
+	/* Only requests for all steps are common enough to be worth caching */
+	cache_ok = ((request->job_id == NO_VAL) &&
+		    (request->step_id == NO_VAL));
 	if ((request->last_update - 1) >= last_job_update) {
-		unlock_slurmctld(job_read_lock);
 		if (slurmctld_conf.debug_flags & DEBUG_FLAG_STEPS)
 			debug("%s, no change", __func__);
 		error_code = SLURM_NO_CHANGE_IN_DATA;
 	} else {
-		Buf buffer = init_buf(BUF_SIZE);
-		error_code = pack_ctld_job_step_info_response_msg(
-			request->job_id, request->step_id,
-			uid, request->show_flags, buffer,
-			msg->protocol_version);
-		unlock_slurmctld(job_read_lock);
+		if (cache_ok) {
+			cache_ptr = _dump_cache_find_unlocked(DUMP_CACHE_STEP,
+					request->show_flags, uid,
+					PRIVATE_DATA_JOBS,
+					msg->protocol_version,
+					MAX(last_job_update, last_part_update));
+		}
+		if (!cache_ptr) {
+			Buf buffer = NULL;
+
+			lock_slurmctld(job_read_lock);
+			if (cache_ok) {
+				(void) _dump_cache_uid(request->show_flags,
+						       uid, PRIVATE_DATA_JOBS,
+						       true, &cache_uid);
+				cache_ptr = _dump_cache_find(DUMP_CACHE_STEP,
+					request->show_flags, cache_uid,
+					msg->protocol_version,
+					MAX(last_job_update, last_part_update));
+			}
+			if (!cache_ptr) {
+				buffer = init_buf(BUF_SIZE);
+				pack_time = time(NULL);
+				error_code =
+					pack_ctld_job_step_info_response_msg(
+						request->job_id,
+						request->step_id, uid,
+						request->show_flags, buffer,
+						msg->protocol_version);
+			}
+			unlock_slurmctld(job_read_lock);
+			if (cache_ptr) {
+				;	/* packed while waiting for locks */
+			} else if (error_code) {
+				/* job_id:step_id not found or otherwise *\
+				\* error message is printed elsewhere    */
+				if (slurmctld_conf.debug_flags &
+				    DEBUG_FLAG_STEPS) {
+					debug("%s: %s", __func__,
+					      slurm_strerror(error_code));
+				}
+				free_buf(buffer);
+			} else {
+				resp_buffer_size = get_buf_offset(buffer);
+				resp_buffer = xfer_buf_data(buffer);
+				if (cache_ok) {
+					cache_ptr = _dump_cache_add(
+						DUMP_CACHE_STEP,
+						request->show_flags, cache_uid,
+						msg->protocol_version,
+						pack_time, resp_buffer,
+						resp_buffer_size);
+				}
+			}
+		}
 		END_TIMER2("_slurm_rpc_job_step_get_info");
-		if (error_code) {
-			/* job_id:step_id not found or otherwise *\
-			\* error message is printed elsewhere    */
-			if (slurmctld_conf.debug_flags & DEBUG_FLAG_STEPS)
-				debug("%s: %s",
-					__func__, slurm_strerror(error_code));
-			free_buf(buffer);
-		} else {
-			resp_buffer_size = get_buf_offset(buffer);
-			resp_buffer = xfer_buf_data(buffer);
-			if (slurmctld_conf.debug_flags & DEBUG_FLAG_STEPS)
-				debug("%s size=%d %s",
-					__func__, resp_buffer_size, TIME_STR);
+		if (cache_ptr) {
+			resp_buffer = cache_ptr->data;
+			resp_buffer_size = cache_ptr->data_size;
+		}
+		if (!error_code && (slurmctld_conf.debug_flags &
+				    DEBUG_FLAG_STEPS)) {
+			debug("%s size=%d %s",
+			      __func__, resp_buffer_size, TIME_STR);
 		}
 	}
 
@@ -2317,7 +2803,10 @@ static void _slurm_rpc_job_step_get_info(slurm_msg_t * msg)
 		response_msg.data = resp_buffer;
 		response_msg.data_size = resp_buffer_size;
 		slurm_send_node_msg(msg->conn_fd, &response_msg);
-		xfree(resp_buffer);
+		if (cache_ptr)
+			_dump_cache_fini(cache_ptr);
+		else
+			xfree(resp_buffer);
 	}
 }
 
@@ -3375,6 +3864,133 @@ static void _slurm_rpc_submit_batch_job(slurm_msg_t * msg)
 fini:	xfree(err_msg);
 }
 
+/* _slurm_rpc_submit_batch_job_multi - process RPC to submit several batch jobs.
+ * Each job is validated and created as by _slurm_rpc_submit_batch_job(), but
+ * the locks are acquired once for all of them and the job state save and
+ * scheduler are triggered once. Batch steps in existing jobs are not
+ * supported. */
+static void _slurm_rpc_submit_batch_job_multi(slurm_msg_t * msg)
+{
+	static int active_rpc_cnt = 0;
+	int error_code;
+	DEF_TIMERS;
+	int i, submit_cnt = 0;
+	struct job_record *job_ptr;
+	slurm_msg_t response_msg;
+	submit_response_multi_msg_t submit_msg;
+	job_desc_multi_msg_t *multi_msg = (job_desc_multi_msg_t *) msg->data;
+	job_desc_msg_t *job_desc_msg;
+	/* Locks: Read config, read job, read node, read partition */
+	slurmctld_lock_t job_read_lock = {
+		READ_LOCK, READ_LOCK, READ_LOCK, READ_LOCK };
+	/* Locks: Write job, read node, read partition */
+	slurmctld_lock_t job_write_lock = {
+		NO_LOCK, WRITE_LOCK, READ_LOCK, READ_LOCK };
+	uid_t uid = g_slurm_auth_get_uid(msg->auth_cred, NULL);
+
+	START_TIMER;
+	debug2("Processing RPC: REQUEST_SUBMIT_BATCH_JOB_MULTI from uid=%d "
+	       "job_cnt=%u", uid, multi_msg->job_cnt);
+
+	submit_msg.job_cnt = multi_msg->job_cnt;
+	submit_msg.job_id = xmalloc(sizeof(uint32_t) * multi_msg->job_cnt);
+	submit_msg.error_code = xmalloc(sizeof(uint32_t) * multi_msg->job_cnt);
+	submit_msg.err_msg = xmalloc(sizeof(char *) * multi_msg->job_cnt);
+
+	for (i = 0; i < multi_msg->job_cnt; i++) {
+		job_desc_msg = multi_msg->job_desc[i];
+		if ((uid != job_desc_msg->user_id) &&
+		    (!validate_super_user(uid))) {
+			/* NOTE: Super root can submit a batch job for any
+			 * user */
+			submit_msg.error_code[i] = ESLURM_USER_ID_MISSING;
+			error("Security violation, SUBMIT_JOB_MULTI from "
+			      "uid=%d", uid);
+		} else if ((job_desc_msg->alloc_node == NULL) ||
+			   (job_desc_msg->alloc_node[0] == '\0')) {
+			submit_msg.error_code[i] = ESLURM_INVALID_NODE_NAME;
+			error("REQUEST_SUBMIT_BATCH_JOB_MULTI lacks alloc_node "
+			      "from uid=%d", uid);
+		}
+	}
+
+	/* Locks are for job_submit plugin use */
+	lock_slurmctld(job_read_lock);
+	for (i = 0; i < multi_msg->job_cnt; i++) {
+		if (submit_msg.error_code[i])
+			continue;
+		submit_msg.error_code[i] = validate_job_create_req(
+			multi_msg->job_desc[i], uid, &submit_msg.err_msg[i]);
+	}
+	unlock_slurmctld(job_read_lock);
+
+	_throttle_start(&active_rpc_cnt);
+	lock_slurmctld(job_write_lock);
+	for (i = 0; i < multi_msg->job_cnt; i++) {
+		if (submit_msg.error_code[i])
+			continue;
+		job_desc_msg = multi_msg->job_desc[i];
+		dump_job_desc(job_desc_msg);
+		if (job_desc_msg->job_id != SLURM_BATCH_SCRIPT) {
+			job_ptr = find_job_record(job_desc_msg->job_id);
+			if (job_ptr && (!IS_JOB_FINISHED(job_ptr) ||
+					IS_JOB_COMPLETING(job_ptr))) {
+				info("Attempt to re-use active job id %u",
+				     job_ptr->job_id);
+				submit_msg.error_code[i] =
+					ESLURM_DUPLICATE_JOB_ID;
+				continue;
+			}
+		}
+
+		job_ptr = NULL;
+		error_code = job_allocate(job_desc_msg,
+					  job_desc_msg->immediate, false,
+					  NULL, 0, uid, &job_ptr,
+					  &submit_msg.err_msg[i],
+					  msg->protocol_version);
+		if (job_desc_msg->immediate && (error_code != SLURM_SUCCESS))
+			error_code = ESLURM_CAN_NOT_START_IMMEDIATELY;
+		if (job_ptr &&
+		    ((error_code == SLURM_SUCCESS) ||
+		     (error_code == ESLURM_JOB_HELD) ||
+		     (error_code == ESLURM_NODE_NOT_AVAIL) ||
+		     (error_code == ESLURM_QOS_THRES) ||
+		     (error_code == ESLURM_RESERVATION_NOT_USABLE) ||
+		     (error_code == ESLURM_REQUESTED_PART_CONFIG_UNAVAILABLE))) {
+			submit_msg.job_id[i] = job_ptr->job_id;
+			submit_cnt++;
+		} else {
+			info("_slurm_rpc_submit_batch_job_multi: %s",
+			     slurm_strerror(error_code));
+		}
+		submit_msg.error_code[i] = error_code;
+	}
+	unlock_slurmctld(job_write_lock);
+	_throttle_fini(&active_rpc_cnt);
+	END_TIMER2("_slurm_rpc_submit_batch_job_multi");
+	info("_slurm_rpc_submit_batch_job_multi submitted %d of %u jobs %s",
+	     submit_cnt, multi_msg->job_cnt, TIME_STR);
+
+	slurm_msg_t_init(&response_msg);
+	response_msg.flags = msg->flags;
+	response_msg.protocol_version = msg->protocol_version;
+	response_msg.msg_type = RESPONSE_SUBMIT_BATCH_JOB_MULTI;
+	response_msg.data = &submit_msg;
+	slurm_send_node_msg(msg->conn_fd, &response_msg);
+	for (i = 0; i < multi_msg->job_cnt; i++)
+		xfree(submit_msg.err_msg[i]);
+	xfree(submit_msg.err_msg);
+	xfree(submit_msg.job_id);
+	xfree(submit_msg.error_code);
+
+	if (submit_cnt) {
+		schedule_job_save();	/* Has own locks */
+		schedule_node_save();	/* Has own locks */
+		queue_job_scheduler();
+	}
+}
+
 /* _slurm_rpc_update_job - process RPC to update the configuration of a
  * job (e.g. priority)
  */
@@ -4905,6 +5521,7 @@ inline static void _slurm_rpc_reboot_nodes(slurm_msg_t * msg)
 		if (IS_NODE_CLOUD(node_ptr) && IS_NODE_POWER_SAVE(node_ptr))
 			continue;
 		node_ptr->node_state |= NODE_STATE_MAINT;
+		NODE_DELTA_TOUCH(node_ptr);
 		want_nodes_reboot = true;
 	}
 
@@ -5229,6 +5846,145 @@ _slurm_rpc_kill_job2(slurm_msg_t *msg)
 	END_TIMER2("_slurm_rpc_kill_job2");
 }
 
+/* Return true if the job is active and satisfies the filters of a
+ * REQUEST_KILL_JOBS message. owner_id is the only user whose jobs may match,
+ * NO_VAL for any user */
+static bool _kill_jobs_match(struct job_record *job_ptr, kill_jobs_msg_t *kill,
+			     uint32_t owner_id)
+{
+	slurmdb_qos_rec_t *qos_ptr;
+	uint16_t job_base_state = job_ptr->job_state & JOB_STATE_BASE;
+
+	if ((job_base_state != JOB_PENDING) &&
+	    (job_base_state != JOB_RUNNING) &&
+	    (job_base_state != JOB_SUSPENDED))
+		return false;
+	if ((kill->state != JOB_END) && (job_base_state != kill->state))
+		return false;
+	if ((owner_id != NO_VAL) && (job_ptr->user_id != owner_id))
+		return false;
+	if ((kill->user_id != NO_VAL) && (job_ptr->user_id != kill->user_id))
+		return false;
+	if (kill->account && xstrcmp(job_ptr->account, kill->account))
+		return false;
+	if (kill->job_name && xstrcmp(job_ptr->name, kill->job_name))
+		return false;
+	if (kill->partition && xstrcmp(job_ptr->partition, kill->partition))
+		return false;
+	if (kill->reservation && xstrcmp(job_ptr->resv_name, kill->reservation))
+		return false;
+	if (kill->qos) {
+		qos_ptr = (slurmdb_qos_rec_t *) job_ptr->qos_ptr;
+		if (!qos_ptr || xstrcmp(qos_ptr->name, kill->qos))
+			return false;
+	}
+	return true;
+}
+
+/* Record the result of signaling one job for a RESPONSE_KILL_JOBS message.
+ * Only failures are recorded individually. */
+static void _kill_jobs_result(kill_jobs_resp_msg_t *resp, uint32_t *resp_size,
+			      uint32_t job_id, int rc)
+{
+	resp->job_cnt++;
+	if (rc == SLURM_SUCCESS)
+		return;
+	if (resp->err_cnt >= *resp_size) {
+		*resp_size = MAX(64, *resp_size * 2);
+		xrealloc(resp->job_id, sizeof(uint32_t) * *resp_size);
+		xrealloc(resp->error_code, sizeof(uint32_t) * *resp_size);
+	}
+	resp->job_id[resp->err_cnt] = job_id;
+	resp->error_code[resp->err_cnt] = rc;
+	resp->err_cnt++;
+}
+
+/* _slurm_rpc_kill_jobs - process RPC to signal a list of jobs, or all active
+ * jobs matching some filter, under a single acquisition of the job write lock
+ */
+inline static void
+_slurm_rpc_kill_jobs(slurm_msg_t *msg)
+{
+	static int active_rpc_cnt = 0;
+	DEF_TIMERS;
+	kill_jobs_msg_t *kill = (kill_jobs_msg_t *) msg->data;
+	kill_jobs_resp_msg_t resp;
+	slurm_msg_t response_msg;
+	/* Locks: Read config, write job, write node */
+	slurmctld_lock_t job_write_lock = {
+		READ_LOCK, WRITE_LOCK, WRITE_LOCK, NO_LOCK };
+	uid_t uid = g_slurm_auth_get_uid(msg->auth_cred, NULL);
+	uint16_t flags = kill->flags & (~KILL_JOB_ARRAY);
+	struct job_record *job_ptr;
+	ListIterator job_iterator;
+	uint32_t resp_size = 0, cancel_cnt, owner_id;
+	char job_id_str[16];
+	int i, rc;
+
+	START_TIMER;
+	debug2("Processing RPC: REQUEST_KILL_JOBS from uid=%d job_cnt=%u "
+	       "signal=%u", uid, kill->job_cnt, kill->signal);
+
+	memset(&resp, 0, sizeof(kill_jobs_resp_msg_t));
+	_throttle_start(&active_rpc_cnt);
+	lock_slurmctld(job_write_lock);
+	if (kill->job_id) {
+		for (i = 0; i < kill->job_cnt; i++) {
+			if (kill->flags & KILL_JOB_ARRAY) {
+				snprintf(job_id_str, sizeof(job_id_str), "%u",
+					 kill->job_id[i]);
+				rc = job_str_signal(job_id_str, kill->signal,
+						    flags, uid, false);
+			} else {
+				rc = job_signal(kill->job_id[i], kill->signal,
+						flags, uid, false);
+			}
+			_kill_jobs_result(&resp, &resp_size, kill->job_id[i],
+					  rc);
+		}
+	} else {
+		/* Other users' jobs are skipped silently rather than denied,
+		 * so a filter does not reveal them */
+		if (validate_operator(uid))
+			owner_id = NO_VAL;
+		else
+			owner_id = (uint32_t) uid;
+		job_iterator = list_iterator_create(job_list);
+		while ((job_ptr = (struct job_record *)
+				  list_next(job_iterator))) {
+			if (!_kill_jobs_match(job_ptr, kill, owner_id))
+				continue;
+			rc = job_signal(job_ptr->job_id, kill->signal, flags,
+					uid, false);
+			_kill_jobs_result(&resp, &resp_size, job_ptr->job_id,
+					  rc);
+		}
+		list_iterator_destroy(job_iterator);
+	}
+	unlock_slurmctld(job_write_lock);
+	_throttle_fini(&active_rpc_cnt);
+	END_TIMER2("_slurm_rpc_kill_jobs");
+
+	cancel_cnt = resp.job_cnt - resp.err_cnt;
+	if (kill->signal == SIGKILL)
+		slurmctld_diag_stats.jobs_canceled += cancel_cnt;
+	info("%s: signal %u sent to %u of %u jobs by uid=%d %s", __func__,
+	     kill->signal, cancel_cnt, resp.job_cnt, uid, TIME_STR);
+
+	slurm_msg_t_init(&response_msg);
+	response_msg.flags = msg->flags;
+	response_msg.protocol_version = msg->protocol_version;
+	response_msg.msg_type = RESPONSE_KILL_JOBS;
+	response_msg.data = &resp;
+	slurm_send_node_msg(msg->conn_fd, &response_msg);
+	xfree(resp.job_id);
+	xfree(resp.error_code);
+
+	/* Below function provides its own locking */
+	if (cancel_cnt)
+		schedule_job_save();
+}
+
 /* _slurm_rpc_dump_cache()
  *
  * Pack the io buffer and send it back to the library.
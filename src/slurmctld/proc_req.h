@@ -54,6 +54,9 @@ typedef struct connection_arg {
 /* Free memory used to track RPC usage by type and user */
 extern void free_rpc_stats(void);
 
+/* Free memory used to cache job, node and partition information responses */
+extern void free_dump_cache(void);
+
 /*
  * slurmctld_req  - Process an individual RPC request
  * IN/OUT msg - the request message, data associated with the message is freed
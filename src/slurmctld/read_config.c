@@ -291,6 +291,7 @@ static int _build_bitmaps(void)
 
 	last_node_update = time(NULL);
 	last_part_update = time(NULL);
+	node_set_cache_clear();
 
 	/* initialize the idle and up bitmaps */
 	FREE_NULL_BITMAP(avail_node_bitmap);
@@ -1897,7 +1898,7 @@ static int _sync_nodes_to_active_job(struct job_record *job_ptr)
 			time_t now = time(NULL);
 			info("Killing job %u on DOWN node %s",
 			     job_ptr->job_id, node_ptr->name);
-			job_ptr->job_state = JOB_NODE_FAIL | JOB_COMPLETING;
+			JOB_STATE_SET(job_ptr, JOB_NODE_FAIL | JOB_COMPLETING);
 			build_cg_bitmap(job_ptr);
 			job_ptr->end_time = MIN(job_ptr->end_time, now);
 			job_ptr->exit_code = MAX(job_ptr->exit_code, 1);
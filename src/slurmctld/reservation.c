@@ -4818,6 +4818,7 @@ extern int set_node_maint_mode(bool reset_all)
 		     i <= node_record_count;
 		     i++, node_ptr++) {
 			node_ptr->node_state &= (~flags);
+			NODE_DELTA_TOUCH(node_ptr);
 		}
 	}
 	iter = list_iterator_create(resv_list);
@@ -4966,6 +4967,7 @@ static void _set_nodes_flags(slurmctld_resv_t *resv_ptr, time_t now,
 			node_ptr->node_state |= flags;
 		else
 			node_ptr->node_state &= (~flags);
+		NODE_DELTA_TOUCH(node_ptr);
 		/* mark that this node is now down and in maint mode
 		 * or was removed from maint mode */
 		if (IS_NODE_DOWN(node_ptr) || IS_NODE_DRAIN(node_ptr) ||
@@ -97,6 +97,13 @@
 #define MAX_SERVER_THREADS 256
 #endif
 
+/* Maximum number of accepted RPC connections waiting for a server thread
+ * once MAX_SERVER_THREADS are busy. Queued connections are serviced by the
+ * existing server threads as they complete their current RPC. */
+#ifndef MAX_SERVER_QUEUE
+#define MAX_SERVER_QUEUE (MAX_SERVER_THREADS * 4)
+#endif
+
 /* Perform full slurmctld's state every PERIODIC_CHECKPOINT seconds */
 #ifndef PERIODIC_CHECKPOINT
 #define	PERIODIC_CHECKPOINT	300
@@ -206,6 +213,16 @@ typedef struct diag_stats {
 	uint32_t bf_queue_len_sum;
 	time_t   bf_when_last_cycle;
 	uint32_t bf_active;
+	uint32_t bf_threads;
+	uint64_t bf_spec_tests;
+	uint64_t bf_spec_used;
+
+	uint64_t job_hash_lookups;
+	uint64_t job_hash_probes;
+	uint32_t job_hash_probe_max;
+
+	uint64_t agent_msg_cnt;
+	uint32_t agent_queue_max;
 } diag_stats_t;
 
 extern time_t	last_proc_req_start;
@@ -422,6 +439,31 @@ extern time_t last_resv_update;	/* time of last resv_list update */
  *  JOB parameters and data structures
 \*****************************************************************************/
 extern time_t last_job_update;	/* time of last update to job records */
+extern uint32_t job_delta_next_gen;	/* generation of job record changes
+					 * not yet seen by any client */
+extern bool job_delta_changed;	/* set if any record has job_delta_next_gen */
+
+/* Record a change to a job record for pack_all_jobs_delta(). Use along with
+ * setting last_job_update, the job write lock must be set. */
+#define JOB_DELTA_TOUCH(_job_ptr) do {				\
+		(_job_ptr)->delta_gen = job_delta_next_gen;	\
+		job_delta_changed = true;			\
+	} while (0)
+
+/* Change a job's state, recording the change for pack_all_jobs_delta().
+ * Use these rather than writing job_state directly. */
+#define JOB_STATE_SET(_job_ptr, _state) do {			\
+		(_job_ptr)->job_state = (_state);		\
+		JOB_DELTA_TOUCH(_job_ptr);			\
+	} while (0)
+#define JOB_STATE_FLAG_SET(_job_ptr, _flag) do {		\
+		(_job_ptr)->job_state |= (_flag);		\
+		JOB_DELTA_TOUCH(_job_ptr);			\
+	} while (0)
+#define JOB_STATE_FLAG_CLEAR(_job_ptr, _flag) do {		\
+		(_job_ptr)->job_state &= (~(_flag));		\
+		JOB_DELTA_TOUCH(_job_ptr);			\
+	} while (0)
 
 #define DETAILS_MAGIC	0xdea84e7
 #define JOB_MAGIC	0xf0b7392c
@@ -580,6 +622,8 @@ struct job_record {
 					 * 1 if cr is enabled */
 	uint32_t db_index;              /* used only for database
 					 * plugins */
+	uint32_t delta_gen;		/* generation of last change to packed
+					 * record, see pack_all_jobs_delta() */
 	uint32_t derived_ec;		/* highest exit code of all job steps */
 	struct job_details *details;	/* job details */
 	uint16_t direct_set_prio;	/* Priority set directly if
@@ -657,6 +701,9 @@ struct job_record {
 	bool part_nodes_missing;	/* set if job's nodes removed from this
 					 * partition */
 	struct part_record *part_ptr;	/* pointer to the partition record */
+	uint32_t pend_inx;		/* position in pending job index + 1,
+					 * zero if not indexed, see
+					 * pend_job_add() */
 	uint8_t power_flags;		/* power management flags,
 					 * see SLURM_POWER_FLAGS_ */
 	time_t pre_sus_time;		/* time job ran prior to last suspend */
@@ -1011,6 +1058,13 @@ extern struct job_record *find_job_array_rec(uint32_t array_job_id,
  */
 struct job_record *find_job_record(uint32_t job_id);
 
+/*
+ * get_job_hash_size - report the size and usage of the job hash table
+ * OUT table_size - number of hash table buckets
+ * OUT record_cnt - number of job records in the hash table
+ */
+extern void get_job_hash_size(uint32_t *table_size, uint32_t *record_cnt);
+
 /*
  * find_first_node_record - find a record for first node in the bitmap
  * IN node_bitmap
@@ -1655,6 +1709,23 @@ extern void pack_all_jobs(char **buffer_ptr, int *buffer_size,
 			  uint16_t show_flags, uid_t uid, uint32_t filter_uid,
 			  uint16_t protocol_version);
 
+/*
+ * pack_all_jobs_delta - dump information for jobs changed since a client's
+ *	generation in machine independent form (for network transmission)
+ * OUT buffer_ptr - the pointer is set to the allocated buffer, NULL if no
+ *	job changed since the client's generation
+ * OUT buffer_size - set to size of the buffer in bytes
+ * IN generation - generation of the client's job information, 0 if none
+ * IN show_flags - job filtering options
+ * IN uid - uid of user making request (for partition filtering)
+ * IN protocol_version - slurm protocol version of client
+ * global: job_list - global list of job records
+ * NOTE: the buffer at *buffer_ptr must be xfreed by the caller
+ */
+extern void pack_all_jobs_delta(char **buffer_ptr, int *buffer_size,
+				uint64_t generation, uint16_t show_flags,
+				uid_t uid, uint16_t protocol_version);
+
 /*
  * pack_all_node - dump all configuration and node information for all nodes
  *	in machine independent form (for network transmission)
@@ -1672,6 +1743,24 @@ extern void pack_all_node (char **buffer_ptr, int *buffer_size,
 			   uint16_t show_flags, uid_t uid,
 			   uint16_t protocol_version);
 
+/*
+ * pack_all_node_delta - dump information for nodes changed since a client's
+ *	generation in machine independent form (for network transmission)
+ * OUT buffer_ptr - pointer to the stored data, NULL if no node changed since
+ *	the client's generation
+ * OUT buffer_size - set to size of the buffer in bytes
+ * IN generation - generation of the client's node information, 0 if none
+ * IN show_flags - node filtering options
+ * IN uid - uid of user making request (for partition filtering)
+ * IN protocol_version - slurm protocol version of client
+ * global: node_record_table_ptr - pointer to global node table
+ * NOTE: the caller must xfree the buffer at *buffer_ptr
+ * NOTE: READ lock_slurmctld config and WRITE lock node before entry
+ */
+extern void pack_all_node_delta(char **buffer_ptr, int *buffer_size,
+				uint64_t generation, uint16_t show_flags,
+				uid_t uid, uint16_t protocol_version);
+
 /*
  * pack_all_sicp - dump inter-cluster job state information
  * OUT buffer_ptr - the pointer is set to the allocated buffer.
@@ -1789,6 +1878,11 @@ extern void part_filter_clear(void);
  * group access. This must be followed by a call to part_filter_clear() */
 extern void part_filter_set(uid_t uid);
 
+/* part_filter_uid - Return true if any partition restricts access by group,
+ * in which case the partitions visible to a non-super-user (and the job and
+ * node records packed for them) depend upon that user's identity */
+extern bool part_filter_uid(void);
+
 /* part_fini - free all memory associated with partition records */
 extern void part_fini (void);
 
@@ -2239,6 +2333,16 @@ extern int validate_nodes_via_front_end(
 		slurm_node_registration_status_msg_t *reg_msg,
 		uint16_t protocol_version, bool *newly_up);
 
+/*
+ * validate_node_reg_list - validate the registrations of a group of nodes,
+ *	as returned through the forward tree in reply to
+ *	REQUEST_NODE_REGISTRATION_STATUS, with one hold of the slurmctld locks
+ * IN reg_list - list of slurm_node_registration_status_msg_t
+ * IN protocol_version - Version of Slurm on these nodes
+ * NOTE: Sets own locks
+ */
+extern void validate_node_reg_list(List reg_list, uint16_t protocol_version);
+
 /*
  * validate_slurm_user - validate that the uid is authorized to see
  *      privileged data (either user root or SlurmUser)
@@ -50,6 +50,7 @@
 #endif                          /* WITH_PTHREADS */
 
 #include "src/common/macros.h"
+#include "src/common/timers.h"
 #include "src/slurmctld/front_end.h"
 #include "src/slurmctld/reservation.h"
 #include "src/slurmctld/slurmctld.h"
@@ -60,6 +61,17 @@
 #define SAVE_MAX_WAIT	5
 #endif
 
+/* Saving job state holds the job read lock while every job record is packed,
+ * so with large job queues the save itself can take seconds. Space job state
+ * saves so that at most 1/JOB_SAVE_DUTY of the time is spent saving job state,
+ * but never more than JOB_SAVE_MAX_WAIT seconds apart */
+#ifndef JOB_SAVE_DUTY
+#define JOB_SAVE_DUTY	10
+#endif
+#ifndef JOB_SAVE_MAX_WAIT
+#define JOB_SAVE_MAX_WAIT 30
+#endif
+
 static pthread_mutex_t state_save_lock = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t  state_save_cond = PTHREAD_COND_INITIALIZER;
 static int save_jobs = 0, save_nodes = 0, save_parts = 0;
@@ -170,11 +182,13 @@ extern void shutdown_state_save(void)
  */
 extern void *slurmctld_state_save(void *no_data)
 {
-	time_t last_save = 0, now;
-	double save_delay;
+	time_t last_save = 0, last_job_save = 0, now;
+	double save_delay, job_save_delay;
+	int job_save_wait = SAVE_MAX_WAIT;
 	bool run_save;
 	int save_count;
 	int cc;
+	DEF_TIMERS;
 
 #if HAVE_SYS_PRCTL_H
 	cc = prctl(PR_SET_NAME, "slurmctld_sstate", NULL, NULL, NULL);
@@ -193,9 +207,12 @@ extern void *slurmctld_state_save(void *no_data)
 				     save_triggers;
 			now = time(NULL);
 			save_delay = difftime(now, last_save);
+			job_save_delay = difftime(now, last_job_save);
 			if (save_count &&
 			    (!run_save_thread ||
-			     (save_delay >= SAVE_MAX_WAIT))) {
+			     ((save_delay >= SAVE_MAX_WAIT) &&
+			      ((save_count > save_jobs) ||
+			       (job_save_delay >= job_save_wait))))) {
 				last_save = now;
 				break;		/* do the work */
 			} else if (!run_save_thread) {
@@ -227,13 +244,21 @@ extern void *slurmctld_state_save(void *no_data)
 		/* save job info if necessary */
 		run_save = false;
 		slurm_mutex_lock(&state_save_lock);
-		if (save_jobs) {
+		if (save_jobs &&
+		    (!run_save_thread || (job_save_delay >= job_save_wait))) {
 			run_save = true;
 			save_jobs = 0;
 		}
 		slurm_mutex_unlock(&state_save_lock);
-		if (run_save)
+		if (run_save) {
+			START_TIMER;
 			(void)dump_all_job_state();
+			END_TIMER;
+			last_job_save = time(NULL);
+			job_save_wait = (DELTA_TIMER * JOB_SAVE_DUTY) / 1000000;
+			job_save_wait = MAX(job_save_wait, SAVE_MAX_WAIT);
+			job_save_wait = MIN(job_save_wait, JOB_SAVE_MAX_WAIT);
+		}
 
 		/* save node info if necessary */
 		run_save = false;
@@ -43,6 +43,7 @@
 #include <stdio.h>
 
 #include "src/slurmctld/agent.h"
+#include "src/slurmctld/locks.h"
 #include "src/slurmctld/slurmctld.h"
 #include "src/common/list.h"
 #include "src/common/pack.h"
@@ -57,6 +58,8 @@ extern void pack_all_stat(int resp, char **buffer_ptr, int *buffer_size,
 	Buf buffer;
 	int parts_packed;
 	int agent_queue_size;
+	slurmctld_lock_stats_t lock_stats;
+	uint32_t job_hash_size, job_hash_cnt;
 	time_t now = time(NULL);
 
 	buffer_ptr[0] = NULL;
@@ -116,6 +119,45 @@ extern void pack_all_stat(int resp, char **buffer_ptr, int *buffer_size,
 			pack32(slurmctld_diag_stats.bf_depth_try_sum, buffer);
 			pack32(slurmctld_diag_stats.bf_queue_len_sum, buffer);
 			pack32(slurmctld_diag_stats.bf_active,	 buffer);
+
+			if (protocol_version >= SLURM_15_08_PROTOCOL_VERSION) {
+				get_lock_stats(&lock_stats);
+				pack32(LOCK_STAT_COUNT, buffer);
+				pack32_array(lock_stats.lock_cnt,
+					     LOCK_STAT_COUNT, buffer);
+				pack64_array(lock_stats.wait_time,
+					     LOCK_STAT_COUNT, buffer);
+				pack32_array(lock_stats.wait_max,
+					     LOCK_STAT_COUNT, buffer);
+				pack32(LOCK_HIST_BUCKETS, buffer);
+				pack32_array(&lock_stats.wait_hist[0][0],
+					     LOCK_STAT_COUNT *
+					     LOCK_HIST_BUCKETS, buffer);
+
+				get_job_hash_size(&job_hash_size,
+						  &job_hash_cnt);
+				pack32(job_hash_size, buffer);
+				pack32(job_hash_cnt, buffer);
+				pack64(slurmctld_diag_stats.job_hash_lookups,
+				       buffer);
+				pack64(slurmctld_diag_stats.job_hash_probes,
+				       buffer);
+				pack32(slurmctld_diag_stats.job_hash_probe_max,
+				       buffer);
+
+				pack32(get_agent_count(), buffer);
+				pack32(get_agent_thread_count(), buffer);
+				pack64(slurmctld_diag_stats.agent_msg_cnt,
+				       buffer);
+				pack32(slurmctld_diag_stats.agent_queue_max,
+				       buffer);
+
+				pack32(slurmctld_diag_stats.bf_threads, buffer);
+				pack64(slurmctld_diag_stats.bf_spec_tests,
+				       buffer);
+				pack64(slurmctld_diag_stats.bf_spec_used,
+				       buffer);
+			}
 		}
 	}
 
@@ -155,6 +197,17 @@ extern void reset_stats(int level)
 	slurmctld_diag_stats.bf_last_depth = 0;
 	slurmctld_diag_stats.bf_last_depth_try = 0;
 	slurmctld_diag_stats.bf_active = 0;
+	slurmctld_diag_stats.bf_spec_tests = 0;
+	slurmctld_diag_stats.bf_spec_used = 0;
+
+	slurmctld_diag_stats.job_hash_lookups = 0;
+	slurmctld_diag_stats.job_hash_probes = 0;
+	slurmctld_diag_stats.job_hash_probe_max = 0;
+
+	slurmctld_diag_stats.agent_msg_cnt = 0;
+	slurmctld_diag_stats.agent_queue_max = 0;
+
+	reset_lock_stats();
 
 	last_proc_req_start = time(NULL);
 }
@@ -176,6 +176,7 @@ static struct step_record * _create_step_record(struct job_record *job_ptr)
 	step_ptr = (struct step_record *) xmalloc(sizeof(struct step_record));
 
 	last_job_update = time(NULL);
+	JOB_DELTA_TOUCH(job_ptr);
 	step_ptr->job_ptr    = job_ptr;
 	step_ptr->exit_code  = NO_VAL;
 	step_ptr->time_limit = INFINITE;
@@ -242,6 +243,7 @@ extern void delete_step_records (struct job_record *job_ptr)
 	xassert(job_ptr);
 
 	last_job_update = time(NULL);
+	JOB_DELTA_TOUCH(job_ptr);
 	step_iterator = list_iterator_create(job_ptr->step_list);
 	while ((step_ptr = (struct step_record *) list_next (step_iterator))) {
 		/* Only check if not a pending step */
@@ -341,6 +343,7 @@ delete_step_record (struct job_record *job_ptr, uint32_t step_id)
 		return error_code;
 
 	last_job_update = time(NULL);
+	JOB_DELTA_TOUCH(job_ptr);
 	step_iterator = list_iterator_create (job_ptr->step_list);
 	while ((step_ptr = (struct step_record *) list_next (step_iterator))) {
 		if (step_ptr->step_id != step_id)
@@ -740,6 +743,7 @@ int job_step_complete(uint32_t job_id, uint32_t step_id, uid_t uid,
 	_internal_step_complete(job_ptr, step_ptr);
 
 	last_job_update = time(NULL);
+	JOB_DELTA_TOUCH(job_ptr);
 
 	return SLURM_SUCCESS;
 }
@@ -967,7 +971,7 @@ _pick_step_nodes (struct job_record  *job_ptr,
 				return NULL;
 			}
 		}
-		job_ptr->job_state &= (~JOB_CONFIGURING);
+		JOB_STATE_FLAG_CLEAR(job_ptr, JOB_CONFIGURING);
 		debug("Configuration for job %u complete", job_ptr->job_id);
 	}
 
@@ -2982,6 +2986,7 @@ extern int job_step_checkpoint(checkpoint_msg_t *ckpt_ptr,
 				   &resp_data.error_code,
 				   &resp_data.error_msg);
 		last_job_update = time(NULL);
+		JOB_DELTA_TOUCH(step_ptr->job_ptr);
 	}
 
     reply:
@@ -3048,6 +3053,7 @@ extern int job_step_checkpoint_comp(checkpoint_comp_msg_t *ckpt_ptr,
 		rc = checkpoint_comp((void *)step_ptr, ckpt_ptr->begin_time,
 			ckpt_ptr->error_code, ckpt_ptr->error_msg);
 		last_job_update = time(NULL);
+		JOB_DELTA_TOUCH(step_ptr->job_ptr);
 	}
 
     reply:
@@ -3107,6 +3113,7 @@ extern int job_step_checkpoint_task_comp(checkpoint_task_comp_msg_t *ckpt_ptr,
 			ckpt_ptr->task_id, ckpt_ptr->begin_time,
 			ckpt_ptr->error_code, ckpt_ptr->error_msg);
 		last_job_update = time(NULL);
+		JOB_DELTA_TOUCH(step_ptr->job_ptr);
 	}
 
     reply:
@@ -3811,6 +3818,7 @@ extern void step_checkpoint(void)
 				       (uint16_t)NO_VAL);
 			job_ptr->ckpt_time = now;
 			last_job_update = now;
+			JOB_DELTA_TOUCH(job_ptr);
 			continue; /* ignore periodic step ckpt */
 		}
 		step_iterator = list_iterator_create (job_ptr->step_list);
@@ -3837,6 +3845,7 @@ extern void step_checkpoint(void)
 
 			step_ptr->ckpt_time = now;
 			last_job_update = now;
+			JOB_DELTA_TOUCH(job_ptr);
 			image_dir = xstrdup(step_ptr->ckpt_dir);
 			xstrfmtcat(image_dir, "/%u.%u", job_ptr->job_id,
 				   step_ptr->step_id);
@@ -4107,8 +4116,10 @@ extern int update_step(step_update_request_msg_t *req, uid_t uid)
 			     req->job_id, req->step_id, req->time_limit);
 		}
 	}
-	if (mod_cnt)
+	if (mod_cnt) {
 		last_job_update = time(NULL);
+		JOB_DELTA_TOUCH(job_ptr);
+	}
 
 	return SLURM_SUCCESS;
 }
@@ -4207,6 +4218,7 @@ extern int post_job_step(struct step_record *step_ptr)
 				 step_ptr->step_id);
 
 	last_job_update = time(NULL);
+	JOB_DELTA_TOUCH(job_ptr);
 	step_ptr->state = JOB_COMPLETE;
 
 	error_code = delete_step_record(job_ptr, step_ptr->step_id);
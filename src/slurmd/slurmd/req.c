@@ -178,6 +178,7 @@ static void _rpc_reboot(slurm_msg_t *msg);
 static void _rpc_pid2jid(slurm_msg_t *msg);
 static int  _rpc_file_bcast(slurm_msg_t *msg);
 static int  _rpc_ping(slurm_msg_t *);
+static void _rpc_node_registration(slurm_msg_t *);
 static int  _rpc_health_check(slurm_msg_t *);
 static int  _rpc_acct_gather_update(slurm_msg_t *);
 static int  _rpc_acct_gather_energy(slurm_msg_t *);
@@ -188,6 +189,7 @@ static int  _rpc_daemon_status(slurm_msg_t *msg);
 static int  _run_epilog(job_env_t *job_env);
 static int  _run_prolog(job_env_t *job_env, slurm_cred_t *cred);
 static void _rpc_forward_data(slurm_msg_t *msg);
+static void _rpc_node_multi_msg(slurm_msg_t *msg);
 
 
 static bool _pause_for_job_completion(uint32_t jobid, char *nodes,
@@ -380,10 +382,16 @@ slurmd_req(slurm_msg_t *msg)
 		break;
 	case REQUEST_NODE_REGISTRATION_STATUS:
 		debug2("Processing RPC: REQUEST_NODE_REGISTRATION_STATUS");
-		/* Treat as ping (for slurmctld agent, just return SUCCESS) */
-		rc = _rpc_ping(msg);
 		last_slurmctld_msg = time(NULL);
 		/* No body to free */
+		if (msg->flags & SLURM_NODE_REG_REPLY) {
+			/* Reply with the registration, slurmctld validates
+			 * the replies of many nodes together */
+			_rpc_node_registration(msg);
+			break;
+		}
+		/* Treat as ping (for slurmctld agent, just return SUCCESS) */
+		rc = _rpc_ping(msg);
 		/* Then initiate a separate node registration */
 		if (rc == SLURM_SUCCESS)
 			send_registration_msg(SLURM_SUCCESS, true);
@@ -443,6 +451,12 @@ slurmd_req(slurm_msg_t *msg)
 		_rpc_forward_data(msg);
 		slurm_free_forward_data_msg(msg->data);
 		break;
+	case REQUEST_NODE_MULTI_MSG:
+		debug2("Processing RPC: REQUEST_NODE_MULTI_MSG");
+		last_slurmctld_msg = time(NULL);
+		_rpc_node_multi_msg(msg);
+		slurm_free_node_multi_msg(msg->data);
+		break;
 	case REQUEST_SUSPEND:	/* Defunct, see REQUEST_SUSPEND_INT */
 	default:
 		error("slurmd_req: invalid request msg type %d",
@@ -452,6 +466,74 @@ slurmd_req(slurm_msg_t *msg)
 	}
 	return;
 }
+
+static void *_node_multi_msg_thread(void *arg)
+{
+	slurm_msg_t *msg = (slurm_msg_t *) arg;
+
+	slurmd_req(msg);	/* Frees msg->data */
+	xfree(msg);
+	return NULL;
+}
+
+/*
+ * Process each of the requests in a REQUEST_NODE_MULTI_MSG as if it had been
+ * received separately, after its reply has been sent and the connection
+ * closed. Each request gets its own thread since termination requests wait
+ * for the job's processes to end and its epilog to run. Wait for all of them
+ * so that msg->auth_cred stays valid.
+ */
+static void _rpc_node_multi_msg(slurm_msg_t *msg)
+{
+	node_multi_msg_t *req = (node_multi_msg_t *) msg->data;
+	uid_t uid = g_slurm_auth_get_uid(msg->auth_cred, NULL);
+	slurm_msg_t *sub_msg;
+	pthread_attr_t attr;
+	pthread_t *thread_id;
+	int i;
+
+	if (!_slurm_authorized_user(uid)) {
+		error("Security violation: node_multi_msg from uid %d", uid);
+		if (msg->conn_fd >= 0)
+			slurm_send_rc_msg(msg, ESLURM_USER_ID_MISSING);
+		return;
+	}
+
+	if (msg->conn_fd >= 0) {
+		slurm_send_rc_msg(msg, SLURM_SUCCESS);
+		slurm_close(msg->conn_fd);
+		msg->conn_fd = -1;
+	}
+
+	thread_id = xmalloc(sizeof(pthread_t) * req->msg_cnt);
+	slurm_attr_init(&attr);
+	for (i = 0; i < req->msg_cnt; i++) {
+		sub_msg = xmalloc(sizeof(slurm_msg_t));
+		slurm_msg_t_init(sub_msg);
+		sub_msg->msg_type = req->msg_type[i];
+		sub_msg->data = req->msg_data[i];
+		req->msg_data[i] = NULL;
+		sub_msg->auth_cred = msg->auth_cred;
+		sub_msg->protocol_version = msg->protocol_version;
+		sub_msg->address = msg->address;
+		sub_msg->orig_addr = msg->orig_addr;
+		sub_msg->conn_fd = -1;
+		if (pthread_create(&thread_id[i], &attr,
+				   _node_multi_msg_thread, sub_msg)) {
+			error("%s: pthread_create: %m", __func__);
+			thread_id[i] = 0;
+			_node_multi_msg_thread(sub_msg);
+		}
+	}
+	slurm_attr_destroy(&attr);
+
+	for (i = 0; i < req->msg_cnt; i++) {
+		if (thread_id[i])
+			pthread_join(thread_id[i], NULL);
+	}
+	xfree(thread_id);
+}
+
 static int _send_slurmd_conf_lite (int fd, slurmd_conf_t *cf)
 {
 	int len;
@@ -1485,7 +1567,8 @@ static void _rpc_prolog(slurm_msg_t *msg)
 	if (req == NULL)
 		return;
 
-	if (slurm_send_rc_msg(msg, rc) < 0) {
+	/* No reply is expected when part of a REQUEST_NODE_MULTI_MSG */
+	if ((msg->conn_fd >= 0) && (slurm_send_rc_msg(msg, rc) < 0)) {
 		error("Error starting prolog: %m");
 	}
 	if (rc) {
@@ -2252,6 +2335,27 @@ _rpc_ping(slurm_msg_t *msg)
 	return rc;
 }
 
+static void
+_rpc_node_registration(slurm_msg_t *msg)
+{
+	uid_t req_uid = g_slurm_auth_get_uid(msg->auth_cred, NULL);
+
+	if (!_slurm_authorized_user(req_uid)) {
+		error("Security violation, node registration RPC from uid %d",
+		      req_uid);
+		slurm_send_rc_msg(msg, ESLURM_USER_ID_MISSING);
+		return;
+	}
+
+	/* If the reply can not be sent, register separately so the node
+	 * is not set DOWN for failing to respond */
+	if (reply_registration_msg(msg) != SLURM_SUCCESS)
+		send_registration_msg(SLURM_SUCCESS, true);
+
+	/* Take this opportunity to enforce any job memory limits */
+	_enforce_job_mem_limit();
+}
+
 static int
 _rpc_health_check(slurm_msg_t *msg)
 {
@@ -2854,16 +2958,20 @@ _rpc_timelimit(slurm_msg_t *msg)
 	if (!_slurm_authorized_user(uid)) {
 		error ("Security violation: rpc_timelimit req from uid %d",
 		       uid);
-		slurm_send_rc_msg(msg, ESLURM_USER_ID_MISSING);
+		if (msg->conn_fd >= 0)
+			slurm_send_rc_msg(msg, ESLURM_USER_ID_MISSING);
 		return;
 	}
 
 	/*
-	 *  Indicate to slurmctld that we've received the message
+	 *  Indicate to slurmctld that we've received the message,
+	 *  unless part of a REQUEST_NODE_MULTI_MSG already replied to
 	 */
-	slurm_send_rc_msg(msg, SLURM_SUCCESS);
-	slurm_close(msg->conn_fd);
-	msg->conn_fd = -1;
+	if (msg->conn_fd >= 0) {
+		slurm_send_rc_msg(msg, SLURM_SUCCESS);
+		slurm_close(msg->conn_fd);
+		msg->conn_fd = -1;
+	}
 
 	if (req->step_id != NO_VAL) {
 		slurm_ctl_conf_t *cf;
@@ -621,6 +621,33 @@ send_registration_msg(uint32_t status, bool startup)
 	return ret_val;
 }
 
+extern int
+reply_registration_msg(slurm_msg_t *req_msg)
+{
+	int ret_val = SLURM_SUCCESS;
+	slurm_msg_t resp_msg;
+	slurm_node_registration_status_msg_t *msg =
+		xmalloc (sizeof (slurm_node_registration_status_msg_t));
+
+	msg->startup = (uint16_t) true;
+	_fill_registration_msg(msg);
+	msg->status  = SLURM_SUCCESS;
+
+	slurm_msg_t_copy(&resp_msg, req_msg);
+	resp_msg.msg_type = MESSAGE_NODE_REGISTRATION_STATUS;
+	resp_msg.data     = msg;
+
+	if (slurm_send_node_msg(req_msg->conn_fd, &resp_msg) < 0) {
+		error("Unable to reply with registration: %m");
+		ret_val = SLURM_FAILURE;
+	} else {
+		sent_reg_time = time(NULL);
+	}
+	slurm_free_node_registration_status_msg (msg);
+
+	return ret_val;
+}
+
 static void
 _fill_registration_msg(slurm_node_registration_status_msg_t *msg)
 {
@@ -176,6 +176,13 @@ extern slurmd_conf_t * conf;
  */
 int send_registration_msg(uint32_t status, bool startup);
 
+/* Send node registration message as the reply to the controller's
+ * REQUEST_NODE_REGISTRATION_STATUS, so that it is returned through the
+ * forward tree together with the registrations of the other nodes
+ * IN req_msg - the REQUEST_NODE_REGISTRATION_STATUS message
+ */
+int reply_registration_msg(slurm_msg_t *req_msg);
+
 /*
  * save_cred_state - save the current credential list to a file
  * IN list - list of credentials
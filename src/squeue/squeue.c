@@ -180,8 +180,10 @@ _print_job ( bool clear_old )
 		show_flags |= SHOW_DETAIL;
 
 	if (old_job_ptr) {
-		if (clear_old)
+		if (clear_old) {
 			old_job_ptr->last_update = 0;
+			old_job_ptr->generation = 0;
+		}
 		if (params.job_id) {
 			error_code = slurm_load_job(
 				&new_job_ptr, params.job_id,
@@ -191,9 +193,9 @@ _print_job ( bool clear_old )
 							 params.user_id,
 							 show_flags);
 		} else {
-			error_code = slurm_load_jobs(
-				old_job_ptr->last_update,
-				&new_job_ptr, show_flags);
+			error_code = slurm_load_jobs_delta(old_job_ptr,
+							   &new_job_ptr,
+							   show_flags);
 		}
 		if (error_code ==  SLURM_SUCCESS)
 			slurm_free_job_info_msg( old_job_ptr );
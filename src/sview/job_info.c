@@ -3491,9 +3491,9 @@ extern int get_new_info_job(job_info_msg_t **info_ptr,
 		show_flags |= SHOW_ALL;
 	if (g_job_info_ptr) {
 		if (show_flags != last_flags)
-			g_job_info_ptr->last_update = 0;
-		error_code = slurm_load_jobs(g_job_info_ptr->last_update,
-					     &new_job_ptr, show_flags);
+			g_job_info_ptr->generation = 0;
+		error_code = slurm_load_jobs_delta(g_job_info_ptr,
+						   &new_job_ptr, show_flags);
 		if (error_code == SLURM_SUCCESS) {
 			slurm_free_job_info_msg(g_job_info_ptr);
 			changed = 1;
@@ -1,6 +1,7 @@
 /* Test of src/bitstring.c 
  */
 #include <stdlib.h>
+#include <string.h>
 #include <src/common/bitstring.h>
 #include <sys/time.h>
 #include <testsuite/dejagnu.h>
@@ -20,6 +21,132 @@
 		pass( _msg );		\
 } while (0)
 
+/* Sizes around word boundaries for both 32 and 64 bit words */
+static int test_sizes[] = { 1, 31, 32, 33, 63, 64, 65, 127, 1000, 1025 };
+
+/* Fill b with random bits, then complement it so that any unused bits in
+ * its last word are set as well */
+static void _random_fill(bitstr_t *b, int pct)
+{
+	int i;
+
+	for (i = 0; i < bit_size(b); i++) {
+		if ((rand() % 100) >= pct)
+			bit_set(b, i);
+		else
+			bit_clear(b, i);
+	}
+	bit_not(b);
+}
+
+/* Reference versions of the word at a time functions, one bit at a time */
+static int _ref_count(bitstr_t *b1, bitstr_t *b2, int start, int end)
+{
+	int i, count = 0;
+
+	for (i = start; i < end; i++) {
+		if (bit_test(b1, i) && (!b2 || bit_test(b2, i)))
+			count++;
+	}
+	return count;
+}
+
+static int _ref_ffs(bitstr_t *b, int set)
+{
+	int i;
+
+	for (i = 0; i < bit_size(b); i++) {
+		if (bit_test(b, i) == set)
+			return i;
+	}
+	return -1;
+}
+
+static int _ref_fls(bitstr_t *b)
+{
+	int i;
+
+	for (i = bit_size(b) - 1; i >= 0; i--) {
+		if (bit_test(b, i))
+			return i;
+	}
+	return -1;
+}
+
+static int _ref_super_set(bitstr_t *b1, bitstr_t *b2)
+{
+	int i;
+
+	for (i = 0; i < bit_size(b1); i++) {
+		if (bit_test(b1, i) && !bit_test(b2, i))
+			return 0;
+	}
+	return 1;
+}
+
+/* Compare the word at a time functions with the reference versions */
+static int _check_words(int nbits, int pct,
+			bitstr_t *(*alloc1)(bitoff_t), bitstr_t *(*alloc2)(bitoff_t))
+{
+	bitstr_t *b1 = alloc1(nbits), *b2 = alloc2(nbits), *b3;
+	int i, start, end, rc = 1;
+
+	_random_fill(b1, pct);
+	_random_fill(b2, pct);
+
+	if ((bit_set_count(b1) != _ref_count(b1, NULL, 0, nbits)) ||
+	    (bit_overlap(b1, b2) != _ref_count(b1, b2, 0, nbits)) ||
+	    (bit_overlap_any(b1, b2) != (_ref_count(b1, b2, 0, nbits) > 0)) ||
+	    (bit_ffs(b1) != _ref_ffs(b1, 1)) ||
+	    (bit_ffc(b1) != _ref_ffs(b1, 0)) ||
+	    (bit_fls(b1) != _ref_fls(b1)) ||
+	    (bit_super_set(b1, b2) != _ref_super_set(b1, b2)))
+		rc = 0;
+
+	for (i = 0; (i < 20) && rc; i++) {
+		start = rand() % nbits;
+		end = start + (rand() % (nbits - start + 1));
+		if (bit_set_count_range(b1, start, end) !=
+		    _ref_count(b1, NULL, start, end))
+			rc = 0;
+	}
+
+	b3 = bit_copy(b1);
+	bit_and(b3, b2);
+	if (!_ref_super_set(b3, b1) || !_ref_super_set(b3, b2) ||
+	    (bit_set_count(b3) != _ref_count(b1, b2, 0, nbits)))
+		rc = 0;
+	bit_copybits(b3, b1);
+	bit_and_not(b3, b2);
+	if (bit_overlap_any(b3, b2) ||
+	    (bit_set_count(b3) != (_ref_count(b1, NULL, 0, nbits) -
+				   _ref_count(b1, b2, 0, nbits))))
+		rc = 0;
+	bit_free(b3);
+
+	start = rand() % nbits;
+	end = start + (rand() % (nbits - start));
+	bit_nset(b1, start, end);
+	if (_ref_count(b1, NULL, start, end + 1) != (end - start + 1))
+		rc = 0;
+	bit_copybits(b2, b1);
+	bit_nclear(b1, start, end);
+	if (_ref_count(b1, NULL, start, end + 1) ||
+	    (_ref_count(b1, NULL, 0, start) != _ref_count(b2, NULL, 0, start)) ||
+	    (_ref_count(b1, NULL, end + 1, nbits) !=
+	     _ref_count(b2, NULL, end + 1, nbits)))
+		rc = 0;
+
+	bit_free(b1);
+	bit_free(b2);
+	return rc;
+}
+
+static long _delta_usec(struct timeval *tv1, struct timeval *tv2)
+{
+	return ((tv2->tv_sec - tv1->tv_sec) * 1000000) +
+	       (tv2->tv_usec - tv1->tv_usec);
+}
 
 int
 main(int argc, char *argv[])
@@ -202,6 +329,129 @@ main(int argc, char *argv[])
 		TEST(bit_equal(bs, bs2), "bitstring");
 	}
 
+	note("Testing word operations against bit at a time results");
+	{
+		int i, j, pct[] = { 0, 3, 50, 97, 100 };
+		int ok = 1;
+
+		srand(1);
+		for (i = 0; i < sizeof(test_sizes) / sizeof(int); i++) {
+			for (j = 0; j < sizeof(pct) / sizeof(int); j++) {
+				if (!_check_words(test_sizes[i], pct[j],
+						  bit_alloc, bit_alloc))
+					ok = 0;
+			}
+		}
+		TEST(ok, "word operations");
+	}
+
+	note("Testing sparse bitstrings against bit at a time results");
+	{
+		int sizes[] = { 33, 65536, 65600, 200000 };
+		int i, j, pct[] = { 0, 3, 50, 97, 100 };
+		int ok = 1;
+
+		for (i = 0; i < sizeof(sizes) / sizeof(int); i++) {
+			for (j = 0; j < sizeof(pct) / sizeof(int); j++) {
+				if (!_check_words(sizes[i], pct[j],
+						  bit_alloc_sparse,
+						  bit_alloc_sparse) ||
+				    !_check_words(sizes[i], pct[j],
+						  bit_alloc_sparse, bit_alloc) ||
+				    !_check_words(sizes[i], pct[j],
+						  bit_alloc, bit_alloc_sparse))
+					ok = 0;
+			}
+		}
+		TEST(ok, "sparse operations");
+	}
+
+	note("Testing sparse bit_realloc/bit_fmt");
+	{
+		bitstr_t *bs1 = bit_alloc_sparse(70000);
+		bitstr_t *bs2 = bit_alloc(70000);
+		char str1[128], str2[128];
+
+		bit_nset(bs1, 1000, 69999);
+		bit_clear(bs1, 5000);
+		bit_nset(bs2, 1000, 69999);
+		bit_clear(bs2, 5000);
+		TEST(bit_equal(bs1, bs2), "sparse equal");
+		TEST(!strcmp(bit_fmt(str1, sizeof(str1), bs1),
+			     bit_fmt(str2, sizeof(str2), bs2)), "sparse fmt");
+		bs1 = bit_realloc(bs1, 140000);
+		TEST(bit_set_count(bs1) == 68999, "sparse realloc");
+		TEST(bit_fls(bs1) == 69999, "sparse realloc");
+		bs1 = bit_realloc(bs1, 3000);
+		TEST(bit_set_count(bs1) == 2000, "sparse realloc");
+		bit_set(bs1, 5);
+		TEST(!strcmp(bit_fmt(str1, sizeof(str1), bs1), "5,1000-2999"),
+		     "sparse fmt");
+
+		bit_free(bs1);
+		bit_free(bs2);
+	}
+
+	note("Testing bit_and_not/bit_overlap_any");
+	{
+		bitstr_t *bs1 = bit_alloc(100);
+		bitstr_t *bs2 = bit_alloc(100);
+
+		bit_nset(bs1, 10, 90);
+		bit_set(bs2, 95);
+		TEST(!bit_overlap_any(bs1, bs2), "overlap_any");
+		bit_set(bs2, 90);
+		TEST(bit_overlap_any(bs1, bs2), "overlap_any");
+		bit_and_not(bs1, bs2);
+		TEST(!bit_test(bs1, 90), "and_not");
+		TEST(bit_test(bs1, 89), "and_not");
+		TEST(bit_test(bs2, 90), "and_not");
+		TEST(bit_set_count(bs1) == 80, "and_not");
+
+		bit_free(bs1);
+		bit_free(bs2);
+	}
+
+	note("Throughput of 100000 bit operations");
+	{
+		bitstr_t *bs1 = bit_alloc(100000);
+		bitstr_t *bs2 = bit_alloc(100000);
+		struct timeval tv1, tv2;
+		int i, loops = 2000;
+		long count = 0;
+
+		_random_fill(bs1, 50);
+		_random_fill(bs2, 50);
+
+		gettimeofday(&tv1, NULL);
+		for (i = 0; i < loops; i++)
+			count += bit_set_count(bs1);
+		gettimeofday(&tv2, NULL);
+		note("bit_set_count: %ld nsec per call",
+		     _delta_usec(&tv1, &tv2) * 1000 / loops);
+
+		gettimeofday(&tv1, NULL);
+		for (i = 0; i < loops; i++)
+			count += bit_overlap(bs1, bs2);
+		gettimeofday(&tv2, NULL);
+		note("bit_overlap: %ld nsec per call",
+		     _delta_usec(&tv1, &tv2) * 1000 / loops);
+
+		gettimeofday(&tv1, NULL);
+		for (i = 0; i < loops; i++) {
+			bit_nclear(bs2, 0, 99999);
+			bit_nset(bs2, i, 99999 - i);
+			count += bit_ffs(bs2) + bit_fls(bs2);
+		}
+		gettimeofday(&tv2, NULL);
+		note("bit_nclear/bit_nset/bit_ffs/bit_fls: %ld nsec per call",
+		     _delta_usec(&tv1, &tv2) * 1000 / loops);
+		TEST(count != 0, "throughput");
+
+		bit_free(bs1);
+		bit_free(bs2);
+	}
+
 	totals();
 	return failed;
 }
@@ -0,0 +1,183 @@
+/* Simulation of message forwarding over a tree of 10000 virtual nodes.
+ * Compares the time by which every responsive node has received a message
+ * when the node list is split as the route/default plugin does (set_span,
+ * first node of each sublist forwards) and as the route/adaptive plugin does
+ * (forward_split_hostlist with and without node history).
+ *
+ * Node behaviour is derived from the node index, so results are repeatable.
+ * A single history is shared by every level of the tree, standing in for the
+ * history each forwarding slurmd builds up on its own.
+ */
+#include <stdlib.h>
+#include <src/common/forward.h>
+#include <src/common/hostlist.h>
+#include <src/common/slurm_protocol_api.h>
+#include <src/common/xmalloc.h>
+#include <testsuite/dejagnu.h>
+
+#define SIM_NODES	10000
+#define SIM_WIDTH	50
+#define DEAD_USEC	2000000	/* time to give up on an unresponsive node */
+#define SEND_USEC	150	/* forwarder cost to start each sub-message */
+
+/* Test for failure:
+*/
+#define TEST(_tst, _msg) do {		\
+	if (! (_tst))			\
+		fail( _msg );		\
+	else				\
+		pass( _msg );		\
+} while (0)
+
+static int delivered;
+
+static uint32_t _node_hash(char *name)
+{
+	uint32_t inx = strtoul(name + 3, NULL, 10);
+
+	return inx * 2654435761U;
+}
+
+/* One way message latency of a node, 0 if the node does not respond */
+static uint64_t _node_usec(char *name)
+{
+	uint32_t hash = _node_hash(name);
+	uint64_t usec = 150 + ((hash >> 8) % 100);
+
+	if ((hash % 100) < 1)
+		return 0;		/* 1% dead */
+	if ((hash % 100) < 3)
+		usec *= 20;		/* 2% slow */
+	return usec;
+}
+
+/* Each _send function returns the time the last responsive node received
+ * the message, 0 if none did */
+static uint64_t _send_list(hostlist_t hl, uint64_t start, bool adaptive);
+
+/* Send to each node of hl directly, as a forwarder does after the head of
+ * a route/default sublist failed */
+static uint64_t _send_flat(hostlist_t hl, uint64_t start)
+{
+	uint64_t usec, last = 0;
+	char *name;
+	int i = 0;
+
+	while ((name = hostlist_shift(hl))) {
+		if ((usec = _node_usec(name))) {
+			delivered++;
+			last = MAX(last, start + (++i * SEND_USEC) + usec);
+		}
+		free(name);
+	}
+	return last;
+}
+
+/* Send to the first node of hl, which forwards to the rest */
+static uint64_t _send_sublist(hostlist_t hl, uint64_t start, bool adaptive)
+{
+	uint64_t usec, last, sub_last;
+	char *name = hostlist_shift(hl);
+
+	if (!(usec = _node_usec(name))) {
+		forward_history_update(name, 0, true);
+		free(name);
+		start += DEAD_USEC;
+		if (adaptive)
+			return _send_list(hl, start, true);
+		return _send_flat(hl, start);
+	}
+	forward_history_update(name, 2 * usec, false);
+	free(name);
+	delivered++;
+	last = start + usec;
+	if (hostlist_count(hl)) {
+		sub_last = _send_list(hl, start + usec, adaptive);
+		last = MAX(last, sub_last);
+	}
+	return last;
+}
+
+/* Split hl as the route plugin would and send to every sublist */
+static uint64_t _send_list(hostlist_t hl, uint64_t start, bool adaptive)
+{
+	hostlist_t *sp_hl;
+	uint64_t last = 0, sub_last;
+	int count = 0, i, j, *span;
+	char *name;
+
+	if (adaptive) {
+		forward_split_hostlist(hl, SIM_WIDTH, &sp_hl, &count);
+	} else {
+		/* Same as route_split_hostlist_treewidth() */
+		span = set_span(hostlist_count(hl), SIM_WIDTH);
+		sp_hl = xmalloc(SIM_WIDTH * sizeof(hostlist_t));
+		while ((name = hostlist_shift(hl))) {
+			sp_hl[count] = hostlist_create(name);
+			free(name);
+			for (j = 0; j < span[count]; j++) {
+				if (!(name = hostlist_shift(hl)))
+					break;
+				hostlist_push_host(sp_hl[count], name);
+				free(name);
+			}
+			count++;
+		}
+		xfree(span);
+	}
+
+	for (i = 0; i < count; i++) {
+		sub_last = _send_sublist(sp_hl[i],
+					 start + ((i + 1) * SEND_USEC),
+					 adaptive);
+		last = MAX(last, sub_last);
+		hostlist_destroy(sp_hl[i]);
+	}
+	xfree(sp_hl);
+	return last;
+}
+
+static uint64_t _broadcast(bool adaptive)
+{
+	hostlist_t hl = hostlist_create("sim[00001-10000]");
+	uint64_t last;
+
+	delivered = 0;
+	last = _send_list(hl, 0, adaptive);
+	hostlist_destroy(hl);
+	return last;
+}
+
+int
+main(int argc, char *argv[])
+{
+	uint64_t static_usec, cold_usec, warm_usec;
+	int i, live = 0;
+	char name[16];
+
+	for (i = 1; i <= SIM_NODES; i++) {
+		snprintf(name, sizeof(name), "sim%05d", i);
+		if (_node_usec(name))
+			live++;
+	}
+	note("Simulating %d nodes, %d responsive, tree width %d",
+	     SIM_NODES, live, SIM_WIDTH);
+
+	static_usec = _broadcast(false);
+	TEST(delivered == live, "static tree reaches every node");
+
+	forward_history_init();
+	cold_usec = _broadcast(true);
+	TEST(delivered == live, "adaptive tree reaches every node");
+	warm_usec = _broadcast(true);
+	TEST(delivered == live, "adaptive tree with history reaches every node");
+
+	note("static %"PRIu64" usec, adaptive %"PRIu64" usec, "
+	     "adaptive with history %"PRIu64" usec",
+	     static_usec, cold_usec, warm_usec);
+	TEST(cold_usec <= static_usec, "adaptive tree no slower than static");
+	TEST(warm_usec < static_usec, "node history speeds up adaptive tree");
+
+	totals();
+	return failed;
+}
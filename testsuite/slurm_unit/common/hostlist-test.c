@@ -0,0 +1,243 @@
+/* Test of node name list and node bitmap conversion in src/common/hostlist.c
+ * and src/common/node_conf.c, over a table of 100000 node names.
+ *
+ * Each conversion is compared with one built host at a time and timed.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <src/common/bitstring.h>
+#include <src/common/hostlist.h>
+#include <src/common/node_conf.h>
+#include <src/common/xmalloc.h>
+#include <src/common/xstring.h>
+#include <testsuite/dejagnu.h>
+
+/* 50000 + 40000 + 9999 + 1 names, with and without zero padding */
+#define TEST_NODES	"a[1-50000],b[00001-40000],login[1-9999],head"
+#define TEST_NODE_CNT	100000
+
+/* Test for failure:
+*/
+#define TEST(_tst, _msg) do {		\
+	if (! (_tst))			\
+		fail( _msg );		\
+	else				\
+		pass( _msg );		\
+} while (0)
+
+static long _delta_usec(struct timeval *tv1, struct timeval *tv2)
+{
+	return ((tv2->tv_sec - tv1->tv_sec) * 1000000) +
+	       (tv2->tv_usec - tv1->tv_usec);
+}
+
+static void _build_node_table(void)
+{
+	hostlist_t hl = hostlist_create(TEST_NODES);
+	char *name;
+	int i = 0;
+
+	node_record_table_ptr = xmalloc(TEST_NODE_CNT *
+					sizeof(struct node_record));
+	while ((name = hostlist_shift(hl))) {
+		node_record_table_ptr[i].name = xstrdup(name);
+		node_record_table_ptr[i].magic = NODE_MAGIC;
+		free(name);
+		i++;
+	}
+	node_record_count = i;
+	hostlist_destroy(hl);
+	rehash_node();
+}
+
+/* Reference versions, one host at a time */
+static char *_ref_bitmap2node_name(bitstr_t *bitmap)
+{
+	hostlist_t hl = hostlist_create(NULL);
+	char *buf;
+	int i;
+
+	for (i = 0; i < node_record_count; i++) {
+		if (bit_test(bitmap, i))
+			hostlist_push_host(hl, node_record_table_ptr[i].name);
+	}
+	hostlist_sort(hl);
+	buf = hostlist_ranged_string_xmalloc(hl);
+	hostlist_destroy(hl);
+	return buf;
+}
+
+static bitstr_t *_ref_node_name2bitmap(char *names)
+{
+	bitstr_t *bitmap = bit_alloc(node_record_count);
+	hostlist_t hl = hostlist_create(names);
+	struct node_record *node_ptr;
+	char *name;
+
+	while ((name = hostlist_shift(hl))) {
+		if ((node_ptr = find_node_record_no_alias(name)))
+			bit_set(bitmap, node_ptr - node_record_table_ptr);
+		free(name);
+	}
+	hostlist_destroy(hl);
+	return bitmap;
+}
+
+/* Fill bitmap with runs of set and clear bits up to max_run long */
+static void _random_runs(bitstr_t *bitmap, int max_run)
+{
+	int i = 0, run;
+
+	bit_nclear(bitmap, 0, bit_size(bitmap) - 1);
+	while (i < bit_size(bitmap)) {
+		run = 1 + (rand() % max_run);
+		if (i + run > bit_size(bitmap))
+			run = bit_size(bitmap) - i;
+		if (rand() % 2)
+			bit_nset(bitmap, i, i + run - 1);
+		i += run;
+	}
+}
+
+/* Compare bitmap2node_name() and node_name2bitmap() with the references */
+static int _check_bitmap(bitstr_t *bitmap)
+{
+	bitstr_t *new_bitmap = NULL;
+	char *names, *ref_names;
+	int rc = 1;
+
+	names = bitmap2node_name(bitmap);
+	ref_names = _ref_bitmap2node_name(bitmap);
+	if (strcmp(names, ref_names))
+		rc = 0;
+	if ((node_name2bitmap(names, false, &new_bitmap) != SLURM_SUCCESS) ||
+	    !bit_equal(new_bitmap, bitmap))
+		rc = 0;
+	FREE_NULL_BITMAP(new_bitmap);
+	xfree(names);
+	xfree(ref_names);
+	return rc;
+}
+
+int
+main(int argc, char *argv[])
+{
+	bitstr_t *bitmap, *ref_bitmap = NULL;
+	struct timeval tv1, tv2;
+	hostlist_t hl;
+	char *names;
+	int i, ok;
+
+	_build_node_table();
+	TEST(node_record_count == TEST_NODE_CNT, "node table");
+	bitmap = bit_alloc(node_record_count);
+
+	note("Testing bitmap2node_name/node_name2bitmap");
+	srand(1);
+	for (i = 0, ok = 1; i < 40; i++) {
+		_random_runs(bitmap, (i % 2) ? 3 : 2000);
+		if (!_check_bitmap(bitmap))
+			ok = 0;
+	}
+	bit_nclear(bitmap, 0, node_record_count - 1);
+	if (!_check_bitmap(bitmap))
+		ok = 0;
+	bit_nset(bitmap, 0, node_record_count - 1);
+	if (!_check_bitmap(bitmap))
+		ok = 0;
+	TEST(ok, "random bitmaps");
+
+	note("Testing node_name2bitmap on other forms of names");
+	{
+		char *forms[] = {
+			"a[9-11],a[99-101]",		/* suffix width change */
+			"b0000[1-9],b000[10-12]",	/* digits in prefix */
+			"b[0001-0003]",			/* other zero padding */
+			"b[1-3],a[01-03]",		/* other zero padding */
+			"login[9990-9999],head,a77,b00077",
+			"a[49990-50010]",		/* past last node */
+			"nosuch[1-3],a1",
+		};
+
+		for (i = 0, ok = 1; i < sizeof(forms) / sizeof(char *); i++) {
+			FREE_NULL_BITMAP(ref_bitmap);
+			ref_bitmap = _ref_node_name2bitmap(forms[i]);
+			node_name2bitmap(forms[i], false, &bitmap);
+			if (!bit_equal(bitmap, ref_bitmap)) {
+				note("mismatch for %s", forms[i]);
+				ok = 0;
+			}
+			FREE_NULL_BITMAP(bitmap);
+		}
+		TEST(ok, "name forms");
+		TEST(node_name2bitmap("a[1-3],nosuch", false, &bitmap) ==
+		     EINVAL, "invalid name");
+		TEST(bit_set_count(bitmap) == 3, "invalid name");
+		FREE_NULL_BITMAP(bitmap);
+	}
+
+	note("Throughput at %d node names", node_record_count);
+	{
+		int loops = 10;
+
+		bitmap = bit_alloc(node_record_count);
+		_random_runs(bitmap, 3);
+
+		gettimeofday(&tv1, NULL);
+		for (i = 0; i < loops; i++) {
+			names = bitmap2node_name(bitmap);
+			xfree(names);
+		}
+		gettimeofday(&tv2, NULL);
+		note("bitmap2node_name: %ld usec per call",
+		     _delta_usec(&tv1, &tv2) / loops);
+
+		gettimeofday(&tv1, NULL);
+		for (i = 0; i < loops; i++) {
+			names = _ref_bitmap2node_name(bitmap);
+			xfree(names);
+		}
+		gettimeofday(&tv2, NULL);
+		note("bitmap2node_name, host at a time: %ld usec per call",
+		     _delta_usec(&tv1, &tv2) / loops);
+
+		names = bitmap2node_name(bitmap);
+		gettimeofday(&tv1, NULL);
+		for (i = 0; i < loops; i++) {
+			FREE_NULL_BITMAP(ref_bitmap);
+			node_name2bitmap(names, false, &ref_bitmap);
+		}
+		gettimeofday(&tv2, NULL);
+		note("node_name2bitmap: %ld usec per call",
+		     _delta_usec(&tv1, &tv2) / loops);
+		TEST(bit_equal(bitmap, ref_bitmap), "throughput");
+		FREE_NULL_BITMAP(ref_bitmap);
+
+		gettimeofday(&tv1, NULL);
+		for (i = 0; i < loops; i++) {
+			FREE_NULL_BITMAP(ref_bitmap);
+			ref_bitmap = _ref_node_name2bitmap(names);
+		}
+		gettimeofday(&tv2, NULL);
+		note("node_name2bitmap, host at a time: %ld usec per call",
+		     _delta_usec(&tv1, &tv2) / loops);
+		FREE_NULL_BITMAP(ref_bitmap);
+
+		hl = hostlist_create(names);
+		xfree(names);
+		gettimeofday(&tv1, NULL);
+		for (i = 0; i < loops; i++) {
+			names = hostlist_ranged_string_xmalloc(hl);
+			xfree(names);
+		}
+		gettimeofday(&tv2, NULL);
+		note("hostlist_ranged_string: %ld usec per call",
+		     _delta_usec(&tv1, &tv2) / loops);
+		hostlist_destroy(hl);
+		FREE_NULL_BITMAP(bitmap);
+	}
+
+	totals();
+	return failed;
+}
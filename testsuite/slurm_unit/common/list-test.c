@@ -0,0 +1,163 @@
+/* Test of src/common/list.c used as a queue and as a private list by 32
+ * threads at once.
+ *
+ * Half of the threads enqueue to one shared list while the other half
+ * dequeue from it, as the slurmctld and slurmstepd message queues do; then
+ * every thread appends to and pops from a list of its own, so that threads
+ * only meet on list node allocation. Each phase is checked and timed.
+ */
+#include <inttypes.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/time.h>
+#include <src/common/list.h>
+#include <testsuite/dejagnu.h>
+
+#define TEST_THREADS	32
+#define QUEUE_ITEMS	100000	/* items enqueued by each producer */
+#define PRIVATE_LOOPS	200	/* fill and drain passes of each private list */
+#define PRIVATE_ITEMS	1000	/* items in each private list pass */
+
+/* Test for failure:
+*/
+#define TEST(_tst, _msg) do {		\
+	if (! (_tst))			\
+		fail( _msg );		\
+	else				\
+		pass( _msg );		\
+} while (0)
+
+static List queue;
+static int queue_done;		/* address used as end of queue marker */
+static uint64_t queue_sum;
+static int queue_cnt;
+static pthread_mutex_t queue_lock = PTHREAD_MUTEX_INITIALIZER;
+static int private_errors;
+
+static long _delta_usec(struct timeval *tv1, struct timeval *tv2)
+{
+	return ((tv2->tv_sec - tv1->tv_sec) * 1000000) +
+	       (tv2->tv_usec - tv1->tv_usec);
+}
+
+static void *_producer(void *arg)
+{
+	uintptr_t base = (uintptr_t) arg * QUEUE_ITEMS;
+	uintptr_t i;
+
+	for (i = 1; i <= QUEUE_ITEMS; i++)
+		list_enqueue(queue, (void *) (base + i));
+	return NULL;
+}
+
+static void *_consumer(void *arg)
+{
+	uint64_t sum = 0;
+	int cnt = 0;
+	void *x;
+
+	while (1) {
+		if (!(x = list_dequeue(queue))) {
+			sched_yield();
+			continue;
+		}
+		if (x == &queue_done)
+			break;
+		sum += (uintptr_t) x;
+		cnt++;
+	}
+	pthread_mutex_lock(&queue_lock);
+	queue_sum += sum;
+	queue_cnt += cnt;
+	pthread_mutex_unlock(&queue_lock);
+	return NULL;
+}
+
+static void *_private(void *arg)
+{
+	List l = list_create(NULL);
+	uintptr_t i;
+	int loop, errors = 0;
+
+	for (loop = 0; loop < PRIVATE_LOOPS; loop++) {
+		for (i = 1; i <= PRIVATE_ITEMS; i++)
+			list_append(l, (void *) i);
+		for (i = 1; i <= PRIVATE_ITEMS; i++) {
+			if (list_pop(l) != (void *) i)
+				errors++;
+		}
+	}
+	list_destroy(l);
+	pthread_mutex_lock(&queue_lock);
+	private_errors += errors;
+	pthread_mutex_unlock(&queue_lock);
+	return NULL;
+}
+
+/* Run TEST_THREADS threads, the first cnt1 of them running f1 and the rest
+ * f2, and return the time until all have finished */
+static long _run_threads(void *(*f1)(void *), int cnt1, void *(*f2)(void *))
+{
+	pthread_t threads[TEST_THREADS];
+	struct timeval tv1, tv2;
+	uintptr_t i;
+
+	gettimeofday(&tv1, NULL);
+	for (i = 0; i < TEST_THREADS; i++) {
+		pthread_create(&threads[i], NULL, (i < cnt1) ? f1 : f2,
+			       (void *) i);
+	}
+	for (i = 0; i < cnt1; i++)
+		pthread_join(threads[i], NULL);
+	/* Producers are done, one end marker for each consumer */
+	for (i = cnt1; i < TEST_THREADS; i++)
+		list_enqueue(queue, &queue_done);
+	for (i = cnt1; i < TEST_THREADS; i++)
+		pthread_join(threads[i], NULL);
+	gettimeofday(&tv2, NULL);
+	return _delta_usec(&tv1, &tv2);
+}
+
+int
+main(int argc, char *argv[])
+{
+	uint64_t items, sum;
+	uintptr_t i;
+	long usec;
+	int ok;
+
+	note("Testing list_enqueue/list_dequeue order");
+	queue = list_create(NULL);
+	for (i = 1; i <= 1000; i++)
+		list_enqueue(queue, (void *) i);
+	for (i = 1, ok = 1; i <= 1000; i++) {
+		if (list_dequeue(queue) != (void *) i)
+			ok = 0;
+	}
+	TEST(ok && !list_dequeue(queue), "queue order");
+
+	note("Shared queue, %d producers and %d consumers",
+	     TEST_THREADS / 2, TEST_THREADS / 2);
+	usec = _run_threads(_producer, TEST_THREADS / 2, _consumer);
+	items = (uint64_t) QUEUE_ITEMS * (TEST_THREADS / 2);
+	/* sum of 1 .. producers * QUEUE_ITEMS */
+	sum = items * (items + 1) / 2;
+	TEST(queue_cnt == items, "shared queue item count");
+	TEST(queue_sum == sum, "shared queue item sum");
+	TEST(list_count(queue) == 0, "shared queue empty");
+	note("shared queue: %"PRIu64" items in %ld usec, %ld nsec per item",
+	     items, usec, (long) ((usec * 1000) / items));
+	list_destroy(queue);
+
+	note("Private lists, %d threads", TEST_THREADS);
+	queue = list_create(NULL);
+	usec = _run_threads(_private, TEST_THREADS, NULL);
+	items = (uint64_t) PRIVATE_LOOPS * PRIVATE_ITEMS * TEST_THREADS;
+	TEST(private_errors == 0, "private list order");
+	note("private lists: %"PRIu64" items in %ld usec, %ld nsec per item",
+	     items, usec, (long) ((usec * 1000) / items));
+	list_destroy(queue);
+
+	totals();
+	return failed;
+}
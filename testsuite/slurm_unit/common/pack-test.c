@@ -95,6 +95,43 @@ int main (int argc, char *argv[])
 	xfree(outstring);
 
 	free_buf(buffer);
+
+	/* Data packed by reference must be sent as if it had been copied */
+	{
+		Buf copy_buf = init_buf(0), ref_buf = init_buf_refs(0);
+		uint32_t big_size = MIN_BUF_REF_SIZE * 2, len = 0;
+		char *big = xmalloc(big_size);
+		struct iovec *iov;
+		int i, iov_cnt, diff = 0;
+
+		memset(big, 'x', big_size);
+		for (i = 0; i < 2; i++) {
+			buffer = i ? ref_buf : copy_buf;
+			pack32(test32, buffer);
+			packmem_array_ref(big, big_size, buffer);
+			packmem_array_ref(testbytes, sizeof(testbytes), buffer);
+		}
+		TEST(get_buf_offset(copy_buf) != get_buf_length(copy_buf),
+		     "packmem_array_ref copies into plain buffer");
+		TEST(get_buf_offset(ref_buf) != (get_buf_offset(copy_buf) -
+						 big_size),
+		     "packmem_array_ref references large data");
+
+		iov = get_buf_iovec(ref_buf, &iov_cnt);
+		for (i = 0; i < iov_cnt; i++) {
+			if (memcmp(get_buf_data(copy_buf) + len,
+				   iov[i].iov_base, iov[i].iov_len))
+				diff = 1;
+			len += iov[i].iov_len;
+		}
+		TEST(diff || (iov_cnt != 3) ||
+		     (len != get_buf_offset(copy_buf)),
+		     "get_buf_iovec matches copied data");
+		xfree(iov);
+		xfree(big);
+		free_buf(copy_buf);
+		free_buf(ref_buf);
+	}
 	totals();
 	return failed;
 